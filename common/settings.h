@@ -32,8 +32,15 @@ class FrameTiming {
     return data_[phase] = value;
   }
 
+  // The start of the vsync interval the frame was built for. The UI thread
+  // may start building the frame later than this if it was busy. This is not
+  // one of the |kPhases| reported to the framework.
+  fml::TimePoint GetVsyncStart() const { return vsync_start_; }
+  void SetVsyncStart(fml::TimePoint value) { vsync_start_ = value; }
+
  private:
   fml::TimePoint data_[kCount];
+  fml::TimePoint vsync_start_;
 };
 
 using TaskObserverAdd =
@@ -52,6 +59,21 @@ using MappingsCallback =
 
 using FrameRasterizedCallback = std::function<void(const FrameTiming&)>;
 
+// How frames are scheduled, trading throughput for the latency between input
+// and the frame reflecting it appearing.
+enum class FrameLatencyMode {
+  // The next frame may be built while the previous one is rasterized.
+  kDefault,
+  // Only one frame is in flight at a time, and it is built as late as the
+  // measured build and raster times allow for it to still meet its vsync
+  // deadline.
+  kLowLatency,
+  // More frames may be in flight when the raster thread would otherwise wait
+  // for the UI thread, keeping the raster thread busy with content whose build
+  // times vary.
+  kHighThroughput,
+};
+
 struct Settings {
   Settings();
 
@@ -172,6 +194,33 @@ struct Settings {
   // blocking calls in this callback will cause applications to jank.
   UnhandledExceptionCallback unhandled_exception_callback;
   bool enable_software_rendering = false;
+  // The maximum number of bytes of rasterized layers and pictures the raster
+  // cache may retain. Zero selects the engine default.
+  size_t raster_cache_max_bytes = 0;
+  // The maximum number of bytes of laid out words the text layout cache may
+  // retain. The cache is shared by all shells in the process. Zero selects the
+  // engine default.
+  size_t text_layout_cache_max_bytes = 0;
+  // The maximum number of bytes of decoded image pixels the decoded image
+  // cache may retain. The cache is shared by all shells in the process. Zero
+  // selects the engine default.
+  size_t decoded_image_cache_max_bytes = 0;
+  // The number of upcoming frames of animated images that are decoded ahead of
+  // time, and the size under which all frames of an animated image are kept
+  // once decoded. Applies to all shells in the process. Zero selects the
+  // engine default.
+  size_t animated_image_frame_cache_count = 0;
+  size_t animated_image_frame_cache_max_bytes = 0;
+  // Whether the raster cache is populated on the concurrent worker threads
+  // instead of the raster thread. Content is drawn directly until its cached
+  // image becomes available on a later frame.
+  bool enable_async_raster_cache = false;
+  // Whether software rendered frames are recorded and then rasterized as
+  // tiles in parallel on the concurrent worker threads.
+  bool enable_parallel_software_rasterization = false;
+  FrameLatencyMode frame_latency_mode = FrameLatencyMode::kDefault;
+  // The most frames that may be in flight in FrameLatencyMode::kHighThroughput.
+  uint32_t max_frame_pipeline_depth = 3;
   bool skia_deterministic_rendering_on_cpu = false;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
@@ -69,9 +69,11 @@ CompositorContext::ScopedFrame::~ScopedFrame() {
 
 RasterStatus CompositorContext::ScopedFrame::Raster(
     flutter::LayerTree& layer_tree,
-    bool ignore_raster_cache) {
+    bool ignore_raster_cache,
+    FrameDamage* frame_damage) {
   TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::Raster");
-  bool root_needs_readback = layer_tree.Preroll(*this, ignore_raster_cache);
+  bool root_needs_readback = layer_tree.Preroll(
+      *this, ignore_raster_cache, frame_damage != nullptr);
   bool needs_save_layer = root_needs_readback && !surface_supports_readback();
   PostPrerollResult post_preroll_result = PostPrerollResult::kSuccess;
   if (view_embedder_ && raster_thread_merger_) {
@@ -82,9 +84,18 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (post_preroll_result == PostPrerollResult::kResubmitFrame) {
     return RasterStatus::kResubmit;
   }
+  std::optional<SkRect> clip_rect =
+      frame_damage ? frame_damage->ComputeClipRect(layer_tree) : std::nullopt;
+
   // Clearing canvas after preroll reduces one render target switch when preroll
   // paints some raster cache.
   if (canvas()) {
+    if (clip_rect) {
+      // The canvas of an acquired frame is in device space, which is also the
+      // space the damage is computed in.
+      canvas()->save();
+      canvas()->clipRect(*clip_rect);
+    }
     if (needs_save_layer) {
       FML_LOG(INFO) << "Using SaveLayer to protect non-readback surface";
       SkRect bounds = SkRect::Make(layer_tree.frame_size());
@@ -94,10 +105,15 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
     }
     canvas()->clear(SK_ColorTRANSPARENT);
   }
-  layer_tree.Paint(*this, ignore_raster_cache);
+  if (!clip_rect || !clip_rect->isEmpty()) {
+    layer_tree.Paint(*this, ignore_raster_cache);
+  }
   if (canvas() && needs_save_layer) {
     canvas()->restore();
   }
+  if (canvas() && clip_rect) {
+    canvas()->restore();
+  }
   return RasterStatus::kSuccess;
 }
 
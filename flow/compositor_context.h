@@ -9,6 +9,7 @@
 #include <string>
 
 #include "flutter/flow/embedded_views.h"
+#include "flutter/flow/frame_damage.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/texture.h"
@@ -64,8 +65,13 @@ class CompositorContext {
 
     GrContext* gr_context() const { return gr_context_; }
 
+    // Prerolls and paints |layer_tree| into the frame's canvas. When
+    // |frame_damage| is non-null, painting is clipped to the region that
+    // changed since the layer tree it was configured with, and the damage is
+    // reported back through it.
     virtual RasterStatus Raster(LayerTree& layer_tree,
-                                bool ignore_raster_cache);
+                                bool ignore_raster_cache,
+                                FrameDamage* frame_damage);
 
    private:
     CompositorContext& context_;
@@ -0,0 +1,188 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_damage.h"
+
+#include <algorithm>
+
+#include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+size_t HashPaintProperty(const SkRect& rect) {
+  return fml::HashCombine(rect.fLeft, rect.fTop, rect.fRight, rect.fBottom);
+}
+
+size_t HashPaintProperty(const SkRRect& rrect) {
+  size_t hash = HashPaintProperty(rrect.rect());
+  for (auto corner :
+       {SkRRect::kUpperLeft_Corner, SkRRect::kUpperRight_Corner,
+        SkRRect::kLowerRight_Corner, SkRRect::kLowerLeft_Corner}) {
+    const SkVector radii = rrect.radii(corner);
+    fml::HashCombineSeed(hash, radii.fX, radii.fY);
+  }
+  return hash;
+}
+
+size_t HashPaintProperty(const SkPath& path) {
+  // Copies of a path share their generation ID until either is modified.
+  return fml::HashCombine(path.getGenerationID(), path.getFillType());
+}
+
+size_t HashPaintProperty(const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  size_t hash = fml::HashCombine();
+  for (SkScalar value : values) {
+    fml::HashCombineSeed(hash, value);
+  }
+  return hash;
+}
+
+PaintRegionMap::PaintRegionMap() = default;
+
+PaintRegionMap::~PaintRegionMap() = default;
+
+size_t PaintRegionMap::EnterContainer(const Layer* layer,
+                                      const SkMatrix& child_matrix) {
+  size_t token = ancestor_fingerprint_;
+  size_t fingerprint = layer->paint_fingerprint();
+  if (fingerprint != 0) {
+    fml::HashCombineSeed(ancestor_fingerprint_, fingerprint,
+                         HashPaintProperty(child_matrix));
+  }
+  return token;
+}
+
+void PaintRegionMap::ExitContainer(size_t token) {
+  ancestor_fingerprint_ = token;
+}
+
+void PaintRegionMap::AddLayer(const Layer* layer, const SkMatrix& matrix) {
+  if (!layer->paints_own_content() && !layer->spreads_damage()) {
+    return;
+  }
+
+  const size_t key = fml::HashCombine(ancestor_fingerprint_,
+                                      layer->paint_fingerprint(),
+                                      HashPaintProperty(matrix));
+  const SkRect bounds = matrix.mapRect(layer->paint_bounds());
+  const SkRect damage_source_bounds =
+      layer->spreads_damage() ? layer->GetDamageSourceBounds(bounds, matrix)
+                              : SkRect::MakeEmpty();
+
+  auto result = region_indices_.emplace(key, regions_.size());
+  if (!result.second) {
+    // An identical layer was already painted at the same place in this frame.
+    // The two cannot be told apart from frame to frame, so always treat them
+    // as damaged.
+    Region& region = regions_[result.first->second];
+    region.bounds.join(bounds);
+    region.damage_source_bounds.join(damage_source_bounds);
+    region.paints_volatile_content = true;
+    return;
+  }
+  regions_.push_back({key, bounds, layer->paints_volatile_content(),
+                      layer->spreads_damage(), damage_source_bounds});
+}
+
+FrameDamage::FrameDamage() = default;
+
+FrameDamage::~FrameDamage() = default;
+
+void FrameDamage::SetPreviousLayerTree(const LayerTree* prev_layer_tree) {
+  prev_layer_tree_ = prev_layer_tree;
+}
+
+void FrameDamage::AddAdditionalDamage(const SkIRect& damage) {
+  if (additional_damage_) {
+    additional_damage_->join(damage);
+  } else {
+    additional_damage_ = damage;
+  }
+}
+
+std::optional<SkRect> FrameDamage::ComputeClipRect(
+    const LayerTree& layer_tree) {
+  TRACE_EVENT0("flutter", "FrameDamage::ComputeClipRect");
+
+  const SkIRect frame_rect = SkIRect::MakeSize(layer_tree.frame_size());
+  frame_damage_ = frame_rect;
+
+  const PaintRegionMap* current = layer_tree.paint_regions();
+  const PaintRegionMap* previous =
+      prev_layer_tree_ ? prev_layer_tree_->paint_regions() : nullptr;
+
+  // Redrawing the tree that is already in the target (for instance after the
+  // surface was recreated) cannot be diffed against itself.
+  if (current == nullptr || previous == nullptr ||
+      prev_layer_tree_ == &layer_tree ||
+      prev_layer_tree_->frame_size() != layer_tree.frame_size()) {
+    return std::nullopt;
+  }
+
+  // Regions that appear in both frames but are now painted in a different
+  // order relative to each other may have swapped which one is on top where
+  // they overlap. Such a region is painted after a region it used to be
+  // painted before, and the overlap lies within its bounds.
+  SkRect damage = SkRect::MakeEmpty();
+  std::vector<bool> matched(previous->regions_.size(), false);
+  size_t max_previous_index = 0;
+  for (const auto& region : current->regions_) {
+    auto found = previous->region_indices_.find(region.key);
+    if (found == previous->region_indices_.end()) {
+      damage.join(region.bounds);
+      continue;
+    }
+    const size_t previous_index = found->second;
+    const auto& previous_region = previous->regions_[previous_index];
+    matched[previous_index] = true;
+    if (region.paints_volatile_content ||
+        previous_region.paints_volatile_content ||
+        previous_region.bounds != region.bounds) {
+      damage.join(region.bounds);
+      damage.join(previous_region.bounds);
+    } else if (previous_index < max_previous_index) {
+      damage.join(region.bounds);
+    }
+    max_previous_index = std::max(max_previous_index, previous_index);
+  }
+  for (size_t i = 0; i < matched.size(); i++) {
+    if (!matched[i]) {
+      damage.join(previous->regions_[i].bounds);
+    }
+  }
+
+  if (additional_damage_) {
+    damage.join(SkRect::Make(*additional_damage_));
+  }
+
+  // Some layers, such as blurs, let a change to any pixel they cover affect
+  // all of the pixels they produce. Repainting them may in turn damage other
+  // such layers, so iterate until the damage is stable.
+  bool damage_grew = true;
+  while (damage_grew && !damage.isEmpty()) {
+    damage_grew = false;
+    for (const auto& region : current->regions_) {
+      if (region.spreads_damage &&
+          SkRect::Intersects(region.damage_source_bounds, damage) &&
+          !damage.contains(region.bounds)) {
+        damage.join(region.bounds);
+        damage_grew = true;
+      }
+    }
+  }
+
+  SkIRect device_damage = damage.roundOut();
+  if (!device_damage.intersect(frame_rect)) {
+    device_damage.setEmpty();
+  }
+  frame_damage_ = device_damage;
+  return SkRect::Make(device_damage);
+}
+
+}  // namespace flutter
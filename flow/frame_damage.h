@@ -0,0 +1,124 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FRAME_DAMAGE_H_
+#define FLUTTER_FLOW_FRAME_DAMAGE_H_
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+class Layer;
+class LayerTree;
+
+// Helpers for |Layer::paint_fingerprint| implementations.
+size_t HashPaintProperty(const SkRect& rect);
+size_t HashPaintProperty(const SkRRect& rrect);
+size_t HashPaintProperty(const SkPath& path);
+size_t HashPaintProperty(const SkMatrix& matrix);
+
+//------------------------------------------------------------------------------
+/// Records, in paint order, the device space regions painted by the layers of
+/// a prerolled layer tree.
+///
+/// Each region is keyed by everything that determines the pixels painted
+/// there: the painting layer's own |Layer::paint_fingerprint|, its
+/// transformation, and the fingerprints of the ancestors that affect how it
+/// paints (clips, opacity, filters...). A layer that is rebuilt from one frame
+/// to the next with the same properties, for instance an ancestor of a
+/// retained layer, therefore maps to the same region in both frames.
+///
+class PaintRegionMap {
+ public:
+  PaintRegionMap();
+
+  ~PaintRegionMap();
+
+  // Called before the children of |layer| are prerolled with |child_matrix|.
+  // Returns a token that must be handed to |ExitContainer| once they are done.
+  size_t EnterContainer(const Layer* layer, const SkMatrix& child_matrix);
+
+  void ExitContainer(size_t token);
+
+  // Records the region painted by |layer| if it paints anything by itself.
+  // |matrix| is the matrix that was handed to |layer| during Preroll.
+  void AddLayer(const Layer* layer, const SkMatrix& matrix);
+
+  size_t size() const { return regions_.size(); }
+
+ private:
+  friend class FrameDamage;
+
+  struct Region {
+    size_t key;
+    SkRect bounds;
+    bool paints_volatile_content;
+    bool spreads_damage;
+    // Where a change of pixels spreads damage to this region, if it does.
+    SkRect damage_source_bounds;
+  };
+
+  size_t ancestor_fingerprint_ = 0;
+  // In the order the layers were prerolled.
+  std::vector<Region> regions_;
+  // Maps region keys to indices into |regions_|.
+  std::unordered_map<size_t, size_t> region_indices_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PaintRegionMap);
+};
+
+//------------------------------------------------------------------------------
+/// Computes the region of a frame that has changed since the previous frame
+/// drawn into the same render target, so that painting can be clipped to it.
+///
+/// The rasterizer configures an instance with the layer tree that was last
+/// drawn into the target and any damage the target itself reports, then passes
+/// it to |CompositorContext::ScopedFrame::Raster|. Once the frame has been
+/// rasterized, |GetFrameDamage| reports what was repainted so that it can be
+/// forwarded to surfaces capable of partial presentation.
+///
+class FrameDamage {
+ public:
+  FrameDamage();
+
+  ~FrameDamage();
+
+  // The layer tree whose contents are currently in the render target. Passing
+  // nullptr (the default) forces a full repaint.
+  void SetPreviousLayerTree(const LayerTree* prev_layer_tree);
+
+  // Adds damage that is not caused by layer tree differences, such as parts
+  // of the render target whose contents are stale.
+  void AddAdditionalDamage(const SkIRect& damage);
+
+  // Compares |layer_tree|, which must have been prerolled with paint region
+  // recording enabled, against the previous layer tree. Returns the device
+  // space rect painting must be clipped to, or std::nullopt if the entire
+  // frame must be repainted.
+  std::optional<SkRect> ComputeClipRect(const LayerTree& layer_tree);
+
+  // The damaged region of the last frame passed to |ComputeClipRect|.
+  const std::optional<SkIRect>& GetFrameDamage() const {
+    return frame_damage_;
+  }
+
+ private:
+  const LayerTree* prev_layer_tree_ = nullptr;
+  std::optional<SkIRect> additional_damage_;
+  std::optional<SkIRect> frame_damage_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameDamage);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_FRAME_DAMAGE_H_
@@ -0,0 +1,262 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_damage.h"
+
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "flutter/testing/canvas_test.h"
+#include "flutter/testing/mock_canvas.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+namespace flutter {
+namespace testing {
+
+class FrameDamageTest : public CanvasTest {
+ public:
+  FrameDamageTest()
+      : compositor_context_(fml::kDefaultFrameBudget),
+        scoped_frame_(compositor_context_.AcquireFrame(nullptr,
+                                                       &mock_canvas(),
+                                                       nullptr,
+                                                       SkMatrix::I(),
+                                                       false,
+                                                       true,
+                                                       nullptr)) {}
+
+  std::unique_ptr<LayerTree> MakeLayerTree(std::shared_ptr<Layer> root) {
+    auto layer_tree =
+        std::make_unique<LayerTree>(SkISize::Make(100, 100), 100.0f, 1.0f);
+    layer_tree->set_root_layer(std::move(root));
+    return layer_tree;
+  }
+
+  std::optional<SkRect> ComputeClipRect(LayerTree* prev, LayerTree* current) {
+    current->Preroll(frame(), false, true);
+    FrameDamage damage;
+    damage.SetPreviousLayerTree(prev);
+    return damage.ComputeClipRect(*current);
+  }
+
+  CompositorContext::ScopedFrame& frame() { return *scoped_frame_.get(); }
+
+ private:
+  CompositorContext compositor_context_;
+  std::unique_ptr<CompositorContext::ScopedFrame> scoped_frame_;
+};
+
+TEST_F(FrameDamageTest, FirstFrameIsFullyDamaged) {
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(std::make_shared<MockLayer>(SkPath().addRect(5, 5, 10, 10)));
+  auto layer_tree = MakeLayerTree(root);
+
+  EXPECT_EQ(ComputeClipRect(nullptr, layer_tree.get()), std::nullopt);
+}
+
+TEST_F(FrameDamageTest, RebuiltAncestorsOfRetainedLayersAreNotDamaged) {
+  auto child1 = std::make_shared<MockLayer>(SkPath().addRect(5, 5, 10, 10));
+  auto child2 = std::make_shared<MockLayer>(SkPath().addRect(50, 50, 60, 60));
+
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(child1);
+  root1->Add(child2);
+  auto tree1 = MakeLayerTree(root1);
+  ComputeClipRect(nullptr, tree1.get());
+
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(child1);
+  root2->Add(std::make_shared<MockLayer>(SkPath().addRect(50, 50, 60, 60)));
+  auto tree2 = MakeLayerTree(root2);
+
+  auto clip_rect = ComputeClipRect(tree1.get(), tree2.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(50, 50, 60, 60));
+}
+
+TEST_F(FrameDamageTest, UnchangedRetainedRootHasNoDamage) {
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(std::make_shared<MockLayer>(SkPath().addRect(5, 5, 10, 10)));
+  auto tree1 = MakeLayerTree(root);
+  ComputeClipRect(nullptr, tree1.get());
+
+  auto tree2 = MakeLayerTree(root);
+  auto clip_rect = ComputeClipRect(tree1.get(), tree2.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_TRUE(clip_rect->isEmpty());
+}
+
+TEST_F(FrameDamageTest, MovedRetainedLayerDamagesOldAndNewBounds) {
+  auto child = std::make_shared<MockLayer>(SkPath().addRect(0, 0, 10, 10));
+  auto still = std::make_shared<MockLayer>(SkPath().addRect(80, 80, 90, 90));
+
+  auto transform1 = std::make_shared<TransformLayer>(SkMatrix::Translate(5, 5));
+  transform1->Add(child);
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(transform1);
+  root->Add(still);
+  auto tree1 = MakeLayerTree(root);
+  ComputeClipRect(nullptr, tree1.get());
+
+  auto transform2 =
+      std::make_shared<TransformLayer>(SkMatrix::Translate(20, 5));
+  transform2->Add(child);
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(transform2);
+  root2->Add(still);
+  auto tree2 = MakeLayerTree(root2);
+
+  // |still| is unchanged, so the damage is the union of the old and new
+  // bounds of |child|.
+  auto clip_rect = ComputeClipRect(tree1.get(), tree2.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(5, 5, 30, 15));
+}
+
+TEST_F(FrameDamageTest, RemovedLayerIsDamaged) {
+  auto keep = std::make_shared<MockLayer>(SkPath().addRect(0, 0, 10, 10));
+  auto removed = std::make_shared<MockLayer>(SkPath().addRect(40, 40, 50, 50));
+  auto container = std::make_shared<ContainerLayer>();
+  container->Add(keep);
+  container->Add(removed);
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(container);
+  auto tree1 = MakeLayerTree(root1);
+  ComputeClipRect(nullptr, tree1.get());
+
+  auto container2 = std::make_shared<ContainerLayer>();
+  container2->Add(keep);
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(container2);
+  auto tree2 = MakeLayerTree(root2);
+
+  auto clip_rect = ComputeClipRect(tree1.get(), tree2.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(40, 40, 50, 50));
+}
+
+TEST_F(FrameDamageTest, DamageUnderBackdropFilterRepaintsFilter) {
+  auto static_child = std::make_shared<MockLayer>(SkPath().addRect(0, 0, 5, 5));
+  auto backdrop = std::make_shared<BackdropFilterLayer>(
+      SkImageFilters::Blur(2, 2, SkTileMode::kClamp, nullptr));
+  backdrop->Add(std::make_shared<MockLayer>(SkPath().addRect(20, 20, 80, 80)));
+
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(static_child);
+  root1->Add(std::make_shared<MockLayer>(SkPath().addRect(30, 30, 40, 40)));
+  root1->Add(backdrop);
+  auto tree1 = MakeLayerTree(root1);
+  ComputeClipRect(nullptr, tree1.get());
+
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(static_child);
+  root2->Add(std::make_shared<MockLayer>(SkPath().addRect(32, 30, 42, 40)));
+  root2->Add(backdrop);
+  auto tree2 = MakeLayerTree(root2);
+
+  auto clip_rect = ComputeClipRect(tree1.get(), tree2.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(20, 20, 80, 80));
+}
+
+TEST_F(FrameDamageTest, DamageNextToBackdropBlurRepaintsFilter) {
+  auto backdrop = std::make_shared<BackdropFilterLayer>(
+      SkImageFilters::Blur(2, 2, SkTileMode::kClamp, nullptr));
+  backdrop->Add(std::make_shared<MockLayer>(SkPath().addRect(20, 20, 80, 80)));
+
+  // The moved layer lies outside the backdrop filter, but within the radius
+  // of its blur.
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(std::make_shared<MockLayer>(SkPath().addRect(10, 30, 16, 40)));
+  root1->Add(backdrop);
+  auto tree1 = MakeLayerTree(root1);
+  ComputeClipRect(nullptr, tree1.get());
+
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(std::make_shared<MockLayer>(SkPath().addRect(12, 30, 18, 40)));
+  root2->Add(backdrop);
+  auto tree2 = MakeLayerTree(root2);
+
+  auto clip_rect = ComputeClipRect(tree1.get(), tree2.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(10, 20, 80, 80));
+}
+
+TEST_F(FrameDamageTest, ChangedClipDamagesRetainedChildren) {
+  auto child = std::make_shared<MockLayer>(SkPath().addRect(10, 10, 60, 60));
+  auto clip1 = std::make_shared<ClipRectLayer>(SkRect::MakeLTRB(0, 0, 50, 50),
+                                               Clip::hardEdge);
+  clip1->Add(child);
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(clip1);
+  root1->Add(std::make_shared<MockLayer>(SkPath().addRect(70, 70, 80, 80)));
+  auto tree1 = MakeLayerTree(root1);
+  ComputeClipRect(nullptr, tree1.get());
+
+  // Rebuilding the clip with the same properties causes no damage.
+  auto clip2 = std::make_shared<ClipRectLayer>(SkRect::MakeLTRB(0, 0, 50, 50),
+                                               Clip::hardEdge);
+  clip2->Add(child);
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(clip2);
+  root2->Add(root1->layers()[1]);
+  auto tree2 = MakeLayerTree(root2);
+  auto clip_rect = ComputeClipRect(tree1.get(), tree2.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_TRUE(clip_rect->isEmpty());
+
+  auto clip3 = std::make_shared<ClipRectLayer>(SkRect::MakeLTRB(0, 0, 40, 40),
+                                               Clip::hardEdge);
+  clip3->Add(child);
+  auto root3 = std::make_shared<ContainerLayer>();
+  root3->Add(clip3);
+  root3->Add(root1->layers()[1]);
+  auto tree3 = MakeLayerTree(root3);
+  clip_rect = ComputeClipRect(tree2.get(), tree3.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(10, 10, 60, 60));
+}
+
+TEST_F(FrameDamageTest, ReorderedLayersAreDamaged) {
+  auto below = std::make_shared<MockLayer>(SkPath().addRect(0, 0, 20, 20));
+  auto above = std::make_shared<MockLayer>(SkPath().addRect(10, 10, 30, 30));
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(below);
+  root1->Add(above);
+  auto tree1 = MakeLayerTree(root1);
+  ComputeClipRect(nullptr, tree1.get());
+
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(above);
+  root2->Add(below);
+  auto tree2 = MakeLayerTree(root2);
+  auto clip_rect = ComputeClipRect(tree1.get(), tree2.get());
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(0, 0, 20, 20));
+}
+
+TEST_F(FrameDamageTest, AdditionalDamageIsIncluded) {
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(std::make_shared<MockLayer>(SkPath().addRect(5, 5, 10, 10)));
+  auto tree1 = MakeLayerTree(root);
+  ComputeClipRect(nullptr, tree1.get());
+
+  auto tree2 = MakeLayerTree(root);
+  tree2->Preroll(frame(), false, true);
+  FrameDamage damage;
+  damage.SetPreviousLayerTree(tree1.get());
+  damage.AddAdditionalDamage(SkIRect::MakeLTRB(60, 60, 200, 200));
+  auto clip_rect = damage.ComputeClipRect(*tree2);
+  ASSERT_TRUE(clip_rect.has_value());
+  EXPECT_EQ(*clip_rect, SkRect::MakeLTRB(60, 60, 100, 100));
+  EXPECT_EQ(damage.GetFrameDamage(), SkIRect::MakeLTRB(60, 60, 100, 100));
+}
+
+}  // namespace testing
+}  // namespace flutter
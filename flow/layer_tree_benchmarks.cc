@@ -0,0 +1,388 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <functional>
+#include <memory>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/clip_rrect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_arena.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/time/time_delta.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+namespace flutter {
+namespace {
+
+constexpr int kFrameWidth = 1024;
+constexpr int kFrameHeight = 1024;
+constexpr SkScalar kPictureSize = 64;
+// The default |RasterCache| access threshold.
+constexpr int64_t kAccessThreshold = 3;
+
+// Owns everything needed to preroll and paint synthetic layer trees into a
+// CPU backed surface.
+class LayerTreeBenchmarkContext {
+ public:
+  LayerTreeBenchmarkContext()
+      : surface_(SkSurface::MakeRasterN32Premul(kFrameWidth, kFrameHeight)),
+        compositor_context_(fml::kDefaultFrameBudget) {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    unref_queue_ = fml::MakeRefCounted<SkiaUnrefQueue>(
+        fml::MessageLoop::GetCurrent().GetTaskRunner(),
+        fml::TimeDelta::FromSeconds(0));
+  }
+
+  std::unique_ptr<CompositorContext::ScopedFrame> AcquireFrame() {
+    return compositor_context_.AcquireFrame(
+        nullptr,                // gr_context
+        surface_->getCanvas(),  // canvas
+        nullptr,                // view_embedder
+        SkMatrix::I(),          // root_surface_transformation
+        false,                  // instrumentation_enabled
+        true,                   // surface_supports_readback
+        nullptr                 // raster_thread_merger
+    );
+  }
+
+  std::unique_ptr<LayerTree> MakeLayerTree(std::shared_ptr<Layer> root) {
+    auto layer_tree = std::make_unique<LayerTree>(
+        SkISize::Make(kFrameWidth, kFrameHeight), 100.0f, 1.0f);
+    layer_tree->set_root_layer(std::move(root));
+    return layer_tree;
+  }
+
+  // A picture layer with a picture of its own that is always considered worth
+  // caching. Cache entries ignore the translation, so sharing one picture
+  // between layers would leave the cache with a single entry.
+  std::shared_ptr<PictureLayer> MakePictureLayer(const SkPoint& offset,
+                                                 int64_t seed) {
+    return std::make_shared<PictureLayer>(
+        offset, SkiaGPUObject<SkPicture>(MakePicture(seed), unref_queue_),
+        true, false);
+  }
+
+  RasterCache& raster_cache() { return compositor_context_.raster_cache(); }
+
+ private:
+  sk_sp<SkSurface> surface_;
+  CompositorContext compositor_context_;
+  fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+
+  static sk_sp<SkPicture> MakePicture(int64_t seed) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas =
+        recorder.beginRecording(SkRect::MakeWH(kPictureSize, kPictureSize));
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 8; i++) {
+      paint.setColor(SkColorSetARGB(0xFF, 0x20 * i, 0xFF - 0x20 * i,
+                                    seed & 0xFF));
+      SkScalar inset = i * 4;
+      canvas->drawRRect(
+          SkRRect::MakeRectXY(SkRect::MakeWH(kPictureSize, kPictureSize)
+                                  .makeInset(inset, inset),
+                              6, 6),
+          paint);
+      canvas->drawCircle(kPictureSize / 2, kPictureSize / 2, inset / 2, paint);
+    }
+    return recorder.finishRecordingAsPicture();
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerTreeBenchmarkContext);
+};
+
+using TreeBuilder = std::function<std::shared_ptr<ContainerLayer>(
+    LayerTreeBenchmarkContext& context,
+    int64_t size)>;
+
+// Lays pictures out in a grid that wraps around once the frame is full.
+SkPoint GridOffset(int64_t index) {
+  const int64_t columns = kFrameWidth / kPictureSize;
+  const int64_t rows = kFrameHeight / kPictureSize;
+  return SkPoint::Make((index % columns) * kPictureSize,
+                       ((index / columns) % rows) * kPictureSize);
+}
+
+// Alternating transforms and anti-aliased rounded rect clips, |size| levels
+// deep, around a single picture.
+std::shared_ptr<ContainerLayer> BuildDeepTransformClipTree(
+    LayerTreeBenchmarkContext& context,
+    int64_t size) {
+  auto root = std::make_shared<ContainerLayer>();
+  std::shared_ptr<ContainerLayer> parent = root;
+  for (int64_t i = 0; i < size; i++) {
+    std::shared_ptr<ContainerLayer> child;
+    if (i % 2 == 0) {
+      SkMatrix matrix = SkMatrix::Translate(1, 1);
+      matrix.preRotate(0.5f);
+      child = std::make_shared<TransformLayer>(matrix);
+    } else {
+      child = std::make_shared<ClipRRectLayer>(
+          SkRRect::MakeRectXY(SkRect::MakeWH(kFrameWidth, kFrameHeight), 8, 8),
+          Clip::antiAlias);
+    }
+    parent->Add(child);
+    parent = child;
+  }
+  parent->Add(context.MakePictureLayer(SkPoint::Make(0, 0), 0));
+  return root;
+}
+
+// A single container with |size| pictures as its children.
+std::shared_ptr<ContainerLayer> BuildWideTree(
+    LayerTreeBenchmarkContext& context,
+    int64_t size) {
+  auto root = std::make_shared<ContainerLayer>();
+  for (int64_t i = 0; i < size; i++) {
+    root->Add(context.MakePictureLayer(GridOffset(i), i));
+  }
+  return root;
+}
+
+// |size| pictures, each under its own opacity layer.
+std::shared_ptr<ContainerLayer> BuildOpacityTree(
+    LayerTreeBenchmarkContext& context,
+    int64_t size) {
+  auto root = std::make_shared<ContainerLayer>();
+  for (int64_t i = 0; i < size; i++) {
+    auto opacity = std::make_shared<OpacityLayer>(0x80, GridOffset(i));
+    opacity->Add(context.MakePictureLayer(SkPoint::Make(0, 0), i));
+    root->Add(opacity);
+  }
+  return root;
+}
+
+// |size| blurring backdrop filters, each over a picture and wrapping another.
+std::shared_ptr<ContainerLayer> BuildBackdropFilterTree(
+    LayerTreeBenchmarkContext& context,
+    int64_t size) {
+  auto root = std::make_shared<ContainerLayer>();
+  for (int64_t i = 0; i < size; i++) {
+    root->Add(context.MakePictureLayer(GridOffset(i), i));
+    auto filter = std::make_shared<BackdropFilterLayer>(
+        SkImageFilters::Blur(4, 4, SkTileMode::kClamp, nullptr));
+    filter->Add(context.MakePictureLayer(GridOffset(i), size + i));
+    root->Add(filter);
+  }
+  return root;
+}
+
+// Allocates layers from a |LayerArena|, as |SceneBuilder| does, or from the
+// heap.
+class LayerFactory {
+ public:
+  explicit LayerFactory(bool use_arena) : use_arena_(use_arena) {}
+
+  template <typename T, typename... Args>
+  std::shared_ptr<T> Make(Args&&... args) {
+    if (use_arena_) {
+      return arena_.Make<T>(std::forward<Args>(args)...);
+    }
+    return std::make_shared<T>(std::forward<Args>(args)...);
+  }
+
+ private:
+  const bool use_arena_;
+  LayerArena arena_;
+};
+
+// |size| list items, each a transform over a clip over a picture, as built
+// for a long scrolling list. All items share one picture so that building
+// the tree measures the cost of the layers alone.
+std::shared_ptr<ContainerLayer> BuildListTree(
+    LayerFactory& factory,
+    std::shared_ptr<PictureLayer> picture,
+    int64_t size) {
+  auto root = factory.Make<ContainerLayer>();
+  for (int64_t i = 0; i < size; i++) {
+    const SkPoint offset = GridOffset(i);
+    auto item = factory.Make<TransformLayer>(
+        SkMatrix::Translate(offset.x(), offset.y()));
+    auto clip = factory.Make<ClipRectLayer>(
+        SkRect::MakeWH(kPictureSize, kPictureSize), Clip::hardEdge);
+    clip->Add(picture);
+    item->Add(clip);
+    root->Add(item);
+  }
+  return root;
+}
+
+void BM_BuildListTree(benchmark::State& state, bool use_arena) {
+  LayerTreeBenchmarkContext context;
+  auto picture = context.MakePictureLayer(SkPoint::Make(0, 0), 0);
+  while (state.KeepRunning()) {
+    // Includes tearing the tree down again, as happens once it is replaced.
+    LayerFactory factory(use_arena);
+    auto root = BuildListTree(factory, picture, state.range(0));
+    benchmark::DoNotOptimize(root);
+  }
+}
+
+void BM_PrerollListTree(benchmark::State& state, bool use_arena) {
+  LayerTreeBenchmarkContext context;
+  auto picture = context.MakePictureLayer(SkPoint::Make(0, 0), 0);
+  LayerFactory factory(use_arena);
+  auto layer_tree =
+      context.MakeLayerTree(BuildListTree(factory, picture, state.range(0)));
+
+  auto frame = context.AcquireFrame();
+  while (state.KeepRunning()) {
+    layer_tree->Preroll(*frame, true);
+  }
+}
+
+// Renders enough frames for a tree that uses the raster cache to populate it
+// before the measurements start. Each frame rasterizes at most a few new
+// pictures, and a picture must be seen a few times before it is cached. Each
+// frame is prerolled, painted and swept like the rasterizer does, so that the
+// cache holds the entries a real frame would find.
+void WarmUp(LayerTreeBenchmarkContext& context,
+            LayerTree& layer_tree,
+            int64_t size,
+            bool ignore_raster_cache) {
+  const int64_t frames =
+      ignore_raster_cache
+          ? 1
+          : kAccessThreshold + 1 +
+                size / RasterCache::kDefaultPictureCacheLimitPerFrame;
+  for (int64_t i = 0; i < frames; i++) {
+    auto frame = context.AcquireFrame();
+    layer_tree.Preroll(*frame, ignore_raster_cache);
+    layer_tree.Paint(*frame, ignore_raster_cache);
+    context.raster_cache().SweepAfterFrame();
+  }
+  FML_CHECK(ignore_raster_cache ||
+            context.raster_cache().GetCachedEntriesCount() > 0)
+      << "The raster cache is empty after warming up.";
+}
+
+void BM_Preroll(benchmark::State& state,
+                TreeBuilder build,
+                bool use_raster_cache) {
+  LayerTreeBenchmarkContext context;
+  auto layer_tree = context.MakeLayerTree(build(context, state.range(0)));
+  WarmUp(context, *layer_tree, state.range(0), !use_raster_cache);
+
+  auto frame = context.AcquireFrame();
+  while (state.KeepRunning()) {
+    layer_tree->Preroll(*frame, !use_raster_cache);
+  }
+}
+
+void BM_Paint(benchmark::State& state,
+              TreeBuilder build,
+              bool use_raster_cache) {
+  LayerTreeBenchmarkContext context;
+  auto layer_tree = context.MakeLayerTree(build(context, state.range(0)));
+  WarmUp(context, *layer_tree, state.range(0), !use_raster_cache);
+
+  auto frame = context.AcquireFrame();
+  layer_tree->Preroll(*frame, !use_raster_cache);
+  while (state.KeepRunning()) {
+    layer_tree->Paint(*frame, !use_raster_cache);
+  }
+}
+
+void BM_SweepAfterFrame(benchmark::State& state, TreeBuilder build) {
+  LayerTreeBenchmarkContext context;
+  auto layer_tree = context.MakeLayerTree(build(context, state.range(0)));
+  WarmUp(context, *layer_tree, state.range(0), false);
+
+  auto frame = context.AcquireFrame();
+  while (state.KeepRunning()) {
+    {
+      // Mark the cached entries as used in this frame, as the rasterizer
+      // would, so that the sweep keeps them.
+      ::benchmarking::ScopedPauseTiming pause(state);
+      layer_tree->Preroll(*frame, false);
+    }
+    context.raster_cache().SweepAfterFrame();
+  }
+  state.counters["CachedEntries"] =
+      context.raster_cache().GetCachedEntriesCount();
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Preroll,
+                  DeepTransformClip,
+                  BuildDeepTransformClipTree,
+                  false)
+    ->RangeMultiplier(4)
+    ->Range(4, 256);
+BENCHMARK_CAPTURE(BM_Preroll, WideContainer, BuildWideTree, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK_CAPTURE(BM_Preroll, WideContainerRasterCache, BuildWideTree, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK_CAPTURE(BM_Preroll, Opacity, BuildOpacityTree, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024);
+BENCHMARK_CAPTURE(BM_Preroll, BackdropFilter, BuildBackdropFilterTree, false)
+    ->RangeMultiplier(4)
+    ->Range(1, 64);
+
+BENCHMARK_CAPTURE(BM_Paint,
+                  DeepTransformClip,
+                  BuildDeepTransformClipTree,
+                  false)
+    ->RangeMultiplier(4)
+    ->Range(4, 256)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Paint, WideContainer, BuildWideTree, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Paint, WideContainerRasterCache, BuildWideTree, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Paint, Opacity, BuildOpacityTree, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Paint, OpacityRasterCache, BuildOpacityTree, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Paint, BackdropFilter, BuildBackdropFilterTree, false)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_SweepAfterFrame, WideContainer, BuildWideTree)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK_CAPTURE(BM_SweepAfterFrame, Opacity, BuildOpacityTree)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024);
+
+BENCHMARK_CAPTURE(BM_BuildListTree, Heap, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK_CAPTURE(BM_BuildListTree, Arena, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK_CAPTURE(BM_PrerollListTree, Heap, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK_CAPTURE(BM_PrerollListTree, Arena, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+
+}  // namespace flutter
@@ -16,6 +16,19 @@ void BackdropFilterLayer::Preroll(PrerollContext* context,
   ContainerLayer::Preroll(context, matrix);
 }
 
+size_t BackdropFilterLayer::paint_fingerprint() const {
+  return fml::HashCombine(filter_.get());
+}
+
+SkRect BackdropFilterLayer::GetDamageSourceBounds(
+    const SkRect& device_bounds,
+    const SkMatrix& matrix) const {
+  // The filter reads the backdrop around the layer, e.g. up to the radius of
+  // a blur.
+  return SkRect::Make(filter_->filterBounds(
+      device_bounds.roundOut(), matrix, SkImageFilter::kReverse_MapDirection));
+}
+
 void BackdropFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "BackdropFilterLayer::Paint");
   FML_DCHECK(needs_painting());
@@ -19,6 +19,11 @@ class BackdropFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  size_t paint_fingerprint() const override;
+  bool spreads_damage() const override { return bool(filter_); }
+  SkRect GetDamageSourceBounds(const SkRect& device_bounds,
+                               const SkMatrix& matrix) const override;
+
  private:
   sk_sp<SkImageFilter> filter_;
 
@@ -53,6 +53,10 @@ void ClipPathLayer::UpdateScene(SceneUpdateContext& context) {
 
 #endif
 
+size_t ClipPathLayer::paint_fingerprint() const {
+  return fml::HashCombine(HashPaintProperty(clip_path_), clip_behavior_);
+}
+
 void ClipPathLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipPathLayer::Paint");
   FML_DCHECK(needs_painting());
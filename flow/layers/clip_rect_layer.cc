@@ -46,6 +46,10 @@ void ClipRectLayer::UpdateScene(SceneUpdateContext& context) {
 
 #endif
 
+size_t ClipRectLayer::paint_fingerprint() const {
+  return fml::HashCombine(HashPaintProperty(clip_rect_), clip_behavior_);
+}
+
 void ClipRectLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipRectLayer::Paint");
   FML_DCHECK(needs_painting());
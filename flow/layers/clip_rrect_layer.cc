@@ -47,6 +47,10 @@ void ClipRRectLayer::UpdateScene(SceneUpdateContext& context) {
 
 #endif
 
+size_t ClipRRectLayer::paint_fingerprint() const {
+  return fml::HashCombine(HashPaintProperty(clip_rrect_), clip_behavior_);
+}
+
 void ClipRRectLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipRRectLayer::Paint");
   FML_DCHECK(needs_painting());
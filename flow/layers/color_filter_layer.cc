@@ -16,6 +16,10 @@ void ColorFilterLayer::Preroll(PrerollContext* context,
   ContainerLayer::Preroll(context, matrix);
 }
 
+size_t ColorFilterLayer::paint_fingerprint() const {
+  return fml::HashCombine(filter_.get());
+}
+
 void ColorFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ColorFilterLayer::Paint");
   FML_DCHECK(needs_painting());
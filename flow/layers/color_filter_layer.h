@@ -19,6 +19,8 @@ class ColorFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  size_t paint_fingerprint() const override;
+
  private:
   sk_sp<SkColorFilter> filter_;
 
@@ -38,6 +38,11 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   // always be false.
   FML_DCHECK(!context->has_platform_view);
   bool child_has_platform_view = false;
+  size_t paint_region_token = 0;
+  if (context->paint_regions) {
+    paint_region_token =
+        context->paint_regions->EnterContainer(this, child_matrix);
+  }
   for (auto& layer : layers_) {
     // Reset context->has_platform_view to false so that layers aren't treated
     // as if they have a platform view based on one being previously found in a
@@ -46,6 +51,10 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
 
     layer->Preroll(context, child_matrix);
 
+    if (context->paint_regions) {
+      context->paint_regions->AddLayer(layer.get(), child_matrix);
+    }
+
     if (layer->needs_system_composite()) {
       set_needs_system_composite(true);
     }
@@ -56,6 +65,9 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   }
 
   context->has_platform_view = child_has_platform_view;
+  if (context->paint_regions) {
+    context->paint_regions->ExitContainer(paint_region_token);
+  }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   if (child_layer_exists_below_) {
@@ -18,6 +18,11 @@ class ContainerLayer : public Layer {
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
+
+  // Subclasses that affect how their children paint must override
+  // |paint_fingerprint| to describe that effect.
+  size_t paint_fingerprint() const override { return 0; }
+  bool paints_own_content() const override { return false; }
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void CheckForChildLayerBelow(PrerollContext* context) override;
   void UpdateScene(SceneUpdateContext& context) override;
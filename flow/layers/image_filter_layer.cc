@@ -61,6 +61,10 @@ void ImageFilterLayer::Preroll(PrerollContext* context,
   }
 }
 
+size_t ImageFilterLayer::paint_fingerprint() const {
+  return fml::HashCombine(filter_.get());
+}
+
 void ImageFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ImageFilterLayer::Paint");
   FML_DCHECK(needs_painting());
@@ -19,6 +19,9 @@ class ImageFilterLayer : public MergedContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  size_t paint_fingerprint() const override;
+  bool spreads_damage() const override { return true; }
+
  private:
   // The ImageFilterLayer might cache the filtered output of this layer
   // if the layer remains stable (if it is not animating for instance).
@@ -9,11 +9,13 @@
 #include <vector>
 
 #include "flutter/flow/embedded_views.h"
+#include "flutter/flow/frame_damage.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/texture.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/compiler_specific.h"
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/trace_event.h"
@@ -66,6 +68,11 @@ struct PrerollContext {
   float total_elevation = 0.0f;
   bool has_platform_view = false;
   bool is_opaque = true;
+
+  // When non-null, every prerolled layer records its device space paint
+  // bounds here so that the frame damage can be computed against the previous
+  // frame. See |FrameDamage|.
+  PaintRegionMap* paint_regions = nullptr;
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   // True if, during the traversal so far, we have seen a child_scene_layer.
   // Informs whether a layer needs to be system composited.
@@ -183,6 +190,41 @@ class Layer {
 
   bool needs_painting() const { return !paint_bounds_.isEmpty(); }
 
+  // The following describe how this layer paints for the purposes of
+  // computing the damaged region of a frame. See |FrameDamage|.
+
+  // Hashes the properties that determine the pixels this layer paints by
+  // itself or the way its children paint, excluding its transformation. Two
+  // layers with the same fingerprint, painted with the same transformation and
+  // under the same ancestors, must produce the same pixels. The default is
+  // the unique id, which is always correct since layers are immutable once
+  // built, but lets no other layer stand in for this one. A return value of 0
+  // declares that the layer does not affect how its children paint.
+  virtual size_t paint_fingerprint() const { return unique_id(); }
+
+  // Whether this layer paints anything other than its children.
+  virtual bool paints_own_content() const { return true; }
+
+  // Whether the pixels painted by this layer may change from frame to frame
+  // even when the layer is retained, e.g. because they come from an external
+  // source. Such layers are always treated as damaged.
+  virtual bool paints_volatile_content() const { return false; }
+
+  // Whether a change to any pixel within the paint bounds of this layer, such
+  // as a change in the backdrop it filters or in the children it blurs, may
+  // affect all of the pixels it produces.
+  virtual bool spreads_damage() const { return false; }
+
+  // The device space region in which a change of pixels spreads damage to
+  // this layer, given its device space paint bounds and the matrix that was
+  // handed to it during Preroll. Only consulted if |spreads_damage| is true.
+  // The default is the paint bounds; layers that read pixels from around
+  // them, such as backdrop blurs, must extend it.
+  virtual SkRect GetDamageSourceBounds(const SkRect& device_bounds,
+                                       const SkMatrix& matrix) const {
+    return device_bounds;
+  }
+
   uint64_t unique_id() const { return unique_id_; }
 
  protected:
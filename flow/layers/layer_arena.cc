@@ -0,0 +1,46 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace flutter {
+
+LayerArena::Block::Block(size_t size)
+    : data_(new std::byte[size]), size_(size) {}
+
+LayerArena::Block::~Block() = default;
+
+void* LayerArena::Block::Allocate(size_t size, size_t alignment) {
+  const uintptr_t base = reinterpret_cast<uintptr_t>(data_.get());
+  const uintptr_t start = (base + used_ + alignment - 1) & ~(alignment - 1);
+  if (start + size > base + size_) {
+    return nullptr;
+  }
+  used_ = start + size - base;
+  return reinterpret_cast<void*>(start);
+}
+
+bool LayerArena::Block::Contains(const void* pointer) const {
+  const std::byte* begin = data_.get();
+  return std::greater_equal<const void*>()(pointer, begin) &&
+         std::less<const void*>()(pointer, begin + size_);
+}
+
+LayerArena::LayerArena() = default;
+
+LayerArena::~LayerArena() = default;
+
+const std::shared_ptr<LayerArena::Block>& LayerArena::ReserveBlock(
+    size_t size) {
+  if (!current_block_ || current_block_->remaining() < size) {
+    current_block_ = std::make_shared<Block>(std::max(size, kBlockSize));
+    block_count_++;
+  }
+  return current_block_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Allocates the layers built for a frame, together with the
+///             control blocks of the `std::shared_ptr`s that own them, out of
+///             large blocks of memory.
+///
+///             Layers are built in the order the tree is later prerolled and
+///             painted in, so allocating them one after another keeps each
+///             traversal walking forward through a few contiguous blocks
+///             instead of through many scattered heap allocations. Building
+///             a layer costs a pointer bump instead of a call to the heap.
+///
+///             The returned layers are ordinary `std::shared_ptr`s and may
+///             outlive the arena, for instance when they are retained into
+///             later frames. Each block is freed once the arena and all of
+///             the layers allocated from it are gone. A retained layer keeps
+///             only its own block alive, not the rest of its frame.
+///
+///             An arena may only be used on one thread at a time. The layers
+///             it returns may be used and destroyed on any thread.
+///
+class LayerArena {
+ public:
+  // The size of the blocks that layers are allocated from. Larger layers get
+  // a block of their own.
+  static constexpr size_t kBlockSize = 16 * 1024;
+
+  LayerArena();
+
+  ~LayerArena();
+
+  template <typename T, typename... Args>
+  std::shared_ptr<T> Make(Args&&... args) {
+    // |std::allocate_shared| places the control block, which holds a copy of
+    // the allocator, next to the object in a single allocation.
+    const std::shared_ptr<Block>& block =
+        ReserveBlock(sizeof(T) + kControlBlockSize);
+    return std::allocate_shared<T>(Allocator<T>(block),
+                                   std::forward<Args>(args)...);
+  }
+
+  // The number of blocks this arena has allocated.
+  size_t block_count() const { return block_count_; }
+
+ private:
+  // An upper bound on the size of a |std::shared_ptr| control block besides
+  // the object itself.
+  static constexpr size_t kControlBlockSize = 64;
+
+  class Block {
+   public:
+    explicit Block(size_t size);
+
+    ~Block();
+
+    // Returns nullptr if the block does not have room for |size| bytes.
+    void* Allocate(size_t size, size_t alignment);
+
+    bool Contains(const void* pointer) const;
+
+    size_t remaining() const { return size_ - used_; }
+
+   private:
+    const std::unique_ptr<std::byte[]> data_;
+    const size_t size_;
+    size_t used_ = 0;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Block);
+  };
+
+  // Allocates from a block, falling back to the heap if that block has run
+  // out of room. Copies of the allocator keep the block alive.
+  template <typename T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    explicit Allocator(std::shared_ptr<Block> block)
+        : block_(std::move(block)) {}
+
+    template <typename U>
+    Allocator(const Allocator<U>& other)  // NOLINT(google-explicit-constructor)
+        : block_(other.block_) {}
+
+    T* allocate(size_t count) {
+      void* memory = nullptr;
+      if (alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        memory = block_->Allocate(count * sizeof(T), alignof(T));
+      }
+      if (memory == nullptr) {
+        memory = ::operator new(count * sizeof(T));
+      }
+      return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* pointer, size_t count) {
+      // Memory in the block is reclaimed all at once with the block.
+      if (!block_->Contains(pointer)) {
+        ::operator delete(pointer);
+      }
+    }
+
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const {
+      return block_ == other.block_;
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const {
+      return block_ != other.block_;
+    }
+
+   private:
+    template <typename U>
+    friend class Allocator;
+
+    std::shared_ptr<Block> block_;
+  };
+
+  std::shared_ptr<Block> current_block_;
+  size_t block_count_ = 0;
+
+  // Returns a block with at least |size| bytes of room, starting a new one if
+  // the current block does not have enough.
+  const std::shared_ptr<Block>& ReserveBlock(size_t size);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerArena);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <array>
+#include <vector>
+
+#include "flutter/flow/layers/container_layer.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+class CountedObject {
+ public:
+  explicit CountedObject(int& live_count) : live_count_(live_count) {
+    live_count_++;
+  }
+  ~CountedObject() { live_count_--; }
+
+ private:
+  int& live_count_;
+};
+
+}  // namespace
+
+TEST(LayerArenaTest, AllocatesObjectsInOrder) {
+  LayerArena arena;
+  std::vector<std::shared_ptr<ContainerLayer>> layers;
+  for (int i = 0; i < 16; i++) {
+    layers.push_back(arena.Make<ContainerLayer>());
+  }
+  EXPECT_EQ(arena.block_count(), 1u);
+  for (size_t i = 1; i < layers.size(); i++) {
+    EXPECT_LT(layers[i - 1].get(), layers[i].get());
+  }
+}
+
+TEST(LayerArenaTest, StartsNewBlockWhenFull) {
+  LayerArena arena;
+  std::vector<std::shared_ptr<std::array<char, 1024>>> objects;
+  for (size_t i = 0; i < LayerArena::kBlockSize / 1024 + 1; i++) {
+    objects.push_back(arena.Make<std::array<char, 1024>>());
+  }
+  EXPECT_EQ(arena.block_count(), 2u);
+}
+
+TEST(LayerArenaTest, LargeObjectsGetTheirOwnBlock) {
+  LayerArena arena;
+  auto large = arena.Make<std::array<char, LayerArena::kBlockSize * 2>>();
+  ASSERT_TRUE(large);
+  (*large)[LayerArena::kBlockSize * 2 - 1] = 1;
+  EXPECT_EQ(arena.block_count(), 1u);
+}
+
+TEST(LayerArenaTest, DestroysObjects) {
+  int live_count = 0;
+  {
+    LayerArena arena;
+    auto first = arena.Make<CountedObject>(live_count);
+    auto second = arena.Make<CountedObject>(live_count);
+    EXPECT_EQ(live_count, 2);
+    first.reset();
+    EXPECT_EQ(live_count, 1);
+  }
+  EXPECT_EQ(live_count, 0);
+}
+
+TEST(LayerArenaTest, ObjectsOutliveArena) {
+  int live_count = 0;
+  std::shared_ptr<CountedObject> retained;
+  std::shared_ptr<ContainerLayer> root;
+  {
+    LayerArena arena;
+    retained = arena.Make<CountedObject>(live_count);
+    root = arena.Make<ContainerLayer>();
+    root->Add(arena.Make<ContainerLayer>());
+  }
+  EXPECT_EQ(live_count, 1);
+  EXPECT_EQ(root->layers().size(), 1u);
+  retained.reset();
+  EXPECT_EQ(live_count, 0);
+}
+
+}  // namespace testing
+}  // namespace flutter
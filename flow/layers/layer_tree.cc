@@ -21,17 +21,23 @@ LayerTree::LayerTree(const SkISize& frame_size,
       checkerboard_raster_cache_images_(false),
       checkerboard_offscreen_layers_(false) {}
 
-void LayerTree::RecordBuildTime(fml::TimePoint build_start,
+void LayerTree::RecordBuildTime(fml::TimePoint vsync_start,
+                                fml::TimePoint build_start,
                                 fml::TimePoint target_time) {
+  vsync_start_ = vsync_start;
   build_start_ = build_start;
   target_time_ = target_time;
   build_finish_ = fml::TimePoint::Now();
 }
 
 bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
-                        bool ignore_raster_cache) {
+                        bool ignore_raster_cache,
+                        bool record_paint_regions) {
   TRACE_EVENT0("flutter", "LayerTree::Preroll");
 
+  paint_regions_ =
+      record_paint_regions ? std::make_unique<PaintRegionMap>() : nullptr;
+
   if (!root_layer_) {
     FML_LOG(ERROR) << "The scene did not specify any layers.";
     return false;
@@ -56,8 +62,13 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       checkerboard_offscreen_layers_,
       frame_physical_depth_,
       frame_device_pixel_ratio_};
+  context.paint_regions = paint_regions_.get();
 
   root_layer_->Preroll(&context, frame.root_surface_transformation());
+  if (paint_regions_) {
+    paint_regions_->AddLayer(root_layer_.get(),
+                             frame.root_surface_transformation());
+  }
   return context.surface_needs_readback;
 }
 
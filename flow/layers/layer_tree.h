@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "flutter/flow/compositor_context.h"
+#include "flutter/flow/frame_damage.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_delta.h"
@@ -31,8 +32,12 @@ class LayerTree {
   // - a boolean indicating whether or not the top level of the
   //   layer tree performs any operations that require readback
   //   from the root surface.
+  //
+  // When |record_paint_regions| is set, the device space paint bounds of every
+  // layer are recorded for use by |FrameDamage|.
   bool Preroll(CompositorContext::ScopedFrame& frame,
-               bool ignore_raster_cache = false);
+               bool ignore_raster_cache = false,
+               bool record_paint_regions = false);
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void UpdateScene(SceneUpdateContext& context,
@@ -46,6 +51,10 @@ class LayerTree {
 
   Layer* root_layer() const { return root_layer_.get(); }
 
+  // The paint regions recorded by the last Preroll, or nullptr if that
+  // Preroll did not record them.
+  const PaintRegionMap* paint_regions() const { return paint_regions_.get(); }
+
   void set_root_layer(std::shared_ptr<Layer> root_layer) {
     root_layer_ = std::move(root_layer);
   }
@@ -54,7 +63,10 @@ class LayerTree {
   float frame_physical_depth() const { return frame_physical_depth_; }
   float frame_device_pixel_ratio() const { return frame_device_pixel_ratio_; }
 
-  void RecordBuildTime(fml::TimePoint build_start, fml::TimePoint target_time);
+  void RecordBuildTime(fml::TimePoint vsync_start,
+                       fml::TimePoint build_start,
+                       fml::TimePoint target_time);
+  fml::TimePoint vsync_start() const { return vsync_start_; }
   fml::TimePoint build_start() const { return build_start_; }
   fml::TimePoint build_finish() const { return build_finish_; }
   fml::TimeDelta build_time() const { return build_finish_ - build_start_; }
@@ -83,6 +95,8 @@ class LayerTree {
 
  private:
   std::shared_ptr<Layer> root_layer_;
+  std::unique_ptr<PaintRegionMap> paint_regions_;
+  fml::TimePoint vsync_start_;
   fml::TimePoint build_start_;
   fml::TimePoint build_finish_;
   fml::TimePoint target_time_;
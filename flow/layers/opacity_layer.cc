@@ -49,6 +49,10 @@ void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   context->cull_rect = context->cull_rect.makeOffset(offset_.fX, offset_.fY);
 }
 
+size_t OpacityLayer::paint_fingerprint() const {
+  return fml::HashCombine(alpha_, offset_.fX, offset_.fY);
+}
+
 void OpacityLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "OpacityLayer::Paint");
   FML_DCHECK(needs_painting());
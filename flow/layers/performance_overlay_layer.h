@@ -31,6 +31,8 @@ class PerformanceOverlayLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  bool paints_volatile_content() const override { return true; }
+
  private:
   int options_;
   std::string font_path_;
@@ -69,6 +69,11 @@ void PhysicalShapeLayer::Preroll(PrerollContext* context,
   }
 }
 
+size_t PhysicalShapeLayer::paint_fingerprint() const {
+  return fml::HashCombine(color_, shadow_color_, elevation_,
+                          HashPaintProperty(path_), clip_behavior_);
+}
+
 void PhysicalShapeLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "PhysicalShapeLayer::Paint");
   FML_DCHECK(needs_painting());
@@ -42,6 +42,10 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   set_paint_bounds(bounds);
 }
 
+size_t PictureLayer::paint_fingerprint() const {
+  return fml::HashCombine(picture()->uniqueID(), offset_.fX, offset_.fY);
+}
+
 void PictureLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "PictureLayer::Paint");
   FML_DCHECK(picture_.get());
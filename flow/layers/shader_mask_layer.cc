@@ -21,6 +21,11 @@ void ShaderMaskLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   ContainerLayer::Preroll(context, matrix);
 }
 
+size_t ShaderMaskLayer::paint_fingerprint() const {
+  return fml::HashCombine(shader_.get(), HashPaintProperty(mask_rect_),
+                          blend_mode_);
+}
+
 void ShaderMaskLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ShaderMaskLayer::Paint");
   FML_DCHECK(needs_painting());
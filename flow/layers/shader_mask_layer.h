@@ -21,6 +21,8 @@ class ShaderMaskLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  size_t paint_fingerprint() const override;
+
  private:
   sk_sp<SkShader> shader_;
   SkRect mask_rect_;
@@ -23,6 +23,8 @@ class TextureLayer : public Layer {
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
 
+  bool paints_volatile_content() const override { return !freeze_; }
+
  private:
   SkPoint offset_;
   SkSize size_;
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "flutter/flow/layers/layer.h"
@@ -11,9 +12,16 @@
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColorFilter.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkMaskFilter.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkShader.h"
 #include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
 
 namespace flutter {
 
@@ -34,11 +42,26 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
 }
 
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t picture_cache_limit_per_frame)
+                         size_t picture_cache_limit_per_frame,
+                         size_t max_bytes,
+                         size_t max_idle_frames)
     : access_threshold_(access_threshold),
       picture_cache_limit_per_frame_(picture_cache_limit_per_frame),
+      max_idle_frames_(max_idle_frames),
+      max_bytes_(max_bytes),
       checkerboard_images_(false) {}
 
+// The size of the image |Rasterize| produces for |logical_rect|.
+static size_t EstimateImageBytes(const SkRect& logical_rect,
+                                 const SkMatrix& ctm) {
+  SkIRect bounds = RasterCache::GetDeviceBounds(logical_rect, ctm);
+  if (bounds.isEmpty()) {
+    return 0;
+  }
+  return static_cast<size_t>(bounds.width()) * bounds.height() *
+         SkColorTypeBytesPerPixel(kN32_SkColorType);
+}
+
 static bool CanRasterizePicture(SkPicture* picture) {
   if (picture == nullptr) {
     return false;
@@ -86,7 +109,7 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
 }
 
 /// @note Procedure doesn't copy all closures.
-static std::unique_ptr<RasterCacheResult> Rasterize(
+static sk_sp<SkImage> RasterizeImage(
     GrContext* context,
     const SkMatrix& ctm,
     SkColorSpace* dst_color_space,
@@ -118,8 +141,283 @@ static std::unique_ptr<RasterCacheResult> Rasterize(
     DrawCheckerboard(canvas, logical_rect);
   }
 
-  return std::make_unique<RasterCacheResult>(surface->makeImageSnapshot(),
-                                             logical_rect);
+  return surface->makeImageSnapshot();
+}
+
+static std::unique_ptr<RasterCacheResult> Rasterize(
+    GrContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard,
+    const SkRect& logical_rect,
+    const std::function<void(SkCanvas*)>& draw_function) {
+  sk_sp<SkImage> image = RasterizeImage(context, ctm, dst_color_space,
+                                        checkerboard, logical_rect,
+                                        draw_function);
+  if (!image) {
+    return nullptr;
+  }
+  return std::make_unique<RasterCacheResult>(std::move(image), logical_rect);
+}
+
+namespace {
+
+// Finds out whether a picture draws any GPU backed images. Those may only be
+// used on the thread of the GrContext that owns them, so such pictures cannot
+// be rasterized on worker threads.
+class TextureImageDetector final : public SkNoDrawCanvas {
+ public:
+  TextureImageDetector(
+      const SkIRect& bounds,
+      const std::function<bool(const SkImage&)>& is_texture_image)
+      : SkNoDrawCanvas(bounds), is_texture_image_(is_texture_image) {}
+
+  bool found_texture_image() const { return found_texture_image_; }
+
+ private:
+  const std::function<bool(const SkImage&)>& is_texture_image_;
+  bool found_texture_image_ = false;
+
+  void CheckImage(const SkImage* image) {
+    found_texture_image_ |= image != nullptr && is_texture_image_(*image);
+  }
+
+  // Shaders and filters may hold images that are only reachable by
+  // serializing them, like those of an image filter or a picture shader.
+  void CheckFlattenable(const SkFlattenable* flattenable) {
+    if (flattenable == nullptr || found_texture_image_) {
+      return;
+    }
+    SkSerialProcs procs;
+    procs.fImageProc = [](SkImage* image, void* context) -> sk_sp<SkData> {
+      static_cast<TextureImageDetector*>(context)->CheckImage(image);
+      // Anything but null skips encoding the image.
+      return SkData::MakeEmpty();
+    };
+    procs.fImageCtx = this;
+    flattenable->serialize(&procs);
+  }
+
+  void CheckPaint(const SkPaint* paint) {
+    if (paint == nullptr) {
+      return;
+    }
+    SkShader* shader = paint->getShader();
+    if (shader != nullptr) {
+      const SkImage* image = shader->isAImage(nullptr, nullptr);
+      if (image != nullptr) {
+        CheckImage(image);
+      } else {
+        CheckFlattenable(shader);
+      }
+    }
+    CheckFlattenable(paint->getColorFilter());
+    CheckFlattenable(paint->getImageFilter());
+    CheckFlattenable(paint->getMaskFilter());
+  }
+
+  // |SkCanvas|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    CheckPaint(rec.fPaint);
+    CheckFlattenable(rec.fBackdrop);
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+  // |SkCanvas|
+  void onDrawPaint(const SkPaint& paint) override { CheckPaint(&paint); }
+
+  // |SkCanvas|
+  void onDrawBehind(const SkPaint& paint) override { CheckPaint(&paint); }
+
+  // |SkCanvas|
+  void onDrawPoints(PointMode,
+                    size_t,
+                    const SkPoint[],
+                    const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawRect(const SkRect&, const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawRegion(const SkRegion&, const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawOval(const SkRect&, const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawArc(const SkRect&,
+                 SkScalar,
+                 SkScalar,
+                 bool,
+                 const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawRRect(const SkRRect&, const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawDRRect(const SkRRect&,
+                    const SkRRect&,
+                    const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawPath(const SkPath&, const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawTextBlob(const SkTextBlob*,
+                      SkScalar,
+                      SkScalar,
+                      const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawVerticesObject(const SkVertices*,
+                            SkBlendMode,
+                            const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawPatch(const SkPoint[12],
+                   const SkColor[4],
+                   const SkPoint[4],
+                   SkBlendMode,
+                   const SkPaint& paint) override {
+    CheckPaint(&paint);
+  }
+
+  // |SkCanvas|
+  void onDrawImage(const SkImage* image,
+                   SkScalar,
+                   SkScalar,
+                   const SkPaint* paint) override {
+    CheckImage(image);
+    CheckPaint(paint);
+  }
+
+  // |SkCanvas|
+  void onDrawImageRect(const SkImage* image,
+                       const SkRect*,
+                       const SkRect&,
+                       const SkPaint* paint,
+                       SrcRectConstraint) override {
+    CheckImage(image);
+    CheckPaint(paint);
+  }
+
+  // |SkCanvas|
+  void onDrawImageNine(const SkImage* image,
+                       const SkIRect&,
+                       const SkRect&,
+                       const SkPaint* paint) override {
+    CheckImage(image);
+    CheckPaint(paint);
+  }
+
+  // |SkCanvas|
+  void onDrawImageLattice(const SkImage* image,
+                          const Lattice&,
+                          const SkRect&,
+                          const SkPaint* paint) override {
+    CheckImage(image);
+    CheckPaint(paint);
+  }
+
+  // |SkCanvas|
+  void onDrawAtlas(const SkImage* image,
+                   const SkRSXform[],
+                   const SkRect[],
+                   const SkColor[],
+                   int,
+                   SkBlendMode,
+                   const SkRect*,
+                   const SkPaint* paint) override {
+    CheckImage(image);
+    CheckPaint(paint);
+  }
+
+  // |SkCanvas|
+  void onDrawEdgeAAImageSet(const ImageSetEntry set[],
+                            int count,
+                            const SkPoint[],
+                            const SkMatrix[],
+                            const SkPaint* paint,
+                            SrcRectConstraint) override {
+    for (int i = 0; i < count; i++) {
+      CheckImage(set[i].fImage.get());
+    }
+    CheckPaint(paint);
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TextureImageDetector);
+};
+
+}  // namespace
+
+bool RasterCache::DrawsTextureImage(
+    const SkPicture& picture,
+    const std::function<bool(const SkImage&)>& is_texture_image) {
+  TextureImageDetector detector(picture.cullRect().roundOut(),
+                                is_texture_image);
+  picture.playback(&detector);
+  return detector.found_texture_image();
+}
+
+static bool CanRasterizeOffThread(SkPicture* picture) {
+  TRACE_EVENT0("flutter", "RasterCache::CanRasterizeOffThread");
+  return !RasterCache::DrawsTextureImage(
+      *picture, [](const SkImage& image) { return image.isTextureBacked(); });
+}
+
+static void PaintLayer(PrerollContext* context,
+                       Layer* layer,
+                       SkCanvas* canvas,
+                       RasterCache* raster_cache) {
+  SkISize canvas_size = canvas->getBaseLayerSize();
+  SkNWayCanvas internal_nodes_canvas(canvas_size.width(),
+                                     canvas_size.height());
+  internal_nodes_canvas.addCanvas(canvas);
+  Layer::PaintContext paintContext = {
+      (SkCanvas*)&internal_nodes_canvas,  // internal_nodes_canvas
+      canvas,                             // leaf_nodes_canvas
+      context->gr_context,                // gr_context
+      nullptr,                            // view_embedder
+      context->raster_time,
+      context->ui_time,
+      context->texture_registry,
+      raster_cache,
+      context->checkerboard_offscreen_layers,
+      context->frame_physical_depth,
+      context->frame_device_pixel_ratio};
+  if (layer->needs_painting()) {
+    layer->Paint(paintContext);
+  }
+}
+
+// Records |layer| so that it can be rasterized on a worker thread. Cached
+// descendants are painted directly, as their images may be GPU backed.
+static sk_sp<SkPicture> RecordLayer(PrerollContext* context, Layer* layer) {
+  TRACE_EVENT0("flutter", "RasterCache::RecordLayer");
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(layer->paint_bounds());
+  PaintLayer(context, layer, canvas, nullptr);
+  return recorder.finishRecordingAsPicture();
 }
 
 std::unique_ptr<RasterCacheResult> RasterCache::RasterizePicture(
@@ -140,9 +438,34 @@ void RasterCache::Prepare(PrerollContext* context,
   Entry& entry = layer_cache_[cache_key];
   entry.access_count++;
   entry.used_this_frame = true;
-  if (!entry.image) {
-    entry.image = RasterizeLayer(context, layer, ctm, checkerboard_images_);
+  if (entry.image) {
+    return;
+  }
+  if (entry.async_result) {
+    AdoptAsyncResult(entry, context->gr_context, layer_bytes_);
+    return;
+  }
+
+  const size_t bytes = EstimateImageBytes(layer->paint_bounds(), ctm);
+  if (!EnsureCapacity(bytes)) {
+    return;
+  }
+  if (task_runner_ && entry.can_rasterize_off_thread.value_or(true)) {
+    sk_sp<SkPicture> recording = RecordLayer(context, layer);
+    if (!entry.can_rasterize_off_thread) {
+      entry.can_rasterize_off_thread =
+          recording && CanRasterizeOffThread(recording.get());
+    }
+    if (*entry.can_rasterize_off_thread) {
+      RasterizeAsync(entry, std::move(recording), ctm,
+                     sk_ref_sp(context->dst_color_space), bytes,
+                     layer_bytes_);
+      return;
+    }
   }
+  SetEntryImage(entry,
+                RasterizeLayer(context, layer, ctm, checkerboard_images_),
+                layer_bytes_);
 }
 
 std::unique_ptr<RasterCacheResult> RasterCache::RasterizeLayer(
@@ -153,25 +476,9 @@ std::unique_ptr<RasterCacheResult> RasterCache::RasterizeLayer(
   return Rasterize(
       context->gr_context, ctm, context->dst_color_space, checkerboard,
       layer->paint_bounds(), [layer, context](SkCanvas* canvas) {
-        SkISize canvas_size = canvas->getBaseLayerSize();
-        SkNWayCanvas internal_nodes_canvas(canvas_size.width(),
-                                           canvas_size.height());
-        internal_nodes_canvas.addCanvas(canvas);
-        Layer::PaintContext paintContext = {
-            (SkCanvas*)&internal_nodes_canvas,  // internal_nodes_canvas
-            canvas,                             // leaf_nodes_canvas
-            context->gr_context,                // gr_context
-            nullptr,                            // view_embedder
-            context->raster_time,
-            context->ui_time,
-            context->texture_registry,
-            context->has_platform_view ? nullptr : context->raster_cache,
-            context->checkerboard_offscreen_layers,
-            context->frame_physical_depth,
-            context->frame_device_pixel_ratio};
-        if (layer->needs_painting()) {
-          layer->Paint(paintContext);
-        }
+        PaintLayer(context, layer, canvas,
+                   context->has_platform_view ? nullptr
+                                              : context->raster_cache);
       });
 }
 
@@ -185,7 +492,9 @@ bool RasterCache::Prepare(GrContext* context,
   if (access_threshold_ == 0) {
     return false;
   }
-  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+  // Rasterizing on workers costs no time in this frame.
+  if (!task_runner_ &&
+      picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
     return false;
   }
   if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
@@ -206,16 +515,44 @@ bool RasterCache::Prepare(GrContext* context,
 
   // Creates an entry, if not present prior.
   Entry& entry = picture_cache_[cache_key];
+  // Protect the entry from being evicted in favor of other pictures prepared
+  // in this frame.
+  entry.used_this_frame = true;
   if (entry.access_count < access_threshold_) {
     // Frame threshold has not yet been reached.
     return false;
   }
 
-  if (!entry.image) {
-    entry.image = RasterizePicture(picture, context, transformation_matrix,
-                                   dst_color_space, checkerboard_images_);
-    picture_cached_this_frame_++;
+  if (entry.image) {
+    return true;
+  }
+  if (entry.async_result) {
+    return AdoptAsyncResult(entry, context, picture_bytes_);
+  }
+
+  if (task_runner_ && !entry.can_rasterize_off_thread) {
+    entry.can_rasterize_off_thread = CanRasterizeOffThread(picture);
   }
+  const bool rasterize_async = task_runner_ && *entry.can_rasterize_off_thread;
+  if (!rasterize_async &&
+      picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    return false;
+  }
+  const size_t bytes =
+      EstimateImageBytes(picture->cullRect(), transformation_matrix);
+  if (!EnsureCapacity(bytes)) {
+    return false;
+  }
+  if (rasterize_async) {
+    RasterizeAsync(entry, sk_ref_sp(picture), transformation_matrix,
+                   sk_ref_sp(dst_color_space), bytes, picture_bytes_);
+    return false;
+  }
+  SetEntryImage(entry,
+                RasterizePicture(picture, context, transformation_matrix,
+                                 dst_color_space, checkerboard_images_),
+                picture_bytes_);
+  picture_cached_this_frame_++;
   return true;
 }
 
@@ -231,10 +568,12 @@ bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
   entry.used_this_frame = true;
 
   if (entry.image) {
+    hit_count_++;
     entry.image->draw(canvas);
     return true;
   }
 
+  miss_count_++;
   return false;
 }
 
@@ -252,16 +591,155 @@ bool RasterCache::Draw(const Layer* layer,
   entry.used_this_frame = true;
 
   if (entry.image) {
+    hit_count_++;
     entry.image->draw(canvas, paint);
     return true;
   }
 
+  miss_count_++;
   return false;
 }
 
+void RasterCache::SetEntryImage(Entry& entry,
+                                std::unique_ptr<RasterCacheResult> image,
+                                size_t& cache_bytes) {
+  FML_DCHECK(!entry.image);
+  FML_DCHECK(entry.bytes == 0);
+  entry.image = std::move(image);
+  if (entry.image) {
+    entry.bytes = entry.image->image_bytes();
+    cache_bytes += entry.bytes;
+  }
+}
+
+void RasterCache::RasterizeAsync(Entry& entry,
+                                 sk_sp<SkPicture> picture,
+                                 const SkMatrix& ctm,
+                                 sk_sp<SkColorSpace> dst_color_space,
+                                 size_t reserved_bytes,
+                                 size_t& cache_bytes) {
+  FML_DCHECK(task_runner_);
+  auto result = std::make_shared<AsyncResult>();
+  result->logical_rect = picture->cullRect();
+  entry.async_result = result;
+  entry.bytes = reserved_bytes;
+  cache_bytes += reserved_bytes;
+
+  // Frames do not wait for the result, they draw the picture directly until
+  // it is ready.
+  task_runner_->PostTask(
+      [result, picture = std::move(picture), ctm,
+       dst_color_space = std::move(dst_color_space),
+       checkerboard = checkerboard_images_]() {
+        auto image = RasterizeImage(
+            nullptr, ctm, dst_color_space.get(), checkerboard,
+            picture->cullRect(),
+            [&picture](SkCanvas* canvas) { canvas->drawPicture(picture); });
+        std::scoped_lock lock(result->mutex);
+        result->image = std::move(image);
+        result->done = true;
+      },
+      fml::ConcurrentTaskPriority::kLow);
+}
+
+bool RasterCache::AdoptAsyncResult(Entry& entry,
+                                   GrContext* context,
+                                   size_t& cache_bytes) {
+  FML_DCHECK(entry.async_result);
+  sk_sp<SkImage> image;
+  {
+    std::scoped_lock lock(entry.async_result->mutex);
+    if (!entry.async_result->done) {
+      return false;
+    }
+    image = std::move(entry.async_result->image);
+  }
+  const SkRect logical_rect = entry.async_result->logical_rect;
+  entry.async_result.reset();
+  cache_bytes -= entry.bytes;
+  entry.bytes = 0;
+  if (!image) {
+    return false;
+  }
+  if (context) {
+    // Drawing a raster image on a GPU canvas keeps an uploaded copy of it
+    // that is not accounted for. Upload it once and drop the pixels instead.
+    TRACE_EVENT0("flutter", "RasterCache::UploadAsyncResult");
+    if (sk_sp<SkImage> texture_image = image->makeTextureImage(context)) {
+      image = std::move(texture_image);
+    }
+  }
+  SetEntryImage(entry,
+                std::make_unique<RasterCacheResult>(std::move(image),
+                                                    logical_rect),
+                cache_bytes);
+  return true;
+}
+
+bool RasterCache::EnsureCapacity(size_t bytes) {
+  if (bytes > max_bytes_) {
+    return false;
+  }
+  const size_t total_bytes = picture_bytes_ + layer_bytes_;
+  if (total_bytes + bytes <= max_bytes_) {
+    return true;
+  }
+  return EvictIdleImages(total_bytes + bytes - max_bytes_,
+                         /*allow_partial=*/false);
+}
+
+bool RasterCache::EvictIdleImages(size_t bytes_to_free, bool allow_partial) {
+  struct Candidate {
+    Entry* entry;
+    size_t* cache_bytes;
+  };
+  std::vector<Candidate> candidates;
+  size_t reclaimable_bytes = 0;
+  auto collect_candidates = [&](auto& cache, size_t& cache_bytes) {
+    for (auto& item : cache) {
+      Entry& entry = item.second;
+      if (entry.image && !entry.used_this_frame) {
+        candidates.push_back({&entry, &cache_bytes});
+        reclaimable_bytes += entry.bytes;
+      }
+    }
+  };
+  collect_candidates(picture_cache_, picture_bytes_);
+  collect_candidates(layer_cache_, layer_bytes_);
+  if (reclaimable_bytes < bytes_to_free && !allow_partial) {
+    return false;
+  }
+
+  // Evict the entries that have been idle the longest first, and among those,
+  // the ones that were drawn the least.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              if (a.entry->idle_frames != b.entry->idle_frames) {
+                return a.entry->idle_frames > b.entry->idle_frames;
+              }
+              return a.entry->access_count < b.entry->access_count;
+            });
+
+  size_t freed_bytes = 0;
+  for (const auto& candidate : candidates) {
+    if (freed_bytes >= bytes_to_free) {
+      break;
+    }
+    *candidate.cache_bytes -= candidate.entry->bytes;
+    freed_bytes += candidate.entry->bytes;
+    // The entry is swept once it goes unused for long enough. Resetting its
+    // access count makes it earn its way back into the cache.
+    candidate.entry->bytes = 0;
+    candidate.entry->image.reset();
+    candidate.entry->access_count = 0;
+    eviction_count_++;
+  }
+  return freed_bytes >= bytes_to_free;
+}
+
 void RasterCache::SweepAfterFrame() {
-  SweepOneCacheAfterFrame(picture_cache_);
-  SweepOneCacheAfterFrame(layer_cache_);
+  SweepOneCacheAfterFrame(picture_cache_, picture_bytes_);
+  SweepOneCacheAfterFrame(layer_cache_, layer_bytes_);
   picture_cached_this_frame_ = 0;
   TraceStatsToTimeline();
 }
@@ -269,6 +747,44 @@ void RasterCache::SweepAfterFrame() {
 void RasterCache::Clear() {
   picture_cache_.clear();
   layer_cache_.clear();
+  picture_bytes_ = 0;
+  layer_bytes_ = 0;
+}
+
+void RasterCache::SetConcurrentTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+  task_runner_ = std::move(task_runner);
+}
+
+void RasterCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  const size_t total_bytes = picture_bytes_ + layer_bytes_;
+  if (total_bytes > max_bytes_) {
+    // Images used this frame stay pinned until it ends, so free as much as
+    // possible even if the cache cannot get under the new budget yet.
+    EvictIdleImages(total_bytes - max_bytes_, /*allow_partial=*/true);
+  }
+}
+
+RasterCacheMetrics RasterCache::GetMetrics() const {
+  RasterCacheMetrics metrics;
+  for (const auto& item : layer_cache_) {
+    if (item.second.image) {
+      metrics.layer_count++;
+    }
+  }
+  for (const auto& item : picture_cache_) {
+    if (item.second.image) {
+      metrics.picture_count++;
+    }
+  }
+  metrics.layer_bytes = layer_bytes_;
+  metrics.picture_bytes = picture_bytes_;
+  metrics.max_bytes = max_bytes_;
+  metrics.hit_count = hit_count_;
+  metrics.miss_count = miss_count_;
+  metrics.eviction_count = eviction_count_;
+  return metrics;
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
@@ -298,31 +814,18 @@ void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
 void RasterCache::TraceStatsToTimeline() const {
 #if !FLUTTER_RELEASE
 
-  size_t layer_cache_count = 0;
-  size_t layer_cache_bytes = 0;
-  size_t picture_cache_count = 0;
-  size_t picture_cache_bytes = 0;
-
-  for (const auto& item : layer_cache_) {
-    layer_cache_count++;
-    if (item.second.image) {
-      layer_cache_bytes += item.second.image->image_bytes();
-    }
-  }
-
-  for (const auto& item : picture_cache_) {
-    picture_cache_count++;
-    if (item.second.image) {
-      picture_cache_bytes += item.second.image->image_bytes();
-    }
-  }
+  const RasterCacheMetrics metrics = GetMetrics();
 
   FML_TRACE_COUNTER("flutter", "RasterCache",
-                    reinterpret_cast<int64_t>(this),             //
-                    "LayerCount", layer_cache_count,             //
-                    "LayerMBytes", layer_cache_bytes * 1e-6,     //
-                    "PictureCount", picture_cache_count,         //
-                    "PictureMBytes", picture_cache_bytes * 1e-6  //
+                    reinterpret_cast<int64_t>(this),                //
+                    "LayerCount", metrics.layer_count,              //
+                    "LayerMBytes", metrics.layer_bytes * 1e-6,      //
+                    "PictureCount", metrics.picture_count,          //
+                    "PictureMBytes", metrics.picture_bytes * 1e-6,  //
+                    "MaxMBytes", metrics.max_bytes * 1e-6,          //
+                    "HitCount", metrics.hit_count,                  //
+                    "MissCount", metrics.miss_count,                //
+                    "EvictionCount", metrics.eviction_count         //
   );
 
 #endif  // !FLUTTER_RELEASE
@@ -5,10 +5,15 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/flow/raster_cache_key.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -41,6 +46,29 @@ class RasterCacheResult {
 
 struct PrerollContext;
 
+// A snapshot of the contents and effectiveness of a |RasterCache|.
+struct RasterCacheMetrics {
+  // The number of layer and picture entries that hold a rasterized image.
+  size_t layer_count = 0;
+  size_t picture_count = 0;
+
+  // The bytes held by the images of those entries.
+  size_t layer_bytes = 0;
+  size_t picture_bytes = 0;
+
+  // The byte budget the images are kept under.
+  size_t max_bytes = 0;
+
+  // Cumulative counts since the cache was created. A hit is a draw that used
+  // a cached image, a miss is a draw of a prepared item that had none, and an
+  // eviction is an image dropped to stay within |max_bytes|.
+  size_t hit_count = 0;
+  size_t miss_count = 0;
+  size_t eviction_count = 0;
+
+  size_t total_bytes() const { return layer_bytes + picture_bytes; }
+};
+
 class RasterCache {
  public:
   // The default max number of picture raster caches to be generated per frame.
@@ -49,9 +77,22 @@ class RasterCache {
   // multiple frames.
   static constexpr int kDefaultPictureCacheLimitPerFrame = 3;
 
+  // The default number of bytes of rasterized images the cache may hold. When
+  // a new image would not fit, the least recently and least frequently used
+  // images are evicted first. Images used in the frame being prepared are
+  // never evicted in its favor; it is simply not cached instead.
+  static constexpr size_t kDefaultMaxBytes = 128 * 1024 * 1024;
+
+  // The default number of consecutive frames an entry may go unused before it
+  // is swept. Keeping entries around for a few frames avoids re-rasterizing
+  // content that briefly scrolls or animates out of view.
+  static constexpr size_t kDefaultMaxIdleFrames = 3;
+
   explicit RasterCache(
       size_t access_threshold = 3,
-      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame);
+      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame,
+      size_t max_bytes = kDefaultMaxBytes,
+      size_t max_idle_frames = kDefaultMaxIdleFrames);
 
   virtual ~RasterCache() = default;
 
@@ -105,6 +146,13 @@ class RasterCache {
     return bounds;
   }
 
+  // Whether |picture| draws an image for which |is_texture_image| returns
+  // true, directly or through a paint, shader, filter or saveLayer. Texture
+  // backed images may only be drawn on the thread of their GrContext.
+  static bool DrawsTextureImage(
+      const SkPicture& picture,
+      const std::function<bool(const SkImage&)>& is_texture_image);
+
   /**
    * @brief Snap the translation components of the matrix to integers.
    *
@@ -134,6 +182,9 @@ class RasterCache {
   // 3. The picture is accessed too few times
   // 4. There are too many pictures to be cached in the current frame.
   //    (See also kDefaultPictureCacheLimitPerFrame.)
+  // 5. The image would not fit in the byte budget. (See also SetMaxBytes.)
+  // 6. The image is being rasterized on a worker thread.
+  //    (See also SetConcurrentTaskRunner.)
   bool Prepare(GrContext* context,
                SkPicture* picture,
                const SkMatrix& transformation_matrix,
@@ -170,36 +221,114 @@ class RasterCache {
 
   size_t GetPictureCachedEntriesCount() const;
 
+  // Sets the number of bytes of rasterized images the cache may hold. If the
+  // cache holds more than |max_bytes|, images not used this frame are evicted
+  // immediately until it fits or none are left.
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t GetMaxBytes() const { return max_bytes_; }
+
+  RasterCacheMetrics GetMetrics() const;
+
+  // When a task runner is set, pictures and layers are rasterized into the
+  // cache on its workers instead of during Preroll. They are drawn directly
+  // until their image is ready, which is picked up by the first Prepare call
+  // after that, so populating the cache costs no time on the raster thread.
+  //
+  // Images are rasterized into CPU memory, and uploaded to the GPU when they
+  // are picked up if Prepare is given a GrContext. Content that draws GPU
+  // backed images cannot be read on the workers and is rasterized
+  // synchronously as before, subject to the per-frame limit.
+  void SetConcurrentTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner);
+
  private:
+  // The result of rasterizing an entry on a worker thread.
+  struct AsyncResult {
+    std::mutex mutex;
+    bool done = false;
+    sk_sp<SkImage> image;
+    // Set before the task is posted.
+    SkRect logical_rect;
+  };
+
   struct Entry {
     bool used_this_frame = false;
+    size_t idle_frames = 0;
     size_t access_count = 0;
+    // The bytes accounted to this entry. While |async_result| is pending, this
+    // is the size of the image being rasterized.
+    size_t bytes = 0;
     std::unique_ptr<RasterCacheResult> image;
+    std::shared_ptr<AsyncResult> async_result;
+    // Whether the content can be rasterized on a worker, once it is known.
+    // Finding out plays the content back, so it is only done once.
+    std::optional<bool> can_rasterize_off_thread;
   };
 
   template <class Cache>
-  static void SweepOneCacheAfterFrame(Cache& cache) {
+  void SweepOneCacheAfterFrame(Cache& cache, size_t& cache_bytes) {
     std::vector<typename Cache::iterator> dead;
 
     for (auto it = cache.begin(); it != cache.end(); ++it) {
       Entry& entry = it->second;
-      if (!entry.used_this_frame) {
+      if (entry.used_this_frame) {
+        entry.idle_frames = 0;
+      } else if (++entry.idle_frames > max_idle_frames_) {
         dead.push_back(it);
       }
       entry.used_this_frame = false;
     }
 
     for (auto it : dead) {
+      cache_bytes -= it->second.bytes;
       cache.erase(it);
     }
   }
 
+  // Evicts unused images until |bytes| more fit within |max_bytes_|. Returns
+  // false, without evicting anything, if that is not possible.
+  bool EnsureCapacity(size_t bytes);
+
+  // Evicts images not used this frame, longest idle first, until
+  // |bytes_to_free| bytes are freed. Unless |allow_partial| is set, nothing
+  // is evicted if that is not possible. Returns whether enough was freed.
+  bool EvictIdleImages(size_t bytes_to_free, bool allow_partial);
+
+  // Stores |image| in |entry|, accounting for its bytes in |cache_bytes|.
+  void SetEntryImage(Entry& entry,
+                     std::unique_ptr<RasterCacheResult> image,
+                     size_t& cache_bytes);
+
+  // Posts a task rasterizing |picture| for |entry| to |task_runner_|. The
+  // |reserved_bytes| the image is expected to take are accounted to |entry|
+  // in the meantime.
+  void RasterizeAsync(Entry& entry,
+                      sk_sp<SkPicture> picture,
+                      const SkMatrix& ctm,
+                      sk_sp<SkColorSpace> dst_color_space,
+                      size_t reserved_bytes,
+                      size_t& cache_bytes);
+
+  // Moves the image rasterized for |entry| on a worker into it, if it is
+  // ready, uploading it to |context| if there is one. Returns whether |entry|
+  // now has an image.
+  bool AdoptAsyncResult(Entry& entry, GrContext* context, size_t& cache_bytes);
+
   const size_t access_threshold_;
   const size_t picture_cache_limit_per_frame_;
+  const size_t max_idle_frames_;
+  size_t max_bytes_;
   size_t picture_cached_this_frame_ = 0;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
+  size_t picture_bytes_ = 0;
+  size_t layer_bytes_ = 0;
+  mutable size_t hit_count_ = 0;
+  mutable size_t miss_count_ = 0;
+  size_t eviction_count_ = 0;
   bool checkerboard_images_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner_;
 
   void TraceStatsToTimeline() const;
 
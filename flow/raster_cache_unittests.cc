@@ -4,11 +4,15 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPaint.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
 
 namespace flutter {
 namespace testing {
@@ -24,6 +28,33 @@ sk_sp<SkPicture> GetSamplePicture() {
   return recorder.finishRecordingAsPicture();
 }
 
+// Waits for the tasks posted to a single worker |task_runner| so far.
+void WaitForWorker(fml::ConcurrentTaskRunner& task_runner) {
+  fml::AutoResetWaitableEvent latch;
+  task_runner.PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+sk_sp<SkImage> MakeImage() {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(4, 4);
+  bitmap.eraseColor(SK_ColorBLUE);
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
+// Records |draw| and finds out whether it draws |texture|, which stands in
+// for a texture backed image.
+bool DrawsTexture(const sk_sp<SkImage>& texture,
+                  const std::function<void(SkCanvas*)>& draw) {
+  SkPictureRecorder recorder;
+  draw(recorder.beginRecording(SkRect::MakeWH(100, 100)));
+  auto picture = recorder.finishRecordingAsPicture();
+  return RasterCache::DrawsTextureImage(
+      *picture,
+      [&texture](const SkImage& image) { return &image == texture.get(); });
+}
+
 }  // namespace
 
 TEST(RasterCache, SimpleInitialization) {
@@ -127,9 +158,203 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
   ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
 
   cache.SweepAfterFrame();
-  cache.SweepAfterFrame();  // Extra frame without a Get image access.
+  // Frames without a Get image access.
+  for (size_t i = 0; i < RasterCache::kDefaultMaxIdleFrames; i++) {
+    cache.SweepAfterFrame();
+    ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+  }
+  cache.SweepAfterFrame();
+
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, MaxIdleFramesOfZeroSweepsAfterOneUnusedFrame) {
+  flutter::RasterCache cache(1, 3, RasterCache::kDefaultMaxBytes, 0);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
+}
+
+TEST(RasterCache, MetricsCountHitsMissesAndBytes) {
+  flutter::RasterCache cache(1);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+
+  RasterCacheMetrics metrics = cache.GetMetrics();
+  EXPECT_EQ(metrics.picture_count, 1u);
+  EXPECT_EQ(metrics.layer_count, 0u);
+  EXPECT_EQ(metrics.picture_bytes, 150u * 100u * 4u);
+  EXPECT_EQ(metrics.total_bytes(), metrics.picture_bytes);
+  EXPECT_EQ(metrics.max_bytes, RasterCache::kDefaultMaxBytes);
+  EXPECT_EQ(metrics.hit_count, 2u);
+  EXPECT_EQ(metrics.miss_count, 1u);
+  EXPECT_EQ(metrics.eviction_count, 0u);
+
+  cache.Clear();
+  metrics = cache.GetMetrics();
+  EXPECT_EQ(metrics.picture_count, 0u);
+  EXPECT_EQ(metrics.picture_bytes, 0u);
+}
+
+TEST(RasterCache, ByteBudgetEvictsIdleImages) {
+  // Each sample picture takes 60000 bytes, so only one fits.
+  flutter::RasterCache cache(1, 3, 100000);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture1, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture1, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // |picture1| goes idle while |picture2| is drawn.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture2, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture2, dummy_canvas));
+
+  RasterCacheMetrics metrics = cache.GetMetrics();
+  EXPECT_EQ(metrics.picture_count, 1u);
+  EXPECT_EQ(metrics.picture_bytes, 60000u);
+  EXPECT_EQ(metrics.eviction_count, 1u);
+  ASSERT_FALSE(cache.Draw(*picture1, dummy_canvas));
+}
+
+TEST(RasterCache, ImagesUsedThisFrameAreNotEvicted) {
+  flutter::RasterCache cache(1, 3, 100000);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  for (int frame = 0; frame < 3; frame++) {
+    bool expect_cached = frame > 0;
+    ASSERT_EQ(
+        cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false),
+        expect_cached);
+    // There is never room for |picture2| while |picture1| is on screen.
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+    ASSERT_EQ(cache.Draw(*picture1, dummy_canvas), expect_cached);
+    ASSERT_FALSE(cache.Draw(*picture2, dummy_canvas));
+    cache.SweepAfterFrame();
+  }
+
+  EXPECT_EQ(cache.GetMetrics().eviction_count, 0u);
+}
+
+TEST(RasterCache, PicturesLargerThanTheBudgetAreNotCached) {
+  flutter::RasterCache cache(1, 3, 1000);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
 
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
   ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  EXPECT_EQ(cache.GetMetrics().total_bytes(), 0u);
+}
+
+TEST(RasterCache, LoweringMaxBytesEvictsImages) {
+  flutter::RasterCache cache(1);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  cache.SetMaxBytes(0);
+  EXPECT_EQ(cache.GetMaxBytes(), 0u);
+  RasterCacheMetrics metrics = cache.GetMetrics();
+  EXPECT_EQ(metrics.total_bytes(), 0u);
+  EXPECT_EQ(metrics.eviction_count, 1u);
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, LoweringMaxBytesEvictsIdleImagesWhenOthersArePinned) {
+  flutter::RasterCache cache(1, 3, 200000);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  for (int frame = 0; frame < 2; frame++) {
+    bool expect_cached = frame > 0;
+    ASSERT_EQ(
+        cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false),
+        expect_cached);
+    ASSERT_EQ(
+        cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false),
+        expect_cached);
+    cache.SweepAfterFrame();
+  }
+
+  // |picture2| is in use, so the cache cannot get under the new budget, but
+  // the idle |picture1| is still evicted.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  cache.SetMaxBytes(50000);
+  RasterCacheMetrics metrics = cache.GetMetrics();
+  EXPECT_EQ(metrics.picture_count, 1u);
+  EXPECT_EQ(metrics.eviction_count, 1u);
+  ASSERT_FALSE(cache.Draw(*picture1, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*picture2, dummy_canvas));
 }
 
 // Construct a cache result whose device target rectangle rounds out to be one
@@ -164,5 +389,153 @@ TEST(RasterCache, DeviceRectRoundOut) {
   ASSERT_TRUE(cache.Draw(*picture, canvas));
 }
 
+TEST(RasterCache, AsyncRasterizationSwapsInImageOnLaterFrame) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+  flutter::RasterCache cache(1);
+  cache.SetConcurrentTaskRunner(task_runner);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // The picture is drawn directly while it is rasterized on the worker, but
+  // its bytes are already accounted for.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  RasterCacheMetrics metrics = cache.GetMetrics();
+  EXPECT_EQ(metrics.picture_count, 0u);
+  EXPECT_EQ(metrics.picture_bytes, 60000u);
+  WaitForWorker(*task_runner);
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  metrics = cache.GetMetrics();
+  EXPECT_EQ(metrics.picture_count, 1u);
+  EXPECT_EQ(metrics.picture_bytes, 60000u);
+}
+
+TEST(RasterCache, AsyncRasterizationIgnoresPictureCacheLimitPerFrame) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+  flutter::RasterCache cache(1, 0);
+  cache.SetConcurrentTaskRunner(task_runner);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  for (int frame = 0; frame < 2; frame++) {
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+    ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+    cache.SweepAfterFrame();
+  }
+  WaitForWorker(*task_runner);
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, SweepingPendingEntryReleasesReservedBytes) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+  flutter::RasterCache cache(1, 3, RasterCache::kDefaultMaxBytes, 0);
+  cache.SetConcurrentTaskRunner(task_runner);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+
+  EXPECT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
+  EXPECT_EQ(cache.GetMetrics().total_bytes(), 0u);
+  WaitForWorker(*task_runner);
+}
+
+TEST(RasterCache, DetectsDirectlyDrawnTextureImages) {
+  auto texture = MakeImage();
+  auto raster = MakeImage();
+  EXPECT_TRUE(DrawsTexture(texture, [&](SkCanvas* canvas) {
+    canvas->drawImage(texture, 0, 0);
+  }));
+  EXPECT_FALSE(DrawsTexture(texture, [&](SkCanvas* canvas) {
+    canvas->drawImage(raster, 0, 0);
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+  }));
+}
+
+TEST(RasterCache, DetectsTextureImagesInShaders) {
+  auto texture = MakeImage();
+  SkPaint paint;
+  paint.setShader(
+      texture->makeShader(SkTileMode::kClamp, SkTileMode::kClamp, nullptr));
+  EXPECT_TRUE(DrawsTexture(texture, [&](SkCanvas* canvas) {
+    canvas->drawArc(SkRect::MakeWH(10, 10), 0, 90, true, paint);
+  }));
+  EXPECT_TRUE(DrawsTexture(texture, [&](SkCanvas* canvas) {
+    const SkPoint points[] = {{0, 0}, {10, 10}};
+    canvas->drawPoints(SkCanvas::kLines_PointMode, 2, points, paint);
+  }));
+}
+
+TEST(RasterCache, DetectsTextureImagesInSaveLayers) {
+  auto texture = MakeImage();
+  SkPaint paint;
+  paint.setShader(
+      texture->makeShader(SkTileMode::kClamp, SkTileMode::kClamp, nullptr));
+  EXPECT_TRUE(DrawsTexture(texture, [&](SkCanvas* canvas) {
+    canvas->saveLayer(nullptr, &paint);
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    canvas->restore();
+  }));
+
+  auto backdrop = SkImageFilters::Image(texture);
+  EXPECT_TRUE(DrawsTexture(texture, [&](SkCanvas* canvas) {
+    canvas->saveLayer(
+        SkCanvas::SaveLayerRec(nullptr, nullptr, backdrop.get(), 0));
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    canvas->restore();
+  }));
+}
+
+TEST(RasterCache, DetectsTextureImagesInImageFilters) {
+  auto texture = MakeImage();
+  SkPaint paint;
+  paint.setImageFilter(SkImageFilters::Blur(
+      2, 2, SkTileMode::kClamp, SkImageFilters::Image(texture)));
+  EXPECT_TRUE(DrawsTexture(texture, [&](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+  }));
+  EXPECT_TRUE(DrawsTexture(texture, [&](SkCanvas* canvas) {
+    canvas->saveLayer(nullptr, &paint);
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    canvas->restore();
+  }));
+  EXPECT_FALSE(DrawsTexture(MakeImage(), [&](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+  }));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -18,4 +18,7 @@ std::unique_ptr<GLContextResult> Surface::MakeRenderContextCurrent() {
   return std::make_unique<GLContextDefaultResult>(true);
 }
 
+void Surface::SetConcurrentRasterTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {}
+
 }  // namespace flutter
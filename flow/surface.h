@@ -10,6 +10,7 @@
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/gl_context_switch.h"
 #include "flutter/flow/surface_frame.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 
 namespace flutter {
@@ -33,6 +34,12 @@ class Surface {
 
   virtual std::unique_ptr<GLContextResult> MakeRenderContextCurrent();
 
+  // Lets surfaces that rasterize frames on the CPU spread the work over the
+  // workers of |task_runner|. Passing nullptr restores single threaded
+  // rasterization. Surfaces that rasterize on the GPU ignore this.
+  virtual void SetConcurrentRasterTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner);
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(Surface);
 };
@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_SURFACE_FRAME_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/flow/gl_context_switch.h"
 #include "flutter/fml/macros.h"
@@ -21,6 +22,27 @@ class SurfaceFrame {
   using SubmitCallback =
       std::function<bool(const SurfaceFrame& surface_frame, SkCanvas* canvas)>;
 
+  // Information about the underlying framebuffer that lets the rasterizer
+  // avoid repainting pixels that did not change.
+  struct FramebufferInfo {
+    // Whether the framebuffer keeps the contents of the frame previously
+    // submitted to this surface, so that only the changed region needs to be
+    // repainted.
+    bool supports_partial_repaint = false;
+
+    // Region of the framebuffer whose contents do not match the previously
+    // submitted frame and must be repainted in addition to the frame damage.
+    std::optional<SkIRect> existing_damage;
+  };
+
+  // Information about the frame passed to the surface when it is submitted.
+  struct SubmitInfo {
+    // The region of the frame that was repainted, or std::nullopt if the
+    // entire frame was repainted. Surfaces that can present partial updates
+    // only need to present this region.
+    std::optional<SkIRect> frame_damage;
+  };
+
   SurfaceFrame(sk_sp<SkSurface> surface,
                bool supports_readback,
                const SubmitCallback& submit_callback);
@@ -36,15 +58,36 @@ class SurfaceFrame {
 
   bool IsSubmitted() const;
 
+  // The canvas of the surface, unless another canvas was set with
+  // |set_canvas|.
   SkCanvas* SkiaCanvas();
 
   sk_sp<SkSurface> SkiaSurface() const;
 
   bool supports_readback() { return supports_readback_; }
 
+  void set_framebuffer_info(const FramebufferInfo& framebuffer_info) {
+    framebuffer_info_ = framebuffer_info;
+  }
+  const FramebufferInfo& framebuffer_info() const { return framebuffer_info_; }
+
+  // Directs painting to |canvas| instead of the canvas of the surface, for
+  // instance so that the surface can record the frame and rasterize the
+  // recording itself when the frame is submitted. |canvas| must outlive the
+  // frame.
+  void set_canvas(SkCanvas* canvas) { canvas_ = canvas; }
+
+  void set_submit_info(const SubmitInfo& submit_info) {
+    submit_info_ = submit_info;
+  }
+  const SubmitInfo& submit_info() const { return submit_info_; }
+
  private:
   bool submitted_ = false;
+  FramebufferInfo framebuffer_info_;
+  SubmitInfo submit_info_;
   sk_sp<SkSurface> surface_;
+  SkCanvas* canvas_ = nullptr;
   bool supports_readback_;
   SubmitCallback submit_callback_;
   std::unique_ptr<GLContextResult> context_result_;
@@ -11,6 +11,46 @@
 
 namespace fml {
 
+// The number of times a worker looks for tasks again before going idle.
+static constexpr size_t kIdleSpinCount = 16;
+
+struct ConcurrentMessageLoop::TaskInbox::Node {
+  std::atomic<Node*> next{nullptr};
+  fml::closure task;
+};
+
+ConcurrentMessageLoop::TaskInbox::TaskInbox()
+    : head_(new Node()), tail_(head_.load()) {}
+
+ConcurrentMessageLoop::TaskInbox::~TaskInbox() {
+  while (tail_ != nullptr) {
+    Node* next = tail_->next.load();
+    delete tail_;
+    tail_ = next;
+  }
+}
+
+void ConcurrentMessageLoop::TaskInbox::Push(const fml::closure& task) {
+  Node* node = new Node();
+  node->task = task;
+  // Once the exchange is done, the consumer will not move past |previous|
+  // until it is linked to |node|.
+  Node* previous = head_.exchange(node);
+  previous->next.store(node);
+}
+
+fml::closure ConcurrentMessageLoop::TaskInbox::Pop() {
+  Node* next = tail_->next.load();
+  if (next == nullptr) {
+    return nullptr;
+  }
+  fml::closure task;
+  std::swap(task, next->task);
+  delete tail_;
+  tail_ = next;
+  return task;
+}
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
     size_t worker_count) {
   return std::shared_ptr<ConcurrentMessageLoop>{
@@ -19,11 +59,15 @@ std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
 
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  for (size_t i = 0; i < worker_count_; ++i) {
+    queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(
           std::string{"io.flutter.worker." + std::to_string(i + 1)});
-      WorkerMain();
+      WorkerMain(i);
     });
   }
 
@@ -47,80 +91,158 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+void ConcurrentMessageLoop::PostTask(const fml::closure& task,
+                                     ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
-  if (shutdown_) {
+  if (shutdown_.load()) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     task();
     return;
   }
 
-  tasks_.push(task);
-
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  // Tasks posted by a worker are likely to use the same data as the task
+  // that posted them, so keep them on that worker unless another one is idle.
+  size_t queue_index = worker_count_;
+  const auto current_thread_id = std::this_thread::get_id();
+  for (size_t i = 0; i < worker_thread_ids_.size(); ++i) {
+    if (worker_thread_ids_[i] == current_thread_id) {
+      queue_index = i;
+      break;
+    }
+  }
+  if (queue_index == worker_count_) {
+    queue_index = next_queue_index_.fetch_add(1, std::memory_order_relaxed) %
+                  worker_count_;
+  }
 
-  tasks_condition_.notify_one();
+  WorkerQueue& queue = *queues_[queue_index];
+  const size_t priority_index = static_cast<size_t>(priority);
+  // The task is counted after it is pushed so that workers do not spin on
+  // tasks they cannot pop yet.
+  queue.tasks[priority_index].Push(task);
+  ++queue.pending_tasks[priority_index];
+  ++pending_tasks_;
+
+  // A worker about to go idle increments |idle_workers_| before checking
+  // |pending_tasks_|, so either it sees this task or it is woken up here.
+  if (idle_workers_.load() > 0) {
+    WakeIdleWorker();
+  }
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  WorkerQueue& queue = *queues_[worker_index];
+  size_t idle_spins = 0;
   while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return tasks_.size() > 0 || shutdown_ || HasThreadTasksLocked();
-    });
-
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
-
-    if (tasks_.size() != 0) {
-      task = tasks_.front();
-      tasks_.pop();
+    if (queue.has_thread_tasks.load()) {
+      RunThreadTasks(queue);
     }
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+    // Tasks that are still pending on shutdown are dropped.
+    if (shutdown_.load()) {
+      break;
     }
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
-
-    TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
-    // Execute the primary task we woke up for.
-    if (task) {
+    if (fml::closure task = TakeTask(worker_index)) {
+      TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
       task();
+      idle_spins = 0;
+      continue;
     }
 
-    // Execute any thread tasks.
-    for (const auto& thread_task : thread_tasks) {
-      thread_task();
+    // Tasks tend to be posted in bursts. Waiting for a little while before
+    // going idle saves waking this worker up again for the next task. Also
+    // the remaining tasks may be in the queue of a worker that was busy with
+    // it, or the push of the oldest task of a queue may still be completing.
+    if (pending_tasks_.load() > 0 || idle_spins < kIdleSpinCount) {
+      ++idle_spins;
+      std::this_thread::yield();
+      continue;
     }
+    idle_spins = 0;
 
-    if (shutdown_now) {
-      break;
+    std::unique_lock lock(idle_mutex_);
+    ++idle_workers_;
+    idle_condition_.wait(lock, [&]() {
+      return pending_wake_ups_ > 0 || pending_tasks_.load() > 0 ||
+             shutdown_.load() || queue.has_thread_tasks.load();
+    });
+    // Any worker may take the place of the one a poster woke up.
+    if (pending_wake_ups_ > 0) {
+      --pending_wake_ups_;
+    } else {
+      --idle_workers_;
     }
   }
 }
 
+fml::closure ConcurrentMessageLoop::TakeTask(size_t worker_index) {
+  for (size_t priority = 0; priority < kPriorityCount; ++priority) {
+    // Look at the own queue of the worker first.
+    for (size_t i = 0; i < worker_count_; ++i) {
+      WorkerQueue& queue = *queues_[(worker_index + i) % worker_count_];
+      if (queue.pending_tasks[priority].load() <= 0) {
+        continue;
+      }
+
+      // Never wait for another worker, its queue will be looked at again if
+      // there is nothing else to do.
+      std::unique_lock lock(queue.mutex, std::defer_lock);
+      if (i == 0) {
+        lock.lock();
+      } else if (!lock.try_lock()) {
+        continue;
+      }
+
+      if (fml::closure task = queue.tasks[priority].Pop()) {
+        --queue.pending_tasks[priority];
+        --pending_tasks_;
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ConcurrentMessageLoop::RunThreadTasks(WorkerQueue& queue) {
+  std::vector<fml::closure> thread_tasks;
+  {
+    std::scoped_lock lock(queue.mutex);
+    std::swap(thread_tasks, queue.thread_tasks);
+    queue.has_thread_tasks = false;
+  }
+
+  for (const auto& thread_task : thread_tasks) {
+    thread_task();
+  }
+}
+
+void ConcurrentMessageLoop::WakeIdleWorker() {
+  std::unique_lock lock(idle_mutex_);
+  // Another poster may have woken up the last idle worker in the meantime.
+  if (idle_workers_.load() == 0) {
+    return;
+  }
+  --idle_workers_;
+  ++pending_wake_ups_;
+  // Unlock the mutex before notifying the condition variable because that
+  // mutex has to be acquired on the other thread anyway.
+  lock.unlock();
+  idle_condition_.notify_one();
+}
+
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
-  shutdown_ = true;
-  tasks_condition_.notify_all();
+  {
+    std::scoped_lock lock(idle_mutex_);
+    shutdown_ = true;
+  }
+  idle_condition_.notify_all();
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
@@ -128,24 +250,16 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (auto& queue : queues_) {
+    std::scoped_lock lock(queue->mutex);
+    queue->thread_tasks.emplace_back(task);
+    queue->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
-}
-
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
 
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  // Idle workers check |has_thread_tasks| and start waiting while holding the
+  // mutex, so acquiring it here ensures they get notified.
+  { std::scoped_lock lock(idle_mutex_); }
+  idle_condition_.notify_all();
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -154,13 +268,14 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
-void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
+void ConcurrentTaskRunner::PostTask(const fml::closure& task,
+                                    ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTask(task, priority);
     return;
   }
 
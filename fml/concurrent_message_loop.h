@@ -5,10 +5,13 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -17,6 +20,24 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+// Pending tasks of a higher priority are started before any pending task of a
+// lower priority. Tasks of the same priority are started roughly in the order
+// they were posted.
+enum class ConcurrentTaskPriority {
+  // Work somebody is waiting on, such as image decodes.
+  kHigh,
+  kNormal,
+  // Speculative or bulk work, such as warming up caches.
+  kLow,
+};
+
+// Runs tasks on a fixed set of worker threads.
+//
+// Each worker has its own queue of tasks for every priority. Tasks posted from
+// a worker go to the queue of that worker, all other tasks are spread over the
+// workers in turn. Posting does not take a lock, and only wakes a worker if
+// some worker is idle. A worker that runs out of tasks steals tasks from the
+// queues of the other workers before going idle.
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -36,24 +57,78 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  static constexpr size_t kPriorityCount = 3;
+
+  // A multi-producer single-consumer queue. Pushing never blocks, popping
+  // must be serialized by the caller.
+  class TaskInbox {
+   public:
+    TaskInbox();
+
+    ~TaskInbox();
+
+    void Push(const fml::closure& task);
+
+    // Returns an empty closure if the queue is empty, or if the oldest push
+    // has not completed yet.
+    fml::closure Pop();
+
+   private:
+    struct Node;
+
+    // Producers append to |head_|, the consumer pops the node after |tail_|.
+    // |tail_| is a node whose task was already popped.
+    std::atomic<Node*> head_;
+    Node* tail_;
+
+    FML_DISALLOW_COPY_ASSIGN_AND_MOVE(TaskInbox);
+  };
+
+  struct WorkerQueue {
+    // Serializes popping from |tasks| and guards |thread_tasks|. The owning
+    // worker blocks on it, workers stealing from this queue only try it.
+    std::mutex mutex;
+    TaskInbox tasks[kPriorityCount];
+    // The number of tasks pushed to each of |tasks| and not popped yet. Lets
+    // workers skip empty queues without locking them. Tasks are counted after
+    // they are pushed, so this may briefly be negative.
+    std::atomic<ptrdiff_t> pending_tasks[kPriorityCount] = {};
+    std::vector<fml::closure> thread_tasks;
+    std::atomic_bool has_thread_tasks{false};
+  };
+
   size_t worker_count_ = 0;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
   std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::atomic_size_t next_queue_index_{0};
+  // The number of tasks in all |queues_|, excluding thread tasks. May briefly
+  // be negative like |WorkerQueue::pending_tasks|.
+  std::atomic<ptrdiff_t> pending_tasks_{0};
+  // Guards going idle and waking up. |idle_workers_| and |shutdown_| are only
+  // written while holding it.
+  std::mutex idle_mutex_;
+  std::condition_variable idle_condition_;
+  // The number of idle workers that no poster has woken up yet.
+  std::atomic_size_t idle_workers_{0};
+  // The number of idle workers that were woken up by posters, but have not
+  // noticed yet.
+  size_t pending_wake_ups_ = 0;
+  std::atomic_bool shutdown_{false};
 
   ConcurrentMessageLoop(size_t worker_count);
 
-  void WorkerMain();
+  void WorkerMain(size_t worker_index);
+
+  void PostTask(const fml::closure& task, ConcurrentTaskPriority priority);
 
-  void PostTask(const fml::closure& task);
+  // Takes the oldest task of the highest priority from the queue of the given
+  // worker, or steals it from another worker.
+  fml::closure TakeTask(size_t worker_index);
 
-  bool HasThreadTasksLocked() const;
+  void RunThreadTasks(WorkerQueue& queue);
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  void WakeIdleWorker();
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -64,7 +139,9 @@ class ConcurrentTaskRunner {
 
   ~ConcurrentTaskRunner();
 
-  void PostTask(const fml::closure& task);
+  void PostTask(
+      const fml::closure& task,
+      ConcurrentTaskPriority priority = ConcurrentTaskPriority::kNormal);
 
  private:
   friend ConcurrentMessageLoop;
@@ -0,0 +1,191 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+static constexpr size_t kWorkerCount = 4;
+static constexpr size_t kTasksPerIteration = 256;
+
+// Schedules tasks the way ConcurrentMessageLoop did before it had a queue per
+// worker: all workers share one queue guarded by a single mutex and condition
+// variable. Kept as the baseline of the benchmarks below.
+class SingleQueueLoop {
+ public:
+  explicit SingleQueueLoop(size_t worker_count) {
+    for (size_t i = 0; i < worker_count; ++i) {
+      workers_.emplace_back([this]() { WorkerMain(); });
+    }
+  }
+
+  ~SingleQueueLoop() {
+    {
+      std::scoped_lock lock(mutex_);
+      shutdown_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void PostTask(const fml::closure& task,
+                ConcurrentTaskPriority priority =
+                    ConcurrentTaskPriority::kNormal) {
+    std::unique_lock lock(mutex_);
+    tasks_.push(task);
+    lock.unlock();
+    condition_.notify_one();
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::queue<fml::closure> tasks_;
+  bool shutdown_ = false;
+
+  void WorkerMain() {
+    while (true) {
+      std::unique_lock lock(mutex_);
+      condition_.wait(lock, [&]() { return !tasks_.empty() || shutdown_; });
+      if (tasks_.empty()) {
+        return;
+      }
+      fml::closure task = std::move(tasks_.front());
+      tasks_.pop();
+      lock.unlock();
+      task();
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SingleQueueLoop);
+};
+
+class WorkStealingLoop {
+ public:
+  explicit WorkStealingLoop(size_t worker_count)
+      : loop_(ConcurrentMessageLoop::Create(worker_count)),
+        task_runner_(loop_->GetTaskRunner()) {}
+
+  void PostTask(const fml::closure& task,
+                ConcurrentTaskPriority priority =
+                    ConcurrentTaskPriority::kNormal) {
+    task_runner_->PostTask(task, priority);
+  }
+
+ private:
+  std::shared_ptr<ConcurrentMessageLoop> loop_;
+  std::shared_ptr<ConcurrentTaskRunner> task_runner_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(WorkStealingLoop);
+};
+
+static void SpinFor(std::chrono::microseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+// Threads outside of the loop post small tasks and wait for them, as the UI
+// and raster threads of several engines would.
+template <class Loop>
+static void BM_PostFromThreads(benchmark::State& state) {
+  static Loop loop(kWorkerCount);
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTasksPerIteration);
+    for (size_t i = 0; i < kTasksPerIteration; ++i) {
+      loop.PostTask([&latch]() { latch.CountDown(); });
+    }
+    latch.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+BENCHMARK_TEMPLATE(BM_PostFromThreads, SingleQueueLoop)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PostFromThreads, WorkStealingLoop)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// A task on a worker splits its work into many small tasks, as parallel
+// rasterization of tiles does.
+template <class Loop>
+static void BM_FanOutFromWorker(benchmark::State& state) {
+  Loop loop(kWorkerCount);
+
+  while (state.KeepRunning()) {
+    // Also wait for the task posting the others to return, which may hold
+    // the loop alive.
+    CountDownLatch latch(kTasksPerIteration + 1);
+    loop.PostTask([&loop, &latch]() {
+      for (size_t i = 0; i < kTasksPerIteration; ++i) {
+        loop.PostTask([&latch]() {
+          SpinFor(std::chrono::microseconds(1));
+          latch.CountDown();
+        });
+      }
+      latch.CountDown();
+    });
+    latch.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+BENCHMARK_TEMPLATE(BM_FanOutFromWorker, SingleQueueLoop)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FanOutFromWorker, WorkStealingLoop)->UseRealTime();
+
+// Measures how long a high priority task, such as an image decode, takes to
+// start while the workers have a backlog of low priority bulk work.
+template <class Loop>
+static void BM_HighPriorityLatencyWithBacklog(benchmark::State& state) {
+  const size_t kBacklogTasks = kWorkerCount * 16;
+  Loop loop(kWorkerCount);
+
+  while (state.KeepRunning()) {
+    CountDownLatch backlog_done(kBacklogTasks);
+    {
+      ::benchmarking::ScopedPauseTiming pause(state);
+      for (size_t i = 0; i < kBacklogTasks; ++i) {
+        loop.PostTask(
+            [&backlog_done]() {
+              SpinFor(std::chrono::microseconds(100));
+              backlog_done.CountDown();
+            },
+            ConcurrentTaskPriority::kLow);
+      }
+    }
+
+    CountDownLatch started(1);
+    loop.PostTask([&started]() { started.CountDown(); },
+                  ConcurrentTaskPriority::kHigh);
+    started.Wait();
+
+    ::benchmarking::ScopedPauseTiming pause(state);
+    backlog_done.Wait();
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_HighPriorityLatencyWithBacklog, SingleQueueLoop)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HighPriorityLatencyWithBacklog, WorkStealingLoop)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -12,19 +12,85 @@
 
 namespace fml {
 
+namespace {
+
+// The size of the first segment of the entry table. Each following segment
+// is twice the size of the previous one.
+constexpr size_t kFirstEntrySegmentSize = 64;
+
+size_t EntrySegmentSize(size_t segment) {
+  return kFirstEntrySegmentSize << segment;
+}
+
+// Finds the segment of the entry table holding the entry of |queue_id| and
+// the index of the entry within that segment.
+void LocateEntry(TaskQueueId queue_id, size_t& segment, size_t& offset) {
+  const size_t index = static_cast<size_t>(static_cast<int>(queue_id));
+  const size_t scaled = index / kFirstEntrySegmentSize + 1;
+  segment = 0;
+  while ((scaled >> (segment + 1)) != 0) {
+    segment++;
+  }
+  offset = index - kFirstEntrySegmentSize * ((size_t{1} << segment) - 1);
+}
+
+void MoveIncomingTasks(TaskQueueEntry& entry) {
+  while (auto task = entry.inbox.Pop()) {
+    entry.delayed_tasks.push(*task);
+  }
+}
+
+}  // namespace
+
 std::mutex MessageLoopTaskQueues::creation_mutex_;
 
 const size_t TaskQueueId::kUnmerged = ULONG_MAX;
 
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::instance_;
 
-TaskQueueEntry::TaskQueueEntry()
-    : owner_of(_kUnmerged), subsumed_by(_kUnmerged) {
-  wakeable = NULL;
-  task_observers = TaskObservers();
-  delayed_tasks = DelayedTaskQueue();
+struct TaskQueueInbox::Node {
+  std::atomic<Node*> next{nullptr};
+  std::optional<DelayedTask> task;
+};
+
+TaskQueueInbox::TaskQueueInbox() : head_(new Node()), tail_(head_.load()) {}
+
+TaskQueueInbox::~TaskQueueInbox() {
+  while (tail_ != nullptr) {
+    Node* next = tail_->next.load();
+    delete tail_;
+    tail_ = next;
+  }
+}
+
+void TaskQueueInbox::Push(const DelayedTask& task) {
+  Node* node = new Node();
+  node->task.emplace(task);
+  // Once the exchange is done, the consumer will not move past |previous|
+  // until it is linked to |node|.
+  Node* previous = head_.exchange(node);
+  previous->next.store(node);
 }
 
+std::optional<DelayedTask> TaskQueueInbox::Pop() {
+  Node* next = tail_->next.load();
+  if (next == nullptr) {
+    return std::nullopt;
+  }
+  std::optional<DelayedTask> task = std::move(next->task);
+  next->task.reset();
+  delete tail_;
+  tail_ = next;
+  return task;
+}
+
+bool TaskQueueInbox::IsEmpty() const {
+  return head_.load() == tail_;
+}
+
+TaskQueueEntry::TaskQueueEntry()
+    : wakeable(nullptr), owner_of(_kUnmerged), subsumed_by(_kUnmerged) {}
+
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
   std::scoped_lock creation(creation_mutex_);
   if (!instance_) {
@@ -34,57 +100,114 @@ fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
+  std::lock_guard guard(registry_mutex_);
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
   ++task_queue_id_counter_;
-  queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>();
+  size_t segment, offset;
+  LocateEntry(loop_id, segment, offset);
+  FML_CHECK(segment < kMaxEntrySegments) << "Too many task queues.";
+  EntrySlot* slots = entry_segments_[segment].load();
+  if (slots == nullptr) {
+    slots = new EntrySlot[EntrySegmentSize(segment)]();
+    entry_segments_[segment].store(slots);
+  }
+  slots[offset].store(new TaskQueueEntry());
   return loop_id;
 }
 
 MessageLoopTaskQueues::MessageLoopTaskQueues()
-    : task_queue_id_counter_(0), order_(0) {}
+    : task_queue_id_counter_(0), order_(0) {
+  for (auto& segment : entry_segments_) {
+    segment.store(nullptr);
+  }
+}
 
-MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
+MessageLoopTaskQueues::~MessageLoopTaskQueues() {
+  for (size_t segment = 0; segment < kMaxEntrySegments; segment++) {
+    EntrySlot* slots = entry_segments_[segment].load();
+    if (slots == nullptr) {
+      continue;
+    }
+    for (size_t i = 0; i < EntrySegmentSize(segment); i++) {
+      delete slots[i].load();
+    }
+    delete[] slots;
+  }
+}
+
+TaskQueueEntry* MessageLoopTaskQueues::GetEntry(TaskQueueId queue_id) const {
+  size_t segment, offset;
+  LocateEntry(queue_id, segment, offset);
+  FML_DCHECK(segment < kMaxEntrySegments);
+  EntrySlot* slots = entry_segments_[segment].load();
+  TaskQueueEntry* entry = slots ? slots[offset].load() : nullptr;
+  FML_DCHECK(entry != nullptr) << "Unknown task queue.";
+  return entry;
+}
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
-  TaskQueueId subsumed = queue_entry->owner_of;
-  queue_entries_.erase(queue_id);
-  if (subsumed != _kUnmerged) {
-    queue_entries_.erase(subsumed);
+  std::lock_guard guard(registry_mutex_);
+  TaskQueueId subsumed = _kUnmerged;
+  {
+    TaskQueueEntry* entry = GetEntry(queue_id);
+    std::lock_guard entry_guard(entry->mutex);
+    FML_DCHECK(entry->subsumed_by.load() == _kUnmerged);
+    subsumed = entry->owner_of;
+  }
+  // Tasks may no longer be registered for disposed queues, so nothing else
+  // can be using these entries.
+  for (auto disposed : {queue_id, subsumed}) {
+    if (disposed == _kUnmerged) {
+      continue;
+    }
+    size_t segment, offset;
+    LocateEntry(disposed, segment, offset);
+    delete entry_segments_[segment].load()[offset].exchange(nullptr);
   }
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
+  QueueLocks locks = LockQueues(queue_id);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  FML_DCHECK(queue_entry->subsumed_by.load() == _kUnmerged);
   TaskQueueId subsumed = queue_entry->owner_of;
+  MoveIncomingTasksUnlocked(queue_id);
   queue_entry->delayed_tasks = {};
   if (subsumed != _kUnmerged) {
-    queue_entries_.at(subsumed)->delayed_tasks = {};
+    GetEntry(subsumed)->delayed_tasks = {};
   }
 }
 
 void MessageLoopTaskQueues::RegisterTask(TaskQueueId queue_id,
                                          const fml::closure& task,
                                          fml::TimePoint target_time) {
-  std::lock_guard guard(queue_mutex_);
-  size_t order = order_++;
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->delayed_tasks.push({order, task, target_time});
-  TaskQueueId loop_to_wake = queue_id;
-  if (queue_entry->subsumed_by != _kUnmerged) {
-    loop_to_wake = queue_entry->subsumed_by;
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  DelayedTask delayed_task(order_++, task, target_time);
+
+  if (target_time <= fml::TimePoint::Now()) {
+    // The loop only needs to run as soon as possible, which does not depend on
+    // the other pending tasks. If the queue is merged concurrently, either
+    // this reads the new owner or the merge sees this task.
+    queue_entry->inbox.Push(delayed_task);
+    TaskQueueId loop_to_wake = queue_entry->subsumed_by.load();
+    if (loop_to_wake == _kUnmerged) {
+      loop_to_wake = queue_id;
+    }
+    WakeUpUnlocked(loop_to_wake, target_time);
+    return;
   }
-  WakeUpUnlocked(loop_to_wake,
-                 queue_entry->delayed_tasks.top().GetTargetTime());
+
+  // Tasks that are not due yet must not postpone the wake up for the tasks
+  // that are pending already.
+  TaskQueueId loop_to_wake = _kUnmerged;
+  QueueLocks locks = LockServicingQueues(queue_id, loop_to_wake);
+  queue_entry->delayed_tasks.push(delayed_task);
+  ScheduleWakeUpUnlocked(loop_to_wake);
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  QueueLocks locks = LockQueues(queue_id);
+  MoveIncomingTasksUnlocked(queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
@@ -92,7 +215,8 @@ void MessageLoopTaskQueues::GetTasksToRunNow(
     TaskQueueId queue_id,
     FlushType type,
     std::vector<fml::closure>& invocations) {
-  std::lock_guard guard(queue_mutex_);
+  QueueLocks locks = LockQueues(queue_id);
+  MoveIncomingTasksUnlocked(queue_id);
   if (!HasPendingTasksUnlocked(queue_id)) {
     return;
   }
@@ -106,40 +230,72 @@ void MessageLoopTaskQueues::GetTasksToRunNow(
       break;
     }
     invocations.emplace_back(top.GetTask());
-    queue_entries_.at(top_queue)->delayed_tasks.pop();
+    GetEntry(top_queue)->delayed_tasks.pop();
     if (type == FlushType::kSingle) {
       break;
     }
   }
 
-  if (!HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, fml::TimePoint::Max());
-  } else {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
-  }
+  ScheduleWakeUpUnlocked(queue_id);
 }
 
 void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
                                            fml::TimePoint time) const {
-  if (queue_entries_.at(queue_id)->wakeable) {
-    queue_entries_.at(queue_id)->wakeable->WakeUp(time);
+  Wakeable* wakeable = GetEntry(queue_id)->wakeable.load();
+  if (wakeable) {
+    wakeable->WakeUp(time);
+  }
+}
+
+void MessageLoopTaskQueues::ScheduleWakeUpUnlocked(TaskQueueId queue_id) const {
+  MoveIncomingTasksUnlocked(queue_id);
+  const fml::TimePoint wake_time = HasPendingTasksUnlocked(queue_id)
+                                       ? GetNextWakeTimeUnlocked(queue_id)
+                                       : fml::TimePoint::Max();
+  WakeUpUnlocked(queue_id, wake_time);
+
+  // A task registered without locking since the inboxes were emptied may have
+  // woken the loop up before the call above rescheduled it. Make sure that
+  // task does not have to wait.
+  const fml::TimePoint now = fml::TimePoint::Now();
+  if (wake_time > now && HasIncomingTasksUnlocked(queue_id)) {
+    WakeUpUnlocked(queue_id, now);
+  }
+}
+
+void MessageLoopTaskQueues::MoveIncomingTasksUnlocked(
+    TaskQueueId queue_id) const {
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  MoveIncomingTasks(*entry);
+  if (entry->owner_of != _kUnmerged) {
+    MoveIncomingTasks(*GetEntry(entry->owner_of));
+  }
+}
+
+bool MessageLoopTaskQueues::HasIncomingTasksUnlocked(
+    TaskQueueId queue_id) const {
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  if (!entry->inbox.IsEmpty()) {
+    return true;
   }
+  return entry->owner_of != _kUnmerged &&
+         !GetEntry(entry->owner_of)->inbox.IsEmpty();
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  if (queue_entry->subsumed_by != _kUnmerged) {
+  QueueLocks locks = LockQueues(queue_id);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  if (queue_entry->subsumed_by.load() != _kUnmerged) {
     return 0;
   }
+  MoveIncomingTasksUnlocked(queue_id);
 
   size_t total_tasks = 0;
   total_tasks += queue_entry->delayed_tasks.size();
 
   TaskQueueId subsumed = queue_entry->owner_of;
   if (subsumed != _kUnmerged) {
-    const auto& subsumed_entry = queue_entries_.at(subsumed);
-    total_tasks += subsumed_entry->delayed_tasks.size();
+    total_tasks += GetEntry(subsumed)->delayed_tasks.size();
   }
   return total_tasks;
 }
@@ -147,33 +303,36 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  std::lock_guard guard(queue_entry->mutex);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
-  queue_entries_.at(queue_id)->task_observers[key] = callback;
+  queue_entry->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_observers.erase(key);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  std::lock_guard guard(queue_entry->mutex);
+  queue_entry->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  QueueLocks locks = LockQueues(queue_id);
   std::vector<fml::closure> observers;
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
 
-  if (queue_entries_.at(queue_id)->subsumed_by != _kUnmerged) {
+  if (queue_entry->subsumed_by.load() != _kUnmerged) {
     return observers;
   }
 
-  for (const auto& observer : queue_entries_.at(queue_id)->task_observers) {
+  for (const auto& observer : queue_entry->task_observers) {
     observers.push_back(observer.second);
   }
 
-  TaskQueueId subsumed = queue_entries_.at(queue_id)->owner_of;
+  TaskQueueId subsumed = queue_entry->owner_of;
   if (subsumed != _kUnmerged) {
-    for (const auto& observer : queue_entries_.at(subsumed)->task_observers) {
+    for (const auto& observer : GetEntry(subsumed)->task_observers) {
       observers.push_back(observer.second);
     }
   }
@@ -183,27 +342,27 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  std::lock_guard guard(queue_entry->mutex);
+  FML_CHECK(!queue_entry->wakeable.load()) << "Wakeable can only be set once.";
+  queue_entry->wakeable.store(wakeable);
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
-  auto& owner_entry = queue_entries_.at(owner);
-  auto& subsumed_entry = queue_entries_.at(subsumed);
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
+  std::scoped_lock lock(owner_entry->mutex, subsumed_entry->mutex);
 
   if (owner_entry->owner_of == subsumed) {
     return true;
   }
 
   std::vector<TaskQueueId> owner_subsumed_keys = {
-      owner_entry->owner_of, owner_entry->subsumed_by, subsumed_entry->owner_of,
-      subsumed_entry->subsumed_by};
+      owner_entry->owner_of, owner_entry->subsumed_by.load(),
+      subsumed_entry->owner_of, subsumed_entry->subsumed_by.load()};
 
   for (auto key : owner_subsumed_keys) {
     if (key != _kUnmerged) {
@@ -212,32 +371,37 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   }
 
   owner_entry->owner_of = subsumed;
-  subsumed_entry->subsumed_by = owner;
+  subsumed_entry->subsumed_by.store(owner);
 
+  MoveIncomingTasksUnlocked(owner);
   if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
+    ScheduleWakeUpUnlocked(owner);
   }
 
   return true;
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& owner_entry = queue_entries_.at(owner);
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  std::unique_lock owner_lock(owner_entry->mutex);
   const TaskQueueId subsumed = owner_entry->owner_of;
   if (subsumed == _kUnmerged) {
     return false;
   }
+  TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
+  std::unique_lock subsumed_lock(subsumed_entry->mutex);
 
-  queue_entries_.at(subsumed)->subsumed_by = _kUnmerged;
+  subsumed_entry->subsumed_by.store(_kUnmerged);
   owner_entry->owner_of = _kUnmerged;
 
+  MoveIncomingTasksUnlocked(owner);
   if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
+    ScheduleWakeUpUnlocked(owner);
   }
 
+  MoveIncomingTasksUnlocked(subsumed);
   if (HasPendingTasksUnlocked(subsumed)) {
-    WakeUpUnlocked(subsumed, GetNextWakeTimeUnlocked(subsumed));
+    ScheduleWakeUpUnlocked(subsumed);
   }
 
   return true;
@@ -245,16 +409,51 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
-  return subsumed == queue_entries_.at(owner)->owner_of || owner == subsumed;
+  if (owner == subsumed) {
+    return true;
+  }
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  std::lock_guard guard(owner_entry->mutex);
+  return subsumed == owner_entry->owner_of;
+}
+
+MessageLoopTaskQueues::QueueLocks MessageLoopTaskQueues::LockQueues(
+    TaskQueueId queue_id) const {
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  QueueLocks locks;
+  locks.lock = std::unique_lock(entry->mutex);
+  // The queue a queue owns can only change while holding the locks of both.
+  if (entry->owner_of != _kUnmerged) {
+    locks.owned_lock = std::unique_lock(GetEntry(entry->owner_of)->mutex);
+  }
+  return locks;
+}
+
+MessageLoopTaskQueues::QueueLocks MessageLoopTaskQueues::LockServicingQueues(
+    TaskQueueId queue_id,
+    TaskQueueId& owner) const {
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  while (true) {
+    owner = entry->subsumed_by.load();
+    if (owner == _kUnmerged) {
+      owner = queue_id;
+    }
+    QueueLocks locks = LockQueues(owner);
+    // The queues may have been merged or unmerged before the locks were
+    // acquired.
+    const TaskQueueId expected_owner = owner == queue_id ? _kUnmerged : owner;
+    if (entry->subsumed_by.load() == expected_owner) {
+      return locks;
+    }
+  }
 }
 
 // Subsumed queues will never have pending tasks.
 // Owning queues will consider both their and their subsumed tasks.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     TaskQueueId queue_id) const {
-  const auto& entry = queue_entries_.at(queue_id);
-  bool is_subsumed = entry->subsumed_by != _kUnmerged;
+  const TaskQueueEntry* entry = GetEntry(queue_id);
+  bool is_subsumed = entry->subsumed_by.load() != _kUnmerged;
   if (is_subsumed) {
     return false;
   }
@@ -268,7 +467,7 @@ bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     // this is not an owner and queue is empty.
     return false;
   } else {
-    return !queue_entries_.at(subsumed)->delayed_tasks.empty();
+    return !GetEntry(subsumed)->delayed_tasks.empty();
   }
 }
 
@@ -282,7 +481,7 @@ const DelayedTask& MessageLoopTaskQueues::PeekNextTaskUnlocked(
     TaskQueueId owner,
     TaskQueueId& top_queue_id) const {
   FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const auto& entry = queue_entries_.at(owner);
+  const TaskQueueEntry* entry = GetEntry(owner);
   const TaskQueueId subsumed = entry->owner_of;
   if (subsumed == _kUnmerged) {
     top_queue_id = owner;
@@ -290,7 +489,7 @@ const DelayedTask& MessageLoopTaskQueues::PeekNextTaskUnlocked(
   }
 
   const auto& owner_tasks = entry->delayed_tasks;
-  const auto& subsumed_tasks = queue_entries_.at(subsumed)->delayed_tasks;
+  const auto& subsumed_tasks = GetEntry(subsumed)->delayed_tasks;
 
   // we are owning another task queue
   const bool subsumed_has_task = !subsumed_tasks.empty();
@@ -308,7 +507,7 @@ const DelayedTask& MessageLoopTaskQueues::PeekNextTaskUnlocked(
   } else {
     top_queue_id = subsumed;
   }
-  return queue_entries_.at(top_queue_id)->delayed_tasks.top();
+  return GetEntry(top_queue_id)->delayed_tasks.top();
 }
 
 }  // namespace fml
@@ -5,8 +5,10 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 #include "flutter/fml/closure.h"
@@ -32,13 +34,50 @@ class TaskQueueId {
 
 static const TaskQueueId _kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 
+// A multi-producer single-consumer queue of tasks. Any thread may push tasks
+// without taking a lock. Popping tasks requires holding the mutex of the
+// |TaskQueueEntry| the queue belongs to.
+class TaskQueueInbox {
+ public:
+  TaskQueueInbox();
+
+  ~TaskQueueInbox();
+
+  void Push(const DelayedTask& task);
+
+  // Returns std::nullopt if the queue is empty, or if the oldest push has not
+  // completed yet.
+  std::optional<DelayedTask> Pop();
+
+  // Returns false as soon as a push has started.
+  bool IsEmpty() const;
+
+ private:
+  struct Node;
+
+  // Producers append to |head_|, the consumer pops the node after |tail_|.
+  // |tail_| is a node whose task was already popped.
+  std::atomic<Node*> head_;
+  Node* tail_;
+
+  FML_DISALLOW_COPY_ASSIGN_AND_MOVE(TaskQueueInbox);
+};
+
 // This is keyed by the |TaskQueueId| and contains all the queue
 // components that make up a single TaskQueue.
 class TaskQueueEntry {
  public:
   using TaskObservers = std::map<intptr_t, fml::closure>;
-  Wakeable* wakeable;
+
+  // Guards all the other members, except that |wakeable|, |subsumed_by| and
+  // the producer side of |inbox| may be used without it. |subsumed_by| is
+  // only written while holding the mutexes of both of the merged queues.
+  std::mutex mutex;
+  std::atomic<Wakeable*> wakeable;
   TaskObservers task_observers;
+  // Tasks that were due when they were registered. These are moved to
+  // |delayed_tasks| by whoever holds |mutex| before looking at pending tasks.
+  TaskQueueInbox inbox;
   DelayedTaskQueue delayed_tasks;
 
   // Note: Both of these can be _kUnmerged, which indicates that
@@ -46,7 +85,7 @@ class TaskQueueEntry {
   // of these will be _kUnmerged, if owner_of is _kUnmerged, it means
   // that the queue has been subsumed or else it owns another queue.
   TaskQueueId owner_of;
-  TaskQueueId subsumed_by;
+  std::atomic<TaskQueueId> subsumed_by;
 
   TaskQueueEntry();
 
@@ -62,6 +101,10 @@ enum class FlushType {
 // This class keeps track of all the tasks and observers that
 // need to be run on it's MessageLoopImpl. This also wakes up the
 // loop at the required times.
+//
+// Registering a task that is already due takes no lock. It is pushed to the
+// inbox of its queue and the loop servicing the queue is woken up. All other
+// operations only lock the queues they concern, never all of them.
 class MessageLoopTaskQueues
     : public fml::RefCountedThreadSafe<MessageLoopTaskQueues> {
  public:
@@ -127,12 +170,44 @@ class MessageLoopTaskQueues
  private:
   class MergedQueuesRunner;
 
+  // The locks of a queue and of the queue it owns, if any.
+  struct QueueLocks {
+    std::unique_lock<std::mutex> lock;
+    std::unique_lock<std::mutex> owned_lock;
+  };
+
+  using EntrySlot = std::atomic<TaskQueueEntry*>;
+
+  // Entries are stored in segments whose sizes double, so that the table can
+  // grow without moving entries or locking out lookups.
+  static constexpr size_t kMaxEntrySegments = 32;
+
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
+  TaskQueueEntry* GetEntry(TaskQueueId queue_id) const;
+
+  // Locks |queue_id| and the queue it owns, if any. While these are held,
+  // whether |queue_id| is merged cannot change.
+  QueueLocks LockQueues(TaskQueueId queue_id) const;
+
+  // Locks the queue whose loop runs the tasks of |queue_id|, which is either
+  // |queue_id| itself or the queue that subsumed it, and returns its id in
+  // |owner|.
+  QueueLocks LockServicingQueues(TaskQueueId queue_id,
+                                 TaskQueueId& owner) const;
+
   void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
 
+  // Wakes up the loop of |queue_id| when its next pending task is due, or
+  // never if there is none.
+  void ScheduleWakeUpUnlocked(TaskQueueId queue_id) const;
+
+  void MoveIncomingTasksUnlocked(TaskQueueId queue_id) const;
+
+  bool HasIncomingTasksUnlocked(TaskQueueId queue_id) const;
+
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
 
   const DelayedTask& PeekNextTaskUnlocked(TaskQueueId owner,
@@ -143,12 +218,14 @@ class MessageLoopTaskQueues
   static std::mutex creation_mutex_;
   static fml::RefPtr<MessageLoopTaskQueues> instance_;
 
-  mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
+  // Guards the creation and disposal of queues. Looking up entries does not
+  // need it.
+  std::mutex registry_mutex_;
+  std::atomic<EntrySlot*> entry_segments_[kMaxEntrySegments];
 
   size_t task_queue_id_counter_;
 
-  std::atomic_int order_;
+  std::atomic_size_t order_;
 
   FML_FRIEND_MAKE_REF_COUNTED(MessageLoopTaskQueues);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(MessageLoopTaskQueues);
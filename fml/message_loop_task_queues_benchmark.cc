@@ -57,5 +57,86 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+static constexpr int kTasksBetweenFlushes = 1000;
+
+// Each thread registers tasks on a queue of its own, as the task runners of
+// several engines in a process would.
+static void BM_RegisterTaskOnSeparateQueues(benchmark::State& state) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const auto queue_id = task_queues->CreateTaskQueue();
+  const fml::TimePoint past = fml::TimePoint::Now();
+  std::vector<fml::closure> invocations;
+  int registered = 0;
+
+  while (state.KeepRunning()) {
+    task_queues->RegisterTask(
+        queue_id, [] {}, past);
+    if (++registered % kTasksBetweenFlushes == 0) {
+      task_queues->GetTasksToRunNow(queue_id, fml::FlushType::kAll,
+                                    invocations);
+      invocations.clear();
+    }
+  }
+
+  task_queues->Dispose(queue_id);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RegisterTaskOnSeparateQueues)->ThreadRange(1, 8)->UseRealTime();
+
+// All threads register tasks on the same queue, which the first thread also
+// runs the tasks of, as with platform channel messages sent to a single
+// engine from many threads.
+static void BM_RegisterTaskOnSharedQueue(benchmark::State& state) {
+  static fml::TaskQueueId shared_queue_id = fml::_kUnmerged;
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  if (state.thread_index == 0) {
+    shared_queue_id = task_queues->CreateTaskQueue();
+  }
+  const fml::TimePoint past = fml::TimePoint::Now();
+  std::vector<fml::closure> invocations;
+  int registered = 0;
+
+  while (state.KeepRunning()) {
+    task_queues->RegisterTask(
+        shared_queue_id, [] {}, past);
+    if (state.thread_index == 0 && ++registered % kTasksBetweenFlushes == 0) {
+      task_queues->GetTasksToRunNow(shared_queue_id, fml::FlushType::kAll,
+                                    invocations);
+      invocations.clear();
+    }
+  }
+
+  if (state.thread_index == 0) {
+    task_queues->Dispose(shared_queue_id);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RegisterTaskOnSharedQueue)->ThreadRange(1, 8)->UseRealTime();
+
+// Registers delayed tasks, which unlike tasks that are due right away need
+// the lock of their queue to reschedule its loop.
+static void BM_RegisterDelayedTask(benchmark::State& state) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const auto queue_id = task_queues->CreateTaskQueue();
+  const fml::TimePoint future =
+      fml::TimePoint::Now() + fml::TimeDelta::FromSeconds(3600);
+  int registered = 0;
+
+  while (state.KeepRunning()) {
+    task_queues->RegisterTask(
+        queue_id, [] {}, future);
+    if (++registered % kTasksBetweenFlushes == 0) {
+      ::benchmarking::ScopedPauseTiming pause(state);
+      task_queues->DisposeTasks(queue_id);
+    }
+  }
+
+  task_queues->Dispose(queue_id);
+}
+
+BENCHMARK(BM_RegisterDelayedTask);
+
 }  // namespace benchmarking
 }  // namespace fml
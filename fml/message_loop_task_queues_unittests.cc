@@ -81,6 +81,69 @@ TEST(MessageLoopTaskQueue, PreserveTaskOrdering) {
   }
 }
 
+TEST(MessageLoopTaskQueue, PreserveTaskOrderingOfEachThread) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  const int num_threads = 4;
+  const int num_tasks_per_thread = 1000;
+  std::vector<int> last_run(num_threads, -1);
+  bool in_order = true;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, thread = i]() {
+      for (int j = 0; j < num_tasks_per_thread; j++) {
+        task_queue->RegisterTask(
+            queue_id,
+            [&, thread, j]() {
+              in_order &= last_run[thread] == j - 1;
+              last_run[thread] = j;
+            },
+            fml::TimePoint::Now());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(task_queue->GetNumPendingTasks(queue_id),
+            static_cast<size_t>(num_threads * num_tasks_per_thread));
+  std::vector<fml::closure> invocations;
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  ASSERT_EQ(invocations.size(),
+            static_cast<size_t>(num_threads * num_tasks_per_thread));
+  for (auto& invocation : invocations) {
+    invocation();
+  }
+  ASSERT_TRUE(in_order);
+  ASSERT_FALSE(task_queue->HasPendingTasks(queue_id));
+}
+
+TEST(MessageLoopTaskQueue, DelayedTaskDoesNotPostponePendingTasks) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  fml::TimePoint last_wake_time;
+  task_queue->SetWakeable(queue_id,
+                          new TestWakeable([&](fml::TimePoint wake_time) {
+                            last_wake_time = wake_time;
+                          }));
+
+  const auto now = fml::TimePoint::Now();
+  task_queue->RegisterTask(
+      queue_id, [] {}, now);
+  ASSERT_TRUE(last_wake_time == now);
+
+  task_queue->RegisterTask(
+      queue_id, [] {}, fml::TimePoint::Max());
+  ASSERT_TRUE(last_wake_time == now);
+
+  std::vector<fml::closure> invocations;
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  ASSERT_EQ(invocations.size(), 1u);
+  ASSERT_TRUE(last_wake_time == fml::TimePoint::Max());
+}
+
 void TestNotifyObservers(fml::TaskQueueId queue_id) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
   std::vector<fml::closure> observers =
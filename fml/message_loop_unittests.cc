@@ -5,7 +5,9 @@
 #define FML_USED_ON_EMBEDDER
 
 #include <iostream>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/concurrent_message_loop.h"
@@ -315,3 +317,80 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsHigherPriorityTasksFirst) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+
+  // Keep the only worker busy until all the tasks have been posted.
+  fml::AutoResetWaitableEvent started;
+  fml::AutoResetWaitableEvent release;
+  task_runner->PostTask([&]() {
+    started.Signal();
+    release.Wait();
+  });
+  started.Wait();
+
+  std::vector<int> order;
+  fml::CountDownLatch latch(3);
+  task_runner->PostTask(
+      [&]() {
+        order.push_back(3);
+        latch.CountDown();
+      },
+      fml::ConcurrentTaskPriority::kLow);
+  task_runner->PostTask([&]() {
+    order.push_back(2);
+    latch.CountDown();
+  });
+  task_runner->PostTask(
+      [&]() {
+        order.push_back(1);
+        latch.CountDown();
+      },
+      fml::ConcurrentTaskPriority::kHigh);
+
+  release.Signal();
+  latch.Wait();
+  ASSERT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopIdleWorkersStealTasks) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+
+  // Tasks posted by a worker are queued on that worker. This one can only
+  // run if the other worker steals it.
+  fml::AutoResetWaitableEvent stolen;
+  fml::AutoResetWaitableEvent done;
+  std::thread::id posting_thread_id;
+  std::thread::id stealing_thread_id;
+  task_runner->PostTask([&]() {
+    posting_thread_id = std::this_thread::get_id();
+    task_runner->PostTask([&]() {
+      stealing_thread_id = std::this_thread::get_id();
+      stolen.Signal();
+    });
+    stolen.Wait();
+    done.Signal();
+  });
+  done.Wait();
+  ASSERT_NE(posting_thread_id, stealing_thread_id);
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsThreadTasksOnEachWorker) {
+  const size_t kWorkerCount = 4;
+  auto loop = fml::ConcurrentMessageLoop::Create(kWorkerCount);
+  fml::CountDownLatch latch(kWorkerCount);
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    {
+      std::scoped_lock lock(thread_ids_mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    }
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), kWorkerCount);
+}
@@ -84,7 +84,7 @@ void SceneBuilder::RegisterNatives(tonic::DartLibraryNatives* natives) {
 SceneBuilder::SceneBuilder() {
   // Add a ContainerLayer as the root layer, so that AddLayer operations are
   // always valid.
-  PushLayer(std::make_shared<flutter::ContainerLayer>());
+  PushLayer(arena_.Make<flutter::ContainerLayer>());
 }
 
 SceneBuilder::~SceneBuilder() = default;
@@ -92,7 +92,7 @@ SceneBuilder::~SceneBuilder() = default;
 void SceneBuilder::pushTransform(Dart_Handle layer_handle,
                                  tonic::Float64List& matrix4) {
   SkMatrix sk_matrix = ToSkMatrix(matrix4);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
+  auto layer = arena_.Make<flutter::TransformLayer>(sk_matrix);
   PushLayer(layer);
   // matrix4 has to be released before we can return another Dart object
   matrix4.Release();
@@ -101,7 +101,7 @@ void SceneBuilder::pushTransform(Dart_Handle layer_handle,
 
 void SceneBuilder::pushOffset(Dart_Handle layer_handle, double dx, double dy) {
   SkMatrix sk_matrix = SkMatrix::Translate(dx, dy);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
+  auto layer = arena_.Make<flutter::TransformLayer>(sk_matrix);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -114,8 +114,7 @@ void SceneBuilder::pushClipRect(Dart_Handle layer_handle,
                                 int clipBehavior) {
   SkRect clipRect = SkRect::MakeLTRB(left, top, right, bottom);
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
-  auto layer =
-      std::make_shared<flutter::ClipRectLayer>(clipRect, clip_behavior);
+  auto layer = arena_.Make<flutter::ClipRectLayer>(clipRect, clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -125,7 +124,7 @@ void SceneBuilder::pushClipRRect(Dart_Handle layer_handle,
                                  int clipBehavior) {
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   auto layer =
-      std::make_shared<flutter::ClipRRectLayer>(rrect.sk_rrect, clip_behavior);
+      arena_.Make<flutter::ClipRRectLayer>(rrect.sk_rrect, clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -135,8 +134,7 @@ void SceneBuilder::pushClipPath(Dart_Handle layer_handle,
                                 int clipBehavior) {
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   FML_DCHECK(clip_behavior != flutter::Clip::none);
-  auto layer =
-      std::make_shared<flutter::ClipPathLayer>(path->path(), clip_behavior);
+  auto layer = arena_.Make<flutter::ClipPathLayer>(path->path(), clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -145,31 +143,28 @@ void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
                                int alpha,
                                double dx,
                                double dy) {
-  auto layer =
-      std::make_shared<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
+  auto layer = arena_.Make<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
 
 void SceneBuilder::pushColorFilter(Dart_Handle layer_handle,
                                    const ColorFilter* color_filter) {
-  auto layer =
-      std::make_shared<flutter::ColorFilterLayer>(color_filter->filter());
+  auto layer = arena_.Make<flutter::ColorFilterLayer>(color_filter->filter());
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
 
 void SceneBuilder::pushImageFilter(Dart_Handle layer_handle,
                                    const ImageFilter* image_filter) {
-  auto layer =
-      std::make_shared<flutter::ImageFilterLayer>(image_filter->filter());
+  auto layer = arena_.Make<flutter::ImageFilterLayer>(image_filter->filter());
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
 
 void SceneBuilder::pushBackdropFilter(Dart_Handle layer_handle,
                                       ImageFilter* filter) {
-  auto layer = std::make_shared<flutter::BackdropFilterLayer>(filter->filter());
+  auto layer = arena_.Make<flutter::BackdropFilterLayer>(filter->filter());
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -183,7 +178,7 @@ void SceneBuilder::pushShaderMask(Dart_Handle layer_handle,
                                   int blendMode) {
   SkRect rect = SkRect::MakeLTRB(maskRectLeft, maskRectTop, maskRectRight,
                                  maskRectBottom);
-  auto layer = std::make_shared<flutter::ShaderMaskLayer>(
+  auto layer = arena_.Make<flutter::ShaderMaskLayer>(
       shader->shader(), rect, static_cast<SkBlendMode>(blendMode));
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
@@ -195,7 +190,7 @@ void SceneBuilder::pushPhysicalShape(Dart_Handle layer_handle,
                                      int color,
                                      int shadow_color,
                                      int clipBehavior) {
-  auto layer = std::make_shared<flutter::PhysicalShapeLayer>(
+  auto layer = arena_.Make<flutter::PhysicalShapeLayer>(
       static_cast<SkColor>(color), static_cast<SkColor>(shadow_color),
       static_cast<float>(elevation), path->path(),
       static_cast<flutter::Clip>(clipBehavior));
@@ -218,7 +213,7 @@ void SceneBuilder::addPicture(double dx,
   SkPoint offset = SkPoint::Make(dx, dy);
   SkRect pictureRect = picture->picture()->cullRect();
   pictureRect.offset(offset.x(), offset.y());
-  auto layer = std::make_unique<flutter::PictureLayer>(
+  auto layer = arena_.Make<flutter::PictureLayer>(
       offset, UIDartState::CreateGPUObject(picture->picture()), !!(hints & 1),
       !!(hints & 2));
   AddLayer(std::move(layer));
@@ -231,7 +226,7 @@ void SceneBuilder::addTexture(double dx,
                               int64_t textureId,
                               bool freeze,
                               int filterQuality) {
-  auto layer = std::make_unique<flutter::TextureLayer>(
+  auto layer = arena_.Make<flutter::TextureLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), textureId, freeze,
       static_cast<SkFilterQuality>(filterQuality));
   AddLayer(std::move(layer));
@@ -242,7 +237,7 @@ void SceneBuilder::addPlatformView(double dx,
                                    double width,
                                    double height,
                                    int64_t viewId) {
-  auto layer = std::make_unique<flutter::PlatformViewLayer>(
+  auto layer = arena_.Make<flutter::PlatformViewLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), viewId);
   AddLayer(std::move(layer));
 }
@@ -254,7 +249,7 @@ void SceneBuilder::addChildScene(double dx,
                                  double height,
                                  SceneHost* sceneHost,
                                  bool hitTestable) {
-  auto layer = std::make_unique<flutter::ChildSceneLayer>(
+  auto layer = arena_.Make<flutter::ChildSceneLayer>(
       sceneHost->id(), SkPoint::Make(dx, dy), SkSize::Make(width, height),
       hitTestable);
   AddLayer(std::move(layer));
@@ -267,8 +262,7 @@ void SceneBuilder::addPerformanceOverlay(uint64_t enabledOptions,
                                          double top,
                                          double bottom) {
   SkRect rect = SkRect::MakeLTRB(left, top, right, bottom);
-  auto layer =
-      std::make_unique<flutter::PerformanceOverlayLayer>(enabledOptions);
+  auto layer = arena_.Make<flutter::PerformanceOverlayLayer>(enabledOptions);
   layer->set_paint_bounds(rect);
   AddLayer(std::move(layer));
 }
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_arena.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/color_filter.h"
@@ -125,6 +126,9 @@ class SceneBuilder : public RefCountedDartWrappable<SceneBuilder> {
   void PushLayer(std::shared_ptr<ContainerLayer> layer);
   void PopLayer();
 
+  // Holds the layers built for this scene in the order they are built, which
+  // is the order they are prerolled and painted in.
+  LayerArena arena_;
   std::vector<std::shared_ptr<ContainerLayer>> layer_stack_;
   int rasterizer_tracing_threshold_ = 0;
   bool checkerboard_raster_cache_images_ = false;
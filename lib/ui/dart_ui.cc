@@ -18,6 +18,7 @@
 #include "flutter/lib/ui/painting/image.h"
 #include "flutter/lib/ui/painting/image_filter.h"
 #include "flutter/lib/ui/painting/image_shader.h"
+#include "flutter/lib/ui/painting/incremental_image_decoder.h"
 #include "flutter/lib/ui/painting/path.h"
 #include "flutter/lib/ui/painting/path_measure.h"
 #include "flutter/lib/ui/painting/picture.h"
@@ -71,6 +72,7 @@ void DartUI::InitForGlobal() {
     FrameInfo::RegisterNatives(g_natives);
     ImageFilter::RegisterNatives(g_natives);
     ImageShader::RegisterNatives(g_natives);
+    IncrementalImageDecoder::RegisterNatives(g_natives);
     IsolateNameServerNatives::RegisterNatives(g_natives);
     Paragraph::RegisterNatives(g_natives);
     ParagraphBuilder::RegisterNatives(g_natives);
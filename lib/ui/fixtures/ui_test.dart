@@ -44,3 +44,9 @@ void frameCallback(FrameInfo info) {
 @pragma('vm:entry-point')
 void messageCallback(dynamic data) {
 }
+
+@pragma('vm:entry-point')
+void incrementalDecodeCallback(Image image, bool isComplete) {
+  _notifyIncrementalDecode(image != null, isComplete);
+}
+void _notifyIncrementalDecode(bool hasImage, bool isComplete) native 'NotifyIncrementalDecode';
@@ -1546,6 +1546,20 @@ enum ImageByteFormat {
   ///  * <https://en.wikipedia.org/wiki/Portable_Network_Graphics>, the Wikipedia page on PNG.
   ///  * <https://tools.ietf.org/rfc/rfc2083.txt>, the PNG standard.
   png,
+
+  /// PNG format with fast compression.
+  ///
+  /// Encodes several times faster than [png], at the cost of somewhat larger
+  /// output. This format is well suited for large images that are encoded
+  /// often, such as screenshots that are sent elsewhere.
+  pngFast,
+
+  /// PNG format without compression.
+  ///
+  /// Encodes about as fast as the raw formats while still producing a PNG
+  /// image that any decoder can read. The output is slightly larger than the
+  /// raw RGBA bytes of the image.
+  pngUncompressed,
 }
 
 /// The format of pixel data given to [decodeImageFromPixels].
@@ -1692,6 +1706,9 @@ class Codec extends NativeFieldWrapperClass2 {
 
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
+  ///
+  /// A frame that is still being decoded is dropped, and the futures returned
+  /// by [getNextFrame] for it never complete.
   void dispose() native 'Codec_dispose';
 }
 
@@ -1772,6 +1789,57 @@ Future<void> _decodeImageFromListAsync(Uint8List list,
   callback(frameInfo.image);
 }
 
+/// Callback signature for [IncrementalImageDecoder].
+///
+/// The `image` is null if the image could not be decoded. The `isComplete`
+/// argument is false for intermediate images and true for the last call.
+typedef IncrementalImageDecoderCallback = void Function(Image? image, bool isComplete);
+
+/// Decodes an image from encoded data that arrives in chunks, such as the body
+/// of a network response.
+///
+/// Chunks are decoded on a background thread as they are added with
+/// [addChunk], so that decoding overlaps with receiving the data and the data
+/// never has to be gathered into one list. PNG and GIF images are decoded row
+/// by row as their data arrives. Other formats are decoded once [close] was
+/// called.
+///
+/// The `callback` is called once with the decoded image, or with null if the
+/// image could not be decoded. If `emitIntermediateImages` is true, it is also
+/// called with images of the rows decoded so far while the data arrives, where
+/// the other rows are transparent. Intermediate images are skipped while the
+/// previous one is still being prepared.
+///
+/// Only still images are supported. Animated images decode to their first
+/// frame.
+@pragma('vm:entry-point')
+class IncrementalImageDecoder extends NativeFieldWrapperClass2 {
+  /// Creates a decoder that reports the decoded image to `callback`.
+  @pragma('vm:entry-point')
+  IncrementalImageDecoder(
+    IncrementalImageDecoderCallback callback, {
+    bool emitIntermediateImages = false,
+  }) : assert(callback != null), // ignore: unnecessary_null_comparison
+       assert(emitIntermediateImages != null) { // ignore: unnecessary_null_comparison
+    _constructor(callback, emitIntermediateImages);
+  }
+  void _constructor(IncrementalImageDecoderCallback callback, bool emitIntermediateImages) native 'IncrementalImageDecoder_constructor';
+
+  /// Adds the next chunk of the encoded data.
+  ///
+  /// The chunk is copied, so the list may be reused afterwards.
+  void addChunk(Uint8List chunk) native 'IncrementalImageDecoder_addChunk';
+
+  /// Signals that all of the encoded data was added.
+  void close() native 'IncrementalImageDecoder_close';
+
+  /// Stops decoding and releases the resources used by this object.
+  ///
+  /// The callback is not called anymore, and the object is no longer usable
+  /// after this method is called.
+  void dispose() native 'IncrementalImageDecoder_dispose';
+}
+
 /// Convert an array of pixel values into an [Image] object.
 ///
 /// The `pixels` parameter is the pixel data in the encoding described by
@@ -0,0 +1,167 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <cstring>
+#include <iterator>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+namespace {
+
+constexpr uint64_t kHashMultiplier = 0x9e3779b97f4a7c15ull;
+
+// A simple hash of |size| bytes that consumes 8 bytes at a time, which is fast
+// enough to run over megabytes of encoded data on a worker thread.
+uint64_t HashBytes(const void* bytes, size_t size) {
+  const uint8_t* data = static_cast<const uint8_t*>(bytes);
+  uint64_t hash = size * kHashMultiplier;
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + offset, sizeof(word));
+    hash = (hash ^ word) * kHashMultiplier;
+    hash ^= hash >> 29;
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, data + offset, size - offset);
+  hash = (hash ^ tail) * kHashMultiplier;
+  return hash ^ (hash >> 32);
+}
+
+// The bytes held by an entry for |image|, including the data pinned by |key|.
+size_t EntryBytes(const DecodedImageCache::Key& key, const SkImage& image) {
+  const size_t data_bytes = key.data ? key.data->size() : 0;
+  return image.imageInfo().computeMinByteSize() + data_bytes;
+}
+
+}  // namespace
+
+bool DecodedImageCache::Key::operator==(const Key& other) const {
+  return data_hash == other.data_hash && data_size == other.data_size &&
+         image_info_hash == other.image_info_hash &&
+         target_width == other.target_width &&
+         target_height == other.target_height &&
+         image_upscaling == other.image_upscaling &&
+         (data == other.data || (data && data->equals(other.data.get())));
+}
+
+std::size_t DecodedImageCache::Key::Hash::operator()(const Key& key) const {
+  return fml::HashCombine(key.data_hash, key.data_size, key.image_info_hash,
+                          key.target_width.value_or(0),
+                          key.target_height.value_or(0),
+                          static_cast<int>(key.image_upscaling));
+}
+
+DecodedImageCache& DecodedImageCache::GetInstance() {
+  // Never destroyed, so that decodes still running at exit may use it.
+  static DecodedImageCache* instance = new DecodedImageCache();
+  return *instance;
+}
+
+DecodedImageCache::Key DecodedImageCache::MakeKey(
+    const ImageDecoder::ImageDescriptor& descriptor) {
+  TRACE_EVENT0("flutter", "DecodedImageCache::MakeKey");
+  Key key;
+  if (descriptor.data) {
+    key.data = descriptor.data;
+    key.data_hash = HashBytes(descriptor.data->data(), descriptor.data->size());
+    key.data_size = descriptor.data->size();
+  }
+  if (descriptor.decompressed_image_info) {
+    const ImageDecoder::ImageInfo& info =
+        descriptor.decompressed_image_info.value();
+    key.image_info_hash = fml::HashCombine(
+        info.sk_info.width(), info.sk_info.height(),
+        static_cast<int>(info.sk_info.colorType()),
+        static_cast<int>(info.sk_info.alphaType()), info.row_bytes);
+  }
+  key.target_width = descriptor.target_width;
+  key.target_height = descriptor.target_height;
+  key.image_upscaling = descriptor.image_upscaling;
+  return key;
+}
+
+DecodedImageCache::DecodedImageCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+sk_sp<SkImage> DecodedImageCache::Get(const Key& key) {
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    miss_count_++;
+    return nullptr;
+  }
+  hit_count_++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->image;
+}
+
+void DecodedImageCache::Put(const Key& key, sk_sp<SkImage> image) {
+  FML_DCHECK(image && !image->isTextureBacked());
+  const size_t bytes = EntryBytes(key, *image);
+
+  // The replaced or evicted images are released outside of the lock.
+  std::list<Entry> released;
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    bytes_ -= found->second->bytes;
+    released.splice(released.end(), entries_, found->second);
+    index_.erase(found);
+  }
+  if (bytes > max_bytes_) {
+    return;
+  }
+  entries_.push_front({key, std::move(image), bytes});
+  index_[key] = entries_.begin();
+  bytes_ += bytes;
+  EvictLocked(released);
+}
+
+void DecodedImageCache::Purge() {
+  TRACE_EVENT0("flutter", "DecodedImageCache::Purge");
+  std::list<Entry> released;
+  std::scoped_lock lock(mutex_);
+  released.swap(entries_);
+  index_.clear();
+  bytes_ = 0;
+}
+
+void DecodedImageCache::SetMaxBytes(size_t max_bytes) {
+  std::list<Entry> released;
+  std::scoped_lock lock(mutex_);
+  max_bytes_ = max_bytes;
+  EvictLocked(released);
+}
+
+DecodedImageCacheStatistics DecodedImageCache::GetStatistics() {
+  std::scoped_lock lock(mutex_);
+  DecodedImageCacheStatistics statistics;
+  statistics.entry_count = entries_.size();
+  statistics.bytes = bytes_;
+  statistics.max_bytes = max_bytes_;
+  statistics.hit_count = hit_count_;
+  statistics.miss_count = miss_count_;
+  statistics.eviction_count = eviction_count_;
+  return statistics;
+}
+
+void DecodedImageCache::EvictLocked(std::list<Entry>& evicted) {
+  while (bytes_ > max_bytes_ && !entries_.empty()) {
+    const Entry& entry = entries_.back();
+    bytes_ -= entry.bytes;
+    index_.erase(entry.key);
+    evicted.splice(evicted.begin(), entries_, std::prev(entries_.end()));
+    eviction_count_++;
+  }
+}
+
+}  // namespace flutter
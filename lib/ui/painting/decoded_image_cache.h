@@ -0,0 +1,127 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+
+namespace flutter {
+
+// A snapshot of the contents and effectiveness of the |DecodedImageCache|.
+struct DecodedImageCacheStatistics {
+  // The number of images in the cache and the bytes of their pixels and of
+  // the encoded data they were decoded from.
+  size_t entry_count = 0;
+  size_t bytes = 0;
+
+  // The byte budget the images are kept under.
+  size_t max_bytes = 0;
+
+  // Cumulative counts since the process started. A hit is a decode that was
+  // served from the cache, a miss is one that was not, and an eviction is an
+  // image dropped to stay within |max_bytes|. Purges do not count as
+  // evictions.
+  size_t hit_count = 0;
+  size_t miss_count = 0;
+  size_t eviction_count = 0;
+};
+
+// A process wide cache of the raster images decoded by |ImageDecoder|, keyed by
+// the encoded data and the size the image was decoded at. Decoding
+// the same bytes at the same size again, from any engine in the process, uses
+// the cached image and skips decompression and resizing. Uploading the image to
+// the GPU still happens for each decode, as the resource context is specific to
+// each engine.
+//
+// The cache may be accessed from any thread.
+class DecodedImageCache {
+ public:
+  // The default number of bytes the cache may hold. Each image is charged for
+  // its pixels and for the encoded data its key keeps alive. When a new image
+  // would not fit, the least recently used images are evicted first.
+  static constexpr size_t kDefaultMaxBytes = 32 * 1024 * 1024;
+
+  struct Key {
+    // The data the image is decoded from. Keys with the same hash are only
+    // equal if their data is too, so that a hash collision cannot return the
+    // image of other data.
+    sk_sp<SkData> data;
+    uint64_t data_hash = 0;
+    size_t data_size = 0;
+    // Zero for encoded data, and a hash of the image info for decompressed
+    // data.
+    uint64_t image_info_hash = 0;
+    std::optional<uint32_t> target_width;
+    std::optional<uint32_t> target_height;
+    ImageUpscalingMode image_upscaling = ImageUpscalingMode::kNotAllowed;
+
+    bool operator==(const Key& other) const;
+
+    struct Hash {
+      std::size_t operator()(const Key& key) const;
+    };
+  };
+
+  static DecodedImageCache& GetInstance();
+
+  // Computes the key of the image decoded from |descriptor|. This hashes all
+  // of the data of the descriptor, so call it on a worker thread.
+  static Key MakeKey(const ImageDecoder::ImageDescriptor& descriptor);
+
+  explicit DecodedImageCache(size_t max_bytes = kDefaultMaxBytes);
+
+  ~DecodedImageCache();
+
+  // Returns the cached image for |key|, or nullptr if there is none.
+  sk_sp<SkImage> Get(const Key& key);
+
+  // Caches |image|, which must be a raster image, for |key|. Images larger
+  // than the budget are not cached.
+  void Put(const Key& key, sk_sp<SkImage> image);
+
+  // Drops all images, for example when the system is low on memory.
+  void Purge();
+
+  // Sets the byte budget, evicting images right away if it is exceeded.
+  void SetMaxBytes(size_t max_bytes);
+
+  DecodedImageCacheStatistics GetStatistics();
+
+ private:
+  struct Entry {
+    Key key;
+    sk_sp<SkImage> image;
+    size_t bytes;
+  };
+
+  std::mutex mutex_;
+  // The most recently used entries are at the front.
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, Key::Hash> index_;
+  size_t bytes_ = 0;
+  size_t max_bytes_;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+  size_t eviction_count_ = 0;
+
+  // Moves the least recently used entries to |evicted| until the cache holds
+  // at most |max_bytes_|, so that the caller can release them after unlocking.
+  void EvictLocked(std::list<Entry>& evicted);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <string>
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Makes a raster image of |width| by |height| pixels, 4 bytes each.
+sk_sp<SkImage> MakeImage(int width, int height) {
+  const SkImageInfo info = SkImageInfo::MakeN32Premul(width, height);
+  return SkImage::MakeRasterData(
+      info, SkData::MakeUninitialized(info.computeMinByteSize()),
+      info.minRowBytes());
+}
+
+DecodedImageCache::Key MakeKey(const char* bytes,
+                               std::optional<uint32_t> target_width = {}) {
+  ImageDecoder::ImageDescriptor descriptor;
+  descriptor.data = SkData::MakeWithCString(bytes);
+  descriptor.target_width = target_width;
+  return DecodedImageCache::MakeKey(descriptor);
+}
+
+}  // namespace
+
+TEST(DecodedImageCacheTest, KeysDependOnDataAndTargetSize) {
+  EXPECT_EQ(MakeKey("image"), MakeKey("image"));
+  EXPECT_FALSE(MakeKey("image") == MakeKey("other"));
+  EXPECT_FALSE(MakeKey("image") == MakeKey("image", 10));
+  EXPECT_FALSE(MakeKey("image", 10) == MakeKey("image", 20));
+  EXPECT_EQ(DecodedImageCache::Key::Hash()(MakeKey("image", 10)),
+            DecodedImageCache::Key::Hash()(MakeKey("image", 10)));
+}
+
+TEST(DecodedImageCacheTest, KeysWithCollidingHashesAreNotEqual) {
+  const auto key = MakeKey("image");
+  // Other data of the same size that happens to have the same hash.
+  auto colliding_key = key;
+  colliding_key.data = SkData::MakeWithCString("other");
+  EXPECT_FALSE(key == colliding_key);
+
+  DecodedImageCache cache;
+  cache.Put(key, MakeImage(10, 10));
+  EXPECT_EQ(cache.Get(colliding_key), nullptr);
+  EXPECT_NE(cache.Get(key), nullptr);
+}
+
+TEST(DecodedImageCacheTest, ReturnsCachedImages) {
+  DecodedImageCache cache;
+  const auto key = MakeKey("image");
+  EXPECT_EQ(cache.Get(key), nullptr);
+
+  auto image = MakeImage(10, 10);
+  cache.Put(key, image);
+  EXPECT_EQ(cache.Get(key), image);
+  EXPECT_EQ(cache.Get(MakeKey("other")), nullptr);
+
+  const auto statistics = cache.GetStatistics();
+  EXPECT_EQ(statistics.entry_count, 1u);
+  // The pixels and the 6 bytes of data held by the key.
+  EXPECT_EQ(statistics.bytes, 406u);
+  EXPECT_EQ(statistics.hit_count, 1u);
+  EXPECT_EQ(statistics.miss_count, 2u);
+  EXPECT_EQ(statistics.eviction_count, 0u);
+}
+
+TEST(DecodedImageCacheTest, EvictsLeastRecentlyUsedImages) {
+  // Room for two 10x10 images with 2 bytes of data each.
+  DecodedImageCache cache(804);
+  cache.Put(MakeKey("a"), MakeImage(10, 10));
+  cache.Put(MakeKey("b"), MakeImage(10, 10));
+  // Using "a" makes "b" the least recently used image.
+  ASSERT_NE(cache.Get(MakeKey("a")), nullptr);
+  cache.Put(MakeKey("c"), MakeImage(10, 10));
+
+  EXPECT_NE(cache.Get(MakeKey("a")), nullptr);
+  EXPECT_EQ(cache.Get(MakeKey("b")), nullptr);
+  EXPECT_NE(cache.Get(MakeKey("c")), nullptr);
+
+  const auto statistics = cache.GetStatistics();
+  EXPECT_EQ(statistics.entry_count, 2u);
+  EXPECT_EQ(statistics.bytes, 804u);
+  EXPECT_EQ(statistics.eviction_count, 1u);
+}
+
+TEST(DecodedImageCacheTest, DoesNotCacheImagesLargerThanTheBudget) {
+  DecodedImageCache cache(800);
+  cache.Put(MakeKey("small"), MakeImage(10, 10));
+  cache.Put(MakeKey("large"), MakeImage(20, 20));
+
+  EXPECT_EQ(cache.Get(MakeKey("large")), nullptr);
+  EXPECT_NE(cache.Get(MakeKey("small")), nullptr);
+  EXPECT_EQ(cache.GetStatistics().eviction_count, 0u);
+}
+
+TEST(DecodedImageCacheTest, ReplacesImagesWithTheSameKey) {
+  DecodedImageCache cache;
+  cache.Put(MakeKey("image"), MakeImage(10, 10));
+  auto image = MakeImage(20, 20);
+  cache.Put(MakeKey("image"), image);
+
+  EXPECT_EQ(cache.Get(MakeKey("image")), image);
+  const auto statistics = cache.GetStatistics();
+  EXPECT_EQ(statistics.entry_count, 1u);
+  EXPECT_EQ(statistics.bytes, 1606u);
+}
+
+TEST(DecodedImageCacheTest, ChargesEncodedDataToImages) {
+  // The image would fit by itself, but not with the data it is keyed by.
+  DecodedImageCache cache(1000);
+  const std::string data(800, 'x');
+  cache.Put(MakeKey(data.c_str()), MakeImage(10, 10));
+
+  EXPECT_EQ(cache.Get(MakeKey(data.c_str())), nullptr);
+  EXPECT_EQ(cache.GetStatistics().bytes, 0u);
+}
+
+TEST(DecodedImageCacheTest, PurgeDropsAllImages) {
+  DecodedImageCache cache;
+  cache.Put(MakeKey("a"), MakeImage(10, 10));
+  cache.Put(MakeKey("b"), MakeImage(10, 10));
+  cache.Purge();
+
+  EXPECT_EQ(cache.Get(MakeKey("a")), nullptr);
+  const auto statistics = cache.GetStatistics();
+  EXPECT_EQ(statistics.entry_count, 0u);
+  EXPECT_EQ(statistics.bytes, 0u);
+  EXPECT_EQ(statistics.eviction_count, 0u);
+}
+
+TEST(DecodedImageCacheTest, ShrinkingTheBudgetEvictsImages) {
+  DecodedImageCache cache;
+  cache.Put(MakeKey("a"), MakeImage(10, 10));
+  cache.Put(MakeKey("b"), MakeImage(10, 10));
+  cache.SetMaxBytes(402);
+
+  EXPECT_EQ(cache.Get(MakeKey("a")), nullptr);
+  EXPECT_NE(cache.Get(MakeKey("b")), nullptr);
+  const auto statistics = cache.GetStatistics();
+  EXPECT_EQ(statistics.max_bytes, 402u);
+  EXPECT_EQ(statistics.eviction_count, 1u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -5,8 +5,12 @@
 #include "flutter/lib/ui/painting/image_decoder.h"
 
 #include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
 
 #include "flutter/fml/make_copyable.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "third_party/skia/include/codec/SkCodec.h"
 #include "third_party/skia/src/codec/SkCodecImageGenerator.h"
 
@@ -17,21 +21,6 @@ constexpr double kAspectRatioChangedThreshold = 0.01;
 
 }  // namespace
 
-ImageDecoder::ImageDecoder(
-    TaskRunners runners,
-    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-    fml::WeakPtr<IOManager> io_manager)
-    : runners_(std::move(runners)),
-      concurrent_task_runner_(std::move(concurrent_task_runner)),
-      io_manager_(std::move(io_manager)),
-      weak_factory_(this) {
-  FML_DCHECK(runners_.IsValid());
-  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
-      << "The image decoder must be created & collected on the UI thread.";
-}
-
-ImageDecoder::~ImageDecoder() = default;
-
 static double AspectRatio(const SkISize& size) {
   return static_cast<double>(size.width()) / size.height();
 }
@@ -248,7 +237,7 @@ sk_sp<SkImage> ImageFromCompressedData(sk_sp<SkData> data,
   return ResizeRasterImage(std::move(image), resized_dimensions, flow);
 }
 
-static SkiaGPUObject<SkImage> UploadRasterImage(
+SkiaGPUObject<SkImage> UploadRasterImage(
     sk_sp<SkImage> image,
     fml::WeakPtr<IOManager> io_manager,
     const fml::tracing::TraceFlow& flow) {
@@ -304,8 +293,241 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   return result;
 }
 
-void ImageDecoder::Decode(ImageDescriptor descriptor,
-                          const ImageResult& callback) {
+// Holds the decodes that were requested but have not started, and starts them
+// in order of priority on the concurrent task runner. Every request posts one
+// task, which starts whichever pending decode is the most urgent when it runs.
+class ImageDecoder::DecodeQueue
+    : public std::enable_shared_from_this<DecodeQueue> {
+ public:
+  using Result =
+      std::function<void(SkiaGPUObject<SkImage>, fml::tracing::TraceFlow)>;
+
+  DecodeQueue(std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+              fml::RefPtr<fml::TaskRunner> io_runner,
+              fml::WeakPtr<IOManager> io_manager)
+      : concurrent_task_runner_(std::move(concurrent_task_runner)),
+        io_runner_(std::move(io_runner)),
+        io_manager_(std::move(io_manager)) {}
+
+  std::shared_ptr<Request> Push(ImageDescriptor descriptor,
+                                Result result,
+                                fml::tracing::TraceFlow flow,
+                                fml::ConcurrentTaskPriority priority) {
+    std::shared_ptr<Request> request(new Request(weak_from_this(), priority));
+    {
+      std::scoped_lock lock(mutex_);
+      request->sequence_number_ = next_sequence_number_++;
+      pending_[{priority, request->sequence_number_}] =
+          std::unique_ptr<PendingDecode>(new PendingDecode{
+              request, std::move(descriptor), std::move(result),
+              std::move(flow)});
+    }
+    PostDecodeTask(priority);
+    return request;
+  }
+
+  void Cancel(Request& request) {
+    std::unique_ptr<PendingDecode> decode = Remove(request);
+    if (decode) {
+      decode->result({}, std::move(decode->flow));
+    }
+  }
+
+  void SetPriority(Request& request, fml::ConcurrentTaskPriority priority) {
+    {
+      std::scoped_lock lock(mutex_);
+      auto found = pending_.find({request.priority_, request.sequence_number_});
+      if (found == pending_.end() || request.priority_ == priority) {
+        return;
+      }
+      // Requests keep their place among the requests of the new priority.
+      pending_[{priority, request.sequence_number_}] =
+          std::move(found->second);
+      pending_.erase(found);
+      request.priority_ = priority;
+    }
+    // The task posted for the request may be queued behind less urgent work.
+    PostDecodeTask(priority);
+  }
+
+ private:
+  struct PendingDecode {
+    std::shared_ptr<Request> request;
+    ImageDescriptor descriptor;
+    Result result;
+    fml::tracing::TraceFlow flow;
+  };
+
+  // Pending decodes are ordered by priority, then by the order they were
+  // requested in.
+  using Position = std::pair<fml::ConcurrentTaskPriority, uint64_t>;
+
+  const std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  const fml::RefPtr<fml::TaskRunner> io_runner_;
+  const fml::WeakPtr<IOManager> io_manager_;
+  std::mutex mutex_;
+  std::map<Position, std::unique_ptr<PendingDecode>> pending_;
+  uint64_t next_sequence_number_ = 0;
+
+  void PostDecodeTask(fml::ConcurrentTaskPriority priority) {
+    concurrent_task_runner_->PostTask(
+        [queue = shared_from_this()]() { queue->DecodeNext(); }, priority);
+  }
+
+  std::unique_ptr<PendingDecode> Remove(const Request& request) {
+    std::scoped_lock lock(mutex_);
+    auto found = pending_.find({request.priority_, request.sequence_number_});
+    if (found == pending_.end()) {
+      return nullptr;
+    }
+    std::unique_ptr<PendingDecode> decode = std::move(found->second);
+    pending_.erase(found);
+    return decode;
+  }
+
+  // On Worker.
+  void DecodeNext() {
+    std::unique_ptr<PendingDecode> decode;
+    {
+      std::scoped_lock lock(mutex_);
+      // The decode this task was posted for may have been cancelled or
+      // started by an earlier task.
+      if (pending_.empty()) {
+        return;
+      }
+      decode = std::move(pending_.begin()->second);
+      pending_.erase(pending_.begin());
+    }
+
+    ImageDescriptor& descriptor = decode->descriptor;
+    const Result& result = decode->result;
+    fml::tracing::TraceFlow& flow = decode->flow;
+
+    // The request may have been cancelled while it was being taken.
+    if (decode->request->IsCancelled()) {
+      result({}, std::move(flow));
+      return;
+    }
+
+    // Step 1: Decompress the image, unless the same data was already
+    // decompressed to the same size.
+    // On Worker.
+
+    const auto cache_key = DecodedImageCache::MakeKey(descriptor);
+    auto decompressed = DecodedImageCache::GetInstance().Get(cache_key);
+    if (!decompressed) {
+      decompressed =
+          descriptor.decompressed_image_info
+              ? ImageFromDecompressedData(
+                    std::move(descriptor.data),                  //
+                    descriptor.decompressed_image_info.value(),  //
+                    descriptor.target_width,                     //
+                    descriptor.target_height,                    //
+                    descriptor.image_upscaling,                  //
+                    flow                                         //
+                    )
+              : ImageFromCompressedData(std::move(descriptor.data),  //
+                                        descriptor.target_width,     //
+                                        descriptor.target_height,    //
+                                        descriptor.image_upscaling,  //
+                                        flow);
+
+      if (!decompressed) {
+        FML_LOG(ERROR) << "Could not decompress image.";
+        result({}, std::move(flow));
+        return;
+      }
+
+      DecodedImageCache::GetInstance().Put(cache_key, decompressed);
+    }
+
+    // Step 2: Update the image to the GPU.
+    // On IO Thread.
+
+    io_runner_->PostTask(fml::MakeCopyable([io_manager = io_manager_,
+                                            request = decode->request,
+                                            decompressed, result,
+                                            flow = std::move(flow)]() mutable {
+      if (request->IsCancelled()) {
+        return result({}, std::move(flow));
+      }
+
+      if (!io_manager) {
+        FML_LOG(ERROR) << "Could not acquire IO manager.";
+        return result({}, std::move(flow));
+      }
+
+      // If the IO manager does not have a resource context, the caller
+      // might not have set one or a software backend could be in use.
+      // Either way, just return the image as-is.
+      if (!io_manager->GetResourceContext()) {
+        result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
+               std::move(flow));
+        return;
+      }
+
+      auto uploaded =
+          UploadRasterImage(std::move(decompressed), io_manager, flow);
+
+      if (!uploaded.get()) {
+        FML_LOG(ERROR) << "Could not upload image to the GPU.";
+        result({}, std::move(flow));
+        return;
+      }
+
+      // Finally, all done.
+      result(std::move(uploaded), std::move(flow));
+    }));
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodeQueue);
+};
+
+ImageDecoder::Request::Request(std::weak_ptr<DecodeQueue> queue,
+                               fml::ConcurrentTaskPriority priority)
+    : queue_(std::move(queue)), priority_(priority) {}
+
+ImageDecoder::Request::~Request() = default;
+
+void ImageDecoder::Request::Cancel() {
+  if (cancelled_.exchange(true)) {
+    return;
+  }
+  if (auto queue = queue_.lock()) {
+    queue->Cancel(*this);
+  }
+}
+
+bool ImageDecoder::Request::IsCancelled() const {
+  return cancelled_;
+}
+
+void ImageDecoder::Request::SetPriority(fml::ConcurrentTaskPriority priority) {
+  if (auto queue = queue_.lock()) {
+    queue->SetPriority(*this, priority);
+  }
+}
+
+ImageDecoder::ImageDecoder(
+    TaskRunners runners,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+    fml::WeakPtr<IOManager> io_manager)
+    : runners_(std::move(runners)),
+      queue_(std::make_shared<DecodeQueue>(std::move(concurrent_task_runner),
+                                           runners_.GetIOTaskRunner(),
+                                           std::move(io_manager))),
+      weak_factory_(this) {
+  FML_DCHECK(runners_.IsValid());
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
+      << "The image decoder must be created & collected on the UI thread.";
+}
+
+ImageDecoder::~ImageDecoder() = default;
+
+std::shared_ptr<ImageDecoder::Request> ImageDecoder::Decode(
+    ImageDescriptor descriptor,
+    const ImageResult& callback,
+    fml::ConcurrentTaskPriority priority) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   fml::tracing::TraceFlow flow(__FUNCTION__);
 
@@ -328,74 +550,12 @@ void ImageDecoder::Decode(ImageDescriptor descriptor,
 
   if (!descriptor.data || descriptor.data->size() == 0) {
     result({}, std::move(flow));
-    return;
+    // The decode has already completed, so there is nothing to cancel.
+    return std::shared_ptr<Request>(new Request({}, priority));
   }
 
-  concurrent_task_runner_->PostTask(
-      fml::MakeCopyable([descriptor,                              //
-                         io_manager = io_manager_,                //
-                         io_runner = runners_.GetIOTaskRunner(),  //
-                         result,                                  //
-                         flow = std::move(flow)                   //
-  ]() mutable {
-        // Step 1: Decompress the image.
-        // On Worker.
-
-        auto decompressed =
-            descriptor.decompressed_image_info
-                ? ImageFromDecompressedData(
-                      std::move(descriptor.data),                  //
-                      descriptor.decompressed_image_info.value(),  //
-                      descriptor.target_width,                     //
-                      descriptor.target_height,                    //
-                      descriptor.image_upscaling,                  //
-                      flow                                         //
-                      )
-                : ImageFromCompressedData(std::move(descriptor.data),  //
-                                          descriptor.target_width,     //
-                                          descriptor.target_height,    //
-                                          descriptor.image_upscaling,  //
-                                          flow);
-
-        if (!decompressed) {
-          FML_LOG(ERROR) << "Could not decompress image.";
-          result({}, std::move(flow));
-          return;
-        }
-
-        // Step 2: Update the image to the GPU.
-        // On IO Thread.
-
-        io_runner->PostTask(fml::MakeCopyable([io_manager, decompressed, result,
-                                               flow =
-                                                   std::move(flow)]() mutable {
-          if (!io_manager) {
-            FML_LOG(ERROR) << "Could not acquire IO manager.";
-            return result({}, std::move(flow));
-          }
-
-          // If the IO manager does not have a resource context, the caller
-          // might not have set one or a software backend could be in use.
-          // Either way, just return the image as-is.
-          if (!io_manager->GetResourceContext()) {
-            result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
-                   std::move(flow));
-            return;
-          }
-
-          auto uploaded =
-              UploadRasterImage(std::move(decompressed), io_manager, flow);
-
-          if (!uploaded.get()) {
-            FML_LOG(ERROR) << "Could not upload image to the GPU.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // Finally, all done.
-          result(std::move(uploaded), std::move(flow));
-        }));
-      }));
+  return queue_->Push(std::move(descriptor), std::move(result),
+                      std::move(flow), priority);
 }
 
 fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
 
+#include <atomic>
 #include <memory>
 #include <optional>
 
@@ -55,19 +56,61 @@ class ImageDecoder {
 
   using ImageResult = std::function<void(SkiaGPUObject<SkImage>)>;
 
+  class DecodeQueue;
+
+  // A handle to a decode requested from |Decode|. Pending decodes are started
+  // in order of priority, and in the order they were requested within a
+  // priority. The handle may be used from any thread.
+  class Request {
+   public:
+    ~Request();
+
+    // Drops the decode if its image was not decompressed yet, or was not
+    // uploaded to the GPU yet. The result callback is then invoked with a null
+    // texture. Has no effect on decodes that already completed.
+    void Cancel();
+
+    bool IsCancelled() const;
+
+    // Changes the priority of the decode if it has not started yet, for
+    // example to raise it once the image becomes visible.
+    void SetPriority(fml::ConcurrentTaskPriority priority);
+
+   private:
+    friend ImageDecoder;
+    friend DecodeQueue;
+
+    std::weak_ptr<DecodeQueue> queue_;
+    std::atomic_bool cancelled_{false};
+    // The position of the request while it is in the queue. Guarded by the
+    // mutex of the queue.
+    fml::ConcurrentTaskPriority priority_;
+    uint64_t sequence_number_ = 0;
+
+    Request(std::weak_ptr<DecodeQueue> queue,
+            fml::ConcurrentTaskPriority priority);
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Request);
+  };
+
   // Takes an image descriptor and returns a handle to a texture resident on the
   // GPU. All image decompression and resizes are done on a worker thread
   // concurrently. Texture upload is done on the IO thread and the result
-  // returned back on the UI thread. On error, the texture is null but the
-  // callback is guaranteed to return on the UI thread.
-  void Decode(ImageDescriptor descriptor, const ImageResult& result);
+  // returned back on the UI thread. On error or cancellation, the texture is
+  // null but the callback is guaranteed to return on the UI thread.
+  //
+  // Decodes default to a high priority, as the framework is usually waiting to
+  // show the image.
+  std::shared_ptr<Request> Decode(ImageDescriptor descriptor,
+                                  const ImageResult& result,
+                                  fml::ConcurrentTaskPriority priority =
+                                      fml::ConcurrentTaskPriority::kHigh);
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
  private:
   TaskRunners runners_;
-  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
-  fml::WeakPtr<IOManager> io_manager_;
+  std::shared_ptr<DecodeQueue> queue_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
@@ -79,6 +122,12 @@ sk_sp<SkImage> ImageFromCompressedData(sk_sp<SkData> data,
                                        ImageUpscalingMode image_upscaling,
                                        const fml::tracing::TraceFlow& flow);
 
+// Uploads a raster image to the GPU using the resource context of
+// |io_manager|. Must be called on the IO thread.
+SkiaGPUObject<SkImage> UploadRasterImage(sk_sp<SkImage> image,
+                                         fml::WeakPtr<IOManager> io_manager,
+                                         const fml::tracing::TraceFlow& flow);
+
 }  // namespace flutter
 
 #endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
@@ -14,6 +14,32 @@ ImageDecoderFixtureTest::ImageDecoderFixtureTest()
                                      fml::FilePermission::kRead)),
       aot_symbols_(LoadELFSymbolFromFixturesIfNeccessary()) {}
 
+void ImageDecoderFixtureTest::AddNativeCallback(std::string name,
+                                                Dart_NativeFunction callback) {
+  native_resolver_->AddNativeCallback(std::move(name), callback);
+}
+
+SkBitmap ImageDecoderFixtureTest::GetFrame(MultiFrameCodec& codec,
+                                           int frame_index) {
+  return codec.state_->GetFrame(frame_index);
+}
+
+SkBitmap ImageDecoderFixtureTest::GetNextFrameAndDecodeAhead(
+    MultiFrameCodec& codec) {
+  auto& state = *codec.state_;
+  SkBitmap bitmap = state.GetFrame(state.nextFrameIndex_);
+  state.nextFrameIndex_ = (state.nextFrameIndex_ + 1) % state.frameCount_;
+  // Without a task runner, this only drops the frames that are not needed.
+  state.ScheduleDecodeAhead(nullptr);
+  state.DecodeAhead();
+  return bitmap;
+}
+
+size_t ImageDecoderFixtureTest::GetDecodeCount(MultiFrameCodec& codec) {
+  std::scoped_lock lock(codec.state_->decodeMutex_);
+  return codec.state_->decodeCount_;
+}
+
 Settings ImageDecoderFixtureTest::CreateSettingsForFixture() {
   Settings settings;
   settings.leak_vm = false;
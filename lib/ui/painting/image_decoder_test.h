@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "flutter/common/settings.h"
+#include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/test_dart_native_resolver.h"
@@ -23,6 +24,19 @@ class ImageDecoderFixtureTest : public ThreadTest {
 
   Settings CreateSettingsForFixture();
 
+  void AddNativeCallback(std::string name, Dart_NativeFunction callback);
+
+  // Returns the frame at |frame_index| of |codec|, from its cache or decoded
+  // on the calling thread.
+  static SkBitmap GetFrame(MultiFrameCodec& codec, int frame_index);
+
+  // Returns the next frame of |codec| like |MultiFrameCodec::getNextFrame|
+  // does, and then decodes the upcoming frames ahead on the calling thread.
+  static SkBitmap GetNextFrameAndDecodeAhead(MultiFrameCodec& codec);
+
+  // The number of frames |codec| decoded so far.
+  static size_t GetDecodeCount(MultiFrameCodec& codec);
+
  private:
   std::shared_ptr<TestDartNativeResolver> native_resolver_;
   fml::UniqueFD assets_dir_;
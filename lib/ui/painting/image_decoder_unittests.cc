@@ -2,11 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cstring>
+
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
 #include "flutter/lib/ui/painting/image_decoder_test.h"
+#include "flutter/lib/ui/painting/incremental_image_decoder.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
@@ -17,6 +21,7 @@
 #include "flutter/testing/testing.h"
 #include "flutter/testing/thread_test.h"
 #include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/tonic/converter/dart_converter.h"
 
 namespace flutter {
 namespace testing {
@@ -504,6 +509,87 @@ TEST_F(ImageDecoderFixtureTest, CanResizeWithoutDecode) {
   latch.Wait();
 }
 
+TEST_F(ImageDecoderFixtureTest, DecodesStartInPriorityOrderUnlessCancelled) {
+  // A single worker, so that decodes start one after the other.
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  // Setup the IO manager.
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // Keep the worker busy until all decodes were requested.
+  fml::AutoResetWaitableEvent worker_latch;
+  loop->GetTaskRunner()->PostTask([&]() {
+    latch.Signal();
+    worker_latch.Wait();
+  });
+  latch.Wait();
+
+  // The decodes are told apart by the width they are resized to.
+  std::vector<int> decoded_widths;
+  size_t cancelled_count = 0;
+  fml::CountDownLatch decodes_latch(4);
+  runners.GetUITaskRunner()->PostTask([&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager());
+
+    auto decode = [&](uint32_t width, fml::ConcurrentTaskPriority priority) {
+      ImageDecoder::ImageDescriptor image_descriptor;
+      image_descriptor.data = OpenFixtureAsSkData("Horizontal.jpg");
+      image_descriptor.target_width = width;
+      return image_decoder->Decode(
+          std::move(image_descriptor),
+          [&](SkiaGPUObject<SkImage> image) {
+            ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+            if (image.get()) {
+              decoded_widths.push_back(image.get()->width());
+            } else {
+              cancelled_count++;
+            }
+            decodes_latch.CountDown();
+          },
+          priority);
+    };
+
+    decode(10, fml::ConcurrentTaskPriority::kLow);
+    decode(20, fml::ConcurrentTaskPriority::kNormal)->Cancel();
+    decode(30, fml::ConcurrentTaskPriority::kHigh);
+    decode(40, fml::ConcurrentTaskPriority::kLow)
+        ->SetPriority(fml::ConcurrentTaskPriority::kHigh);
+
+    worker_latch.Signal();
+  });
+  decodes_latch.Wait();
+
+  EXPECT_EQ(decoded_widths, std::vector<int>({30, 40, 10}));
+  EXPECT_EQ(cancelled_count, 1u);
+
+  runners.GetUITaskRunner()->PostTask([&]() {
+    image_decoder.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
 // Verifies https://skia-review.googlesource.com/c/skia/+/259161 is present in
 // Flutter.
 TEST(ImageDecoderTest,
@@ -696,5 +782,173 @@ TEST_F(ImageDecoderFixtureTest,
   latch.Wait();
 }
 
+TEST_F(ImageDecoderFixtureTest,
+       IncrementalImageDecoderCompletesAfterItsReferenceIsDropped) {
+  auto settings = CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto png_data = OpenFixtureAsSkData("Horizontal.png");
+  ASSERT_TRUE(png_data);
+
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<TestIOManager> io_manager;
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager =
+        std::make_unique<TestIOManager>(runners.GetIOTaskRunner(), false);
+    latch.Signal();
+  });
+  latch.Wait();
+
+  fml::AutoResetWaitableEvent decode_latch;
+  bool decoded = false;
+  AddNativeCallback(
+      "NotifyIncrementalDecode",
+      CREATE_NATIVE_ENTRY([&](Dart_NativeArguments args) {
+        const bool has_image = tonic::DartConverter<bool>::FromDart(
+            Dart_GetNativeArgument(args, 0));
+        const bool is_complete = tonic::DartConverter<bool>::FromDart(
+            Dart_GetNativeArgument(args, 1));
+        if (is_complete) {
+          decoded = has_image;
+          decode_latch.Signal();
+        }
+      }));
+
+  auto isolate =
+      RunDartCodeInIsolate(vm_ref, settings, runners, "main", {},
+                           GetFixturesPath(), io_manager->GetWeakIOManager());
+  ASSERT_TRUE(isolate);
+
+  runners.GetUITaskRunner()->PostTask([&]() {
+    EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+      Dart_Handle callback =
+          Dart_GetField(Dart_RootLibrary(),
+                        Dart_NewStringFromCString("incrementalDecodeCallback"));
+      if (Dart_IsError(callback) || !Dart_IsClosure(callback)) {
+        return false;
+      }
+      auto decoder = IncrementalImageDecoder::Create(callback, false);
+      tonic::Uint8List chunk(
+          Dart_NewTypedData(Dart_TypedData_kUint8, png_data->size()));
+      memcpy(chunk.data(), png_data->data(), png_data->size());
+      decoder->addChunk(chunk);
+      chunk.Release();
+      decoder->close();
+      // The decoder has no Dart object, so this drops its last reference
+      // outside of the decode, as when the Dart object is collected.
+      decoder = nullptr;
+      return true;
+    }));
+    latch.Signal();
+  });
+  latch.Wait();
+
+  decode_latch.Wait();
+  EXPECT_TRUE(decoded);
+
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+// Decodes the frame at |frame_index| of |codec| from scratch, along with the
+// frames it depends on.
+static SkBitmap DecodeFrameFromScratch(SkCodec& codec, int frame_index) {
+  SkImageInfo info = codec.getInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(info)) {
+    return SkBitmap();
+  }
+  SkCodec::Options options;
+  options.fFrameIndex = frame_index;
+  if (codec.getPixels(info, bitmap.getPixels(), bitmap.rowBytes(),
+                      &options) != SkCodec::kSuccess) {
+    return SkBitmap();
+  }
+  return bitmap;
+}
+
+static bool HaveSamePixels(const SkBitmap& a, const SkBitmap& b) {
+  return !a.isNull() && !b.isNull() && a.info() == b.info() &&
+         a.rowBytes() == b.rowBytes() &&
+         memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()) == 0;
+}
+
+TEST_F(ImageDecoderFixtureTest, MultiFrameCodecDecodesEachFrameOncePerLoop) {
+  auto gif_mapping = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif_mapping);
+  auto reference_codec = SkCodec::MakeFromData(gif_mapping);
+  ASSERT_TRUE(reference_codec);
+  const int frame_count = reference_codec->getFrameCount();
+  ASSERT_GT(frame_count, 1);
+
+  // The frames of the fixture do not fit into the default cache, so only
+  // the upcoming frames are kept.
+  auto codec = fml::MakeRefCounted<MultiFrameCodec>(
+      SkCodec::MakeFromData(gif_mapping));
+  for (int loop = 1; loop <= 2; loop++) {
+    for (int i = 0; i < frame_count; i++) {
+      SkBitmap frame = GetNextFrameAndDecodeAhead(*codec);
+      ASSERT_TRUE(
+          HaveSamePixels(frame, DecodeFrameFromScratch(*reference_codec, i)))
+          << "Frame " << i;
+    }
+    // The look-ahead also decoded the first frames of the next loop.
+    const size_t decoded_ahead = MultiFrameCodec::kDefaultFrameCacheCount;
+    ASSERT_EQ(GetDecodeCount(*codec),
+              static_cast<size_t>(frame_count * loop) + decoded_ahead);
+  }
+
+  // Animations that fit into the cache do not decode any frame again.
+  MultiFrameCodec::SetFrameCacheLimits(0, 64 * 1024 * 1024);
+  auto cached_codec = fml::MakeRefCounted<MultiFrameCodec>(
+      SkCodec::MakeFromData(gif_mapping));
+  MultiFrameCodec::SetFrameCacheLimits(0, 0);
+  for (int i = 0; i < frame_count * 2; i++) {
+    ASSERT_FALSE(GetNextFrameAndDecodeAhead(*cached_codec).isNull());
+  }
+  ASSERT_EQ(GetDecodeCount(*cached_codec), static_cast<size_t>(frame_count));
+}
+
+TEST_F(ImageDecoderFixtureTest,
+       MultiFrameCodecCompositesOntoEvictedRequiredFrames) {
+  auto gif_mapping = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif_mapping);
+  auto reference_codec = SkCodec::MakeFromData(gif_mapping);
+  ASSERT_TRUE(reference_codec);
+  const std::vector<SkCodec::FrameInfo> frame_infos =
+      reference_codec->getFrameInfo();
+
+  // Find a frame that requires a frame other than frame 0, which is the only
+  // one decoded before it.
+  auto codec = fml::MakeRefCounted<MultiFrameCodec>(
+      SkCodec::MakeFromData(gif_mapping));
+  ASSERT_FALSE(GetFrame(*codec, 0).isNull());
+  int frame_index = -1;
+  for (int i = 2; i < static_cast<int>(frame_infos.size()); i++) {
+    if (frame_infos[i].fRequiredFrame > 0) {
+      frame_index = i;
+      break;
+    }
+  }
+  ASSERT_GE(frame_index, 0);
+
+  // Only frame 0 was decoded, so the required frame has to be decoded again.
+  SkBitmap frame = GetFrame(*codec, frame_index);
+  ASSERT_TRUE(HaveSamePixels(
+      frame, DecodeFrameFromScratch(*reference_codec, frame_index)));
+}
+
 }  // namespace testing
 }  // namespace flutter
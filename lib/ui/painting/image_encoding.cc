@@ -12,10 +12,9 @@
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/png_encoder.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "third_party/skia/include/core/SkCanvas.h"
-#include "third_party/skia/include/core/SkEncodedImageFormat.h"
-#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/logging/dart_invoke.h"
@@ -28,13 +27,6 @@ using tonic::ToDart;
 namespace flutter {
 namespace {
 
-// This must be kept in sync with the enum in painting.dart
-enum ImageByteFormat {
-  kRawRGBA,
-  kRawUnmodified,
-  kPNG,
-};
-
 void InvokeDataCallback(std::unique_ptr<DartPersistentValue> callback,
                         sk_sp<SkData> buffer) {
   std::shared_ptr<tonic::DartState> dart_state = callback->dart_state().lock();
@@ -45,8 +37,14 @@ void InvokeDataCallback(std::unique_ptr<DartPersistentValue> callback,
   if (!buffer) {
     DartInvoke(callback->value(), {Dart_Null()});
   } else {
-    Dart_Handle dart_data = tonic::DartConverter<tonic::Uint8List>::ToDart(
-        buffer->bytes(), buffer->size());
+    // The encoded bytes are not shared with anything else, so they are handed
+    // to Dart without a copy. The list keeps a reference to them.
+    const size_t size = buffer->size();
+    void* bytes = const_cast<void*>(buffer->data());
+    Dart_Handle dart_data = Dart_NewExternalTypedDataWithFinalizer(
+        Dart_TypedData_kUint8, bytes, size, buffer.release(), size,
+        [](void* isolate_callback_data, Dart_WeakPersistentHandle handle,
+           void* peer) { static_cast<SkData*>(peer)->unref(); });
     DartInvoke(callback->value(), {dart_data});
   }
 }
@@ -150,59 +148,37 @@ sk_sp<SkData> CopyImageByteData(sk_sp<SkImage> raster_image,
     return nullptr;
   }
 
-  // The color types already match. No need to swizzle. Return early.
-  if (pixmap.colorType() == color_type) {
-    return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
-  }
-
-  // Perform swizzle if the type doesnt match the specification.
-  auto surface = SkSurface::MakeRaster(
-      SkImageInfo::Make(raster_image->width(), raster_image->height(),
-                        color_type, kPremul_SkAlphaType, nullptr));
-
-  if (!surface) {
-    FML_LOG(ERROR) << "Could not setup the surface for swizzle.";
+  // Copy the pixels straight into the buffer that is handed to Dart, and
+  // swizzle them on the way if the color types do not match.
+  const SkImageInfo info =
+      pixmap.colorType() == color_type
+          ? pixmap.info()
+          : SkImageInfo::Make(raster_image->width(), raster_image->height(),
+                              color_type, kPremul_SkAlphaType, nullptr);
+  sk_sp<SkData> data = SkData::MakeUninitialized(info.computeMinByteSize());
+  if (!pixmap.readPixels(info, data->writable_data(), info.minRowBytes())) {
+    FML_LOG(ERROR) << "Could not copy the pixels of the raster image.";
     return nullptr;
   }
 
-  surface->writePixels(pixmap, 0, 0);
-
-  if (!surface->peekPixels(&pixmap)) {
-    FML_LOG(ERROR) << "Pixel address is not available.";
-    return nullptr;
-  }
-
-  return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
+  return data;
 }
 
-sk_sp<SkData> EncodeImage(sk_sp<SkImage> raster_image, ImageByteFormat format) {
-  TRACE_EVENT0("flutter", __FUNCTION__);
-
-  if (!raster_image) {
-    return nullptr;
+sk_sp<SkData> EncodeImageAsPNG(
+    sk_sp<SkImage> raster_image,
+    int compression_level,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner) {
+  SkPixmap pixmap;
+  sk_sp<SkData> png_image;
+  if (raster_image->peekPixels(&pixmap)) {
+    png_image = EncodePNG(pixmap, compression_level, concurrent_task_runner);
   }
 
-  switch (format) {
-    case kPNG: {
-      auto png_image =
-          raster_image->encodeToData(SkEncodedImageFormat::kPNG, 0);
-
-      if (png_image == nullptr) {
-        FML_LOG(ERROR) << "Could not convert raster image to PNG.";
-        return nullptr;
-      };
-      return png_image;
-    } break;
-    case kRawRGBA: {
-      return CopyImageByteData(raster_image, kRGBA_8888_SkColorType);
-    } break;
-    case kRawUnmodified: {
-      return CopyImageByteData(raster_image, raster_image->colorType());
-    } break;
+  if (png_image == nullptr) {
+    FML_LOG(ERROR) << "Could not convert raster image to PNG.";
+    return nullptr;
   }
-
-  FML_LOG(ERROR) << "Unknown error encoding image.";
-  return nullptr;
+  return png_image;
 }
 
 void EncodeImageAndInvokeDataCallback(
@@ -212,6 +188,7 @@ void EncodeImageAndInvokeDataCallback(
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
     fml::RefPtr<fml::TaskRunner> raster_task_runner,
     fml::RefPtr<fml::TaskRunner> io_task_runner,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     GrContext* resource_context,
     fml::WeakPtr<SnapshotDelegate> snapshot_delegate) {
   auto callback_task = fml::MakeCopyable(
@@ -219,20 +196,70 @@ void EncodeImageAndInvokeDataCallback(
         InvokeDataCallback(std::move(callback), std::move(encoded));
       });
 
-  auto encode_task = [callback_task = std::move(callback_task), format,
-                      ui_task_runner](sk_sp<SkImage> raster_image) {
-    sk_sp<SkData> encoded = EncodeImage(std::move(raster_image), format);
+  auto encode = [callback_task = std::move(callback_task), format,
+                 ui_task_runner,
+                 concurrent_task_runner](sk_sp<SkImage> raster_image) {
+    sk_sp<SkData> encoded =
+        EncodeImage(std::move(raster_image), format, concurrent_task_runner);
     ui_task_runner->PostTask(
         [callback_task = std::move(callback_task),
          encoded = std::move(encoded)] { callback_task(encoded); });
   };
 
+  // Encode on a worker rather than on the IO thread, which uploads images.
+  auto encode_task = [encode = std::move(encode),
+                      concurrent_task_runner](sk_sp<SkImage> raster_image) {
+    if (!concurrent_task_runner) {
+      encode(std::move(raster_image));
+      return;
+    }
+    concurrent_task_runner->PostTask(
+        [encode, raster_image = std::move(raster_image)] {
+          encode(raster_image);
+        });
+  };
+
   ConvertImageToRaster(std::move(image), encode_task, raster_task_runner,
                        io_task_runner, resource_context, snapshot_delegate);
 }
 
 }  // namespace
 
+sk_sp<SkData> EncodeImage(
+    sk_sp<SkImage> raster_image,
+    ImageByteFormat format,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+
+  if (!raster_image) {
+    return nullptr;
+  }
+
+  switch (format) {
+    case kPNG: {
+      return EncodeImageAsPNG(std::move(raster_image), 6,
+                              concurrent_task_runner);
+    } break;
+    case kPNGFast: {
+      return EncodeImageAsPNG(std::move(raster_image), 1,
+                              concurrent_task_runner);
+    } break;
+    case kPNGUncompressed: {
+      return EncodeImageAsPNG(std::move(raster_image), 0,
+                              concurrent_task_runner);
+    } break;
+    case kRawRGBA: {
+      return CopyImageByteData(raster_image, kRGBA_8888_SkColorType);
+    } break;
+    case kRawUnmodified: {
+      return CopyImageByteData(raster_image, raster_image->colorType());
+    } break;
+  }
+
+  FML_LOG(ERROR) << "Unknown error encoding image.";
+  return nullptr;
+}
+
 Dart_Handle EncodeImage(CanvasImage* canvas_image,
                         int format,
                         Dart_Handle callback_handle) {
@@ -254,13 +281,16 @@ Dart_Handle EncodeImage(CanvasImage* canvas_image,
        image_format, ui_task_runner = task_runners.GetUITaskRunner(),
        raster_task_runner = task_runners.GetRasterTaskRunner(),
        io_task_runner = task_runners.GetIOTaskRunner(),
+       concurrent_task_runner =
+           UIDartState::Current()->GetConcurrentTaskRunner(),
        io_manager = UIDartState::Current()->GetIOManager(),
        snapshot_delegate =
            UIDartState::Current()->GetSnapshotDelegate()]() mutable {
         EncodeImageAndInvokeDataCallback(
             std::move(image), std::move(callback), image_format,
             std::move(ui_task_runner), std::move(raster_task_runner),
-            std::move(io_task_runner), io_manager->GetResourceContext().get(),
+            std::move(io_task_runner), std::move(concurrent_task_runner),
+            io_manager->GetResourceContext().get(),
             std::move(snapshot_delegate));
       }));
 
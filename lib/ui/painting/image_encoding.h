@@ -5,12 +5,34 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_H_
 
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/tonic/dart_library_natives.h"
 
 namespace flutter {
 
 class CanvasImage;
 
+// This must be kept in sync with the enum in painting.dart
+enum ImageByteFormat {
+  kRawRGBA,
+  kRawUnmodified,
+  kPNG,
+  kPNGFast,
+  kPNGUncompressed,
+};
+
+// Encodes a raster image in the given format. The PNG formats are compressed
+// on the calling thread and, if there is a |concurrent_task_runner|, on its
+// workers.
+sk_sp<SkData> EncodeImage(
+    sk_sp<SkImage> raster_image,
+    ImageByteFormat format,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner);
+
 Dart_Handle EncodeImage(CanvasImage* canvas_image,
                         int format,
                         Dart_Handle callback_handle);
@@ -0,0 +1,498 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/incremental_image_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/tonic/dart_binding_macros.h"
+#include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/logging/dart_invoke.h"
+
+namespace flutter {
+namespace {
+
+// Reads |ChunkedImageData| for an SkCodec. Reads stop at the end of the bytes
+// received so far, which codecs that decode incrementally report as incomplete
+// input. The end of the stream is only reported once the data is closed.
+class ChunkedImageDataStream : public SkStreamRewindable {
+ public:
+  explicit ChunkedImageDataStream(std::shared_ptr<const ChunkedImageData> data)
+      : data_(std::move(data)) {}
+
+  size_t read(void* buffer, size_t size) override {
+    if (buffer == nullptr) {
+      // Skips the bytes.
+      size = std::min(size, data_->GetSize() - position_);
+    } else {
+      size = data_->Read(position_, buffer, size);
+    }
+    position_ += size;
+    return size;
+  }
+
+  size_t peek(void* buffer, size_t size) const override {
+    return data_->Read(position_, buffer, size);
+  }
+
+  bool isAtEnd() const override {
+    return data_->IsClosed() && position_ >= data_->GetSize();
+  }
+
+  bool rewind() override {
+    position_ = 0;
+    return true;
+  }
+
+  bool hasPosition() const override { return true; }
+
+  size_t getPosition() const override { return position_; }
+
+ private:
+  const std::shared_ptr<const ChunkedImageData> data_;
+  size_t position_ = 0;
+
+  SkStreamRewindable* onDuplicate() const override {
+    return new ChunkedImageDataStream(data_);
+  }
+};
+
+}  // namespace
+
+ChunkedImageData::ChunkedImageData() = default;
+
+ChunkedImageData::~ChunkedImageData() = default;
+
+void ChunkedImageData::AddChunk(sk_sp<SkData> chunk) {
+  if (!chunk || chunk->size() == 0) {
+    return;
+  }
+  std::scoped_lock lock(mutex_);
+  if (closed_) {
+    FML_DLOG(WARNING) << "Ignoring image data added after it was closed.";
+    return;
+  }
+  offsets_.push_back(size_);
+  size_ += chunk->size();
+  chunks_.push_back(std::move(chunk));
+}
+
+void ChunkedImageData::Close() {
+  std::scoped_lock lock(mutex_);
+  closed_ = true;
+}
+
+bool ChunkedImageData::IsClosed() const {
+  std::scoped_lock lock(mutex_);
+  return closed_;
+}
+
+size_t ChunkedImageData::GetSize() const {
+  std::scoped_lock lock(mutex_);
+  return size_;
+}
+
+size_t ChunkedImageData::Read(size_t offset, void* buffer, size_t size) const {
+  std::scoped_lock lock(mutex_);
+  if (offset >= size_) {
+    return 0;
+  }
+  // The last chunk that starts at or before |offset|.
+  size_t index =
+      std::upper_bound(offsets_.begin(), offsets_.end(), offset) -
+      offsets_.begin() - 1;
+  uint8_t* destination = static_cast<uint8_t*>(buffer);
+  size_t copied = 0;
+  while (copied < size && index < chunks_.size()) {
+    const SkData& chunk = *chunks_[index];
+    const size_t chunk_offset = offset + copied - offsets_[index];
+    const size_t count = std::min(size - copied, chunk.size() - chunk_offset);
+    memcpy(destination + copied, chunk.bytes() + chunk_offset, count);
+    copied += count;
+    index++;
+  }
+  return copied;
+}
+
+void ChunkedImageData::Release() {
+  std::scoped_lock lock(mutex_);
+  closed_ = true;
+  chunks_.clear();
+  offsets_.clear();
+  size_ = 0;
+}
+
+sk_sp<SkData> ChunkedImageData::CopyToData() const {
+  std::scoped_lock lock(mutex_);
+  sk_sp<SkData> data = SkData::MakeUninitialized(size_);
+  uint8_t* destination = static_cast<uint8_t*>(data->writable_data());
+  for (size_t i = 0; i < chunks_.size(); i++) {
+    memcpy(destination + offsets_[i], chunks_[i]->data(), chunks_[i]->size());
+  }
+  return data;
+}
+
+IncrementalImageDecode::IncrementalImageDecode(
+    std::shared_ptr<const ChunkedImageData> data)
+    : data_(std::move(data)) {}
+
+IncrementalImageDecode::~IncrementalImageDecode() = default;
+
+IncrementalImageDecode::Status IncrementalImageDecode::Decode() {
+  if (status_ == Status::kComplete || status_ == Status::kError) {
+    return status_;
+  }
+  TRACE_EVENT0("flutter", "IncrementalImageDecode::Decode");
+  // Read once, so that the data cannot be closed between the checks below.
+  const bool closed = data_->IsClosed();
+
+  if (!codec_ && !buffered_) {
+    SkCodec::Result result;
+    codec_ = SkCodec::MakeFromStream(
+        std::make_unique<ChunkedImageDataStream>(data_), &result);
+    if (!codec_) {
+      if (result == SkCodec::kIncompleteInput && !closed) {
+        return status_ = Status::kNeedsMoreData;
+      }
+      FML_LOG(ERROR) << "Could not create a codec for the image data.";
+      return Fail();
+    }
+    // The other codecs may read all of the data up front when they are
+    // created, and could not decode the data that arrives later.
+    const SkEncodedImageFormat format = codec_->getEncodedFormat();
+    if (format != SkEncodedImageFormat::kPNG &&
+        format != SkEncodedImageFormat::kGIF) {
+      buffered_ = true;
+      codec_.reset();
+    }
+  }
+
+  if (buffered_) {
+    if (!closed) {
+      return status_ = Status::kNeedsMoreData;
+    }
+    // Decoding the whole image through SkImage respects its EXIF orientation.
+    sk_sp<SkImage> image = SkImage::MakeFromEncoded(data_->CopyToData());
+    image = image ? image->makeRasterImage() : nullptr;
+    if (!image) {
+      FML_LOG(ERROR) << "Could not decode the image data.";
+      return Fail();
+    }
+    return Complete(std::move(image));
+  }
+
+  if (!started_) {
+    SkImageInfo info = codec_->getInfo().makeColorType(kN32_SkColorType);
+    if (info.alphaType() == kUnpremul_SkAlphaType) {
+      info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    if (!bitmap_.tryAllocPixels(info)) {
+      FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
+                     << info.computeMinByteSize() << "B";
+      return Fail();
+    }
+    bitmap_.eraseColor(SK_ColorTRANSPARENT);
+    const SkCodec::Result result = codec_->startIncrementalDecode(
+        info, bitmap_.getPixels(), bitmap_.rowBytes());
+    if (result == SkCodec::kIncompleteInput && !closed) {
+      return status_ = Status::kNeedsMoreData;
+    }
+    if (result != SkCodec::kSuccess) {
+      FML_LOG(ERROR) << "Could not start decoding the image data: "
+                     << SkCodec::ResultToString(result);
+      return Fail();
+    }
+    started_ = true;
+  }
+
+  int rows_decoded = 0;
+  const SkCodec::Result result = codec_->incrementalDecode(&rows_decoded);
+  if (result == SkCodec::kSuccess ||
+      (result == SkCodec::kIncompleteInput && closed)) {
+    // Like a decode of the complete data, a truncated image keeps the rows
+    // that could be decoded.
+    bitmap_.setImmutable();
+    return Complete(SkImage::MakeFromBitmap(bitmap_));
+  }
+  if (result != SkCodec::kIncompleteInput) {
+    FML_LOG(ERROR) << "Could not decode the image data: "
+                   << SkCodec::ResultToString(result);
+    return Fail();
+  }
+  if (rows_decoded > rows_decoded_) {
+    rows_decoded_ = rows_decoded;
+    return status_ = Status::kPartial;
+  }
+  return status_ = Status::kNeedsMoreData;
+}
+
+sk_sp<SkImage> IncrementalImageDecode::MakeImage() const {
+  if (status_ == Status::kComplete) {
+    return image_;
+  }
+  if (rows_decoded_ == 0) {
+    return nullptr;
+  }
+  // The bitmap is still being decoded into.
+  return SkImage::MakeRasterCopy(bitmap_.pixmap());
+}
+
+IncrementalImageDecode::Status IncrementalImageDecode::Fail() {
+  codec_.reset();
+  bitmap_.reset();
+  return status_ = Status::kError;
+}
+
+IncrementalImageDecode::Status IncrementalImageDecode::Complete(
+    sk_sp<SkImage> image) {
+  codec_.reset();
+  bitmap_.reset();
+  image_ = std::move(image);
+  return status_ = Status::kComplete;
+}
+
+// The decode shared between the Dart object on the UI thread, the decode
+// steps on the worker threads and the uploads on the IO thread.
+struct IncrementalImageDecoder::State
+    : public std::enable_shared_from_this<State> {
+  using Callback = std::function<void(SkiaGPUObject<SkImage>, bool)>;
+
+  State(std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+        fml::RefPtr<fml::TaskRunner> io_task_runner,
+        fml::WeakPtr<IOManager> io_manager,
+        bool emit_intermediate_images,
+        Callback callback)
+      : data_(std::make_shared<ChunkedImageData>()),
+        decode_(data_),
+        concurrent_task_runner_(std::move(concurrent_task_runner)),
+        io_task_runner_(std::move(io_task_runner)),
+        io_manager_(std::move(io_manager)),
+        emit_intermediate_images_(emit_intermediate_images),
+        callback_(std::move(callback)) {}
+
+  const std::shared_ptr<ChunkedImageData> data_;
+  // Only used by the decode step that is running.
+  IncrementalImageDecode decode_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  const fml::RefPtr<fml::TaskRunner> io_task_runner_;
+  const fml::WeakPtr<IOManager> io_manager_;
+  const bool emit_intermediate_images_;
+  // Invoked on the IO thread with the uploaded images.
+  const Callback callback_;
+  std::atomic_bool cancelled_{false};
+  // Whether an intermediate image is being uploaded. Intermediate images are
+  // skipped while one is, so that uploads do not fall behind the decode.
+  std::atomic_bool uploading_intermediate_image_{false};
+
+  // Guards the members below.
+  std::mutex mutex_;
+  bool step_running_ = false;
+  // Whether data was added since the running step last looked at it.
+  bool data_added_ = false;
+
+  // Decodes the data that was added, unless a step doing so is running.
+  void ScheduleStep() {
+    {
+      std::scoped_lock lock(mutex_);
+      data_added_ = true;
+      if (step_running_) {
+        return;
+      }
+      step_running_ = true;
+    }
+    auto step = [state = shared_from_this()]() { state->Step(); };
+    if (concurrent_task_runner_) {
+      concurrent_task_runner_->PostTask(step,
+                                        fml::ConcurrentTaskPriority::kHigh);
+    } else {
+      io_task_runner_->PostTask(step);
+    }
+  }
+
+  // On Worker.
+  void Step() {
+    while (true) {
+      {
+        std::scoped_lock lock(mutex_);
+        if (!data_added_ || cancelled_) {
+          step_running_ = false;
+          return;
+        }
+        data_added_ = false;
+      }
+
+      IncrementalImageDecode::Status status;
+      while ((status = decode_.Decode()) ==
+             IncrementalImageDecode::Status::kPartial) {
+        if (emit_intermediate_images_ && !uploading_intermediate_image_) {
+          uploading_intermediate_image_ = true;
+          Upload(decode_.MakeImage(), false);
+        }
+      }
+
+      if (status == IncrementalImageDecode::Status::kComplete) {
+        Upload(decode_.MakeImage(), true);
+      } else if (status == IncrementalImageDecode::Status::kError) {
+        io_task_runner_->PostTask(
+            [state = shared_from_this()]() { state->callback_({}, true); });
+      }
+      // Nothing is left to decode, so no more steps need to run.
+      if (status != IncrementalImageDecode::Status::kNeedsMoreData) {
+        cancelled_ = true;
+        data_->Release();
+      }
+    }
+  }
+
+  void Upload(sk_sp<SkImage> image, bool is_complete) {
+    io_task_runner_->PostTask([state = shared_from_this(), image,
+                               is_complete]() mutable {
+      TRACE_EVENT0("flutter", "IncrementalImageDecoder::Upload");
+      fml::tracing::TraceFlow flow(__FUNCTION__);
+      SkiaGPUObject<SkImage> uploaded;
+      if (!state->io_manager_) {
+        FML_LOG(ERROR) << "Could not acquire IO manager.";
+      } else if (!state->io_manager_->GetResourceContext()) {
+        // As in |ImageDecoder|, the raster image is used as-is without a
+        // resource context.
+        uploaded = {std::move(image),
+                    state->io_manager_->GetSkiaUnrefQueue()};
+      } else {
+        uploaded =
+            UploadRasterImage(std::move(image), state->io_manager_, flow);
+      }
+      if (!is_complete) {
+        state->uploading_intermediate_image_ = false;
+        if (!uploaded.get()) {
+          return;
+        }
+      }
+      state->callback_(std::move(uploaded), is_complete);
+    });
+  }
+};
+
+static void IncrementalImageDecoder_constructor(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  DartCallConstructor(&IncrementalImageDecoder::Create, args);
+}
+
+IMPLEMENT_WRAPPERTYPEINFO(ui, IncrementalImageDecoder);
+
+#define FOR_EACH_BINDING(V)            \
+  V(IncrementalImageDecoder, addChunk) \
+  V(IncrementalImageDecoder, close)    \
+  V(IncrementalImageDecoder, dispose)
+
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void IncrementalImageDecoder::RegisterNatives(
+    tonic::DartLibraryNatives* natives) {
+  natives->Register({{"IncrementalImageDecoder_constructor",
+                      IncrementalImageDecoder_constructor, 3, true},
+                     FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+fml::RefPtr<IncrementalImageDecoder> IncrementalImageDecoder::Create(
+    Dart_Handle callback,
+    bool emit_intermediate_images) {
+  return fml::MakeRefCounted<IncrementalImageDecoder>(
+      callback, emit_intermediate_images);
+}
+
+IncrementalImageDecoder::IncrementalImageDecoder(Dart_Handle callback,
+                                                 bool emit_intermediate_images)
+    : callback_(UIDartState::Current(), callback), weak_factory_(this) {
+  UIDartState* dart_state = UIDartState::Current();
+  const TaskRunners& task_runners = dart_state->GetTaskRunners();
+  // Deliver the images to the UI thread, unless this object was collected in
+  // the meantime.
+  auto deliver = [ui_task_runner = task_runners.GetUITaskRunner(),
+                  weak_decoder = weak_factory_.GetWeakPtr()](
+                     SkiaGPUObject<SkImage> image, bool is_complete) {
+    ui_task_runner->PostTask(fml::MakeCopyable(
+        [weak_decoder, image = std::move(image), is_complete]() mutable {
+          if (weak_decoder) {
+            weak_decoder->InvokeCallback(std::move(image), is_complete);
+          }
+        }));
+  };
+  state_ = std::make_shared<State>(dart_state->GetConcurrentTaskRunner(),
+                                   task_runners.GetIOTaskRunner(),
+                                   dart_state->GetIOManager(),
+                                   emit_intermediate_images, deliver);
+}
+
+IncrementalImageDecoder::~IncrementalImageDecoder() {
+  state_->cancelled_ = true;
+}
+
+void IncrementalImageDecoder::addChunk(const tonic::Uint8List& chunk) {
+  if (callback_.is_empty()) {
+    return;
+  }
+  state_->data_->AddChunk(
+      SkData::MakeWithCopy(chunk.data(), chunk.num_elements()));
+  state_->ScheduleStep();
+}
+
+void IncrementalImageDecoder::close() {
+  if (callback_.is_empty()) {
+    return;
+  }
+  // Callers may keep only what the callback completes, so the decoder must
+  // not be cancelled once its Dart object is collected.
+  pending_decode_ref_ = fml::RefPtr<IncrementalImageDecoder>(this);
+  state_->data_->Close();
+  state_->ScheduleStep();
+}
+
+void IncrementalImageDecoder::dispose() {
+  // Released when this method returns, as it may be the last reference.
+  fml::RefPtr<IncrementalImageDecoder> pending_decode_ref =
+      std::move(pending_decode_ref_);
+  state_->cancelled_ = true;
+  callback_.Clear();
+  ClearDartWrapper();
+}
+
+void IncrementalImageDecoder::InvokeCallback(SkiaGPUObject<SkImage> image,
+                                             bool is_complete) {
+  // Released when this method returns, as it may be the last reference.
+  fml::RefPtr<IncrementalImageDecoder> pending_decode_ref;
+  if (is_complete) {
+    pending_decode_ref = std::move(pending_decode_ref_);
+  }
+  if (callback_.is_empty()) {
+    return;
+  }
+  std::shared_ptr<tonic::DartState> dart_state = callback_.dart_state().lock();
+  if (!dart_state) {
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state);
+
+  Dart_Handle image_handle = Dart_Null();
+  if (image.get()) {
+    fml::RefPtr<CanvasImage> canvas_image = CanvasImage::Create();
+    canvas_image->set_image(std::move(image));
+    image_handle = tonic::ToDart(canvas_image);
+  }
+  // The callback may dispose of this decoder.
+  Dart_Handle callback = callback_.value();
+  if (is_complete) {
+    callback_.Clear();
+  }
+  tonic::DartInvoke(callback, {image_handle, tonic::ToDart(is_complete)});
+}
+
+}  // namespace flutter
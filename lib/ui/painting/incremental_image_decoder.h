@@ -0,0 +1,159 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DECODER_H_
+#define FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DECODER_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/lib/ui/dart_wrapper.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/tonic/dart_persistent_value.h"
+#include "third_party/tonic/typed_data/typed_list.h"
+
+namespace tonic {
+class DartLibraryNatives;
+}  // namespace tonic
+
+namespace flutter {
+
+// Encoded image data that is received in chunks. Chunks may be added on one
+// thread while the data is read on others.
+class ChunkedImageData {
+ public:
+  ChunkedImageData();
+
+  ~ChunkedImageData();
+
+  void AddChunk(sk_sp<SkData> chunk);
+
+  // Marks the data as complete. Chunks added afterwards are ignored.
+  void Close();
+
+  bool IsClosed() const;
+
+  // The number of bytes received so far.
+  size_t GetSize() const;
+
+  // Copies up to |size| of the bytes received so far, starting at |offset|,
+  // to |buffer|. Returns the number of bytes copied.
+  size_t Read(size_t offset, void* buffer, size_t size) const;
+
+  // Returns a contiguous copy of the bytes received so far.
+  sk_sp<SkData> CopyToData() const;
+
+  // Closes the data and drops the bytes received, once they are no longer
+  // needed.
+  void Release();
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<sk_sp<SkData>> chunks_;
+  // The offset of each chunk in the data.
+  std::vector<size_t> offsets_;
+  size_t size_ = 0;
+  bool closed_ = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ChunkedImageData);
+};
+
+// Decodes an image from |ChunkedImageData| while its chunks arrive.
+//
+// PNG and GIF images are decoded with the incremental decoding of SkCodec, so
+// the rows of the image are decoded as soon as their data arrives. Other
+// formats are decoded once all of the data was received.
+//
+// Calls must be serialized, but may happen on any thread.
+class IncrementalImageDecode {
+ public:
+  enum class Status {
+    // Nothing more can be decoded until more data arrives.
+    kNeedsMoreData,
+    // More rows of the image were decoded, but not all of them.
+    kPartial,
+    kComplete,
+    kError,
+  };
+
+  explicit IncrementalImageDecode(std::shared_ptr<const ChunkedImageData> data);
+
+  ~IncrementalImageDecode();
+
+  // Decodes as much of the image as the data received so far allows.
+  Status Decode();
+
+  // Returns a raster image of what was decoded so far, where rows that were
+  // not decoded yet are transparent. Returns null before the first partial or
+  // complete status.
+  sk_sp<SkImage> MakeImage() const;
+
+ private:
+  const std::shared_ptr<const ChunkedImageData> data_;
+  Status status_ = Status::kNeedsMoreData;
+  std::unique_ptr<SkCodec> codec_;
+  // Whether the image is decoded only once all of the data was received.
+  bool buffered_ = false;
+  bool started_ = false;
+  SkBitmap bitmap_;
+  int rows_decoded_ = 0;
+  sk_sp<SkImage> image_;
+
+  Status Fail();
+
+  Status Complete(sk_sp<SkImage> image);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(IncrementalImageDecode);
+};
+
+// Decodes an image from encoded data that is added in chunks, such as the body
+// of a network response, on the concurrent worker threads. The Dart callback
+// is invoked on the UI thread with intermediate images if requested, and with
+// the complete image or null on failure.
+class IncrementalImageDecoder
+    : public RefCountedDartWrappable<IncrementalImageDecoder> {
+  DEFINE_WRAPPERTYPEINFO();
+  FML_FRIEND_MAKE_REF_COUNTED(IncrementalImageDecoder);
+
+ public:
+  static fml::RefPtr<IncrementalImageDecoder> Create(
+      Dart_Handle callback,
+      bool emit_intermediate_images);
+
+  ~IncrementalImageDecoder() override;
+
+  void addChunk(const tonic::Uint8List& chunk);
+
+  void close();
+
+  void dispose();
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  struct State;
+
+  tonic::DartPersistentValue callback_;
+  std::shared_ptr<State> state_;
+  // Keeps this decoder alive from |close| until the final callback, so that
+  // the decode completes even if the Dart object is collected in the
+  // meantime.
+  fml::RefPtr<IncrementalImageDecoder> pending_decode_ref_;
+  fml::WeakPtrFactory<IncrementalImageDecoder> weak_factory_;
+
+  IncrementalImageDecoder(Dart_Handle callback, bool emit_intermediate_images);
+
+  void InvokeCallback(SkiaGPUObject<SkImage> image, bool is_complete);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DECODER_H_
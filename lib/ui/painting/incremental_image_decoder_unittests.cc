@@ -0,0 +1,161 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/incremental_image_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<SkData> OpenFixtureAsSkData(const char* name) {
+  auto fixtures_directory =
+      fml::OpenDirectory(GetFixturesPath(), false, fml::FilePermission::kRead);
+  if (!fixtures_directory.is_valid()) {
+    return nullptr;
+  }
+  auto fixture_mapping =
+      fml::FileMapping::CreateReadOnly(fixtures_directory, name);
+  if (!fixture_mapping) {
+    return nullptr;
+  }
+  return SkData::MakeWithCopy(fixture_mapping->GetMapping(),
+                              fixture_mapping->GetSize());
+}
+
+// Adds |size| bytes of |data|, starting at |offset|, as one chunk.
+void AddChunk(ChunkedImageData& chunked_data,
+              const sk_sp<SkData>& data,
+              size_t offset,
+              size_t size) {
+  chunked_data.AddChunk(SkData::MakeWithCopy(data->bytes() + offset, size));
+}
+
+}  // namespace
+
+TEST(ChunkedImageDataTest, ReadsAcrossChunks) {
+  ChunkedImageData data;
+  data.AddChunk(SkData::MakeWithCString("abc"));
+  data.AddChunk(SkData::MakeEmpty());
+  data.AddChunk(SkData::MakeWithCopy("defg", 4));
+  // |MakeWithCString| includes the terminating null.
+  ASSERT_EQ(data.GetSize(), 8u);
+  ASSERT_FALSE(data.IsClosed());
+
+  char buffer[8] = {};
+  ASSERT_EQ(data.Read(2, buffer, 4), 4u);
+  ASSERT_EQ(std::memcmp(buffer, "c\0de", 4), 0);
+  ASSERT_EQ(data.Read(6, buffer, 8), 2u);
+  ASSERT_EQ(std::memcmp(buffer, "fg", 2), 0);
+  ASSERT_EQ(data.Read(8, buffer, 8), 0u);
+
+  auto copy = data.CopyToData();
+  ASSERT_EQ(copy->size(), 8u);
+  ASSERT_EQ(std::memcmp(copy->data(), "abc\0defg", 8), 0);
+}
+
+TEST(ChunkedImageDataTest, IgnoresChunksOnceClosed) {
+  ChunkedImageData data;
+  data.AddChunk(SkData::MakeWithCopy("abc", 3));
+  data.Close();
+  ASSERT_TRUE(data.IsClosed());
+  data.AddChunk(SkData::MakeWithCopy("def", 3));
+  ASSERT_EQ(data.GetSize(), 3u);
+
+  data.Release();
+  ASSERT_EQ(data.GetSize(), 0u);
+}
+
+TEST(IncrementalImageDecodeTest, DecodesPngWhileDataArrives) {
+  auto encoded = OpenFixtureAsSkData("Horizontal.png");
+  ASSERT_TRUE(encoded != nullptr);
+
+  auto data = std::make_shared<ChunkedImageData>();
+  IncrementalImageDecode decode(data);
+  ASSERT_EQ(decode.Decode(), IncrementalImageDecode::Status::kNeedsMoreData);
+  ASSERT_EQ(decode.MakeImage(), nullptr);
+
+  const size_t chunk_size = 1024;
+  bool decoded_partially = false;
+  for (size_t offset = 0; offset < encoded->size(); offset += chunk_size) {
+    AddChunk(*data, encoded, offset,
+             std::min(chunk_size, encoded->size() - offset));
+    auto status = decode.Decode();
+    ASSERT_TRUE(status == IncrementalImageDecode::Status::kNeedsMoreData ||
+                status == IncrementalImageDecode::Status::kPartial ||
+                status == IncrementalImageDecode::Status::kComplete);
+    if (status == IncrementalImageDecode::Status::kPartial) {
+      decoded_partially = true;
+      auto image = decode.MakeImage();
+      ASSERT_TRUE(image != nullptr);
+      ASSERT_EQ(image->dimensions(), SkISize::Make(300, 100));
+    }
+  }
+  ASSERT_TRUE(decoded_partially);
+
+  data->Close();
+  ASSERT_EQ(decode.Decode(), IncrementalImageDecode::Status::kComplete);
+  auto image = decode.MakeImage();
+  ASSERT_TRUE(image != nullptr);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(300, 100));
+
+  auto expected = SkImage::MakeFromEncoded(encoded)->makeRasterImage();
+  SkBitmap expected_bitmap;
+  ASSERT_TRUE(expected_bitmap.tryAllocPixels(image->imageInfo()));
+  ASSERT_TRUE(expected->readPixels(expected_bitmap.pixmap(), 0, 0));
+  SkBitmap bitmap;
+  ASSERT_TRUE(bitmap.tryAllocPixels(image->imageInfo()));
+  ASSERT_TRUE(image->readPixels(bitmap.pixmap(), 0, 0));
+  ASSERT_EQ(std::memcmp(bitmap.getPixels(), expected_bitmap.getPixels(),
+                        bitmap.computeByteSize()),
+            0);
+}
+
+TEST(IncrementalImageDecodeTest, DecodesJpegOnceDataIsComplete) {
+  auto encoded = OpenFixtureAsSkData("Horizontal.jpg");
+  ASSERT_TRUE(encoded != nullptr);
+
+  auto data = std::make_shared<ChunkedImageData>();
+  IncrementalImageDecode decode(data);
+  const size_t half = encoded->size() / 2;
+  AddChunk(*data, encoded, 0, half);
+  ASSERT_EQ(decode.Decode(), IncrementalImageDecode::Status::kNeedsMoreData);
+  AddChunk(*data, encoded, half, encoded->size() - half);
+  ASSERT_EQ(decode.Decode(), IncrementalImageDecode::Status::kNeedsMoreData);
+  ASSERT_EQ(decode.MakeImage(), nullptr);
+
+  data->Close();
+  ASSERT_EQ(decode.Decode(), IncrementalImageDecode::Status::kComplete);
+  auto image = decode.MakeImage();
+  ASSERT_TRUE(image != nullptr);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(600, 200));
+}
+
+TEST(IncrementalImageDecodeTest, FailsOnInvalidData) {
+  auto data = std::make_shared<ChunkedImageData>();
+  IncrementalImageDecode decode(data);
+  data->AddChunk(SkData::MakeWithCString("This is not an image."));
+  data->Close();
+  ASSERT_EQ(decode.Decode(), IncrementalImageDecode::Status::kError);
+  ASSERT_EQ(decode.MakeImage(), nullptr);
+  // The result does not change once the decode failed.
+  ASSERT_EQ(decode.Decode(), IncrementalImageDecode::Status::kError);
+}
+
+TEST(IncrementalImageDecodeTest, FailsOnEmptyData) {
+  auto data = std::make_shared<ChunkedImageData>();
+  IncrementalImageDecode decode(data);
+  data->Close();
+  ASSERT_EQ(decode.Decode(), IncrementalImageDecode::Status::kError);
+}
+
+}  // namespace testing
+}  // namespace flutter
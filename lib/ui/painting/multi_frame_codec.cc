@@ -4,12 +4,38 @@
 
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
 #include "flutter/fml/make_copyable.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "third_party/tonic/logging/dart_invoke.h"
 
 namespace flutter {
+namespace {
+
+std::atomic_size_t frame_cache_count{MultiFrameCodec::kDefaultFrameCacheCount};
+std::atomic_size_t frame_cache_max_bytes{
+    MultiFrameCodec::kDefaultFrameCacheMaxBytes};
+
+SkImageInfo GetFrameInfo(const SkCodec& codec) {
+  SkImageInfo info = codec.getInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  return info;
+}
+
+}  // namespace
+
+void MultiFrameCodec::SetFrameCacheLimits(size_t frame_count,
+                                          size_t max_bytes) {
+  frame_cache_count = frame_count > 0 ? frame_count : kDefaultFrameCacheCount;
+  frame_cache_max_bytes =
+      max_bytes > 0 ? max_bytes : kDefaultFrameCacheMaxBytes;
+}
 
 MultiFrameCodec::MultiFrameCodec(std::unique_ptr<SkCodec> codec)
     : state_(new State(std::move(codec))) {}
@@ -20,6 +46,12 @@ MultiFrameCodec::State::State(std::unique_ptr<SkCodec> codec)
     : codec_(std::move(codec)),
       frameCount_(codec_->getFrameCount()),
       repetitionCount_(codec_->getRepetitionCount()),
+      frameInfos_(codec_->getFrameInfo()),
+      frameCacheCount_(
+          std::min<size_t>(frame_cache_count, std::max(frameCount_, 1))),
+      cacheAllFrames_(GetFrameInfo(*codec_).computeMinByteSize() *
+                          std::max(frameCount_, 1) <=
+                      frame_cache_max_bytes),
       nextFrameIndex_(0) {}
 
 static void InvokeNextFrameCallback(
@@ -73,49 +105,157 @@ static bool CopyToBitmap(SkBitmap* dst,
   return true;
 }
 
-sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
-    fml::WeakPtr<GrContext> resourceContext) {
+SkBitmap MultiFrameCodec::State::DecodeFrameLocked(int frameIndex) {
+  TRACE_EVENT0("flutter", "MultiFrameCodec::DecodeFrame");
   SkBitmap bitmap = SkBitmap();
-  SkImageInfo info = codec_->getInfo().makeColorType(kN32_SkColorType);
-  if (info.alphaType() == kUnpremul_SkAlphaType) {
-    info = info.makeAlphaType(kPremul_SkAlphaType);
+  SkImageInfo info = GetFrameInfo(*codec_);
+  if (!bitmap.tryAllocPixels(info)) {
+    FML_LOG(ERROR) << "Failed to allocate memory for frame " << frameIndex;
+    return SkBitmap();
   }
-  bitmap.allocPixels(info);
 
   SkCodec::Options options;
-  options.fFrameIndex = nextFrameIndex_;
-  SkCodec::FrameInfo frameInfo;
-  codec_->getFrameInfo(nextFrameIndex_, &frameInfo);
+  options.fFrameIndex = frameIndex;
+  const SkCodec::FrameInfo& frameInfo = frameInfos_[frameIndex];
   const int requiredFrameIndex = frameInfo.fRequiredFrame;
   if (requiredFrameIndex != SkCodec::kNoFrame) {
-    if (lastRequiredFrame_ == nullptr) {
-      FML_LOG(ERROR) << "Frame " << nextFrameIndex_ << " depends on frame "
-                     << requiredFrameIndex
-                     << " and no required frames are cached.";
-      return nullptr;
-    } else if (lastRequiredFrameIndex_ != requiredFrameIndex) {
-      FML_DLOG(INFO) << "Required frame " << requiredFrameIndex
-                     << " is not cached. Using " << lastRequiredFrameIndex_
-                     << " instead";
+    // The frame is composited onto the frame it requires if that is still
+    // decoded. Otherwise the codec decodes the required frames again, as
+    // compositing onto any other frame would give the wrong pixels.
+    SkBitmap requiredFrame;
+    {
+      std::scoped_lock lock(mutex_);
+      auto found = decodedFrames_.find(requiredFrameIndex);
+      if (found != decodedFrames_.end()) {
+        requiredFrame = found->second;
+      }
     }
-
-    if (lastRequiredFrame_->getPixels() &&
-        CopyToBitmap(&bitmap, lastRequiredFrame_->colorType(),
-                     *lastRequiredFrame_)) {
+    if (requiredFrame.isNull() && lastRequiredFrame_ != nullptr &&
+        lastRequiredFrameIndex_ == requiredFrameIndex) {
+      requiredFrame = *lastRequiredFrame_;
+    }
+    if (requiredFrame.isNull()) {
+      FML_DLOG(INFO) << "Required frame " << requiredFrameIndex
+                     << " is not cached. Decoding it again.";
+    } else if (requiredFrame.getPixels() &&
+               CopyToBitmap(&bitmap, requiredFrame.colorType(),
+                            requiredFrame)) {
       options.fPriorFrame = requiredFrameIndex;
     }
   }
 
   if (SkCodec::kSuccess != codec_->getPixels(info, bitmap.getPixels(),
                                              bitmap.rowBytes(), &options)) {
-    FML_LOG(ERROR) << "Could not getPixels for frame " << nextFrameIndex_;
-    return nullptr;
+    FML_LOG(ERROR) << "Could not getPixels for frame " << frameIndex;
+    return SkBitmap();
   }
+  decodeCount_++;
+
+  // The frame may be shared with the cache and the images made from it.
+  bitmap.setImmutable();
 
   // Hold onto this if we need it to decode future frames.
   if (frameInfo.fDisposalMethod == SkCodecAnimation::DisposalMethod::kKeep) {
     lastRequiredFrame_ = std::make_unique<SkBitmap>(bitmap);
-    lastRequiredFrameIndex_ = nextFrameIndex_;
+    lastRequiredFrameIndex_ = frameIndex;
+  }
+
+  return bitmap;
+}
+
+SkBitmap MultiFrameCodec::State::GetFrame(int frameIndex) {
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = decodedFrames_.find(frameIndex);
+    if (found != decodedFrames_.end()) {
+      return found->second;
+    }
+  }
+
+  std::scoped_lock decodeLock(decodeMutex_);
+  {
+    // The frame may have been decoded ahead while waiting for the lock.
+    std::scoped_lock lock(mutex_);
+    auto found = decodedFrames_.find(frameIndex);
+    if (found != decodedFrames_.end()) {
+      return found->second;
+    }
+  }
+
+  SkBitmap bitmap = DecodeFrameLocked(frameIndex);
+  if (!bitmap.isNull() && cacheAllFrames_) {
+    std::scoped_lock lock(mutex_);
+    decodedFrames_[frameIndex] = bitmap;
+  }
+  return bitmap;
+}
+
+void MultiFrameCodec::State::DecodeAhead() {
+  TRACE_EVENT0("flutter", "MultiFrameCodec::DecodeAhead");
+  for (size_t i = 0; i < frameCacheCount_; i++) {
+    // Locked for one frame at a time, so that the IO thread waits for at most
+    // one frame when it needs to decode a frame that is not cached.
+    std::scoped_lock decodeLock(decodeMutex_);
+    int frameIndex;
+    {
+      std::scoped_lock lock(mutex_);
+      frameIndex = (lookAheadFrameIndex_ + static_cast<int>(i)) % frameCount_;
+      if (decodedFrames_.count(frameIndex) > 0) {
+        continue;
+      }
+    }
+    SkBitmap bitmap = DecodeFrameLocked(frameIndex);
+    if (bitmap.isNull()) {
+      break;
+    }
+    std::scoped_lock lock(mutex_);
+    decodedFrames_[frameIndex] = std::move(bitmap);
+  }
+  std::scoped_lock lock(mutex_);
+  lookAheadPending_ = false;
+}
+
+void MultiFrameCodec::State::ScheduleDecodeAhead(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner) {
+  {
+    std::scoped_lock lock(mutex_);
+    lookAheadFrameIndex_ = nextFrameIndex_;
+    if (!cacheAllFrames_) {
+      // Drop the frames that were delivered and are not coming up next.
+      for (auto it = decodedFrames_.begin(); it != decodedFrames_.end();) {
+        const size_t distance =
+            (it->first - lookAheadFrameIndex_ + frameCount_) % frameCount_;
+        it = distance < frameCacheCount_ ? std::next(it)
+                                         : decodedFrames_.erase(it);
+      }
+    }
+    bool framesMissing = false;
+    for (size_t i = 0; i < frameCacheCount_; i++) {
+      const int frameIndex =
+          (lookAheadFrameIndex_ + static_cast<int>(i)) % frameCount_;
+      if (decodedFrames_.count(frameIndex) == 0) {
+        framesMissing = true;
+      }
+    }
+    if (!concurrent_runner || lookAheadPending_ || !framesMissing) {
+      return;
+    }
+    lookAheadPending_ = true;
+  }
+
+  concurrent_runner->PostTask(
+      [weak_state = std::weak_ptr<State>(shared_from_this())]() {
+        if (auto state = weak_state.lock()) {
+          state->DecodeAhead();
+        }
+      });
+}
+
+sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
+    fml::WeakPtr<GrContext> resourceContext) {
+  SkBitmap bitmap = GetFrame(nextFrameIndex_);
+  if (bitmap.isNull()) {
+    return nullptr;
   }
 
   if (resourceContext) {
@@ -134,6 +274,7 @@ sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
 void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     std::unique_ptr<DartPersistentValue> callback,
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_runner,
     fml::WeakPtr<GrContext> resourceContext,
     fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
     size_t trace_id) {
@@ -142,13 +283,14 @@ void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
   if (skImage) {
     fml::RefPtr<CanvasImage> image = CanvasImage::Create();
     image->set_image({skImage, std::move(unref_queue)});
-    SkCodec::FrameInfo skFrameInfo;
-    codec_->getFrameInfo(nextFrameIndex_, &skFrameInfo);
-    frameInfo =
-        fml::MakeRefCounted<FrameInfo>(std::move(image), skFrameInfo.fDuration);
+    frameInfo = fml::MakeRefCounted<FrameInfo>(
+        std::move(image), frameInfos_[nextFrameIndex_].fDuration);
   }
   nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
 
+  // Decode the upcoming frames while the framework shows this one.
+  ScheduleDecodeAhead(concurrent_runner);
+
   ui_task_runner->PostTask(fml::MakeCopyable(
       [callback = std::move(callback), frameInfo, trace_id]() mutable {
         InvokeNextFrameCallback(frameInfo, std::move(callback), trace_id);
@@ -172,6 +314,7 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
            tonic::DartState::Current(), callback_handle),
        weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
        ui_task_runner = task_runners.GetUITaskRunner(),
+       concurrent_runner = dart_state->GetConcurrentTaskRunner(),
        io_manager = dart_state->GetIOManager()]() mutable {
         auto state = weak_state.lock();
         if (!state) {
@@ -181,8 +324,8 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
         }
         state->GetNextFrameAndInvokeCallback(
             std::move(callback), std::move(ui_task_runner),
-            io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
-            trace_id);
+            std::move(concurrent_runner), io_manager->GetResourceContext(),
+            io_manager->GetSkiaUnrefQueue(), trace_id);
       }));
 
   return Dart_Null();
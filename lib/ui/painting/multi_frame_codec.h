@@ -5,13 +5,34 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 #define FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/lib/ui/painting/codec.h"
 
 namespace flutter {
 
+namespace testing {
+class ImageDecoderFixtureTest;
+}
+
 class MultiFrameCodec : public Codec {
  public:
+  // The number of upcoming frames each codec decodes ahead of time.
+  static constexpr size_t kDefaultFrameCacheCount = 3;
+
+  // Codecs whose frames all fit into this many bytes keep all of their frames
+  // once decoded, so that a looping animation decodes each frame only once.
+  static constexpr size_t kDefaultFrameCacheMaxBytes = 4 * 1024 * 1024;
+
+  // Sets the limits of the frame caches of codecs created afterwards. Zero
+  // selects the default.
+  static void SetFrameCacheLimits(size_t frame_count, size_t max_bytes);
+
   MultiFrameCodec(std::unique_ptr<SkCodec> codec);
 
   ~MultiFrameCodec() override;
@@ -29,34 +50,69 @@ class MultiFrameCodec : public Codec {
   // Captures the state shared between the IO and UI task runners.
   //
   // The state is initialized on the UI task runner when the Dart object is
-  // created. Decoding occurs on the IO task runner. Since it is possible for
-  // the UI object to be collected independently of the IO task runner work,
-  // it is not safe for this state to live directly on the MultiFrameCodec.
-  // Instead, the MultiFrameCodec creates this object when it is constructed,
-  // shares it with the IO task runner's decoding work, and sets the live_
-  // member to false when it is destructed.
-  struct State {
+  // created. Frames are delivered on the IO task runner, and decoded ahead of
+  // time on the concurrent worker threads. Since it is possible for the UI
+  // object to be collected independently of the IO task runner work, it is not
+  // safe for this state to live directly on the MultiFrameCodec. Instead, the
+  // MultiFrameCodec creates this object when it is constructed, shares it with
+  // the IO task runner's decoding work, and sets the live_ member to false
+  // when it is destructed.
+  struct State : public std::enable_shared_from_this<State> {
     State(std::unique_ptr<SkCodec> codec);
 
     const std::unique_ptr<SkCodec> codec_;
     const int frameCount_;
     const int repetitionCount_;
-
-    // The non-const members and functions below here are only read or written
-    // to on the IO thread. They are not safe to access or write on the UI
-    // thread.
+    // Read up front, as the codec may be decoding a frame on another thread.
+    const std::vector<SkCodec::FrameInfo> frameInfos_;
+    // The number of frames to decode ahead of the next frame.
+    const size_t frameCacheCount_;
+    // Whether decoded frames are kept for the next loops of the animation.
+    const bool cacheAllFrames_;
+
+    // Only read or written to on the IO thread.
     int nextFrameIndex_;
+
+    // Serializes decoding, and guards the members below up to |mutex_|.
+    std::mutex decodeMutex_;
     // The last decoded frame that's required to decode any subsequent frames.
     std::unique_ptr<SkBitmap> lastRequiredFrame_;
 
     // The index of the last decoded required frame.
     int lastRequiredFrameIndex_ = -1;
 
+    // The number of frames decoded so far.
+    size_t decodeCount_ = 0;
+
+    // Guards the members below, which are read and written to on the IO thread
+    // and on the worker threads.
+    std::mutex mutex_;
+    // Immutable decoded frames by their index.
+    std::map<int, SkBitmap> decodedFrames_;
+    // The index of the frame that will be delivered next.
+    int lookAheadFrameIndex_ = 0;
+    bool lookAheadPending_ = false;
+
+    // Returns the decoded frame at |frameIndex| from the cache, or decodes it.
+    // Returns an empty bitmap if decoding fails.
+    SkBitmap GetFrame(int frameIndex);
+
+    // Decodes the frame at |frameIndex|, which must be called while holding
+    // |decodeMutex_|.
+    SkBitmap DecodeFrameLocked(int frameIndex);
+
+    // Caches the upcoming frames that are not cached yet. On a worker thread.
+    void DecodeAhead();
+
+    void ScheduleDecodeAhead(
+        const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner);
+
     sk_sp<SkImage> GetNextFrameImage(fml::WeakPtr<GrContext> resourceContext);
 
     void GetNextFrameAndInvokeCallback(
         std::unique_ptr<DartPersistentValue> callback,
         fml::RefPtr<fml::TaskRunner> ui_task_runner,
+        std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_runner,
         fml::WeakPtr<GrContext> resourceContext,
         fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
         size_t trace_id);
@@ -65,6 +121,8 @@ class MultiFrameCodec : public Codec {
   // Shared across the UI and IO task runners.
   std::shared_ptr<State> state_;
 
+  friend class testing::ImageDecoderFixtureTest;
+
   FML_FRIEND_MAKE_REF_COUNTED(MultiFrameCodec);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(MultiFrameCodec);
 };
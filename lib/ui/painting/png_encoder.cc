@@ -0,0 +1,421 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/png_encoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/encode/SkPngEncoder.h"
+#include "third_party/zlib/zlib.h"
+
+namespace flutter {
+namespace {
+
+// The number of bytes of pixels that are compressed together. Each strip
+// starts without the history of the previous one and adds a few bytes of
+// output, so the strips must not be too small.
+constexpr size_t kStripPixelBytes = 256 * 1024;
+
+constexpr uint8_t kSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+// The filter types of PNG. The average filter rarely compresses best, so it
+// is not tried.
+enum FilterType : uint8_t {
+  kFilterNone = 0,
+  kFilterSub = 1,
+  kFilterUp = 2,
+  kFilterPaeth = 4,
+};
+
+void WriteUInt32(uint8_t* out, uint32_t value) {
+  out[0] = static_cast<uint8_t>(value >> 24);
+  out[1] = static_cast<uint8_t>(value >> 16);
+  out[2] = static_cast<uint8_t>(value >> 8);
+  out[3] = static_cast<uint8_t>(value);
+}
+
+void WriteChunk(SkWStream* stream,
+                const char type[4],
+                const uint8_t* data,
+                size_t size) {
+  uint8_t header[8];
+  WriteUInt32(header, static_cast<uint32_t>(size));
+  memcpy(header + 4, type, 4);
+  uLong crc = crc32(0L, header + 4, 4);
+  if (size > 0) {
+    crc = crc32(crc, data, static_cast<uInt>(size));
+  }
+  uint8_t footer[4];
+  WriteUInt32(footer, static_cast<uint32_t>(crc));
+
+  stream->write(header, sizeof(header));
+  if (size > 0) {
+    stream->write(data, size);
+  }
+  stream->write(footer, sizeof(footer));
+}
+
+// The second byte of the zlib header, which records the compression level.
+uint8_t ZlibHeaderFlags(int compression_level) {
+  if (compression_level <= 1) {
+    return 0x01;
+  }
+  if (compression_level <= 5) {
+    return 0x5e;
+  }
+  if (compression_level == 6) {
+    return 0x9c;
+  }
+  return 0xda;
+}
+
+uint8_t PaethPredictor(int a, int b, int c) {
+  const int p = a + b - c;
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) {
+    return a;
+  }
+  return pb <= pc ? b : c;
+}
+
+// The heuristic of libpng for the filter that compresses a row best: the
+// smallest sum of the filtered bytes taken as signed values.
+size_t FilterCost(const uint8_t* filtered, size_t size) {
+  size_t cost = 0;
+  for (size_t i = 0; i < size; i++) {
+    cost += std::abs(static_cast<int8_t>(filtered[i]));
+  }
+  return cost;
+}
+
+// Converts rows of the image to the unpremultiplied 8-bit RGB or RGBA pixels
+// of the PNG, and filters them.
+class RowFilter {
+ public:
+  RowFilter(const SkPixmap& pixmap, bool opaque, bool filter)
+      : pixmap_(pixmap),
+        row_info_(SkImageInfo::Make(pixmap.width(),
+                                    1,
+                                    kRGBA_8888_SkColorType,
+                                    kUnpremul_SkAlphaType,
+                                    pixmap.refColorSpace())),
+        channels_(opaque ? 3 : 4),
+        row_size_(pixmap.width() * channels_),
+        filter_(filter),
+        rgba_(opaque ? row_info_.minRowBytes() : 0),
+        previous_(row_size_),
+        current_(row_size_),
+        candidates_(filter ? 3 * (row_size_ + 1) : 0) {}
+
+  // The size of a filtered row, including its filter type.
+  size_t GetFilteredRowSize() const { return row_size_ + 1; }
+
+  // Prepares to filter the rows from row |y| on.
+  bool Start(int y) {
+    if (y == 0) {
+      std::fill(previous_.begin(), previous_.end(), 0);
+      return true;
+    }
+    return ReadRow(y - 1, previous_.data());
+  }
+
+  // Filters row |y| into |out|, which must hold |GetFilteredRowSize| bytes.
+  // The rows must be filtered in order.
+  bool FilterRow(int y, uint8_t* out) {
+    if (!ReadRow(y, current_.data())) {
+      return false;
+    }
+    const uint8_t* row = current_.data();
+    if (!filter_) {
+      out[0] = kFilterNone;
+      memcpy(out + 1, row, row_size_);
+      std::swap(previous_, current_);
+      return true;
+    }
+
+    const uint8_t* above = previous_.data();
+    uint8_t* sub = candidates_.data();
+    uint8_t* up = sub + row_size_ + 1;
+    uint8_t* paeth = up + row_size_ + 1;
+    sub[0] = kFilterSub;
+    up[0] = kFilterUp;
+    paeth[0] = kFilterPaeth;
+    for (size_t i = 0; i < row_size_; i++) {
+      const int left = i >= channels_ ? row[i - channels_] : 0;
+      const int upper_left = i >= channels_ ? above[i - channels_] : 0;
+      sub[i + 1] = static_cast<uint8_t>(row[i] - left);
+      up[i + 1] = static_cast<uint8_t>(row[i] - above[i]);
+      paeth[i + 1] = static_cast<uint8_t>(
+          row[i] - PaethPredictor(left, above[i], upper_left));
+    }
+
+    const uint8_t* best = nullptr;
+    size_t best_cost = FilterCost(row, row_size_);
+    for (const uint8_t* candidate : {sub, up, paeth}) {
+      const size_t cost = FilterCost(candidate + 1, row_size_);
+      if (cost < best_cost) {
+        best = candidate;
+        best_cost = cost;
+      }
+    }
+    if (best) {
+      memcpy(out, best, row_size_ + 1);
+    } else {
+      out[0] = kFilterNone;
+      memcpy(out + 1, row, row_size_);
+    }
+    std::swap(previous_, current_);
+    return true;
+  }
+
+ private:
+  const SkPixmap& pixmap_;
+  const SkImageInfo row_info_;
+  const size_t channels_;
+  const size_t row_size_;
+  const bool filter_;
+  std::vector<uint8_t> rgba_;
+  std::vector<uint8_t> previous_;
+  std::vector<uint8_t> current_;
+  std::vector<uint8_t> candidates_;
+
+  bool ReadRow(int y, uint8_t* out) {
+    const SkPixmap row(pixmap_.info().makeWH(pixmap_.width(), 1),
+                       pixmap_.addr(0, y), pixmap_.rowBytes());
+    if (channels_ == 4) {
+      return row.readPixels(row_info_, out, row_info_.minRowBytes());
+    }
+    if (!row.readPixels(row_info_, rgba_.data(), row_info_.minRowBytes())) {
+      return false;
+    }
+    for (int x = 0; x < pixmap_.width(); x++) {
+      memcpy(out + x * 3, rgba_.data() + x * 4, 3);
+    }
+    return true;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RowFilter);
+};
+
+// Compresses the input of |stream| to |out| from |*size| on, and grows |out|
+// as needed.
+bool Deflate(z_stream* stream,
+             int flush,
+             std::vector<uint8_t>* out,
+             size_t* size) {
+  while (true) {
+    if (*size == out->size()) {
+      out->resize(out->size() * 2);
+    }
+    stream->next_out = out->data() + *size;
+    stream->avail_out = static_cast<uInt>(out->size() - *size);
+    const int result = deflate(stream, flush);
+    *size = out->size() - stream->avail_out;
+    if (result == Z_STREAM_ERROR) {
+      return false;
+    }
+    if (flush == Z_FINISH ? result == Z_STREAM_END : stream->avail_out != 0) {
+      return true;
+    }
+  }
+}
+
+// A strip of rows that is compressed into an IDAT chunk of its own.
+struct Strip {
+  bool encoded = false;
+  std::vector<uint8_t> chunk;
+  // The checksum and size of the filtered rows, which are combined into the
+  // checksum of the whole zlib stream.
+  uLong adler = 0;
+  size_t filtered_size = 0;
+};
+
+// Filters and compresses the rows from |first_row| up to |end_row|. The first
+// strip starts the zlib stream, and the last strip finishes it. The other
+// strips end with a sync flush, so that their compressed data can be joined.
+bool EncodeStrip(const SkPixmap& pixmap,
+                 bool opaque,
+                 int compression_level,
+                 int first_row,
+                 int end_row,
+                 bool is_first,
+                 bool is_last,
+                 Strip* strip) {
+  RowFilter rows(pixmap, opaque, compression_level > 0);
+  if (!rows.Start(first_row)) {
+    return false;
+  }
+
+  z_stream stream = {};
+  if (deflateInit2(&stream, compression_level, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+
+  // The length and type of the chunk, followed by the zlib header.
+  const size_t header_size = is_first ? 10 : 8;
+  const size_t filtered_size =
+      rows.GetFilteredRowSize() * static_cast<size_t>(end_row - first_row);
+  std::vector<uint8_t>& chunk = strip->chunk;
+  chunk.resize(header_size + deflateBound(&stream, filtered_size) + 16);
+  size_t size = header_size;
+
+  std::vector<uint8_t> filtered(rows.GetFilteredRowSize());
+  uLong adler = adler32(0L, Z_NULL, 0);
+  bool success = true;
+  for (int y = first_row; success && y < end_row; y++) {
+    success = rows.FilterRow(y, filtered.data());
+    if (!success) {
+      break;
+    }
+    adler = adler32(adler, filtered.data(), static_cast<uInt>(filtered.size()));
+    stream.next_in = filtered.data();
+    stream.avail_in = static_cast<uInt>(filtered.size());
+    int flush = Z_NO_FLUSH;
+    if (y + 1 == end_row) {
+      flush = is_last ? Z_FINISH : Z_SYNC_FLUSH;
+    }
+    success = Deflate(&stream, flush, &chunk, &size);
+  }
+  deflateEnd(&stream);
+  if (!success) {
+    return false;
+  }
+
+  chunk.resize(size + 4);
+  WriteUInt32(chunk.data(), static_cast<uint32_t>(size - 8));
+  memcpy(chunk.data() + 4, "IDAT", 4);
+  if (is_first) {
+    chunk[8] = 0x78;
+    chunk[9] = ZlibHeaderFlags(compression_level);
+  }
+  const uLong crc = crc32(0L, chunk.data() + 4, static_cast<uInt>(size - 4));
+  WriteUInt32(chunk.data() + size, static_cast<uint32_t>(crc));
+  strip->adler = adler;
+  strip->filtered_size = filtered_size;
+  return true;
+}
+
+// The strips of an image, which are claimed one after the other by the
+// threads that encode them.
+struct StripEncoding {
+  explicit StripEncoding(size_t count) : strips(count), latch(count) {}
+
+  std::vector<Strip> strips;
+  std::atomic_size_t next_strip = {0};
+  // Counts down for every encoded strip.
+  fml::CountDownLatch latch;
+};
+
+sk_sp<SkData> EncodeWithSkia(const SkPixmap& pixmap, int compression_level) {
+  SkPngEncoder::Options options;
+  options.fZLibLevel = compression_level;
+  SkDynamicMemoryWStream stream;
+  if (!SkPngEncoder::Encode(&stream, pixmap, options)) {
+    return nullptr;
+  }
+  return stream.detachAsData();
+}
+
+}  // namespace
+
+sk_sp<SkData> EncodePNG(
+    const SkPixmap& pixmap,
+    int compression_level,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  compression_level = std::clamp(compression_level, 0, 9);
+
+  const bool supported =
+      (pixmap.colorType() == kRGBA_8888_SkColorType ||
+       pixmap.colorType() == kBGRA_8888_SkColorType) &&
+      pixmap.alphaType() != kUnknown_SkAlphaType &&
+      (!pixmap.colorSpace() || pixmap.colorSpace()->isSRGB());
+  const bool opaque = pixmap.info().isOpaque();
+  const size_t row_size =
+      static_cast<size_t>(pixmap.width()) * (opaque ? 3 : 4);
+  const int rows_per_strip =
+      static_cast<int>(std::max<size_t>(1, kStripPixelBytes / row_size));
+  const size_t strip_count =
+      (pixmap.height() + rows_per_strip - 1) / rows_per_strip;
+  if (!supported || strip_count < 2) {
+    return EncodeWithSkia(pixmap, compression_level);
+  }
+
+  auto encoding = std::make_shared<StripEncoding>(strip_count);
+  // Any thread that runs this encodes the strips that no other thread has
+  // claimed yet. The calling thread runs it as well, so the image is encoded
+  // even if none of the workers gets to it.
+  auto encode_strips = [encoding, pixmap, opaque, compression_level,
+                        rows_per_strip]() {
+    const size_t count = encoding->strips.size();
+    for (size_t index = encoding->next_strip++; index < count;
+         index = encoding->next_strip++) {
+      const int first_row = static_cast<int>(index) * rows_per_strip;
+      const int end_row = std::min(first_row + rows_per_strip, pixmap.height());
+      Strip& strip = encoding->strips[index];
+      strip.encoded =
+          EncodeStrip(pixmap, opaque, compression_level, first_row, end_row,
+                      index == 0, index + 1 == count, &strip);
+      encoding->latch.CountDown();
+    }
+  };
+  if (concurrent_task_runner) {
+    const size_t thread_count =
+        std::max(std::thread::hardware_concurrency(), 2u);
+    const size_t helper_count = std::min(strip_count, thread_count) - 1;
+    for (size_t i = 0; i < helper_count; i++) {
+      concurrent_task_runner->PostTask(encode_strips);
+    }
+  }
+  encode_strips();
+  encoding->latch.Wait();
+
+  SkDynamicMemoryWStream stream;
+  stream.write(kSignature, sizeof(kSignature));
+
+  uint8_t header[13] = {};
+  WriteUInt32(header, pixmap.width());
+  WriteUInt32(header + 4, pixmap.height());
+  // The bit depth, and the color type of RGB or RGBA.
+  header[8] = 8;
+  header[9] = opaque ? 2 : 6;
+  WriteChunk(&stream, "IHDR", header, sizeof(header));
+  if (pixmap.colorSpace()) {
+    const uint8_t perceptual_intent = 0;
+    WriteChunk(&stream, "sRGB", &perceptual_intent, 1);
+  }
+
+  uLong adler = adler32(0L, Z_NULL, 0);
+  for (const Strip& strip : encoding->strips) {
+    if (!strip.encoded) {
+      FML_LOG(ERROR) << "Could not compress the rows of the PNG image.";
+      return nullptr;
+    }
+    stream.write(strip.chunk.data(), strip.chunk.size());
+    adler = adler32_combine(adler, strip.adler,
+                            static_cast<z_off_t>(strip.filtered_size));
+  }
+  // The checksum that ends the zlib stream.
+  uint8_t checksum[4];
+  WriteUInt32(checksum, static_cast<uint32_t>(adler));
+  WriteChunk(&stream, "IDAT", checksum, sizeof(checksum));
+  WriteChunk(&stream, "IEND", nullptr, 0);
+  return stream.detachAsData();
+}
+
+}  // namespace flutter
@@ -0,0 +1,34 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PNG_ENCODER_H_
+#define FLUTTER_LIB_UI_PAINTING_PNG_ENCODER_H_
+
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+
+// Encodes |pixmap| as a PNG image with the given zlib compression level, from
+// 0 for no compression to 9 for the smallest output.
+//
+// Large 8-bit RGBA images are split into strips of rows that are filtered and
+// compressed independently on the calling thread and, if there is a
+// |concurrent_task_runner|, on its workers. The compressed strips are joined
+// into a single zlib stream, the way pigz does it. Other images are encoded by
+// Skia.
+//
+// The pixels of |pixmap| must stay valid until this returns. Returns null if
+// the image could not be encoded.
+sk_sp<SkData> EncodePNG(
+    const SkPixmap& pixmap,
+    int compression_level,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PNG_ENCODER_H_
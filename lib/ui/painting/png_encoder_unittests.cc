@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/png_encoder.h"
+
+#include <cstring>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkEncodedImageFormat.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Fills a bitmap with a pattern that exercises every filter type.
+SkBitmap MakeBitmap(int width, int height, SkAlphaType alpha_type) {
+  SkBitmap bitmap;
+  bitmap.allocPixels(SkImageInfo::MakeN32(width, height, alpha_type,
+                                          SkColorSpace::MakeSRGB()));
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const uint8_t alpha =
+          alpha_type == kOpaque_SkAlphaType ? 0xff : (x * 7 + y) & 0xff;
+      const SkColor color =
+          SkColorSetARGB(alpha, x & 0xff, y & 0xff, (x * y) & 0xff);
+      *bitmap.getAddr32(x, y) = SkPreMultiplyColor(color);
+    }
+  }
+  bitmap.setImmutable();
+  return bitmap;
+}
+
+// Decodes |png| and checks that it has the pixels of |bitmap|.
+void ExpectDecodesTo(const sk_sp<SkData>& png, const SkBitmap& bitmap) {
+  ASSERT_TRUE(png != nullptr);
+  auto image = SkImage::MakeFromEncoded(png);
+  ASSERT_TRUE(image != nullptr);
+  ASSERT_EQ(image->dimensions(), bitmap.dimensions());
+
+  SkBitmap decoded;
+  ASSERT_TRUE(decoded.tryAllocPixels(bitmap.info()));
+  ASSERT_TRUE(image->readPixels(decoded.pixmap(), 0, 0));
+  SkBitmap expected;
+  ASSERT_TRUE(expected.tryAllocPixels(bitmap.info()));
+  ASSERT_TRUE(bitmap.readPixels(expected.pixmap(), 0, 0));
+  ASSERT_EQ(std::memcmp(decoded.getPixels(), expected.getPixels(),
+                        expected.computeByteSize()),
+            0);
+}
+
+}  // namespace
+
+TEST(PNGEncoderTest, EncodesSmallImagesLikeSkia) {
+  auto bitmap = MakeBitmap(10, 10, kPremul_SkAlphaType);
+  auto png = EncodePNG(bitmap.pixmap(), 6, nullptr);
+  ASSERT_TRUE(png != nullptr);
+  auto expected = SkImage::MakeFromBitmap(bitmap)->encodeToData(
+      SkEncodedImageFormat::kPNG, 0);
+  ASSERT_TRUE(png->equals(expected.get()));
+}
+
+TEST(PNGEncoderTest, EncodesLargeImagesInStripsAtEveryLevel) {
+  auto bitmap = MakeBitmap(600, 500, kPremul_SkAlphaType);
+  for (int level : {0, 1, 6, 9}) {
+    ExpectDecodesTo(EncodePNG(bitmap.pixmap(), level, nullptr), bitmap);
+  }
+}
+
+TEST(PNGEncoderTest, EncodesOpaqueImagesAsRGB) {
+  auto bitmap = MakeBitmap(700, 500, kOpaque_SkAlphaType);
+  auto png = EncodePNG(bitmap.pixmap(), 6, nullptr);
+  ExpectDecodesTo(png, bitmap);
+  // The color type in the header.
+  ASSERT_EQ(png->bytes()[25], 2);
+}
+
+TEST(PNGEncoderTest, CompressedSizeDependsOnLevel) {
+  auto bitmap = MakeBitmap(600, 500, kPremul_SkAlphaType);
+  auto uncompressed = EncodePNG(bitmap.pixmap(), 0, nullptr);
+  auto compressed = EncodePNG(bitmap.pixmap(), 6, nullptr);
+  ASSERT_TRUE(uncompressed != nullptr);
+  ASSERT_TRUE(compressed != nullptr);
+  ASSERT_GT(uncompressed->size(), bitmap.computeByteSize());
+  ASSERT_LT(compressed->size(), uncompressed->size());
+}
+
+TEST(PNGEncoderTest, EncodesOnConcurrentWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto bitmap = MakeBitmap(1000, 800, kUnpremul_SkAlphaType);
+  auto png = EncodePNG(bitmap.pixmap(), 6, loop->GetTaskRunner());
+  ExpectDecodesTo(png, bitmap);
+  // The output does not depend on the threads that compressed the strips.
+  auto sequential_png = EncodePNG(bitmap.pixmap(), 6, nullptr);
+  ASSERT_TRUE(png->equals(sequential_png.get()));
+}
+
+}  // namespace testing
+}  // namespace flutter
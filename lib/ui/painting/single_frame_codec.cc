@@ -57,9 +57,15 @@ Dart_Handle SingleFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   fml::RefPtr<SingleFrameCodec>* raw_codec_ref =
       new fml::RefPtr<SingleFrameCodec>(this);
 
-  decoder->Decode(descriptor_, [raw_codec_ref](auto image) {
+  decode_request_ = decoder->Decode(descriptor_, [raw_codec_ref](auto image) {
     std::unique_ptr<fml::RefPtr<SingleFrameCodec>> codec_ref(raw_codec_ref);
     fml::RefPtr<SingleFrameCodec> codec(std::move(*codec_ref));
+    codec->decode_request_.reset();
+
+    if (codec->pending_callbacks_.empty()) {
+      // The codec was disposed of before the image could be decoded.
+      return;
+    }
 
     auto state = codec->pending_callbacks_.front().dart_state().lock();
 
@@ -101,6 +107,16 @@ Dart_Handle SingleFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   return Dart_Null();
 }
 
+void SingleFrameCodec::dispose() {
+  // Nobody is waiting for the frame anymore, so drop the decode if it has not
+  // finished yet.
+  if (decode_request_) {
+    decode_request_->Cancel();
+  }
+  pending_callbacks_.clear();
+  Codec::dispose();
+}
+
 size_t SingleFrameCodec::GetAllocationSize() const {
   const auto& data = descriptor_.data;
   const auto data_byte_size = data ? data->size() : 0;
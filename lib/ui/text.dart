@@ -538,6 +538,11 @@ bool _listEquals<T>(List<T>? a, List<T>? b) {
   return true;
 }
 
+// The bits of the first element of an encoded text style for the properties
+// that ParagraphBuilder.addStyledText can not pack: the font family, locale,
+// background, foreground, shadows and font features.
+const int _kUnpackedTextStyleMask = 1 << 9 | 1 << 14 | 1 << 15 | 1 << 16 | 1 << 17 | 1 << 18;
+
 // This encoding must match the C++ version of ParagraphBuilder::pushStyle.
 //
 // The encoded array buffer has 8 elements.
@@ -1926,6 +1931,26 @@ class Paragraph extends NativeFieldWrapperClass2 {
   void layout(ParagraphConstraints constraints) => _layout(constraints.width);
   void _layout(double width) native 'Paragraph_layout';
 
+  /// Lays out each of the `paragraphs` with the constraints at the same index
+  /// in `constraints`.
+  ///
+  /// This has the same effect as calling [layout] on each paragraph, but the
+  /// paragraphs may be laid out in parallel on background threads. This
+  /// method returns once all of them are laid out.
+  ///
+  /// A paragraph that appears more than once in `paragraphs` is laid out with
+  /// the last of its constraints, as if [layout] was called for each of them
+  /// in order.
+  static void layoutAll(List<Paragraph> paragraphs, List<ParagraphConstraints> constraints) {
+    assert(paragraphs.length == constraints.length);
+    final Float64List widths = Float64List(constraints.length);
+    for (int index = 0; index < constraints.length; index += 1) {
+      widths[index] = constraints[index].width;
+    }
+    _layoutAll(paragraphs, widths);
+  }
+  static void _layoutAll(List<Paragraph> paragraphs, Float64List widths) native 'Paragraph_layoutAll';
+
   List<TextBox> _decodeTextBoxes(Float32List encoded) {
     final int count = encoded.length ~/ 5;
     final List<TextBox> boxes = <TextBox>[];
@@ -2178,6 +2203,42 @@ class ParagraphBuilder extends NativeFieldWrapperClass2 {
   }
   String? _addText(String text) native 'ParagraphBuilder_addText';
 
+  /// Adds the UTF-16 code units in `text` to the paragraph in a single call,
+  /// styling its runs with the given `styles`.
+  ///
+  /// The `runs` list holds two entries for each run of the text: the index of
+  /// its style in `styles`, and the offset in `text` where the run ends. Each
+  /// run starts where the previous one ended, and the last run must end at the
+  /// end of `text`.
+  ///
+  /// This has the same effect as pushing the style of each run, adding its
+  /// text and popping the style again, but the text is not copied into a
+  /// [String] first and each distinct style is only stored once. This makes
+  /// it suitable for building paragraphs from large amounts of styled text.
+  ///
+  /// The styles are applied on top of the current stack of text styles, and
+  /// may not set a font family, locale, background, foreground, shadows or
+  /// font features; these are inherited from the current style.
+  void addStyledText(Uint16List text, List<TextStyle> styles, Int32List runs) {
+    final Int32List encodedStyles = Int32List(styles.length * 8);
+    final Float64List styleMetrics = Float64List(styles.length * 5);
+    for (int index = 0; index < styles.length; index += 1) {
+      final TextStyle style = styles[index];
+      assert(style._encoded[0] & _kUnpackedTextStyleMask == 0,
+        'The styles of addStyledText may only set properties that do not need any Dart objects.');
+      encodedStyles.setAll(index * 8, style._encoded);
+      styleMetrics[index * 5] = style._fontSize ?? 0.0;
+      styleMetrics[index * 5 + 1] = style._letterSpacing ?? 0.0;
+      styleMetrics[index * 5 + 2] = style._wordSpacing ?? 0.0;
+      styleMetrics[index * 5 + 3] = style._height ?? 0.0;
+      styleMetrics[index * 5 + 4] = style._decorationThickness ?? 0.0;
+    }
+    final String? error = _addStyledText(text, encodedStyles, styleMetrics, runs);
+    if (error != null)
+      throw ArgumentError(error);
+  }
+  String? _addStyledText(Uint16List text, Int32List encodedStyles, Float64List styleMetrics, Int32List runs) native 'ParagraphBuilder_addStyledText';
+
   /// Adds an inline placeholder space to the paragraph.
   ///
   /// The paragraph will contain a rectangular space with no text of the dimensions
@@ -4,10 +4,18 @@
 
 #include "flutter/lib/ui/text/paragraph.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/ui_dart_state.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
@@ -37,7 +45,13 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Paragraph);
   V(Paragraph, getPositionForOffset)    \
   V(Paragraph, computeLineMetrics)
 
-DART_BIND_ALL(Paragraph, FOR_EACH_BINDING)
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+DART_NATIVE_CALLBACK_STATIC(Paragraph, layoutAll)
+
+void Paragraph::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+  natives->Register({DART_REGISTER_NATIVE_STATIC(Paragraph, layoutAll)});
+}
 
 Paragraph::Paragraph(std::unique_ptr<txt::Paragraph> paragraph)
     : m_paragraph(std::move(paragraph)) {}
@@ -87,6 +101,94 @@ void Paragraph::layout(double width) {
   m_paragraph->Layout(width);
 }
 
+namespace {
+
+// The paragraphs of a call to |Paragraph::layoutAll|. Helper tasks that start
+// after all paragraphs were claimed find nothing left to do, so they keep the
+// batch alive but never touch its paragraphs.
+struct LayoutBatch {
+  LayoutBatch(std::vector<txt::Paragraph*> paragraphs,
+              std::vector<double> widths)
+      : paragraphs(std::move(paragraphs)),
+        widths(std::move(widths)),
+        remaining(this->paragraphs.size()) {}
+
+  const std::vector<txt::Paragraph*> paragraphs;
+  const std::vector<double> widths;
+  std::atomic<size_t> next_index = 0;
+  fml::CountDownLatch remaining;
+
+  // Lays out paragraphs until none are left to claim.
+  void LayoutPending() {
+    for (size_t i = next_index++; i < paragraphs.size(); i = next_index++) {
+      paragraphs[i]->Layout(widths[i]);
+      remaining.CountDown();
+    }
+  }
+};
+
+}  // namespace
+
+void Paragraph::layoutAll(const std::vector<Paragraph*>& paragraphs,
+                          const tonic::Float64List& widths) {
+  TRACE_EVENT0("flutter", "Paragraph::layoutAll");
+  FML_DCHECK(paragraphs.size() == static_cast<size_t>(widths.num_elements()));
+  const size_t count =
+      std::min(paragraphs.size(), static_cast<size_t>(widths.num_elements()));
+
+  // Copy the widths so that the workers do not read from the Dart heap. A
+  // paragraph must not be laid out on two threads at once, so a paragraph that
+  // is listed more than once is laid out once, with its last width, which
+  // leaves it the way laying out each entry in order would.
+  std::vector<txt::Paragraph*> txt_paragraphs;
+  std::vector<double> layout_widths;
+  std::unordered_map<txt::Paragraph*, size_t> indices;
+  txt_paragraphs.reserve(count);
+  layout_widths.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    if (paragraphs[i] == nullptr) {
+      continue;
+    }
+    txt::Paragraph* paragraph = paragraphs[i]->m_paragraph.get();
+    auto [found, inserted] = indices.emplace(paragraph, txt_paragraphs.size());
+    if (!inserted) {
+      layout_widths[found->second] = widths[i];
+      continue;
+    }
+    txt_paragraphs.push_back(paragraph);
+    layout_widths.push_back(widths[i]);
+  }
+  if (txt_paragraphs.empty()) {
+    return;
+  }
+  auto batch = std::make_shared<LayoutBatch>(std::move(txt_paragraphs),
+                                             std::move(layout_widths));
+
+  // Paragraphs share no mutable state besides caches that are safe to use
+  // concurrently, so they may be laid out on any thread. The calling thread
+  // lays out paragraphs too, so the batch completes even if the workers are
+  // busy.
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner =
+      UIDartState::Current()->GetConcurrentTaskRunner();
+  if (task_runner) {
+    const size_t thread_count =
+        std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t helper_count =
+        std::min(batch->paragraphs.size(), thread_count) - 1;
+    for (size_t i = 0; i < helper_count; i++) {
+      task_runner->PostTask(
+          [batch]() {
+            TRACE_EVENT0("flutter", "Paragraph::layoutAll::Worker");
+            batch->LayoutPending();
+          },
+          // The UI thread is blocked until all paragraphs are laid out.
+          fml::ConcurrentTaskPriority::kHigh);
+    }
+  }
+  batch->LayoutPending();
+  batch->remaining.Wait();
+}
+
 void Paragraph::paint(Canvas* canvas, double x, double y) {
   SkCanvas* sk_canvas = canvas->canvas();
   if (!sk_canvas)
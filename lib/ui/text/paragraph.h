@@ -5,12 +5,15 @@
 #ifndef FLUTTER_LIB_UI_TEXT_PARAGRAPH_H_
 #define FLUTTER_LIB_UI_TEXT_PARAGRAPH_H_
 
+#include <vector>
+
 #include "flutter/fml/message_loop.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/canvas.h"
 #include "flutter/lib/ui/text/line_metrics.h"
 #include "flutter/lib/ui/text/text_box.h"
 #include "flutter/third_party/txt/src/txt/paragraph.h"
+#include "third_party/tonic/typed_data/typed_list.h"
 
 namespace tonic {
 class DartLibraryNatives;
@@ -43,6 +46,12 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
   void layout(double width);
   void paint(Canvas* canvas, double x, double y);
 
+  // Lays out each paragraph at the width with the same index, spreading the
+  // paragraphs over the concurrent workers and the calling thread. Returns
+  // once all of them are laid out.
+  static void layoutAll(const std::vector<Paragraph*>& paragraphs,
+                        const tonic::Float64List& widths);
+
   tonic::Float32List getRectsForRange(unsigned start,
                                       unsigned end,
                                       unsigned boxHeightStyle,
@@ -110,6 +110,15 @@ constexpr uint32_t kBlurOffset = 3;
 constexpr uint32_t kBytesPerFontFeature = 8;
 constexpr uint32_t kFontFeatureTagLength = 4;
 
+// Packed style table decoding
+constexpr size_t kEncodedStyleLength = 8;
+constexpr size_t kStyleMetricsLength = 5;
+constexpr size_t kFontSizeOffset = 0;
+constexpr size_t kLetterSpacingOffset = 1;
+constexpr size_t kWordSpacingOffset = 2;
+constexpr size_t kHeightOffset = 3;
+constexpr size_t kDecorationThicknessOffset = 4;
+
 // Strut decoding
 const int sFontWeightIndex = 0;
 const int sFontStyleIndex = 1;
@@ -140,6 +149,7 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, ParagraphBuilder);
   V(ParagraphBuilder, pushStyle)      \
   V(ParagraphBuilder, pop)            \
   V(ParagraphBuilder, addText)        \
+  V(ParagraphBuilder, addStyledText)  \
   V(ParagraphBuilder, addPlaceholder) \
   V(ParagraphBuilder, build)
 
@@ -345,28 +355,17 @@ void decodeFontFeatures(Dart_Handle font_features_data,
   }
 }
 
-void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
-                                 const std::vector<std::string>& fontFamilies,
-                                 double fontSize,
-                                 double letterSpacing,
-                                 double wordSpacing,
-                                 double height,
-                                 double decorationThickness,
-                                 const std::string& locale,
-                                 Dart_Handle background_objects,
-                                 Dart_Handle background_data,
-                                 Dart_Handle foreground_objects,
-                                 Dart_Handle foreground_data,
-                                 Dart_Handle shadows_data,
-                                 Dart_Handle font_features_data) {
-  FML_DCHECK(encoded.num_elements() == 8);
-
+// Applies the properties of an encoded text style that do not need any Dart
+// objects to decode to |style|.
+void decodeTextStyleProperties(const int32_t* encoded,
+                               double fontSize,
+                               double letterSpacing,
+                               double wordSpacing,
+                               double height,
+                               double decorationThickness,
+                               txt::TextStyle& style) {
   int32_t mask = encoded[0];
 
-  // Set to use the properties of the previous style if the property is not
-  // explicitly given.
-  txt::TextStyle style = m_paragraphBuilder->PeekStyle();
-
   // Only change the style property from the previous value if a new explicitly
   // set value is available
   if (mask & tsColorMask) {
@@ -419,6 +418,32 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
     style.height = height;
     style.has_height_override = true;
   }
+}
+
+void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
+                                 const std::vector<std::string>& fontFamilies,
+                                 double fontSize,
+                                 double letterSpacing,
+                                 double wordSpacing,
+                                 double height,
+                                 double decorationThickness,
+                                 const std::string& locale,
+                                 Dart_Handle background_objects,
+                                 Dart_Handle background_data,
+                                 Dart_Handle foreground_objects,
+                                 Dart_Handle foreground_data,
+                                 Dart_Handle shadows_data,
+                                 Dart_Handle font_features_data) {
+  FML_DCHECK(encoded.num_elements() == 8);
+
+  int32_t mask = encoded[0];
+
+  // Set to use the properties of the previous style if the property is not
+  // explicitly given.
+  txt::TextStyle style = m_paragraphBuilder->PeekStyle();
+
+  decodeTextStyleProperties(encoded.data(), fontSize, letterSpacing,
+                            wordSpacing, height, decorationThickness, style);
 
   if (mask & tsLocaleMask) {
     style.locale = locale;
@@ -462,17 +487,21 @@ void ParagraphBuilder::pop() {
   m_paragraphBuilder->Pop();
 }
 
-Dart_Handle ParagraphBuilder::addText(const std::u16string& text) {
-  if (text.empty())
-    return Dart_Null();
-
+bool isWellFormedUTF16(const char16_t* text, size_t length) {
   // Use ICU to validate the UTF-16 input.  Calling u_strToUTF8 with a null
   // output buffer will return U_BUFFER_OVERFLOW_ERROR if the input is well
   // formed.
-  const UChar* text_ptr = reinterpret_cast<const UChar*>(text.data());
+  const UChar* text_ptr = reinterpret_cast<const UChar*>(text);
   UErrorCode error_code = U_ZERO_ERROR;
-  u_strToUTF8(nullptr, 0, nullptr, text_ptr, text.size(), &error_code);
-  if (error_code != U_BUFFER_OVERFLOW_ERROR)
+  u_strToUTF8(nullptr, 0, nullptr, text_ptr, length, &error_code);
+  return error_code == U_BUFFER_OVERFLOW_ERROR;
+}
+
+Dart_Handle ParagraphBuilder::addText(const std::u16string& text) {
+  if (text.empty())
+    return Dart_Null();
+
+  if (!isWellFormedUTF16(text.data(), text.size()))
     return tonic::ToDart("string is not well-formed UTF-16");
 
   m_paragraphBuilder->AddText(text);
@@ -480,6 +509,86 @@ Dart_Handle ParagraphBuilder::addText(const std::u16string& text) {
   return Dart_Null();
 }
 
+// Checks the arguments of |ParagraphBuilder::addStyledText| and collects the
+// style runs into |ranges|. Returns an error message if they are malformed.
+static const char* ValidateStyledText(
+    const tonic::Uint16List& text,
+    const tonic::Int32List& encoded_styles,
+    const tonic::Float64List& style_metrics,
+    const tonic::Int32List& runs,
+    std::vector<txt::ParagraphBuilder::StyledRange>& ranges) {
+  const size_t length = text.num_elements();
+  const size_t style_count =
+      encoded_styles.num_elements() / kEncodedStyleLength;
+  if (encoded_styles.num_elements() % kEncodedStyleLength != 0 ||
+      static_cast<size_t>(style_metrics.num_elements()) !=
+          style_count * kStyleMetricsLength)
+    return "malformed style table";
+
+  if (runs.num_elements() % 2 != 0)
+    return "malformed style runs";
+  ranges.reserve(runs.num_elements() / 2);
+  size_t end = 0;
+  for (intptr_t i = 0; i < runs.num_elements(); i += 2) {
+    const int32_t style_index = runs[i];
+    const int32_t run_end = runs[i + 1];
+    if (style_index < 0 || static_cast<size_t>(style_index) >= style_count ||
+        run_end < 0 || static_cast<size_t>(run_end) < end ||
+        static_cast<size_t>(run_end) > length)
+      return "malformed style runs";
+    end = run_end;
+    ranges.push_back({static_cast<size_t>(style_index), end});
+  }
+  if (end != length)
+    return "style runs do not cover the text";
+
+  if (length != 0 &&
+      !isWellFormedUTF16(reinterpret_cast<const char16_t*>(text.data()),
+                         length))
+    return "string is not well-formed UTF-16";
+
+  return nullptr;
+}
+
+Dart_Handle ParagraphBuilder::addStyledText(tonic::Uint16List& text,
+                                            tonic::Int32List& encoded_styles,
+                                            tonic::Float64List& style_metrics,
+                                            tonic::Int32List& runs) {
+  std::vector<txt::ParagraphBuilder::StyledRange> ranges;
+  const char* error =
+      ValidateStyledText(text, encoded_styles, style_metrics, runs, ranges);
+  if (error != nullptr) {
+    // Dart objects may not be allocated while typed data is acquired.
+    text.Release();
+    encoded_styles.Release();
+    style_metrics.Release();
+    runs.Release();
+    return tonic::ToDart(error);
+  }
+
+  const size_t length = text.num_elements();
+  if (length == 0)
+    return Dart_Null();
+
+  const size_t style_count =
+      encoded_styles.num_elements() / kEncodedStyleLength;
+  std::vector<txt::TextStyle> styles(style_count,
+                                     m_paragraphBuilder->PeekStyle());
+  for (size_t i = 0; i < style_count; ++i) {
+    const double* metrics = style_metrics.data() + i * kStyleMetricsLength;
+    decodeTextStyleProperties(encoded_styles.data() + i * kEncodedStyleLength,
+                              metrics[kFontSizeOffset],
+                              metrics[kLetterSpacingOffset],
+                              metrics[kWordSpacingOffset],
+                              metrics[kHeightOffset],
+                              metrics[kDecorationThicknessOffset], styles[i]);
+  }
+
+  m_paragraphBuilder->AddStyledText(text.data(), length, styles, ranges);
+
+  return Dart_Null();
+}
+
 Dart_Handle ParagraphBuilder::addPlaceholder(double width,
                                              double height,
                                              unsigned alignment,
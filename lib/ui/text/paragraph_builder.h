@@ -57,6 +57,20 @@ class ParagraphBuilder : public RefCountedDartWrappable<ParagraphBuilder> {
 
   Dart_Handle addText(const std::u16string& text);
 
+  // Adds the UTF-16 |text| in a single call, styled by a packed table of
+  // styles. The text is read in place from the typed data.
+  //
+  // Each style takes 8 elements of |encoded_styles|, encoded like the first
+  // argument of pushStyle, and 5 elements of |style_metrics|: the font size,
+  // letter spacing, word spacing, height and decoration thickness. The font
+  // families, locale, paints, shadows and font features are inherited from
+  // the current style. |runs| holds a style index and an end offset for each
+  // run of the text.
+  Dart_Handle addStyledText(tonic::Uint16List& text,
+                            tonic::Int32List& encoded_styles,
+                            tonic::Float64List& style_metrics,
+                            tonic::Int32List& runs);
+
   // Pushes the information requried to leave an open space, where Flutter may
   // draw a custom placeholder into.
   //
@@ -4,11 +4,14 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/lib/ui/painting/image_encoding.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 
 #include <future>
 
@@ -69,4 +72,37 @@ static void BM_PlatformMessageResponseDartComplete(benchmark::State& state) {
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
+static void BM_EncodeImage(benchmark::State& state) {
+  const auto format = static_cast<ImageByteFormat>(state.range(0));
+  // A 4K snapshot with smooth gradients, and some detail that compresses less
+  // well.
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(3840, 2160);
+  for (int y = 0; y < bitmap.height(); y++) {
+    for (int x = 0; x < bitmap.width(); x++) {
+      const uint8_t detail = (x * 31 + y * 17) % 7;
+      *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(
+          0xff, x * 255 / bitmap.width(), y * 255 / bitmap.height(),
+          detail * 32);
+    }
+  }
+  bitmap.setImmutable();
+  auto image = SkImage::MakeFromBitmap(bitmap);
+  auto loop = fml::ConcurrentMessageLoop::Create();
+
+  while (state.KeepRunning()) {
+    auto data = EncodeImage(image, format, loop->GetTaskRunner());
+    FML_CHECK(data);
+    benchmark::DoNotOptimize(data);
+  }
+}
+
+BENCHMARK(BM_EncodeImage)
+    ->Arg(kRawRGBA)
+    ->Arg(kRawUnmodified)
+    ->Arg(kPNG)
+    ->Arg(kPNGFast)
+    ->Arg(kPNGUncompressed)
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace flutter
@@ -21,6 +21,7 @@ UIDartState::UIDartState(
     fml::WeakPtr<IOManager> io_manager,
     fml::RefPtr<SkiaUnrefQueue> skia_unref_queue,
     fml::WeakPtr<ImageDecoder> image_decoder,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     std::string advisory_script_uri,
     std::string advisory_script_entrypoint,
     std::string logger_prefix,
@@ -34,6 +35,7 @@ UIDartState::UIDartState(
       io_manager_(std::move(io_manager)),
       skia_unref_queue_(std::move(skia_unref_queue)),
       image_decoder_(std::move(image_decoder)),
+      concurrent_task_runner_(std::move(concurrent_task_runner)),
       advisory_script_uri_(std::move(advisory_script_uri)),
       advisory_script_entrypoint_(std::move(advisory_script_entrypoint)),
       logger_prefix_(std::move(logger_prefix)),
@@ -142,6 +144,11 @@ fml::WeakPtr<ImageDecoder> UIDartState::GetImageDecoder() const {
   return image_decoder_;
 }
 
+std::shared_ptr<fml::ConcurrentTaskRunner>
+UIDartState::GetConcurrentTaskRunner() const {
+  return concurrent_task_runner_;
+}
+
 std::shared_ptr<IsolateNameServer> UIDartState::GetIsolateNameServer() const {
   return isolate_name_server_;
 }
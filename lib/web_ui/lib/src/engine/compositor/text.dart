@@ -475,6 +475,11 @@ class SkParagraphBuilder implements ui.ParagraphBuilder {
     _paragraphBuilder!.callMethod('addText', <String>[text]);
   }
 
+  @override
+  void addStyledText(Uint16List text, List<ui.TextStyle> styles, Int32List runs) {
+    _addStyledTextByRun(this, text, styles, runs);
+  }
+
   @override
   ui.Paragraph build() {
     final SkParagraph paragraph = SkParagraph(
@@ -1007,6 +1007,29 @@ class EngineStrutStyle implements ui.StrutStyle {
       );
 }
 
+/// Implements [ui.ParagraphBuilder.addStyledText] by pushing the style of each
+/// run, adding its text and popping the style again.
+void _addStyledTextByRun(ui.ParagraphBuilder builder, Uint16List text,
+    List<ui.TextStyle> styles, Int32List runs) {
+  if (runs.length.isOdd) {
+    throw ArgumentError('malformed style runs');
+  }
+  int start = 0;
+  for (int index = 0; index < runs.length; index += 2) {
+    final int end = runs[index + 1];
+    if (end < start || end > text.length) {
+      throw ArgumentError('malformed style runs');
+    }
+    builder.pushStyle(styles[runs[index]]);
+    builder.addText(String.fromCharCodes(text, start, end));
+    builder.pop();
+    start = end;
+  }
+  if (start != text.length) {
+    throw ArgumentError('style runs do not cover the text');
+  }
+}
+
 /// The web implementation of [ui.ParagraphBuilder].
 class EngineParagraphBuilder implements ui.ParagraphBuilder {
   /// Marks a call to the [pop] method in the [_ops] list.
@@ -1085,6 +1108,11 @@ class EngineParagraphBuilder implements ui.ParagraphBuilder {
     _ops.add(text);
   }
 
+  @override
+  void addStyledText(Uint16List text, List<ui.TextStyle> styles, Int32List runs) {
+    _addStyledTextByRun(this, text, styles, runs);
+  }
+
   /// Applies the given paragraph style and returns a [Paragraph] containing the
   /// added text and associated styling.
   ///
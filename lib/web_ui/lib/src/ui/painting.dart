@@ -1486,6 +1486,20 @@ enum ImageByteFormat {
   ///  * <https://en.wikipedia.org/wiki/Portable_Network_Graphics>, the Wikipedia page on PNG.
   ///  * <https://tools.ietf.org/rfc/rfc2083.txt>, the PNG standard.
   png,
+
+  /// PNG format with fast compression.
+  ///
+  /// Encodes several times faster than [png], at the cost of somewhat larger
+  /// output. This format is well suited for large images that are encoded
+  /// often, such as screenshots that are sent elsewhere.
+  pngFast,
+
+  /// PNG format without compression.
+  ///
+  /// Encodes about as fast as the raw formats while still producing a PNG
+  /// image that any decoder can read. The output is slightly larger than the
+  /// raw RGBA bytes of the image.
+  pngUncompressed,
 }
 
 /// The format of pixel data given to [decodeImageFromPixels].
@@ -1636,6 +1650,73 @@ Future<void> _decodeImageFromListAsync(
   callback(frameInfo.image);
 }
 
+/// Callback signature for [IncrementalImageDecoder].
+typedef IncrementalImageDecoderCallback = void Function(Image? image, bool isComplete);
+
+/// Decodes an image from encoded data that arrives in chunks.
+///
+/// On the web the chunks are gathered and decoded once [close] was called, so
+/// `callback` is only called with the complete image, or with null if the
+/// image could not be decoded.
+class IncrementalImageDecoder {
+  /// Creates a decoder that reports the decoded image to `callback`.
+  IncrementalImageDecoder(
+    IncrementalImageDecoderCallback callback, {
+    bool emitIntermediateImages = false,
+  })  : assert(callback != null), // ignore: unnecessary_null_comparison
+        assert(emitIntermediateImages != null), // ignore: unnecessary_null_comparison
+        _callback = callback;
+
+  IncrementalImageDecoderCallback? _callback;
+  final List<Uint8List> _chunks = <Uint8List>[];
+  int _length = 0;
+  bool _closed = false;
+
+  /// Adds the next chunk of the encoded data.
+  void addChunk(Uint8List chunk) {
+    if (_callback != null && !_closed) {
+      _chunks.add(Uint8List.fromList(chunk));
+      _length += chunk.length;
+    }
+  }
+
+  /// Signals that all of the encoded data was added.
+  void close() {
+    if (_callback != null && !_closed) {
+      _closed = true;
+      final Uint8List bytes = Uint8List(_length);
+      int offset = 0;
+      for (final Uint8List chunk in _chunks) {
+        bytes.setAll(offset, chunk);
+        offset += chunk.length;
+      }
+      _chunks.clear();
+      _decode(bytes);
+    }
+  }
+
+  Future<void> _decode(Uint8List list) async {
+    Image? image;
+    try {
+      final Codec codec = await instantiateImageCodec(list);
+      image = (await codec.getNextFrame()).image;
+    } catch (_) {
+      image = null;
+    }
+    final IncrementalImageDecoderCallback? callback = _callback;
+    _callback = null;
+    if (callback != null) {
+      callback(image, true);
+    }
+  }
+
+  /// Stops decoding and releases the resources used by this object.
+  void dispose() {
+    _callback = null;
+    _chunks.clear();
+  }
+}
+
 /// Convert an array of pixel values into an [Image] object.
 ///
 /// [pixels] is the pixel data in the encoding described by [format].
@@ -1413,6 +1413,18 @@ abstract class Paragraph {
   /// The [ParagraphConstraints] control how wide the text is allowed to be.
   void layout(ParagraphConstraints constraints);
 
+  /// Lays out each of the `paragraphs` with the constraints at the same index
+  /// in `constraints`.
+  ///
+  /// This has the same effect as calling [layout] on each paragraph. On the
+  /// web, the paragraphs are laid out one after another.
+  static void layoutAll(List<Paragraph> paragraphs, List<ParagraphConstraints> constraints) {
+    assert(paragraphs.length == constraints.length);
+    for (int index = 0; index < paragraphs.length; index += 1) {
+      paragraphs[index].layout(constraints[index]);
+    }
+  }
+
   /// Returns a list of text boxes that enclose the given text range.
   ///
   /// The [boxHeightStyle] and [boxWidthStyle] parameters allow customization
@@ -1512,6 +1524,18 @@ abstract class ParagraphBuilder {
   /// The text will be styled according to the current stack of text styles.
   void addText(String text);
 
+  /// Adds the UTF-16 code units in `text` to the paragraph in a single call,
+  /// styling its runs with the given `styles`.
+  ///
+  /// The `runs` list holds two entries for each run of the text: the index of
+  /// its style in `styles`, and the offset in `text` where the run ends. Each
+  /// run starts where the previous one ended, and the last run must end at the
+  /// end of `text`.
+  ///
+  /// This has the same effect as pushing the style of each run, adding its
+  /// text and popping the style again. On the web, it is implemented that way.
+  void addStyledText(Uint16List text, List<TextStyle> styles, Int32List runs);
+
   /// Applies the given paragraph style and returns a [Paragraph] containing the
   /// added text and associated styling.
   ///
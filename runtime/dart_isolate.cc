@@ -61,6 +61,7 @@ std::weak_ptr<DartIsolate> DartIsolate::CreateRootIsolate(
     fml::WeakPtr<IOManager> io_manager,
     fml::RefPtr<SkiaUnrefQueue> unref_queue,
     fml::WeakPtr<ImageDecoder> image_decoder,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     std::string advisory_script_uri,
     std::string advisory_script_entrypoint,
     Dart_IsolateFlags* flags,
@@ -86,13 +87,14 @@ std::weak_ptr<DartIsolate> DartIsolate::CreateRootIsolate(
       std::shared_ptr<DartIsolate>(new DartIsolate(
           settings,                      // settings
           task_runners,                  // task runners
-          std::move(snapshot_delegate),  // snapshot delegate
-          std::move(io_manager),         // IO manager
-          std::move(unref_queue),        // Skia unref queue
-          std::move(image_decoder),      // Image Decoder
-          advisory_script_uri,           // advisory URI
-          advisory_script_entrypoint,    // advisory entrypoint
-          true                           // is_root_isolate
+          std::move(snapshot_delegate),       // snapshot delegate
+          std::move(io_manager),              // IO manager
+          std::move(unref_queue),             // Skia unref queue
+          std::move(image_decoder),           // Image Decoder
+          std::move(concurrent_task_runner),  // concurrent task runner
+          advisory_script_uri,                // advisory URI
+          advisory_script_entrypoint,         // advisory entrypoint
+          true                                // is_root_isolate
           )));
 
   DartErrorString error;
@@ -122,6 +124,8 @@ DartIsolate::DartIsolate(const Settings& settings,
                          fml::WeakPtr<IOManager> io_manager,
                          fml::RefPtr<SkiaUnrefQueue> unref_queue,
                          fml::WeakPtr<ImageDecoder> image_decoder,
+                         std::shared_ptr<fml::ConcurrentTaskRunner>
+                             concurrent_task_runner,
                          std::string advisory_script_uri,
                          std::string advisory_script_entrypoint,
                          bool is_root_isolate)
@@ -132,6 +136,7 @@ DartIsolate::DartIsolate(const Settings& settings,
                   std::move(io_manager),
                   std::move(unref_queue),
                   std::move(image_decoder),
+                  std::move(concurrent_task_runner),
                   advisory_script_uri,
                   advisory_script_entrypoint,
                   settings.log_tag,
@@ -602,6 +607,7 @@ Dart_Isolate DartIsolate::DartCreateAndStartServiceIsolate(
           {},                             // IO Manager
           {},                             // Skia unref queue
           {},                             // Image Decoder
+          nullptr,                        // concurrent task runner
           DART_VM_SERVICE_ISOLATE_NAME,   // script uri
           DART_VM_SERVICE_ISOLATE_NAME,   // script entrypoint
           flags,                          // flags
@@ -700,6 +706,7 @@ Dart_Isolate DartIsolate::DartIsolateGroupCreateCallback(
           fml::WeakPtr<IOManager>{},             // io_manager
           fml::RefPtr<SkiaUnrefQueue>{},         // unref_queue
           fml::WeakPtr<ImageDecoder>{},          // image_decoder
+          nullptr,                               // concurrent_task_runner
           advisory_script_uri,                   // advisory_script_uri
           advisory_script_entrypoint,            // advisory_script_entrypoint
           false)));                              // is_root_isolate
@@ -742,6 +749,7 @@ bool DartIsolate::DartIsolateInitializeCallback(void** child_callback_data,
           fml::WeakPtr<IOManager>{},                      // io_manager
           fml::RefPtr<SkiaUnrefQueue>{},                  // unref_queue
           fml::WeakPtr<ImageDecoder>{},                   // image_decoder
+          nullptr,  // concurrent_task_runner
           (*isolate_group_data)->GetAdvisoryScriptURI(),  // advisory_script_uri
           (*isolate_group_data)
               ->GetAdvisoryScriptEntrypoint(),  // advisory_script_entrypoint
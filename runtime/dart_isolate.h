@@ -156,6 +156,8 @@ class DartIsolate : public UIDartState {
   /// @param[in]  io_manager                  The i/o manager.
   /// @param[in]  unref_queue                 The Skia unref queue.
   /// @param[in]  image_decoder               The image decoder.
+  /// @param[in]  concurrent_task_runner      The task runner for the
+  ///                                         concurrent worker pool of the VM.
   /// @param[in]  advisory_script_uri         The advisory script uri. This is
   ///                                         only used in instrumentation.
   /// @param[in]  advisory_script_entrypoint  The advisory script entrypoint.
@@ -197,6 +199,7 @@ class DartIsolate : public UIDartState {
       fml::WeakPtr<IOManager> io_manager,
       fml::RefPtr<SkiaUnrefQueue> skia_unref_queue,
       fml::WeakPtr<ImageDecoder> image_decoder,
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
       std::string advisory_script_uri,
       std::string advisory_script_entrypoint,
       Dart_IsolateFlags* flags,
@@ -406,6 +409,7 @@ class DartIsolate : public UIDartState {
               fml::WeakPtr<IOManager> io_manager,
               fml::RefPtr<SkiaUnrefQueue> unref_queue,
               fml::WeakPtr<ImageDecoder> image_decoder,
+              std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
               std::string advisory_script_uri,
               std::string advisory_script_entrypoint,
               bool is_root_isolate);
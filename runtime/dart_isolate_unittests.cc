@@ -43,6 +43,7 @@ TEST_F(DartIsolateTest, RootIsolateCreationAndShutdown) {
       {},                                 // io manager
       {},                                 // unref queue
       {},                                 // image decoder
+      nullptr,                            // concurrent task runner
       "main.dart",                        // advisory uri
       "main",                             // advisory entrypoint,
       nullptr,                            // flags
@@ -77,6 +78,7 @@ TEST_F(DartIsolateTest, IsolateShutdownCallbackIsInIsolateScope) {
       {},                                 // io manager
       {},                                 // unref queue
       {},                                 // image decoder
+      nullptr,                            // concurrent task runner
       "main.dart",                        // advisory uri
       "main",                             // advisory entrypoint
       nullptr,                            // flags
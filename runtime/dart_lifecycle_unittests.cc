@@ -59,6 +59,7 @@ static std::shared_ptr<DartIsolate> CreateAndRunRootIsolate(
       {},                                 // io_manager
       {},                                 // unref_queue
       {},                                 // image_decoder
+      nullptr,                            // concurrent_task_runner
       "main.dart",                        // advisory_script_uri
       entrypoint.c_str(),                 // advisory_script_entrypoint
       nullptr,                            // flags
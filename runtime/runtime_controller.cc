@@ -49,19 +49,20 @@ RuntimeController::RuntimeController(
   // It will be run at a later point when the engine provides a run
   // configuration and then runs the isolate.
   auto strong_root_isolate =
-      DartIsolate::CreateRootIsolate(vm_->GetVMData()->GetSettings(),  //
-                                     isolate_snapshot_,                //
-                                     task_runners_,                    //
-                                     std::make_unique<Window>(this),   //
-                                     snapshot_delegate_,               //
-                                     io_manager_,                      //
-                                     unref_queue_,                     //
-                                     image_decoder_,                   //
-                                     p_advisory_script_uri,            //
-                                     p_advisory_script_entrypoint,     //
-                                     nullptr,                          //
-                                     isolate_create_callback_,         //
-                                     isolate_shutdown_callback_        //
+      DartIsolate::CreateRootIsolate(vm_->GetVMData()->GetSettings(),       //
+                                     isolate_snapshot_,                     //
+                                     task_runners_,                         //
+                                     std::make_unique<Window>(this),        //
+                                     snapshot_delegate_,                    //
+                                     io_manager_,                           //
+                                     unref_queue_,                          //
+                                     image_decoder_,                        //
+                                     vm_->GetConcurrentWorkerTaskRunner(),  //
+                                     p_advisory_script_uri,                 //
+                                     p_advisory_script_entrypoint,          //
+                                     nullptr,                               //
+                                     isolate_create_callback_,              //
+                                     isolate_shutdown_callback_             //
                                      )
           .lock();
 
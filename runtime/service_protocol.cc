@@ -35,6 +35,11 @@ const std::string_view ServiceProtocol::kGetDisplayRefreshRateExtensionName =
     "_flutter.getDisplayRefreshRate";
 const std::string_view ServiceProtocol::kGetSkSLsExtensionName =
     "_flutter.getSkSLs";
+const std::string_view ServiceProtocol::kGetRasterCacheMetricsExtensionName =
+    "_flutter.getRasterCacheMetrics";
+const std::string_view
+    ServiceProtocol::kGetFrameTimingStatisticsExtensionName =
+        "_flutter.getFrameTimingStatistics";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -53,6 +58,8 @@ ServiceProtocol::ServiceProtocol()
           kSetAssetBundlePathExtensionName,
           kGetDisplayRefreshRateExtensionName,
           kGetSkSLsExtensionName,
+          kGetRasterCacheMetricsExtensionName,
+          kGetFrameTimingStatisticsExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
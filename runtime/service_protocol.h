@@ -28,6 +28,8 @@ class ServiceProtocol {
   static const std::string_view kSetAssetBundlePathExtensionName;
   static const std::string_view kGetDisplayRefreshRateExtensionName;
   static const std::string_view kGetSkSLsExtensionName;
+  static const std::string_view kGetRasterCacheMetricsExtensionName;
+  static const std::string_view kGetFrameTimingStatisticsExtensionName;
 
   class Handler {
    public:
@@ -21,25 +21,32 @@ constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
 
 Animator::Animator(Delegate& delegate,
                    TaskRunners task_runners,
-                   std::unique_ptr<VsyncWaiter> waiter)
+                   std::unique_ptr<VsyncWaiter> waiter,
+                   FrameLatencyMode frame_latency_mode,
+                   uint32_t max_frame_pipeline_depth)
     : delegate_(delegate),
       task_runners_(std::move(task_runners)),
       waiter_(std::move(waiter)),
+      last_vsync_start_time_(),
       last_frame_begin_time_(),
       last_frame_target_time_(),
       dart_frame_deadline_(0),
+      frame_latency_controller_(
+          frame_latency_mode,
 #if FLUTTER_SHELL_ENABLE_METAL
-      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(2)),
+          2,
 #else   // FLUTTER_SHELL_ENABLE_METAL
-      // TODO(dnfield): We should remove this logic and set the pipeline depth
-      // back to 2 in this case. See
-      // https://github.com/flutter/engine/pull/9132 for discussion.
-      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(
-          task_runners.GetPlatformTaskRunner() ==
-                  task_runners.GetRasterTaskRunner()
+          // TODO(dnfield): We should remove this logic and set the pipeline
+          // depth back to 2 in this case. See
+          // https://github.com/flutter/engine/pull/9132 for discussion.
+          task_runners_.GetPlatformTaskRunner() ==
+                  task_runners_.GetRasterTaskRunner()
               ? 1
-              : 2)),
+              : 2,
 #endif  // FLUTTER_SHELL_ENABLE_METAL
+          max_frame_pipeline_depth),
+      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(
+          frame_latency_controller_.GetMaxPipelineDepth())),
       pending_frame_semaphore_(1),
       frame_number_(1),
       paused_(false),
@@ -48,6 +55,8 @@ Animator::Animator(Delegate& delegate,
       notify_idle_task_id_(0),
       dimension_change_pending_(false),
       weak_factory_(this) {
+  layer_tree_pipeline_->SetTargetDepth(
+      frame_latency_controller_.GetPipelineDepth());
 }
 
 Animator::~Animator() = default;
@@ -124,6 +133,7 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
       // If we still don't have valid continuation, the pipeline is currently
       // full because the consumer is being too slow. Try again at the next
       // frame interval.
+      frame_latency_controller_.AddPipelineFullFrame();
       RequestFrame();
       return;
     }
@@ -133,7 +143,8 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
   // to service potential frame.
   FML_DCHECK(producer_continuation_);
 
-  last_frame_begin_time_ = frame_start_time;
+  last_vsync_start_time_ = frame_start_time;
+  last_frame_begin_time_ = fml::TimePoint::Now();
   last_frame_target_time_ = frame_target_time;
   dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
   {
@@ -180,7 +191,7 @@ void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
 
   if (layer_tree) {
     // Note the frame time for instrumentation.
-    layer_tree->RecordBuildTime(last_frame_begin_time_,
+    layer_tree->RecordBuildTime(last_vsync_start_time_, last_frame_begin_time_,
                                 last_frame_target_time_);
   }
 
@@ -239,17 +250,53 @@ void Animator::AwaitVSync() {
       [self = weak_factory_.GetWeakPtr()](fml::TimePoint frame_start_time,
                                           fml::TimePoint frame_target_time) {
         if (self) {
-          if (self->CanReuseLastLayerTree()) {
-            self->DrawLastLayerTree();
-          } else {
-            self->BeginFrame(frame_start_time, frame_target_time);
-          }
+          self->OnVSync(frame_start_time, frame_target_time);
         }
       });
 
   delegate_.OnAnimatorNotifyIdle(dart_frame_deadline_);
 }
 
+void Animator::OnVSync(fml::TimePoint frame_start_time,
+                       fml::TimePoint frame_target_time) {
+  if (CanReuseLastLayerTree()) {
+    DrawLastLayerTree();
+    return;
+  }
+
+  const fml::TimePoint frame_build_time =
+      frame_latency_controller_.GetFrameBuildTime(frame_start_time,
+                                                  frame_target_time);
+  if (frame_build_time <= fml::TimePoint::Now()) {
+    BeginFrame(frame_start_time, frame_target_time);
+    return;
+  }
+
+  // Build the frame as late as possible so that it reflects the latest input.
+  // Until then, the UI thread is idle.
+  TRACE_EVENT0("flutter", "Animator::DelayBeginFrame");
+  task_runners_.GetUITaskRunner()->PostTaskForTime(
+      [self = weak_factory_.GetWeakPtr(), frame_start_time,
+       frame_target_time]() {
+        if (self) {
+          self->BeginFrame(frame_start_time, frame_target_time);
+        }
+      },
+      frame_build_time);
+  delegate_.OnAnimatorNotifyIdle(FxlToDartOrEarlier(frame_build_time));
+}
+
+void Animator::OnFrameRasterized(const FrameTiming& timing) {
+  const float refresh_rate = GetDisplayRefreshRate();
+  const fml::Milliseconds frame_budget =
+      refresh_rate > 0 ? fml::RefreshRateToFrameBudget(refresh_rate)
+                       : fml::kDefaultFrameBudget;
+  frame_latency_controller_.AddFrameTiming(
+      timing, fml::TimeDelta::FromMillisecondsF(frame_budget.count()));
+  layer_tree_pipeline_->SetTargetDepth(
+      frame_latency_controller_.GetPipelineDepth());
+}
+
 void Animator::ScheduleSecondaryVsyncCallback(const fml::closure& callback) {
   waiter_->ScheduleSecondaryCallback(callback);
 }
@@ -12,6 +12,7 @@
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/shell/common/frame_latency_controller.h"
 #include "flutter/shell/common/pipeline.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/vsync_waiter.h"
@@ -43,7 +44,9 @@ class Animator final {
 
   Animator(Delegate& delegate,
            TaskRunners task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           FrameLatencyMode frame_latency_mode = FrameLatencyMode::kDefault,
+           uint32_t max_frame_pipeline_depth = 3);
 
   ~Animator();
 
@@ -80,6 +83,10 @@ class Animator final {
   // will be ended during the next |BeginFrame|.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
 
+  // Adapts the scheduling of upcoming frames to the timings of a rasterized
+  // frame, according to the frame latency mode.
+  void OnFrameRasterized(const FrameTiming& timing);
+
  private:
   using LayerTreePipeline = Pipeline<flutter::LayerTree>;
 
@@ -91,15 +98,20 @@ class Animator final {
 
   void AwaitVSync();
 
+  void OnVSync(fml::TimePoint frame_start_time,
+               fml::TimePoint frame_target_time);
+
   const char* FrameParity();
 
   Delegate& delegate_;
   TaskRunners task_runners_;
   std::shared_ptr<VsyncWaiter> waiter_;
 
+  fml::TimePoint last_vsync_start_time_;
   fml::TimePoint last_frame_begin_time_;
   fml::TimePoint last_frame_target_time_;
   int64_t dart_frame_deadline_;
+  FrameLatencyController frame_latency_controller_;
   fml::RefPtr<LayerTreePipeline> layer_tree_pipeline_;
   fml::Semaphore pending_frame_semaphore_;
   LayerTreePipeline::ProducerContinuation producer_continuation_;
@@ -17,10 +17,13 @@
 #include "flutter/fml/trace_event.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/lib/snapshot/snapshot.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/lib/ui/text/font_collection.h"
 #include "flutter/shell/common/animator.h"
+#include "flutter/shell/common/persistent_cache.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/shell.h"
+#include "flutter/third_party/txt/src/minikin/Layout.h"
 #include "rapidjson/document.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -93,6 +96,8 @@ fml::WeakPtr<Engine> Engine::GetWeakPtr() const {
 void Engine::SetupDefaultFontManager() {
   TRACE_EVENT0("flutter", "Engine::SetupDefaultFontManager");
   font_collection_.SetupDefaultFontManager();
+  font_collection_.GetFontCollection()->SetFontFallbackCache(
+      PersistentCache::GetCacheForProcess()->GetFontFallbackCache());
 }
 
 bool Engine::UpdateAssetManager(
@@ -234,11 +239,24 @@ void Engine::ReportTimings(std::vector<int64_t> timings) {
   runtime_controller_->ReportTimings(std::move(timings));
 }
 
+void Engine::OnFrameRasterized(const FrameTiming& timing) {
+  animator_->OnFrameRasterized(timing);
+}
+
 void Engine::NotifyIdle(int64_t deadline) {
   auto trace_event = std::to_string(deadline - Dart_TimelineGetMicros());
   TRACE_EVENT1("flutter", "Engine::NotifyIdle", "deadline_now_delta",
                trace_event.c_str());
   runtime_controller_->NotifyIdle(deadline);
+
+  // Write out the font fallback matches made while the frames were built
+  // without blocking the UI thread.
+  std::shared_ptr<txt::FontFallbackCache> font_fallback_cache =
+      PersistentCache::GetCacheForProcess()->GetFontFallbackCache();
+  if (font_fallback_cache && font_fallback_cache->IsDirty()) {
+    task_runners_.GetIORunner()->PostTask(
+        [font_fallback_cache]() { font_fallback_cache->Save(); });
+  }
 }
 
 std::pair<bool, uint32_t> Engine::GetUIIsolateReturnCode() {
@@ -454,6 +472,30 @@ void Engine::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
     return;
 
   animator_->Render(std::move(layer_tree));
+
+#if !FLUTTER_RELEASE
+  // The text layout cache is shared by all engines in the process.
+  const minikin::LayoutCacheStatistics text_layout_cache =
+      minikin::Layout::getCacheStatistics();
+  FML_TRACE_COUNTER("flutter", "TextLayoutCache", 0,                  //
+                    "EntryCount", text_layout_cache.entryCount,       //
+                    "MBytes", text_layout_cache.bytes * 1e-6,         //
+                    "MaxMBytes", text_layout_cache.maxBytes * 1e-6,   //
+                    "HitCount", text_layout_cache.hitCount,           //
+                    "MissCount", text_layout_cache.missCount,         //
+                    "EvictionCount", text_layout_cache.evictionCount  //
+  );
+  const DecodedImageCacheStatistics decoded_image_cache =
+      DecodedImageCache::GetInstance().GetStatistics();
+  FML_TRACE_COUNTER("flutter", "DecodedImageCache", 0,                   //
+                    "EntryCount", decoded_image_cache.entry_count,       //
+                    "MBytes", decoded_image_cache.bytes * 1e-6,          //
+                    "MaxMBytes", decoded_image_cache.max_bytes * 1e-6,   //
+                    "HitCount", decoded_image_cache.hit_count,           //
+                    "MissCount", decoded_image_cache.miss_count,         //
+                    "EvictionCount", decoded_image_cache.eviction_count  //
+  );
+#endif  // !FLUTTER_RELEASE
 }
 
 void Engine::UpdateSemantics(SemanticsNodeUpdates update,
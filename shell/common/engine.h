@@ -527,6 +527,15 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   void ReportTimings(std::vector<int64_t> timings);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Lets the animator adapt the scheduling of upcoming frames to
+  ///             the timings of a rasterized frame. The shell only does this
+  ///             if a `FrameLatencyMode` other than the default is selected.
+  ///
+  /// @param[in]  timing  The timings of the rasterized frame.
+  ///
+  void OnFrameRasterized(const FrameTiming& timing);
+
   //----------------------------------------------------------------------------
   /// @brief      Gets the main port of the root isolate. Since the isolate is
   ///             created immediately in the constructor of the engine, it is
@@ -0,0 +1,113 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_latency_controller.h"
+
+#include <algorithm>
+
+namespace flutter {
+
+namespace {
+
+// The raster thread is considered to be starved when it waited at least this
+// long for a frame.
+constexpr fml::TimeDelta kRasterStarvationThreshold =
+    fml::TimeDelta::FromMilliseconds(1);
+
+}  // namespace
+
+FrameLatencyController::FrameLatencyController(FrameLatencyMode mode,
+                                               uint32_t default_pipeline_depth,
+                                               uint32_t max_pipeline_depth)
+    : mode_(mode),
+      min_pipeline_depth_(mode == FrameLatencyMode::kLowLatency
+                              ? 1
+                              : std::max<uint32_t>(default_pipeline_depth, 1)),
+      // A default depth of 1 is required by the platform, see |Animator|.
+      max_pipeline_depth_(
+          mode == FrameLatencyMode::kHighThroughput && min_pipeline_depth_ > 1
+              ? std::max(min_pipeline_depth_, max_pipeline_depth)
+              : min_pipeline_depth_),
+      pipeline_depth_(min_pipeline_depth_) {}
+
+FrameLatencyController::~FrameLatencyController() = default;
+
+FrameLatencyMode FrameLatencyController::GetMode() const {
+  return mode_;
+}
+
+uint32_t FrameLatencyController::GetMaxPipelineDepth() const {
+  return max_pipeline_depth_;
+}
+
+uint32_t FrameLatencyController::GetPipelineDepth() const {
+  return pipeline_depth_;
+}
+
+fml::TimePoint FrameLatencyController::GetFrameBuildTime(
+    fml::TimePoint frame_start_time,
+    fml::TimePoint frame_target_time) const {
+  if (mode_ != FrameLatencyMode::kLowLatency || frame_times_.empty()) {
+    return frame_start_time;
+  }
+
+  // Be pessimistic, a frame that misses its deadline costs a whole vsync
+  // interval of latency.
+  const fml::TimeDelta predicted_frame_time =
+      *std::max_element(frame_times_.begin(), frame_times_.end());
+  return std::max(frame_start_time,
+                  frame_target_time - predicted_frame_time - kLowLatencyMargin);
+}
+
+void FrameLatencyController::AddFrameTiming(const FrameTiming& timing,
+                                            fml::TimeDelta frame_budget) {
+  frame_times_.push_back(timing.Get(FrameTiming::kRasterFinish) -
+                         timing.Get(FrameTiming::kBuildStart));
+  if (frame_times_.size() > kTimingSampleCount) {
+    frame_times_.pop_front();
+  }
+
+  if (min_pipeline_depth_ != max_pipeline_depth_) {
+    TunePipelineDepth(timing, frame_budget);
+  }
+  last_raster_finish_ = timing.Get(FrameTiming::kRasterFinish);
+}
+
+void FrameLatencyController::AddPipelineFullFrame() {
+  window_pipeline_full_count_++;
+}
+
+void FrameLatencyController::TunePipelineDepth(const FrameTiming& timing,
+                                               fml::TimeDelta frame_budget) {
+  // The raster thread was starved if it sat idle waiting for this frame while
+  // frames were being produced continuously.
+  if (last_raster_finish_) {
+    const fml::TimeDelta idle_time =
+        timing.Get(FrameTiming::kRasterStart) - *last_raster_finish_;
+    if (idle_time > kRasterStarvationThreshold &&
+        idle_time < frame_budget * 2) {
+      window_starved_frame_count_++;
+    }
+  }
+
+  if (++window_frame_count_ < kTuningWindow) {
+    return;
+  }
+
+  // A deeper pipeline only helps if the UI thread had to skip frames because
+  // the pipeline was full, and later left the raster thread without work.
+  // Conversely, if the pipeline never filled up, the extra depth is unused.
+  if (window_pipeline_full_count_ > 0 &&
+      window_starved_frame_count_ * 10 >= kTuningWindow) {
+    pipeline_depth_ = std::min(pipeline_depth_ + 1, max_pipeline_depth_);
+  } else if (window_pipeline_full_count_ == 0) {
+    pipeline_depth_ = std::max(pipeline_depth_ - 1, min_pipeline_depth_);
+  }
+
+  window_frame_count_ = 0;
+  window_starved_frame_count_ = 0;
+  window_pipeline_full_count_ = 0;
+}
+
+}  // namespace flutter
@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_LATENCY_CONTROLLER_H_
+#define FLUTTER_SHELL_COMMON_FRAME_LATENCY_CONTROLLER_H_
+
+#include <deque>
+#include <optional>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Decides how many frames the animator may have in flight, and
+///             when it starts building them, according to the
+///             `FrameLatencyMode` and the timings of recently rasterized
+///             frames.
+///
+class FrameLatencyController {
+ public:
+  // The number of recent frames whose build and raster times are used to
+  // predict those of the next frame.
+  static constexpr size_t kTimingSampleCount = 16;
+
+  // How much earlier than predicted a frame is started in
+  // FrameLatencyMode::kLowLatency, to absorb small variations.
+  static constexpr fml::TimeDelta kLowLatencyMargin =
+      fml::TimeDelta::FromMilliseconds(1);
+
+  // The number of frames after which the pipeline depth is adjusted in
+  // FrameLatencyMode::kHighThroughput.
+  static constexpr size_t kTuningWindow = 60;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a controller.
+  ///
+  /// @param[in]  mode                    The frame latency mode.
+  /// @param[in]  default_pipeline_depth  The pipeline depth used in
+  ///                                     `FrameLatencyMode::kDefault`, and
+  ///                                     the least depth used in
+  ///                                     `FrameLatencyMode::kHighThroughput`.
+  /// @param[in]  max_pipeline_depth      The greatest depth used in
+  ///                                     `FrameLatencyMode::kHighThroughput`.
+  ///
+  FrameLatencyController(FrameLatencyMode mode,
+                         uint32_t default_pipeline_depth,
+                         uint32_t max_pipeline_depth);
+
+  ~FrameLatencyController();
+
+  FrameLatencyMode GetMode() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The most frames that may ever be in flight in this mode.
+  ///             The pipeline should be created with this depth.
+  ///
+  uint32_t GetMaxPipelineDepth() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The most frames that may currently be in flight.
+  ///
+  uint32_t GetPipelineDepth() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Determines when to start building the frame for a vsync.
+  ///
+  /// @param[in]  frame_start_time   The time of the vsync.
+  /// @param[in]  frame_target_time  The time the frame should be rasterized
+  ///                                by.
+  ///
+  /// @return     In `FrameLatencyMode::kLowLatency`, the latest time that
+  ///             still leaves enough time to build and rasterize the frame
+  ///             by its target time, as far as recent frames tell. In other
+  ///             modes, the frame start time.
+  ///
+  fml::TimePoint GetFrameBuildTime(fml::TimePoint frame_start_time,
+                                   fml::TimePoint frame_target_time) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Takes the timings of a rasterized frame into account.
+  ///
+  /// @param[in]  timing        The timings of the frame.
+  /// @param[in]  frame_budget  The time between vsyncs.
+  ///
+  void AddFrameTiming(const FrameTiming& timing, fml::TimeDelta frame_budget);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notes that a frame could not be started because the pipeline
+  ///             was full.
+  ///
+  void AddPipelineFullFrame();
+
+ private:
+  const FrameLatencyMode mode_;
+  const uint32_t min_pipeline_depth_;
+  const uint32_t max_pipeline_depth_;
+  uint32_t pipeline_depth_;
+  // The times from the start of building to the end of rasterizing recent
+  // frames.
+  std::deque<fml::TimeDelta> frame_times_;
+  std::optional<fml::TimePoint> last_raster_finish_;
+  size_t window_frame_count_ = 0;
+  size_t window_starved_frame_count_ = 0;
+  size_t window_pipeline_full_count_ = 0;
+
+  void TunePipelineDepth(const FrameTiming& timing,
+                         fml::TimeDelta frame_budget);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameLatencyController);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_LATENCY_CONTROLLER_H_
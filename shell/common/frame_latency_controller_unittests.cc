@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_latency_controller.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr fml::TimeDelta kFrameBudget = fml::TimeDelta::FromMilliseconds(16);
+
+FrameTiming MakeTiming(fml::TimePoint build_start,
+                       fml::TimeDelta build_time,
+                       fml::TimePoint raster_start,
+                       fml::TimeDelta raster_time) {
+  FrameTiming timing;
+  timing.Set(FrameTiming::kBuildStart, build_start);
+  timing.Set(FrameTiming::kBuildFinish, build_start + build_time);
+  timing.Set(FrameTiming::kRasterStart, raster_start);
+  timing.Set(FrameTiming::kRasterFinish, raster_start + raster_time);
+  return timing;
+}
+
+// Adds a window of frames that are rasterized back to back, or with the
+// raster thread waiting |raster_idle_time| for each frame.
+void AddTuningWindow(FrameLatencyController& controller,
+                     fml::TimePoint& now,
+                     fml::TimeDelta raster_idle_time,
+                     bool pipeline_full) {
+  if (pipeline_full) {
+    controller.AddPipelineFullFrame();
+  }
+  const fml::TimeDelta raster_time = fml::TimeDelta::FromMilliseconds(8);
+  for (size_t i = 0; i < FrameLatencyController::kTuningWindow; i++) {
+    const fml::TimePoint raster_start = now + raster_idle_time;
+    controller.AddFrameTiming(
+        MakeTiming(raster_start - kFrameBudget, kFrameBudget / 2,
+                   raster_start, raster_time),
+        kFrameBudget);
+    now = raster_start + raster_time;
+  }
+}
+
+}  // namespace
+
+TEST(FrameLatencyControllerTest, DefaultModeUsesDefaultDepth) {
+  FrameLatencyController controller(FrameLatencyMode::kDefault, 2, 3);
+  EXPECT_EQ(controller.GetMaxPipelineDepth(), 2u);
+  EXPECT_EQ(controller.GetPipelineDepth(), 2u);
+
+  fml::TimePoint now = fml::TimePoint::Now();
+  AddTuningWindow(controller, now, fml::TimeDelta::FromMilliseconds(4), true);
+  EXPECT_EQ(controller.GetPipelineDepth(), 2u);
+
+  const fml::TimePoint start = fml::TimePoint::Now();
+  EXPECT_EQ(controller.GetFrameBuildTime(start, start + kFrameBudget), start);
+}
+
+TEST(FrameLatencyControllerTest, LowLatencyModeDelaysFrameStart) {
+  FrameLatencyController controller(FrameLatencyMode::kLowLatency, 2, 3);
+  EXPECT_EQ(controller.GetMaxPipelineDepth(), 1u);
+  EXPECT_EQ(controller.GetPipelineDepth(), 1u);
+
+  const fml::TimePoint start = fml::TimePoint::Now();
+  const fml::TimePoint target = start + kFrameBudget;
+  // Without any timings, frames start right away.
+  EXPECT_EQ(controller.GetFrameBuildTime(start, target), start);
+
+  const fml::TimeDelta two_ms = fml::TimeDelta::FromMilliseconds(2);
+  controller.AddFrameTiming(MakeTiming(start, two_ms, start + two_ms, two_ms),
+                            kFrameBudget);
+  controller.AddFrameTiming(
+      MakeTiming(start, two_ms, start + two_ms, two_ms * 2), kFrameBudget);
+  // The slowest recent frame took 6ms from build start to raster finish.
+  EXPECT_EQ(controller.GetFrameBuildTime(start, target),
+            target - fml::TimeDelta::FromMilliseconds(6) -
+                FrameLatencyController::kLowLatencyMargin);
+
+  // A frame slower than the budget starts right away.
+  controller.AddFrameTiming(MakeTiming(start, kFrameBudget,
+                                       start + kFrameBudget, kFrameBudget),
+                            kFrameBudget);
+  EXPECT_EQ(controller.GetFrameBuildTime(start, target), start);
+}
+
+TEST(FrameLatencyControllerTest, HighThroughputModeGrowsWhenRasterStarves) {
+  FrameLatencyController controller(FrameLatencyMode::kHighThroughput, 2, 4);
+  EXPECT_EQ(controller.GetMaxPipelineDepth(), 4u);
+  EXPECT_EQ(controller.GetPipelineDepth(), 2u);
+
+  fml::TimePoint now = fml::TimePoint::Now();
+  const fml::TimeDelta idle = fml::TimeDelta::FromMilliseconds(4);
+  AddTuningWindow(controller, now, idle, true);
+  EXPECT_EQ(controller.GetPipelineDepth(), 3u);
+  AddTuningWindow(controller, now, idle, true);
+  EXPECT_EQ(controller.GetPipelineDepth(), 4u);
+  AddTuningWindow(controller, now, idle, true);
+  EXPECT_EQ(controller.GetPipelineDepth(), 4u);
+}
+
+TEST(FrameLatencyControllerTest, HighThroughputModeKeepsDepthWhenBusy) {
+  FrameLatencyController controller(FrameLatencyMode::kHighThroughput, 2, 4);
+
+  // The pipeline filled up, but the raster thread never waited for a frame,
+  // so a deeper pipeline would only add latency.
+  fml::TimePoint now = fml::TimePoint::Now();
+  AddTuningWindow(controller, now, fml::TimeDelta::Zero(), true);
+  EXPECT_EQ(controller.GetPipelineDepth(), 2u);
+}
+
+TEST(FrameLatencyControllerTest, HighThroughputModeShrinksWhenUnused) {
+  FrameLatencyController controller(FrameLatencyMode::kHighThroughput, 2, 4);
+
+  fml::TimePoint now = fml::TimePoint::Now();
+  const fml::TimeDelta idle = fml::TimeDelta::FromMilliseconds(4);
+  AddTuningWindow(controller, now, idle, true);
+  ASSERT_EQ(controller.GetPipelineDepth(), 3u);
+
+  AddTuningWindow(controller, now, idle, false);
+  EXPECT_EQ(controller.GetPipelineDepth(), 2u);
+  AddTuningWindow(controller, now, idle, false);
+  EXPECT_EQ(controller.GetPipelineDepth(), 2u);
+}
+
+TEST(FrameLatencyControllerTest, HighThroughputModeKeepsDepthOfOne) {
+  // Some platforms require frames to be rasterized one at a time.
+  FrameLatencyController controller(FrameLatencyMode::kHighThroughput, 1, 4);
+  EXPECT_EQ(controller.GetMaxPipelineDepth(), 1u);
+
+  fml::TimePoint now = fml::TimePoint::Now();
+  AddTuningWindow(controller, now, fml::TimeDelta::FromMilliseconds(4), true);
+  EXPECT_EQ(controller.GetPipelineDepth(), 1u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,145 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_recorder.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+FrameTimingHistogram::FrameTimingHistogram() {
+  buckets_.fill(0);
+}
+
+FrameTimingHistogram::~FrameTimingHistogram() = default;
+
+size_t FrameTimingHistogram::BucketForValue(int64_t micros) {
+  const int64_t value =
+      std::clamp<int64_t>(micros, 0, (int64_t{1} << kMaxValueBits) - 1);
+  if (value < kSubBucketCount) {
+    return value;
+  }
+  // Keep the kSubBucketBits + 1 most significant bits of the value as its
+  // significand. The buckets for each shift follow those for the previous one.
+  int shift = 0;
+  while ((value >> shift) >= 2 * kSubBucketCount) {
+    shift++;
+  }
+  return (static_cast<size_t>(shift) << kSubBucketBits) + (value >> shift);
+}
+
+int64_t FrameTimingHistogram::BucketUpperBound(size_t bucket) {
+  if (bucket < static_cast<size_t>(kSubBucketCount)) {
+    return bucket;
+  }
+  const int shift = static_cast<int>(bucket >> kSubBucketBits) - 1;
+  const int64_t significand = static_cast<int64_t>(
+      bucket - (static_cast<size_t>(shift) << kSubBucketBits));
+  return ((significand + 1) << shift) - 1;
+}
+
+void FrameTimingHistogram::Add(fml::TimeDelta duration) {
+  const int64_t micros = duration.ToMicroseconds();
+  buckets_[BucketForValue(micros)]++;
+  count_++;
+  max_micros_ = std::max(max_micros_, micros);
+}
+
+fml::TimeDelta FrameTimingHistogram::GetMax() const {
+  return fml::TimeDelta::FromMicroseconds(max_micros_);
+}
+
+fml::TimeDelta FrameTimingHistogram::GetPercentile(double percentile) const {
+  FML_DCHECK(percentile >= 0 && percentile <= 100);
+  if (count_ == 0) {
+    return fml::TimeDelta::Zero();
+  }
+  // The rank of the sample at the percentile, counting from 1.
+  const size_t rank = std::max<size_t>(
+      1, static_cast<size_t>(std::ceil(percentile / 100 * count_)));
+  size_t seen = 0;
+  for (size_t bucket = 0; bucket < kBucketCount; bucket++) {
+    seen += buckets_[bucket];
+    if (seen >= rank) {
+      return fml::TimeDelta::FromMicroseconds(
+          std::min(BucketUpperBound(bucket), max_micros_));
+    }
+  }
+  return GetMax();
+}
+
+void FrameTimingHistogram::Reset() {
+  buckets_.fill(0);
+  count_ = 0;
+  max_micros_ = 0;
+}
+
+void FrameTimingRecorder::Phase::Add(fml::TimeDelta duration,
+                                     fml::TimeDelta frame_budget) {
+  histogram.Add(duration);
+  if (duration > frame_budget) {
+    over_budget_count++;
+  }
+}
+
+FramePhaseStatistics FrameTimingRecorder::Phase::GetStatistics() const {
+  FramePhaseStatistics statistics;
+  statistics.p50 = histogram.GetPercentile(50);
+  statistics.p90 = histogram.GetPercentile(90);
+  statistics.p99 = histogram.GetPercentile(99);
+  statistics.max = histogram.GetMax();
+  statistics.over_budget_count = over_budget_count;
+  return statistics;
+}
+
+void FrameTimingRecorder::Phase::Reset() {
+  histogram.Reset();
+  over_budget_count = 0;
+}
+
+FrameTimingRecorder::FrameTimingRecorder() = default;
+
+FrameTimingRecorder::~FrameTimingRecorder() = default;
+
+void FrameTimingRecorder::AddFrameTiming(const FrameTiming& timing,
+                                         fml::TimeDelta frame_budget) {
+  const fml::TimeDelta build_time = timing.Get(FrameTiming::kBuildFinish) -
+                                    timing.Get(FrameTiming::kBuildStart);
+  const fml::TimeDelta raster_time = timing.Get(FrameTiming::kRasterFinish) -
+                                     timing.Get(FrameTiming::kRasterStart);
+  vsync_to_build_.Add(
+      timing.Get(FrameTiming::kBuildStart) - timing.GetVsyncStart(),
+      frame_budget);
+  build_.Add(build_time, frame_budget);
+  raster_.Add(raster_time, frame_budget);
+  total_.Add(timing.Get(FrameTiming::kRasterFinish) - timing.GetVsyncStart(),
+             frame_budget);
+  if (build_time > frame_budget || raster_time > frame_budget) {
+    janky_frame_count_++;
+  }
+}
+
+FrameTimingStatistics FrameTimingRecorder::GetStatistics() const {
+  FrameTimingStatistics statistics;
+  statistics.frame_count = total_.histogram.GetCount();
+  statistics.janky_frame_count = janky_frame_count_;
+  statistics.vsync_to_build = vsync_to_build_.GetStatistics();
+  statistics.build = build_.GetStatistics();
+  statistics.raster = raster_.GetStatistics();
+  statistics.total = total_.GetStatistics();
+  return statistics;
+}
+
+void FrameTimingRecorder::Reset() {
+  janky_frame_count_ = 0;
+  vsync_to_build_.Reset();
+  build_.Reset();
+  raster_.Reset();
+  total_.Reset();
+}
+
+}  // namespace flutter
@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_TIMING_RECORDER_H_
+#define FLUTTER_SHELL_COMMON_FRAME_TIMING_RECORDER_H_
+
+#include <array>
+#include <cstdint>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A histogram of durations with a fixed memory footprint and
+///             constant time insertion.
+///
+///             Durations are kept in microseconds, in buckets whose width
+///             doubles every `kSubBucketCount` buckets. Durations under
+///             `kSubBucketCount` microseconds are exact, and larger ones are
+///             reported with an error of at most 1 / `kSubBucketCount` of
+///             their value. Durations beyond about a minute are clamped.
+///
+class FrameTimingHistogram {
+ public:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr int64_t kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr int kMaxValueBits = 26;
+  static constexpr size_t kBucketCount =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+  FrameTimingHistogram();
+
+  ~FrameTimingHistogram();
+
+  void Add(fml::TimeDelta duration);
+
+  size_t GetCount() const { return count_; }
+
+  fml::TimeDelta GetMax() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Estimates a percentile of the recorded durations.
+  ///
+  /// @param[in]  percentile  The percentile, in the range [0, 100].
+  ///
+  /// @return     The upper bound of the bucket holding the percentile, but no
+  ///             more than the largest recorded duration. Zero if nothing
+  ///             was recorded.
+  ///
+  fml::TimeDelta GetPercentile(double percentile) const;
+
+  void Reset();
+
+ private:
+  std::array<uint32_t, kBucketCount> buckets_;
+  size_t count_ = 0;
+  int64_t max_micros_ = 0;
+
+  static size_t BucketForValue(int64_t micros);
+
+  static int64_t BucketUpperBound(size_t bucket);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingHistogram);
+};
+
+/// The distribution of the time taken by one phase of recent frames.
+struct FramePhaseStatistics {
+  fml::TimeDelta p50;
+  fml::TimeDelta p90;
+  fml::TimeDelta p99;
+  fml::TimeDelta max;
+  /// The number of frames for which the phase took longer than the frame
+  /// budget.
+  size_t over_budget_count = 0;
+};
+
+/// A summary of the timings of the frames rasterized by a shell.
+struct FrameTimingStatistics {
+  size_t frame_count = 0;
+  /// The number of frames that took longer than the frame budget to build or
+  /// to rasterize, and so missed at least one vsync.
+  size_t janky_frame_count = 0;
+  /// From the vsync a frame was scheduled for to the UI thread starting to
+  /// build it.
+  FramePhaseStatistics vsync_to_build;
+  /// From the UI thread starting to build a frame to it finishing.
+  FramePhaseStatistics build;
+  /// From the raster thread starting to rasterize a frame to it finishing.
+  FramePhaseStatistics raster;
+  /// From the vsync a frame was scheduled for to the end of rasterizing it.
+  FramePhaseStatistics total;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Accumulates the timings of rasterized frames into a histogram
+///             per phase. This is cheap enough to always be enabled. This
+///             class is not thread safe.
+///
+class FrameTimingRecorder {
+ public:
+  FrameTimingRecorder();
+
+  ~FrameTimingRecorder();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the timings of a rasterized frame.
+  ///
+  /// @param[in]  timing        The timings of the frame.
+  /// @param[in]  frame_budget  The time between vsyncs when the frame was
+  ///                           rasterized.
+  ///
+  void AddFrameTiming(const FrameTiming& timing, fml::TimeDelta frame_budget);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Summarizes the frames recorded since this recorder was
+  ///             created or last reset.
+  ///
+  FrameTimingStatistics GetStatistics() const;
+
+  void Reset();
+
+ private:
+  struct Phase {
+    FrameTimingHistogram histogram;
+    size_t over_budget_count = 0;
+
+    void Add(fml::TimeDelta duration, fml::TimeDelta frame_budget);
+    FramePhaseStatistics GetStatistics() const;
+    void Reset();
+  };
+
+  size_t janky_frame_count_ = 0;
+  Phase vsync_to_build_;
+  Phase build_;
+  Phase raster_;
+  Phase total_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingRecorder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_TIMING_RECORDER_H_
@@ -0,0 +1,136 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_recorder.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr fml::TimeDelta kFrameBudget = fml::TimeDelta::FromMilliseconds(16);
+
+FrameTiming MakeTiming(fml::TimeDelta vsync_to_build,
+                       fml::TimeDelta build_time,
+                       fml::TimeDelta raster_time) {
+  const fml::TimePoint vsync_start = fml::TimePoint::Now();
+  const fml::TimePoint build_finish =
+      vsync_start + vsync_to_build + build_time;
+  FrameTiming timing;
+  timing.SetVsyncStart(vsync_start);
+  timing.Set(FrameTiming::kBuildStart, vsync_start + vsync_to_build);
+  timing.Set(FrameTiming::kBuildFinish, build_finish);
+  timing.Set(FrameTiming::kRasterStart, build_finish);
+  timing.Set(FrameTiming::kRasterFinish, build_finish + raster_time);
+  return timing;
+}
+
+// Percentiles are rounded up to the end of the bucket they fall in.
+void ExpectApproximately(fml::TimeDelta actual, fml::TimeDelta expected) {
+  const int64_t expected_micros = expected.ToMicroseconds();
+  EXPECT_GE(actual.ToMicroseconds(), expected_micros);
+  EXPECT_LE(actual.ToMicroseconds(),
+            expected_micros +
+                expected_micros / FrameTimingHistogram::kSubBucketCount);
+}
+
+}  // namespace
+
+TEST(FrameTimingHistogramTest, EmptyHistogramReportsZero) {
+  FrameTimingHistogram histogram;
+  EXPECT_EQ(histogram.GetCount(), 0u);
+  EXPECT_EQ(histogram.GetPercentile(50), fml::TimeDelta::Zero());
+  EXPECT_EQ(histogram.GetMax(), fml::TimeDelta::Zero());
+}
+
+TEST(FrameTimingHistogramTest, SmallDurationsAreExact) {
+  FrameTimingHistogram histogram;
+  for (int64_t i = 1; i <= 10; i++) {
+    histogram.Add(fml::TimeDelta::FromMicroseconds(i));
+  }
+  EXPECT_EQ(histogram.GetCount(), 10u);
+  EXPECT_EQ(histogram.GetPercentile(0).ToMicroseconds(), 1);
+  EXPECT_EQ(histogram.GetPercentile(50).ToMicroseconds(), 5);
+  EXPECT_EQ(histogram.GetPercentile(90).ToMicroseconds(), 9);
+  EXPECT_EQ(histogram.GetPercentile(100).ToMicroseconds(), 10);
+  EXPECT_EQ(histogram.GetMax().ToMicroseconds(), 10);
+}
+
+TEST(FrameTimingHistogramTest, LargeDurationsAreApproximate) {
+  FrameTimingHistogram histogram;
+  for (int64_t i = 1; i <= 1000; i++) {
+    histogram.Add(fml::TimeDelta::FromMicroseconds(i * 100));
+  }
+  ExpectApproximately(histogram.GetPercentile(50),
+                      fml::TimeDelta::FromMilliseconds(50));
+  ExpectApproximately(histogram.GetPercentile(90),
+                      fml::TimeDelta::FromMilliseconds(90));
+  ExpectApproximately(histogram.GetPercentile(99),
+                      fml::TimeDelta::FromMilliseconds(99));
+  // The largest duration is never overstated.
+  EXPECT_EQ(histogram.GetPercentile(100).ToMicroseconds(), 100000);
+  EXPECT_EQ(histogram.GetMax().ToMicroseconds(), 100000);
+}
+
+TEST(FrameTimingHistogramTest, HugeDurationsAreClamped) {
+  FrameTimingHistogram histogram;
+  histogram.Add(fml::TimeDelta::FromSeconds(3600));
+  histogram.Add(fml::TimeDelta::FromMicroseconds(-5));
+  EXPECT_EQ(histogram.GetCount(), 2u);
+  EXPECT_EQ(histogram.GetPercentile(0), fml::TimeDelta::Zero());
+  EXPECT_EQ(histogram.GetMax(), fml::TimeDelta::FromSeconds(3600));
+}
+
+TEST(FrameTimingHistogramTest, ResetClearsDurations) {
+  FrameTimingHistogram histogram;
+  histogram.Add(fml::TimeDelta::FromMilliseconds(20));
+  histogram.Reset();
+  EXPECT_EQ(histogram.GetCount(), 0u);
+  EXPECT_EQ(histogram.GetMax(), fml::TimeDelta::Zero());
+  histogram.Add(fml::TimeDelta::FromMicroseconds(3));
+  EXPECT_EQ(histogram.GetPercentile(100).ToMicroseconds(), 3);
+}
+
+TEST(FrameTimingRecorderTest, SummarizesPhases) {
+  FrameTimingRecorder recorder;
+  const fml::TimeDelta one_ms = fml::TimeDelta::FromMilliseconds(1);
+  for (int i = 0; i < 98; i++) {
+    recorder.AddFrameTiming(MakeTiming(one_ms, one_ms * 4, one_ms * 8),
+                            kFrameBudget);
+  }
+  // A frame that is slow to build, and one that is slow to rasterize.
+  recorder.AddFrameTiming(MakeTiming(one_ms, one_ms * 20, one_ms * 8),
+                          kFrameBudget);
+  recorder.AddFrameTiming(MakeTiming(one_ms * 2, one_ms * 4, one_ms * 30),
+                          kFrameBudget);
+
+  const FrameTimingStatistics statistics = recorder.GetStatistics();
+  EXPECT_EQ(statistics.frame_count, 100u);
+  EXPECT_EQ(statistics.janky_frame_count, 2u);
+
+  ExpectApproximately(statistics.vsync_to_build.p50, one_ms);
+  EXPECT_EQ(statistics.vsync_to_build.max, one_ms * 2);
+  EXPECT_EQ(statistics.vsync_to_build.over_budget_count, 0u);
+
+  ExpectApproximately(statistics.build.p99, one_ms * 4);
+  EXPECT_EQ(statistics.build.max, one_ms * 20);
+  EXPECT_EQ(statistics.build.over_budget_count, 1u);
+
+  ExpectApproximately(statistics.raster.p90, one_ms * 8);
+  EXPECT_EQ(statistics.raster.max, one_ms * 30);
+  EXPECT_EQ(statistics.raster.over_budget_count, 1u);
+
+  ExpectApproximately(statistics.total.p50, one_ms * 13);
+  EXPECT_EQ(statistics.total.max, one_ms * 36);
+  EXPECT_EQ(statistics.total.over_budget_count, 2u);
+
+  recorder.Reset();
+  EXPECT_EQ(recorder.GetStatistics().frame_count, 0u);
+  EXPECT_EQ(recorder.GetStatistics().janky_frame_count, 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
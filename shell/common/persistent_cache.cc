@@ -101,17 +101,20 @@ static void FreeOldCacheDirectory(const fml::UniqueFD& cache_base_dir) {
   });
 }
 
+static fml::UniqueFD OpenCacheBaseDirectory(
+    const std::string& global_cache_base_path) {
+  if (global_cache_base_path.length()) {
+    return fml::OpenDirectory(global_cache_base_path.c_str(), false,
+                              fml::FilePermission::kRead);
+  }
+  return fml::paths::GetCachesDirectory();
+}
+
 static std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
     const std::string& global_cache_base_path,
     bool read_only,
     bool cache_sksl) {
-  fml::UniqueFD cache_base_dir;
-  if (global_cache_base_path.length()) {
-    cache_base_dir = fml::OpenDirectory(global_cache_base_path.c_str(), false,
-                                        fml::FilePermission::kRead);
-  } else {
-    cache_base_dir = fml::paths::GetCachesDirectory();
-  }
+  fml::UniqueFD cache_base_dir = OpenCacheBaseDirectory(global_cache_base_path);
 
   if (cache_base_dir.is_valid()) {
     FreeOldCacheDirectory(cache_base_dir);
@@ -216,6 +219,33 @@ PersistentCache::PersistentCache(bool read_only)
 
 PersistentCache::~PersistentCache() = default;
 
+std::shared_ptr<txt::FontFallbackCache>
+PersistentCache::GetFontFallbackCache() {
+  std::call_once(font_fallback_cache_once_, [this]() {
+    // The cache does not depend on the Skia version, so it lives beside the
+    // Skia caches rather than below them.
+    fml::UniqueFD cache_base_dir = OpenCacheBaseDirectory(cache_base_path_);
+    if (!cache_base_dir.is_valid()) {
+      return;
+    }
+    fml::UniqueFD directory = CreateDirectory(
+        cache_base_dir,
+        {kEngineComponent, GetFlutterEngineVersion(), kTextSubdirName},
+        is_read_only_ ? fml::FilePermission::kRead
+                      : fml::FilePermission::kReadWrite);
+    if (!directory.is_valid()) {
+      FML_LOG(WARNING) << "Could not acquire the font fallback cache "
+                          "directory. Caching of font fallback on disk is "
+                          "disabled.";
+      return;
+    }
+    font_fallback_cache_ =
+        std::make_shared<txt::FontFallbackCache>(std::move(directory),
+                                                 is_read_only_);
+  });
+  return font_fallback_cache_;
+}
+
 bool PersistentCache::IsValid() const {
   return cache_directory_ && cache_directory_->is_valid();
 }
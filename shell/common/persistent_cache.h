@@ -13,6 +13,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/fml/unique_fd.h"
+#include "flutter/third_party/txt/src/txt/font_fallback_cache.h"
 #include "third_party/skia/include/gpu/GrContextOptions.h"
 
 namespace flutter {
@@ -66,6 +67,11 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   /// Load all the SkSL shader caches in the right directory.
   std::vector<SkSLCache> LoadSkSLs();
 
+  /// The cache of the coverage of fonts and of the fallback fonts matched for
+  /// code points, shared by the text layout of every engine in the process.
+  /// This is null if its directory could not be opened.
+  std::shared_ptr<txt::FontFallbackCache> GetFontFallbackCache();
+
   /// Set the asset manager from which PersistentCache can load SkLSs. A nullptr
   /// can be provided to clear the asset manager.
   static void SetAssetManager(std::shared_ptr<AssetManager> value);
@@ -76,6 +82,7 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   static constexpr char kSkSLSubdirName[] = "sksl";
   static constexpr char kAssetFileName[] = "io.flutter.shaders.json";
+  static constexpr char kTextSubdirName[] = "txt";
 
  private:
   static std::string cache_base_path_;
@@ -98,6 +105,8 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  std::once_flag font_fallback_cache_once_;
+  std::shared_ptr<txt::FontFallbackCache> font_fallback_cache_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
 
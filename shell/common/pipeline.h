@@ -10,6 +10,8 @@
 #include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/trace_event.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -91,13 +93,28 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   };
 
   explicit Pipeline(uint32_t depth)
-      : depth_(depth), empty_(depth), available_(0), inflight_(0) {}
+      : depth_(depth),
+        target_depth_(depth),
+        empty_(depth),
+        available_(0),
+        inflight_(0) {}
 
   ~Pipeline() = default;
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  /// Limits the number of resources in flight to fewer than the depth the
+  /// pipeline was created with. Resources already in flight are unaffected.
+  void SetTargetDepth(uint32_t target_depth) {
+    target_depth_ = std::clamp<uint32_t>(target_depth, 1, depth_);
+  }
+
+  uint32_t GetTargetDepth() const { return target_depth_; }
+
   ProducerContinuation Produce() {
+    if (static_cast<uint32_t>(inflight_.load()) >= target_depth_) {
+      return {};
+    }
     if (!empty_.TryWait()) {
       return {};
     }
@@ -118,6 +135,9 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   // Prefer using |Produce|. ProducerContinuation returned by this method
   // doesn't guarantee that the frame will be rendered.
   ProducerContinuation ProduceIfEmpty() {
+    if (static_cast<uint32_t>(inflight_.load()) >= target_depth_) {
+      return {};
+    }
     if (!empty_.TryWait()) {
       return {};
     }
@@ -173,6 +193,7 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
 
  private:
   const uint32_t depth_;
+  std::atomic<uint32_t> target_depth_;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::atomic<int> inflight_;
@@ -197,6 +218,7 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
         // Bail if the queue is not empty, opens up spaces to produce other
         // frames.
         empty_.Signal();
+        --inflight_;
         return false;
       }
       queue_.emplace_back(std::move(resource), trace_id);
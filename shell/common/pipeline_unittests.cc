@@ -130,5 +130,50 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, TargetDepthLimitsResourcesInFlight) {
+  const int depth = 3;
+  fml::RefPtr<IntPipeline> pipeline = fml::MakeRefCounted<IntPipeline>(depth);
+  pipeline->SetTargetDepth(1);
+  ASSERT_EQ(pipeline->GetTargetDepth(), 1u);
+
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1);
+  ASSERT_FALSE(pipeline->Produce());
+
+  pipeline->SetTargetDepth(2);
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_TRUE(continuation_2);
+  ASSERT_FALSE(pipeline->Produce());
+
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)));
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 1); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  ASSERT_TRUE(pipeline->Produce());
+}
+
+TEST(PipelineTest, TargetDepthIsClampedToDepth) {
+  const int depth = 2;
+  fml::RefPtr<IntPipeline> pipeline = fml::MakeRefCounted<IntPipeline>(depth);
+  pipeline->SetTargetDepth(5);
+  ASSERT_EQ(pipeline->GetTargetDepth(), 2u);
+  pipeline->SetTargetDepth(0);
+  ASSERT_EQ(pipeline->GetTargetDepth(), 1u);
+}
+
+TEST(PipelineTest, FailedProduceIfEmptyDoesNotReduceTargetDepth) {
+  const int depth = 2;
+  fml::RefPtr<IntPipeline> pipeline = fml::MakeRefCounted<IntPipeline>(depth);
+  pipeline->SetTargetDepth(2);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->ProduceIfEmpty();
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)));
+  ASSERT_FALSE(continuation_2.Complete(std::make_unique<int>(2)));
+
+  // Only the first resource is in flight.
+  ASSERT_TRUE(pipeline->Produce());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -75,6 +75,9 @@ void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
     SetResourceCacheMaxBytes(max_cache_bytes_.value(),
                              user_override_resource_cache_bytes_);
   }
+  if (concurrent_raster_task_runner_) {
+    surface_->SetConcurrentRasterTaskRunner(concurrent_raster_task_runner_);
+  }
   compositor_context_->OnGrContextCreated();
 #if !defined(OS_FUCHSIA)
   // TODO(sanjayc77): https://github.com/flutter/flutter/issues/53179. Add
@@ -288,6 +291,7 @@ RasterStatus Rasterizer::DoDraw(
 #if !defined(OS_FUCHSIA)
   const fml::TimePoint frame_target_time = layer_tree->target_time();
 #endif
+  timing.SetVsyncStart(layer_tree->vsync_start());
   timing.Set(FrameTiming::kBuildStart, layer_tree->build_start());
   timing.Set(FrameTiming::kBuildFinish, layer_tree->build_finish());
   timing.Set(FrameTiming::kRasterStart, fml::TimePoint::Now());
@@ -417,11 +421,29 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
       raster_thread_merger_         // thread merger
   );
 
+  // Surfaces that keep the previous frame's contents only need the region that
+  // changed since then to be repainted. This is not attempted when an external
+  // view embedder splits the frame across several canvases.
+  std::unique_ptr<FrameDamage> damage;
+  const auto& framebuffer_info = frame->framebuffer_info();
+  if (framebuffer_info.supports_partial_repaint &&
+      external_view_embedder == nullptr) {
+    damage = std::make_unique<FrameDamage>();
+    damage->SetPreviousLayerTree(last_layer_tree_.get());
+    if (framebuffer_info.existing_damage) {
+      damage->AddAdditionalDamage(*framebuffer_info.existing_damage);
+    }
+  }
+
   if (compositor_frame) {
-    RasterStatus raster_status = compositor_frame->Raster(layer_tree, false);
+    RasterStatus raster_status =
+        compositor_frame->Raster(layer_tree, false, damage.get());
     if (raster_status == RasterStatus::kFailed) {
       return raster_status;
     }
+    if (damage) {
+      frame->set_submit_info({damage->GetFrameDamage()});
+    }
     if (external_view_embedder != nullptr) {
       FML_DCHECK(!frame->IsSubmitted());
       external_view_embedder->SubmitFrame(surface_->GetContext(),
@@ -464,7 +486,7 @@ static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
       nullptr, recorder.getRecordingCanvas(), nullptr,
       root_surface_transformation, false, true, nullptr);
 
-  frame->Raster(*tree, true);
+  frame->Raster(*tree, true, nullptr);
 
   SkSerialProcs procs = {0};
   procs.fTypefaceProc = SerializeTypeface;
@@ -521,7 +543,7 @@ sk_sp<SkData> Rasterizer::ScreenshotLayerTreeAsImage(
       surface_context, canvas, nullptr, root_surface_transformation, false,
       true, nullptr);
   canvas->clear(SK_ColorTRANSPARENT);
-  frame->Raster(*tree, true);
+  frame->Raster(*tree, true, nullptr);
   canvas->flush();
 
   // snapshot_surface->makeImageSnapshot needs the GL context to be set if the
@@ -653,6 +675,14 @@ std::optional<size_t> Rasterizer::GetResourceCacheMaxBytes() const {
   return std::nullopt;
 }
 
+void Rasterizer::SetConcurrentRasterTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+  concurrent_raster_task_runner_ = std::move(task_runner);
+  if (surface_) {
+    surface_->SetConcurrentRasterTaskRunner(concurrent_raster_task_runner_);
+  }
+}
+
 Rasterizer::Screenshot::Screenshot() {}
 
 Rasterizer::Screenshot::Screenshot(sk_sp<SkData> p_data, SkISize p_size)
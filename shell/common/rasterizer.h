@@ -430,6 +430,20 @@ class Rasterizer final : public SnapshotDelegate {
   ///
   std::optional<size_t> GetResourceCacheMaxBytes() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Lets surfaces that rasterize on the CPU split each frame into
+  ///             tiles that are rasterized in parallel on the workers of the
+  ///             given task runner. This setting is applied to the current
+  ///             surface, if any, and to surfaces set up later.
+  ///
+  /// @see        `Surface::SetConcurrentRasterTaskRunner`
+  ///
+  /// @param[in]  task_runner  The task runner of the workers, or nullptr to
+  ///                          rasterize frames on the raster thread alone.
+  ///
+  void SetConcurrentRasterTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner);
+
  private:
   Delegate& delegate_;
   TaskRunners task_runners_;
@@ -444,6 +458,7 @@ class Rasterizer final : public SnapshotDelegate {
   fml::closure next_frame_callback_;
   bool user_override_resource_cache_bytes_;
   std::optional<size_t> max_cache_bytes_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_raster_task_runner_;
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
   std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
@@ -19,12 +19,15 @@
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/fml/unique_fd.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+#include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/persistent_cache.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/vsync_waiter.h"
+#include "flutter/third_party/txt/src/minikin/Layout.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
@@ -68,6 +71,23 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        RasterCache& raster_cache =
+            rasterizer->compositor_context()->raster_cache();
+        if (shell->GetSettings().raster_cache_max_bytes > 0) {
+          raster_cache.SetMaxBytes(shell->GetSettings().raster_cache_max_bytes);
+        }
+        if (shell->GetSettings().enable_async_raster_cache) {
+          raster_cache.SetConcurrentTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        if (shell->GetSettings().enable_parallel_software_rasterization) {
+          rasterizer->SetConcurrentRasterTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        {
+          std::scoped_lock lock(shell->raster_cache_metrics_mutex_);
+          shell->raster_cache_metrics_ = raster_cache.GetMetrics();
+        }
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
@@ -145,8 +165,10 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
 
         // The animator is owned by the UI thread but it gets its vsync pulses
         // from the platform.
-        auto animator = std::make_unique<Animator>(*shell, task_runners,
-                                                   std::move(vsync_waiter));
+        auto animator = std::make_unique<Animator>(
+            *shell, task_runners, std::move(vsync_waiter),
+            shell->GetSettings().frame_latency_mode,
+            shell->GetSettings().max_frame_pipeline_depth);
 
         engine_promise.set_value(std::make_unique<Engine>(
             *shell,                         //
@@ -234,6 +256,24 @@ static void PerformInitializationTasks(Settings& settings) {
       }
     }
   });
+
+  // The text layout cache is shared by all shells. The most recently created
+  // shell that specifies a budget decides it.
+  if (settings.text_layout_cache_max_bytes > 0) {
+    minikin::Layout::setCacheMaxBytes(settings.text_layout_cache_max_bytes);
+  }
+
+  // The decoded image cache is shared by all shells in the same way.
+  if (settings.decoded_image_cache_max_bytes > 0) {
+    DecodedImageCache::GetInstance().SetMaxBytes(
+        settings.decoded_image_cache_max_bytes);
+  }
+  if (settings.animated_image_frame_cache_count > 0 ||
+      settings.animated_image_frame_cache_max_bytes > 0) {
+    MultiFrameCodec::SetFrameCacheLimits(
+        settings.animated_image_frame_cache_count,
+        settings.animated_image_frame_cache_max_bytes);
+  }
 }
 
 std::unique_ptr<Shell> Shell::Create(
@@ -374,6 +414,16 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
       task_runners_.GetIOTaskRunner(),
       std::bind(&Shell::OnServiceProtocolGetSkSLs, this, std::placeholders::_1,
                 std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetRasterCacheMetricsExtensionName] = {
+          task_runners_.GetRasterTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetRasterCacheMetrics, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetFrameTimingStatisticsExtensionName] = {
+          task_runners_.GetRasterTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetFrameTimingStatistics, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -440,6 +490,9 @@ void Shell::NotifyLowMemoryWarning() const {
   // running.
   ::Dart_NotifyLowMemory();
 
+  // Images decoded by any shell can be decoded again when they are next used.
+  DecodedImageCache::GetInstance().Purge();
+
   task_runners_.GetRasterTaskRunner()->PostTask(
       [rasterizer = rasterizer_->GetWeakPtr(), trace_id = trace_id]() {
         if (rasterizer) {
@@ -1146,6 +1199,28 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  {
+    std::scoped_lock lock(raster_cache_metrics_mutex_);
+    raster_cache_metrics_ =
+        rasterizer_->compositor_context()->raster_cache().GetMetrics();
+  }
+
+  UpdateFrameLatency(timing);
+
+  {
+    std::scoped_lock lock(frame_timing_recorder_mutex_);
+    frame_timing_recorder_.AddFrameTiming(
+        timing, fml::TimeDelta::FromMillisecondsF(GetFrameBudget().count()));
+  }
+
+  if (settings_.frame_latency_mode != FrameLatencyMode::kDefault) {
+    task_runners_.GetUITaskRunner()->PostTask([timing, engine = weak_engine_] {
+      if (engine) {
+        engine->OnFrameRasterized(timing);
+      }
+    });
+  }
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1195,6 +1270,29 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   }
 }
 
+void Shell::UpdateFrameLatency(const FrameTiming& timing) {
+  const fml::TimeDelta latency = timing.Get(FrameTiming::kRasterFinish) -
+                                 timing.Get(FrameTiming::kBuildStart);
+  FML_TRACE_COUNTER("flutter", "FrameLatency",
+                    reinterpret_cast<int64_t>(this),        //
+                    "latency (us)", latency.ToMicroseconds()  //
+  );
+
+  recent_frame_latencies_.push_back(latency);
+  recent_frame_latencies_sum_ = recent_frame_latencies_sum_ + latency;
+  if (recent_frame_latencies_.size() > FrameLatency::kAverageWindow) {
+    recent_frame_latencies_sum_ =
+        recent_frame_latencies_sum_ - recent_frame_latencies_.front();
+    recent_frame_latencies_.pop_front();
+  }
+
+  std::scoped_lock lock(frame_latency_mutex_);
+  frame_latency_.last = latency;
+  frame_latency_.frame_count = recent_frame_latencies_.size();
+  frame_latency_.average = recent_frame_latencies_sum_ /
+                           static_cast<int64_t>(frame_latency_.frame_count);
+}
+
 fml::Milliseconds Shell::GetFrameBudget() {
   if (display_refresh_rate_ > 0) {
     return fml::RefreshRateToFrameBudget(display_refresh_rate_.load());
@@ -1419,6 +1517,76 @@ bool Shell::OnServiceProtocolGetSkSLs(
   return true;
 }
 
+bool Shell::OnServiceProtocolGetRasterCacheMetrics(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  const RasterCacheMetrics metrics =
+      rasterizer_->compositor_context()->raster_cache().GetMetrics();
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "RasterCacheMetrics", allocator);
+  response.AddMember("layerCount", static_cast<uint64_t>(metrics.layer_count),
+                     allocator);
+  response.AddMember("layerBytes", static_cast<uint64_t>(metrics.layer_bytes),
+                     allocator);
+  response.AddMember("pictureCount",
+                     static_cast<uint64_t>(metrics.picture_count), allocator);
+  response.AddMember("pictureBytes",
+                     static_cast<uint64_t>(metrics.picture_bytes), allocator);
+  response.AddMember("maxBytes", static_cast<uint64_t>(metrics.max_bytes),
+                     allocator);
+  response.AddMember("hitCount", static_cast<uint64_t>(metrics.hit_count),
+                     allocator);
+  response.AddMember("missCount", static_cast<uint64_t>(metrics.miss_count),
+                     allocator);
+  response.AddMember("evictionCount",
+                     static_cast<uint64_t>(metrics.eviction_count), allocator);
+  return true;
+}
+
+static void AddFramePhaseStatistics(const char* name,
+                                    const FramePhaseStatistics& statistics,
+                                    rapidjson::Document& response) {
+  auto& allocator = response.GetAllocator();
+  rapidjson::Value phase(rapidjson::kObjectType);
+  phase.AddMember("p50Micros", statistics.p50.ToMicroseconds(), allocator);
+  phase.AddMember("p90Micros", statistics.p90.ToMicroseconds(), allocator);
+  phase.AddMember("p99Micros", statistics.p99.ToMicroseconds(), allocator);
+  phase.AddMember("maxMicros", statistics.max.ToMicroseconds(), allocator);
+  phase.AddMember("overBudgetCount",
+                  static_cast<uint64_t>(statistics.over_budget_count),
+                  allocator);
+  response.AddMember(rapidjson::StringRef(name), phase, allocator);
+}
+
+bool Shell::OnServiceProtocolGetFrameTimingStatistics(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  auto reset = params.find("reset");
+  const FrameTimingStatistics statistics = GetFrameTimingStatistics(
+      reset != params.end() && reset->second == "true");
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "FrameTimingStatistics", allocator);
+  response.AddMember("frameBudgetMicros",
+                     fml::TimeDelta::FromMillisecondsF(GetFrameBudget().count())
+                         .ToMicroseconds(),
+                     allocator);
+  response.AddMember("frameCount",
+                     static_cast<uint64_t>(statistics.frame_count), allocator);
+  response.AddMember("jankyFrameCount",
+                     static_cast<uint64_t>(statistics.janky_frame_count),
+                     allocator);
+  AddFramePhaseStatistics("vsyncToBuild", statistics.vsync_to_build,
+                          response);
+  AddFramePhaseStatistics("build", statistics.build, response);
+  AddFramePhaseStatistics("raster", statistics.raster, response);
+  AddFramePhaseStatistics("total", statistics.total, response);
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -1502,6 +1670,25 @@ fml::Status Shell::WaitForFirstFrame(fml::TimeDelta timeout) {
   }
 }
 
+RasterCacheMetrics Shell::GetRasterCacheMetrics() const {
+  std::scoped_lock lock(raster_cache_metrics_mutex_);
+  return raster_cache_metrics_;
+}
+
+FrameLatency Shell::GetFrameLatency() const {
+  std::scoped_lock lock(frame_latency_mutex_);
+  return frame_latency_;
+}
+
+FrameTimingStatistics Shell::GetFrameTimingStatistics(bool reset) {
+  std::scoped_lock lock(frame_timing_recorder_mutex_);
+  FrameTimingStatistics statistics = frame_timing_recorder_.GetStatistics();
+  if (reset) {
+    frame_timing_recorder_.Reset();
+  }
+  return statistics;
+}
+
 bool Shell::ReloadSystemFonts() {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
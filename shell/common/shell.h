@@ -5,6 +5,7 @@
 #ifndef SHELL_COMMON_SHELL_H_
 #define SHELL_COMMON_SHELL_H_
 
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <string_view>
@@ -31,6 +32,7 @@
 #include "flutter/runtime/service_protocol.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_timing_recorder.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -49,6 +51,20 @@ enum class DartErrorCode {
   UnknownError = 255
 };
 
+/// The time from the start of building a frame to the end of rasterizing it.
+struct FrameLatency {
+  static constexpr size_t kAverageWindow = 60;
+
+  /// The latency of the last rasterized frame.
+  fml::TimeDelta last;
+  /// The average latency of up to the last `kAverageWindow` rasterized
+  /// frames.
+  fml::TimeDelta average;
+  /// The number of frames the average was taken over. Zero until the first
+  /// frame is rasterized.
+  size_t frame_count = 0;
+};
+
 //------------------------------------------------------------------------------
 /// Perhaps the single most important class in the Flutter engine repository.
 /// When embedders create a Flutter application, they are referring to the
@@ -321,6 +337,38 @@ class Shell final : public PlatformView::Delegate,
   ///
   fml::Status WaitForFirstFrame(fml::TimeDelta timeout);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Reports the contents and effectiveness of the raster cache as
+  ///             of the last frame rasterized by this shell. This may be
+  ///             called on any thread.
+  ///
+  /// @return     The raster cache metrics.
+  ///
+  RasterCacheMetrics GetRasterCacheMetrics() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reports the latency achieved by the frames recently
+  ///             rasterized by this shell. This may be called on any thread.
+  ///
+  /// @return     The frame latency.
+  ///
+  /// @see        `FrameLatencyMode`
+  ///
+  FrameLatency GetFrameLatency() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reports the distribution of the time taken by each phase of
+  ///             the frames rasterized by this shell, since it was created or
+  ///             since the statistics were last reset. The statistics are
+  ///             always collected. This may be called on any thread.
+  ///
+  /// @param[in]  reset  Whether to start collecting the statistics afresh
+  ///                    once they have been reported.
+  ///
+  /// @return     The frame timing statistics.
+  ///
+  FrameTimingStatistics GetFrameTimingStatistics(bool reset = false);
+
   //----------------------------------------------------------------------------
   /// @brief      Used by embedders to reload the system fonts in
   /// FontCollection.
@@ -372,6 +420,14 @@ class Shell final : public PlatformView::Delegate,
   DartVMRef vm_;
   mutable std::mutex time_recorder_mutex_;
   std::optional<fml::TimePoint> latest_frame_target_time_;
+  mutable std::mutex raster_cache_metrics_mutex_;
+  RasterCacheMetrics raster_cache_metrics_;
+  mutable std::mutex frame_latency_mutex_;
+  FrameLatency frame_latency_;
+  std::deque<fml::TimeDelta> recent_frame_latencies_;  // on GPU task runner
+  fml::TimeDelta recent_frame_latencies_sum_;          // on GPU task runner
+  std::mutex frame_timing_recorder_mutex_;
+  FrameTimingRecorder frame_timing_recorder_;
   std::unique_ptr<PlatformView> platform_view_;  // on platform task runner
   std::unique_ptr<Engine> engine_;               // on UI task runner
   std::unique_ptr<Rasterizer> rasterizer_;       // on GPU task runner
@@ -439,6 +495,8 @@ class Shell final : public PlatformView::Delegate,
 
   void ReportTimings();
 
+  void UpdateFrameLatency(const FrameTiming& timing);
+
   // |PlatformView::Delegate|
   void OnPlatformViewCreated(std::unique_ptr<Surface> surface) override;
 
@@ -584,6 +642,19 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document& response);
 
+  // Service protocol handler
+  bool OnServiceProtocolGetRasterCacheMetrics(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // If the "reset" parameter is "true", the statistics are collected afresh
+  // after they are reported.
+  bool OnServiceProtocolGetFrameTimingStatistics(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
   fml::WeakPtrFactory<Shell> weak_factory_;
 
   // For accessing the Shell via the raster thread, necessary for various
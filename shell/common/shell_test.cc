@@ -221,6 +221,12 @@ void ShellTest::OnServiceProtocol(
           case ServiceProtocolEnum::kRunInView:
             shell->OnServiceProtocolRunInView(params, response);
             break;
+          case ServiceProtocolEnum::kGetRasterCacheMetrics:
+            shell->OnServiceProtocolGetRasterCacheMetrics(params, response);
+            break;
+          case ServiceProtocolEnum::kGetFrameTimingStatistics:
+            shell->OnServiceProtocolGetFrameTimingStatistics(params, response);
+            break;
         }
         finished.set_value(true);
       });
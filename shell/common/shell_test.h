@@ -84,6 +84,8 @@ class ShellTest : public ThreadTest {
     kGetSkSLs,
     kSetAssetBundlePath,
     kRunInView,
+    kGetRasterCacheMetrics,
+    kGetFrameTimingStatistics,
   };
 
   // Helper method to test private method Shell::OnServiceProtocolGetSkSLs.
@@ -19,6 +19,7 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/persistent_cache.h"
 #include "flutter/shell/common/platform_view.h"
@@ -31,6 +32,7 @@
 #include "flutter/shell/common/vsync_waiter_fallback.h"
 #include "flutter/shell/version/version.h"
 #include "flutter/testing/testing.h"
+#include "flutter/third_party/txt/src/minikin/Layout.h"
 #include "rapidjson/writer.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "third_party/tonic/converter/dart_converter.h"
@@ -1278,6 +1280,90 @@ TEST_F(ShellTest, OnServiceProtocolGetSkSLsWorks) {
   fml::RemoveFilesInDirectory(temp_dir.fd());
 }
 
+TEST_F(ShellTest, OnServiceProtocolGetRasterCacheMetricsWorks) {
+  Settings settings = CreateSettingsForFixture();
+  settings.raster_cache_max_bytes = 4096;
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  ASSERT_EQ(shell->GetRasterCacheMetrics().max_bytes, 4096u);
+
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetRasterCacheMetrics,
+                    shell->GetTaskRunners().GetRasterTaskRunner(),
+                    empty_params, document);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  document.Accept(writer);
+  DestroyShell(std::move(shell));
+
+  const std::string expected_json =
+      "{\"type\":\"RasterCacheMetrics\",\"layerCount\":0,"
+      "\"layerBytes\":0,\"pictureCount\":0,\"pictureBytes\":0,"
+      "\"maxBytes\":4096,\"hitCount\":0,\"missCount\":0,"
+      "\"evictionCount\":0}";
+  ASSERT_EQ(expected_json, buffer.GetString());
+}
+
+TEST_F(ShellTest, TextLayoutCacheMaxBytesIsApplied) {
+  Settings settings = CreateSettingsForFixture();
+  settings.text_layout_cache_max_bytes = 64 * 1024;
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  ASSERT_EQ(minikin::Layout::getCacheStatistics().maxBytes, 64u * 1024);
+  DestroyShell(std::move(shell));
+
+  minikin::Layout::setCacheMaxBytes(minikin::Layout::kDefaultCacheMaxBytes);
+}
+
+TEST_F(ShellTest, DecodedImageCacheMaxBytesIsApplied) {
+  Settings settings = CreateSettingsForFixture();
+  settings.decoded_image_cache_max_bytes = 1024 * 1024;
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  ASSERT_EQ(DecodedImageCache::GetInstance().GetStatistics().max_bytes,
+            1024u * 1024);
+  DestroyShell(std::move(shell));
+
+  DecodedImageCache::GetInstance().SetMaxBytes(
+      DecodedImageCache::kDefaultMaxBytes);
+}
+
+TEST_F(ShellTest, OnServiceProtocolGetFrameTimingStatisticsWorks) {
+  auto settings = CreateSettingsForFixture();
+  fml::AutoResetWaitableEvent timing_latch;
+  settings.frame_rasterized_callback =
+      [&timing_latch](const FrameTiming& t) { timing_latch.Signal(); };
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  ASSERT_EQ(shell->GetFrameTimingStatistics().frame_count, 0u);
+
+  // Create the surface needed by rasterizer
+  PlatformViewNotifyCreated(shell.get());
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+
+  RunEngine(shell.get(), std::move(configuration));
+  PumpOneFrame(shell.get());
+  timing_latch.Wait();
+
+  ServiceProtocol::Handler::ServiceProtocolMap params;
+  params["reset"] = "true";
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetFrameTimingStatistics,
+                    shell->GetTaskRunners().GetRasterTaskRunner(), params,
+                    document);
+
+  ASSERT_STREQ(document["type"].GetString(), "FrameTimingStatistics");
+  ASSERT_EQ(document["frameCount"].GetUint64(), 1u);
+  const auto& total = document["total"];
+  ASSERT_GT(total["maxMicros"].GetInt64(), 0);
+  ASSERT_LE(total["p50Micros"].GetInt64(), total["maxMicros"].GetInt64());
+  ASSERT_GE(total["maxMicros"].GetInt64(),
+            document["raster"]["maxMicros"].GetInt64());
+
+  // The statistics were reset once reported.
+  ASSERT_EQ(shell->GetFrameTimingStatistics().frame_count, 0u);
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, RasterizerScreenshot) {
   Settings settings = CreateSettingsForFixture();
   auto configuration = RunConfiguration::InferFromSettings(settings);
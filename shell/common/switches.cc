@@ -392,6 +392,72 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.cache_sksl =
       command_line.HasOption(FlagForSwitch(Switch::CacheSkSL));
 
+  settings.enable_async_raster_cache =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAsyncRasterCache));
+  settings.enable_parallel_software_rasterization = command_line.HasOption(
+      FlagForSwitch(Switch::EnableParallelSoftwareRasterization));
+
+  std::string frame_latency_mode;
+  if (command_line.GetOptionValue(FlagForSwitch(Switch::FrameLatencyMode),
+                                  &frame_latency_mode)) {
+    if (frame_latency_mode == "low-latency") {
+      settings.frame_latency_mode = FrameLatencyMode::kLowLatency;
+    } else if (frame_latency_mode == "high-throughput") {
+      settings.frame_latency_mode = FrameLatencyMode::kHighThroughput;
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::MaxFramePipelineDepth))) {
+    if (!GetSwitchValue(command_line, Switch::MaxFramePipelineDepth,
+                        &settings.max_frame_pipeline_depth)) {
+      FML_LOG(INFO) << "Maximum frame pipeline depth specified was malformed. "
+                       "Will use the default.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::RasterCacheMaxBytes,
+                        &settings.raster_cache_max_bytes)) {
+      FML_LOG(INFO) << "Raster cache byte limit specified was malformed. Will "
+                       "use the default.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::TextLayoutCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::TextLayoutCacheMaxBytes,
+                        &settings.text_layout_cache_max_bytes)) {
+      FML_LOG(INFO) << "Text layout cache byte limit specified was malformed. "
+                       "Will use the default.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DecodedImageCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::DecodedImageCacheMaxBytes,
+                        &settings.decoded_image_cache_max_bytes)) {
+      FML_LOG(INFO) << "Decoded image cache byte limit specified was "
+                       "malformed. Will use the default.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AnimatedImageFrameCacheCount))) {
+    if (!GetSwitchValue(command_line, Switch::AnimatedImageFrameCacheCount,
+                        &settings.animated_image_frame_cache_count)) {
+      FML_LOG(INFO) << "Animated image frame cache count specified was "
+                       "malformed. Will use the default.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AnimatedImageFrameCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::AnimatedImageFrameCacheMaxBytes,
+                        &settings.animated_image_frame_cache_max_bytes)) {
+      FML_LOG(INFO) << "Animated image frame cache byte limit specified was "
+                       "malformed. Will use the default.";
+    }
+  }
+
   return settings;
 }
 
@@ -189,6 +189,52 @@ DEF_SWITCH(
     "Uses separate threads for the platform, UI, GPU and IO task runners. "
     "By default, a single thread is used for all task runners. Only available "
     "in the flutter_tester.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The maximum number of bytes of rasterized layers and pictures the "
+           "raster cache may retain. When this budget is exceeded, the least "
+           "recently used entries are evicted first.")
+DEF_SWITCH(TextLayoutCacheMaxBytes,
+           "text-layout-cache-max-bytes",
+           "The maximum number of bytes of laid out words the text layout "
+           "cache may retain. When this budget is exceeded, the least recently "
+           "used words are evicted first.")
+DEF_SWITCH(DecodedImageCacheMaxBytes,
+           "decoded-image-cache-max-bytes",
+           "The maximum number of bytes of decoded image pixels, and of the "
+           "encoded data they were decoded from, the decoded image cache may "
+           "retain. When this budget is exceeded, the least recently used "
+           "images are evicted first.")
+DEF_SWITCH(AnimatedImageFrameCacheCount,
+           "animated-image-frame-cache-count",
+           "The number of upcoming frames of animated images that are decoded "
+           "ahead of time on the worker threads.")
+DEF_SWITCH(AnimatedImageFrameCacheMaxBytes,
+           "animated-image-frame-cache-max-bytes",
+           "The maximum number of bytes of decoded frames an animated image "
+           "may have for all of its frames to be kept once decoded, so that "
+           "each frame is decoded only once as the animation loops.")
+DEF_SWITCH(EnableAsyncRasterCache,
+           "enable-async-raster-cache",
+           "Rasterize pictures and layers into the raster cache on worker "
+           "threads instead of the raster thread. Content is drawn directly "
+           "until its cached image is ready.")
+DEF_SWITCH(EnableParallelSoftwareRasterization,
+           "enable-parallel-software-rasterization",
+           "When rendering in software, split each frame into tiles that are "
+           "rasterized in parallel on worker threads. Tiles that nothing is "
+           "drawn into are skipped.")
+DEF_SWITCH(FrameLatencyMode,
+           "frame-latency-mode",
+           "How frames are scheduled. \"low-latency\" keeps a single frame in "
+           "flight and starts building it as late as measured build and "
+           "raster times allow. \"high-throughput\" lets more frames be in "
+           "flight when the raster thread would otherwise wait for the UI "
+           "thread. Anything else selects the default scheduling.")
+DEF_SWITCH(MaxFramePipelineDepth,
+           "max-frame-pipeline-depth",
+           "The most frames that may be in flight when the frame latency mode "
+           "is \"high-throughput\".")
 // TODO(cyanlaz): Remove this when dynamic thread merging is done.
 // https://github.com/flutter/flutter/issues/59930
 DEF_SWITCH(UseEmbeddedView,
@@ -4,11 +4,246 @@
 
 #include "flutter/shell/gpu/gpu_surface_software.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "flutter/flow/rtree.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/utils/SkNWayCanvas.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
 
 namespace flutter {
 
+namespace {
+
+// The width and height of the tiles recorded frames are rasterized in.
+constexpr int kRasterTileSize = 256;
+
+// Forwards painting to a picture recorder, except for the clear that
+// |CompositorContext| starts every frame with. A recorded clear covers every
+// tile, so none could be skipped. The bounds of the clear are kept instead,
+// and each tile is cleared when the recording is rasterized.
+class FrameRecordingCanvas : public SkNWayCanvas {
+ public:
+  FrameRecordingCanvas(SkCanvas* recording_canvas, const SkISize& size)
+      : SkNWayCanvas(size.width(), size.height()) {
+    addCanvas(recording_canvas);
+  }
+
+  // The device space bounds of the clear, if the frame was cleared.
+  const std::optional<SkIRect>& clear_bounds() const { return clear_bounds_; }
+
+ protected:
+  void onDrawPaint(const SkPaint& paint) override {
+    // |CompositorContext| clears the frame before it paints any layer, so a
+    // clear that is the first paint of the frame precedes all other drawing.
+    if (!seen_paint_ && IsClear(paint)) {
+      seen_paint_ = true;
+      clear_bounds_ = getDeviceClipBounds();
+      return;
+    }
+    seen_paint_ = true;
+    SkNWayCanvas::onDrawPaint(paint);
+  }
+
+ private:
+  static bool IsClear(const SkPaint& paint) {
+    return paint.getBlendMode() == SkBlendMode::kSrc &&
+           paint.getColor() == SK_ColorTRANSPARENT &&
+           paint.getShader() == nullptr && paint.getColorFilter() == nullptr &&
+           paint.getImageFilter() == nullptr &&
+           paint.getMaskFilter() == nullptr;
+  }
+
+  bool seen_paint_ = false;
+  std::optional<SkIRect> clear_bounds_;
+};
+
+// A frame that is recorded to be rasterized tile by tile once it is submitted.
+struct FrameRecording {
+  explicit FrameRecording(const SkISize& size)
+      : canvas(recorder.beginRecording(SkRect::Make(size), &rtree_factory),
+               size) {}
+
+  RTreeFactory rtree_factory;
+  SkPictureRecorder recorder;
+  FrameRecordingCanvas canvas;
+};
+
+// Finds backdrop filters, which read pixels that may lie in other tiles.
+class BackdropFilterDetector : public SkNoDrawCanvas {
+ public:
+  BackdropFilterDetector(int width, int height)
+      : SkNoDrawCanvas(width, height) {}
+
+  bool found() const { return found_; }
+
+ protected:
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    found_ |= rec.fBackdrop != nullptr;
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+ private:
+  bool found_ = false;
+};
+
+bool HasBackdropFilter(const SkPicture& picture, const SkISize& size) {
+  BackdropFilterDetector detector(size.width(), size.height());
+  picture.playback(&detector);
+  return detector.found();
+}
+
+// Clears the part of |canvas| that the recorded frame cleared.
+void ClearRecordedBounds(SkCanvas& canvas,
+                         const std::optional<SkIRect>& clear_bounds) {
+  if (!clear_bounds) {
+    return;
+  }
+  canvas.save();
+  canvas.clipRect(SkRect::Make(*clear_bounds));
+  canvas.clear(SK_ColorTRANSPARENT);
+  canvas.restore();
+}
+
+// The tiles of a recorded frame. Workers that start after all tiles were
+// claimed find nothing left to do, so they keep the batch alive but never
+// touch the backing store.
+struct TileBatch {
+  TileBatch(sk_sp<SkPicture> picture,
+            std::optional<SkIRect> clear_bounds,
+            const SkPixmap& pixmap,
+            const SkSurfaceProps& props,
+            std::vector<SkIRect> tiles,
+            std::vector<bool> drawn)
+      : picture(std::move(picture)),
+        clear_bounds(clear_bounds),
+        pixmap(pixmap),
+        props(props),
+        tiles(std::move(tiles)),
+        drawn(std::move(drawn)),
+        remaining(this->tiles.size()) {}
+
+  const sk_sp<SkPicture> picture;
+  const std::optional<SkIRect> clear_bounds;
+  const SkPixmap pixmap;
+  const SkSurfaceProps props;
+  const std::vector<SkIRect> tiles;
+  // Whether the picture draws into the tile at the same index. Other tiles
+  // only need to be cleared.
+  const std::vector<bool> drawn;
+  std::atomic<size_t> next_index = 0;
+  fml::CountDownLatch remaining;
+
+  // Rasterizes tiles until none are left to claim.
+  void RasterizePending() {
+    for (size_t i = next_index++; i < tiles.size(); i = next_index++) {
+      RasterizeTile(tiles[i], drawn[i]);
+      remaining.CountDown();
+    }
+  }
+
+ private:
+  void RasterizeTile(const SkIRect& tile, bool tile_drawn) const {
+    SkPixmap tile_pixmap;
+    if (!pixmap.extractSubset(&tile_pixmap, tile)) {
+      return;
+    }
+    auto canvas = SkCanvas::MakeRasterDirect(tile_pixmap.info(),
+                                             tile_pixmap.writable_addr(),
+                                             tile_pixmap.rowBytes(), &props);
+    canvas->translate(-tile.x(), -tile.y());
+    ClearRecordedBounds(*canvas, clear_bounds);
+    if (tile_drawn) {
+      canvas->drawPicture(picture);
+    }
+  }
+};
+
+// Rasterizes the recorded frame into |backing_store|. Tiles are claimed one at
+// a time by the raster thread and the workers of |task_runner|. Tiles that
+// nothing was drawn into are only cleared, or skipped if the frame did not
+// clear them either.
+void RasterizeRecording(FrameRecording& recording,
+                        SkSurface& backing_store,
+                        fml::ConcurrentTaskRunner& task_runner) {
+  TRACE_EVENT0("flutter", "GPUSurfaceSoftware::RasterizeRecording");
+  sk_sp<SkPicture> picture = recording.recorder.finishRecordingAsPicture();
+  sk_sp<RTree> rtree = recording.rtree_factory.getInstance();
+  const std::optional<SkIRect>& clear_bounds = recording.canvas.clear_bounds();
+  if (picture == nullptr) {
+    return;
+  }
+
+  const SkISize size =
+      SkISize::Make(backing_store.width(), backing_store.height());
+  SkPixmap pixmap;
+  if (!backing_store.peekPixels(&pixmap) ||
+      HasBackdropFilter(*picture, size)) {
+    SkCanvas* canvas = backing_store.getCanvas();
+    ClearRecordedBounds(*canvas, clear_bounds);
+    canvas->drawPicture(picture);
+    canvas->flush();
+    return;
+  }
+
+  std::vector<SkIRect> tiles;
+  std::vector<bool> drawn;
+  // Any op intersecting a tile may draw into it. Ops that do not draw only
+  // make this conservative.
+  std::vector<int> tile_ops;
+  for (int y = 0; y < size.height(); y += kRasterTileSize) {
+    for (int x = 0; x < size.width(); x += kRasterTileSize) {
+      SkIRect tile = SkIRect::MakeXYWH(x, y, kRasterTileSize, kRasterTileSize);
+      if (!tile.intersect(pixmap.bounds())) {
+        continue;
+      }
+      tile_ops.clear();
+      rtree->search(SkRect::Make(tile), &tile_ops);
+      const bool tile_drawn = !tile_ops.empty();
+      if (!tile_drawn &&
+          !(clear_bounds && SkIRect::Intersects(tile, *clear_bounds))) {
+        continue;
+      }
+      tiles.push_back(tile);
+      drawn.push_back(tile_drawn);
+    }
+  }
+  if (tiles.empty()) {
+    return;
+  }
+
+  // Each tile writes to its own pixels of the backing store, so they can be
+  // rasterized concurrently. The raster thread rasterizes tiles too, so the
+  // frame completes even if the workers are busy.
+  auto batch = std::make_shared<TileBatch>(std::move(picture), clear_bounds,
+                                           pixmap, backing_store.props(),
+                                           std::move(tiles), std::move(drawn));
+  const size_t thread_count =
+      std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  const size_t helper_count = std::min(batch->tiles.size(), thread_count) - 1;
+  for (size_t i = 0; i < helper_count; i++) {
+    task_runner.PostTask(
+        [batch]() {
+          TRACE_EVENT0("flutter", "GPUSurfaceSoftware::RasterizeTiles");
+          batch->RasterizePending();
+        },
+        // The raster thread is blocked until all tiles are done.
+        fml::ConcurrentTaskPriority::kHigh);
+  }
+  batch->RasterizePending();
+  batch->remaining.Wait();
+}
+
+}  // namespace
+
 GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
                                        bool render_to_surface)
     : delegate_(delegate),
@@ -56,20 +291,57 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
   SkCanvas* canvas = backing_store->getCanvas();
   canvas->resetMatrix();
 
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  framebuffer_info.supports_partial_repaint = true;
+  if (backing_store != last_presented_backing_store_) {
+    // A new backing store has none of the previous frame's contents.
+    framebuffer_info.existing_damage = SkIRect::MakeSize(size);
+  }
+  // Until this frame is presented, the contents of the backing store are
+  // unknown.
+  last_presented_backing_store_ = nullptr;
+
+  // When rasterizing in parallel, the frame is painted into a recording that
+  // is rasterized into the backing store when the frame is submitted.
+  std::shared_ptr<FrameRecording> recording;
+  if (concurrent_raster_task_runner_) {
+    recording = std::make_shared<FrameRecording>(size);
+  }
+
   SurfaceFrame::SubmitCallback on_submit =
-      [self = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
-                                          SkCanvas* canvas) -> bool {
+      [self = weak_factory_.GetWeakPtr(), recording,
+       task_runner = concurrent_raster_task_runner_](
+          const SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
     // If the surface itself went away, there is nothing more to do.
     if (!self || !self->IsValid() || canvas == nullptr) {
       return false;
     }
 
-    canvas->flush();
+    if (recording) {
+      RasterizeRecording(*recording, *surface_frame.SkiaSurface(),
+                         *task_runner);
+    } else {
+      canvas->flush();
+    }
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    const auto& frame_damage = surface_frame.submit_info().frame_damage;
+    bool presented =
+        frame_damage ? self->delegate_->PresentBackingStoreWithDamage(
+                           surface_frame.SkiaSurface(), *frame_damage)
+                     : self->delegate_->PresentBackingStore(
+                           surface_frame.SkiaSurface());
+    if (presented) {
+      self->last_presented_backing_store_ = surface_frame.SkiaSurface();
+    }
+    return presented;
   };
 
-  return std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  auto frame = std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  frame->set_framebuffer_info(framebuffer_info);
+  if (recording) {
+    frame->set_canvas(&recording->canvas);
+  }
+  return frame;
 }
 
 // |Surface|
@@ -92,4 +364,10 @@ flutter::ExternalViewEmbedder* GPUSurfaceSoftware::GetExternalViewEmbedder() {
   return delegate_->GetExternalViewEmbedder();
 }
 
+// |Surface|
+void GPUSurfaceSoftware::SetConcurrentRasterTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+  concurrent_raster_task_runner_ = std::move(task_runner);
+}
+
 }  // namespace flutter
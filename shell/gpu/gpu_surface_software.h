@@ -34,6 +34,10 @@ class GPUSurfaceSoftware : public Surface {
   // |Surface|
   flutter::ExternalViewEmbedder* GetExternalViewEmbedder() override;
 
+  // |Surface|
+  void SetConcurrentRasterTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) override;
+
  private:
   GPUSurfaceSoftwareDelegate* delegate_;
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
@@ -41,6 +45,13 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  // The backing store that was last presented in full or in part. Delegates
+  // that hand out the same backing store frame after frame keep its contents,
+  // which allows the next frame to repaint only the damaged region.
+  sk_sp<SkSurface> last_presented_backing_store_;
+  // When set, frames are recorded and the recordings rasterized into the
+  // backing store tile by tile on the workers of this task runner.
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_raster_task_runner_;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
@@ -12,4 +12,10 @@ ExternalViewEmbedder* GPUSurfaceSoftwareDelegate::GetExternalViewEmbedder() {
   return nullptr;
 }
 
+bool GPUSurfaceSoftwareDelegate::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const SkIRect& damage) {
+  return PresentBackingStore(std::move(backing_store));
+}
+
 }  // namespace flutter
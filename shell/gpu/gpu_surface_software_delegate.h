@@ -52,6 +52,22 @@ class GPUSurfaceSoftwareDelegate : public GPUSurfaceDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called instead of `PresentBackingStore` when only part of the
+  ///             backing store was repainted since it was last presented.
+  ///             Platforms that can present partial updates may only copy the
+  ///             damaged region. The default implementation presents the
+  ///             entire backing store.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  damage         The region of the backing store that changed.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen.
+  ///
+  virtual bool PresentBackingStoreWithDamage(sk_sp<SkSurface> backing_store,
+                                             const SkIRect& damage);
 };
 
 }  // namespace flutter
@@ -771,6 +771,27 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
   settings.assets_path = args->assets_path;
   settings.leak_vm = !SAFE_ACCESS(args, shutdown_dart_vm_when_done, false);
   settings.old_gen_heap_size = SAFE_ACCESS(args, dart_old_gen_heap_size, -1);
+  settings.raster_cache_max_bytes =
+      SAFE_ACCESS(args, raster_cache_max_bytes, 0);
+  settings.text_layout_cache_max_bytes =
+      SAFE_ACCESS(args, text_layout_cache_max_bytes, 0);
+  switch (SAFE_ACCESS(args, frame_latency_mode,
+                      kFlutterFrameLatencyModeDefault)) {
+    case kFlutterFrameLatencyModeLowLatency:
+      settings.frame_latency_mode = flutter::FrameLatencyMode::kLowLatency;
+      break;
+    case kFlutterFrameLatencyModeHighThroughput:
+      settings.frame_latency_mode = flutter::FrameLatencyMode::kHighThroughput;
+      break;
+    default:
+      settings.frame_latency_mode = flutter::FrameLatencyMode::kDefault;
+      break;
+  }
+  const uint32_t max_frame_pipeline_depth =
+      SAFE_ACCESS(args, max_frame_pipeline_depth, 0);
+  if (max_frame_pipeline_depth > 0) {
+    settings.max_frame_pipeline_depth = max_frame_pipeline_depth;
+  }
 
   if (!flutter::DartVM::IsRunningPrecompiledCode()) {
     // Verify the assets path contains Dart 2 kernel assets.
@@ -1876,3 +1897,89 @@ FlutterEngineResult FlutterEnginePostCallbackOnAllNativeThreads(
                                   "Internal error while attempting to post "
                                   "tasks to all threads.");
 }
+
+FlutterEngineResult FlutterEngineGetRasterCacheMetrics(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterRasterCacheMetrics* out_metrics) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (out_metrics == nullptr ||
+      out_metrics->struct_size < sizeof(FlutterRasterCacheMetrics)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid raster cache metrics struct.");
+  }
+
+  const flutter::RasterCacheMetrics metrics =
+      engine->GetShell().GetRasterCacheMetrics();
+  out_metrics->layer_count = metrics.layer_count;
+  out_metrics->picture_count = metrics.picture_count;
+  out_metrics->layer_bytes = metrics.layer_bytes;
+  out_metrics->picture_bytes = metrics.picture_bytes;
+  out_metrics->max_bytes = metrics.max_bytes;
+  out_metrics->hit_count = metrics.hit_count;
+  out_metrics->miss_count = metrics.miss_count;
+  out_metrics->eviction_count = metrics.eviction_count;
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineGetFrameLatency(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterFrameLatency* out_latency) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (out_latency == nullptr ||
+      out_latency->struct_size < sizeof(FlutterFrameLatency)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid frame latency struct.");
+  }
+
+  const flutter::FrameLatency latency = engine->GetShell().GetFrameLatency();
+  out_latency->last_frame_latency_us = latency.last.ToMicroseconds();
+  out_latency->average_frame_latency_us = latency.average.ToMicroseconds();
+  out_latency->frame_count = latency.frame_count;
+  return kSuccess;
+}
+
+static FlutterFramePhaseStatistics ToEmbedderFramePhaseStatistics(
+    const flutter::FramePhaseStatistics& statistics) {
+  FlutterFramePhaseStatistics result = {};
+  result.p50_us = statistics.p50.ToMicroseconds();
+  result.p90_us = statistics.p90.ToMicroseconds();
+  result.p99_us = statistics.p99.ToMicroseconds();
+  result.max_us = statistics.max.ToMicroseconds();
+  result.over_budget_count = statistics.over_budget_count;
+  return result;
+}
+
+FlutterEngineResult FlutterEngineGetFrameTimingStatistics(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterFrameTimingStatistics* out_statistics,
+    bool reset) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (out_statistics == nullptr ||
+      out_statistics->struct_size < sizeof(FlutterFrameTimingStatistics)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid frame timing statistics struct.");
+  }
+
+  const flutter::FrameTimingStatistics statistics =
+      engine->GetShell().GetFrameTimingStatistics(reset);
+  out_statistics->frame_count = statistics.frame_count;
+  out_statistics->janky_frame_count = statistics.janky_frame_count;
+  out_statistics->vsync_to_build =
+      ToEmbedderFramePhaseStatistics(statistics.vsync_to_build);
+  out_statistics->build = ToEmbedderFramePhaseStatistics(statistics.build);
+  out_statistics->raster = ToEmbedderFramePhaseStatistics(statistics.raster);
+  out_statistics->total = ToEmbedderFramePhaseStatistics(statistics.total);
+  return kSuccess;
+}
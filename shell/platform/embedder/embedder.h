@@ -861,6 +861,90 @@ typedef struct {
   const char* variant_code;
 } FlutterLocale;
 
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterRasterCacheMetrics).
+  size_t struct_size;
+  /// The number of layers and pictures that have a rasterized image in the
+  /// cache.
+  size_t layer_count;
+  size_t picture_count;
+  /// The number of bytes held by the rasterized images of those layers and
+  /// pictures.
+  size_t layer_bytes;
+  size_t picture_bytes;
+  /// The number of bytes the raster cache keeps its images under.
+  size_t max_bytes;
+  /// The number of draws, since the engine was launched, that used a cached
+  /// image.
+  size_t hit_count;
+  /// The number of draws, since the engine was launched, of cacheable layers
+  /// and pictures that had no cached image.
+  size_t miss_count;
+  /// The number of images that were evicted, since the engine was launched, to
+  /// keep the cache within its byte budget.
+  size_t eviction_count;
+} FlutterRasterCacheMetrics;
+
+typedef enum {
+  /// Frames are built as soon as the vsync signal arrives, and the engine
+  /// picks the number of frames that may be in flight for the platform.
+  kFlutterFrameLatencyModeDefault,
+  /// Only one frame is in flight at a time, and building it is delayed until
+  /// just enough time is left to rasterize it by the next vsync, as predicted
+  /// from recent frames. This minimizes input-to-photon latency for
+  /// interactive content at the risk of occasionally dropping frames.
+  kFlutterFrameLatencyModeLowLatency,
+  /// The number of frames that may be in flight is adjusted between the
+  /// default and `FlutterProjectArgs.max_frame_pipeline_depth` to keep the
+  /// raster thread busy. This favors smooth animations over latency.
+  kFlutterFrameLatencyModeHighThroughput,
+} FlutterFrameLatencyMode;
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterFrameLatency).
+  size_t struct_size;
+  /// The time, in microseconds, from the start of building the last
+  /// rasterized frame to the end of rasterizing it.
+  int64_t last_frame_latency_us;
+  /// The average of the same time over up to the last 60 rasterized frames.
+  int64_t average_frame_latency_us;
+  /// The number of frames the average was taken over. Zero until the first
+  /// frame is rasterized.
+  size_t frame_count;
+} FlutterFrameLatency;
+
+/// The distribution of the time, in microseconds, taken by one phase of the
+/// frames rasterized by an engine. Percentiles are accurate to within about
+/// 3%.
+typedef struct {
+  int64_t p50_us;
+  int64_t p90_us;
+  int64_t p99_us;
+  int64_t max_us;
+  /// The number of frames for which the phase took longer than the frame
+  /// budget.
+  size_t over_budget_count;
+} FlutterFramePhaseStatistics;
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterFrameTimingStatistics).
+  size_t struct_size;
+  /// The number of frames rasterized.
+  size_t frame_count;
+  /// The number of frames that took longer than the frame budget to build or
+  /// to rasterize, and so missed at least one vsync.
+  size_t janky_frame_count;
+  /// From the vsync a frame was scheduled for to the UI thread starting to
+  /// build it.
+  FlutterFramePhaseStatistics vsync_to_build;
+  /// From the UI thread starting to build a frame to it finishing.
+  FlutterFramePhaseStatistics build;
+  /// From the raster thread starting to rasterize a frame to it finishing.
+  FlutterFramePhaseStatistics raster;
+  /// From the vsync a frame was scheduled for to the end of rasterizing it.
+  FlutterFramePhaseStatistics total;
+} FlutterFrameTimingStatistics;
+
 typedef int64_t FlutterEngineDartPort;
 
 typedef enum {
@@ -1205,6 +1289,30 @@ typedef struct {
   ///
   /// Embedders can provide either snapshot buffers or aot_data, but not both.
   FlutterEngineAOTData aot_data;
+
+  /// The maximum number of bytes of rasterized layers and pictures the raster
+  /// cache may retain. When this budget is exceeded, the least recently used
+  /// entries are evicted first. Specify 0 to use the engine default.
+  ///
+  /// See also: `FlutterEngineGetRasterCacheMetrics`.
+  size_t raster_cache_max_bytes;
+
+  /// Whether frames should be scheduled for the least latency or the most
+  /// throughput.
+  ///
+  /// See also: `FlutterEngineGetFrameLatency`.
+  FlutterFrameLatencyMode frame_latency_mode;
+
+  /// The most frames that may be in flight at once in
+  /// `kFlutterFrameLatencyModeHighThroughput`. Specify 0 to use the engine
+  /// default.
+  uint32_t max_frame_pipeline_depth;
+
+  /// The maximum number of bytes of laid out words the text layout cache may
+  /// retain. The cache is shared by all engines in the process. When this
+  /// budget is exceeded, the least recently used words are evicted first.
+  /// Specify 0 to use the engine default.
+  size_t text_layout_cache_max_bytes;
 } FlutterProjectArgs;
 
 //------------------------------------------------------------------------------
@@ -1790,6 +1898,57 @@ FlutterEngineResult FlutterEnginePostCallbackOnAllNativeThreads(
     FlutterNativeThreadCallback callback,
     void* user_data);
 
+//------------------------------------------------------------------------------
+/// @brief      Reports the contents and effectiveness of the raster cache of a
+///             running engine instance as of the last frame it rasterized.
+///             This call may be made on any thread.
+///
+/// @param[in]  engine       A running engine instance.
+/// @param[out] out_metrics  The metrics. The embedder must set its
+///                          `struct_size` before making this call.
+///
+/// @return     If the metrics were reported.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetRasterCacheMetrics(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterRasterCacheMetrics* out_metrics);
+
+//------------------------------------------------------------------------------
+/// @brief      Reports the latency of the frames recently rasterized by a
+///             running engine instance. This call may be made on any thread.
+///
+/// @param[in]  engine       A running engine instance.
+/// @param[out] out_latency  The latency. The embedder must set its
+///                          `struct_size` before making this call.
+///
+/// @return     If the latency was reported.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetFrameLatency(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameLatency* out_latency);
+
+//------------------------------------------------------------------------------
+/// @brief      Reports the distribution of the time taken by each phase of
+///             the frames rasterized by a running engine instance since it
+///             was launched, or since the statistics were last reset. This
+///             call may be made on any thread.
+///
+/// @param[in]  engine          A running engine instance.
+/// @param[out] out_statistics  The statistics. The embedder must set its
+///                             `struct_size` before making this call.
+/// @param[in]  reset           Whether the engine should start collecting
+///                             the statistics afresh once they are reported.
+///
+/// @return     If the statistics were reported.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetFrameTimingStatistics(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingStatistics* out_statistics,
+    bool reset);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <cstring>
 #include <string>
 
 #include "embedder.h"
@@ -23,6 +24,7 @@
 #include "flutter/shell/platform/embedder/tests/embedder_test.h"
 #include "flutter/testing/assertions_skia.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/tonic/converter/dart_converter.h"
 
@@ -2091,6 +2093,51 @@ TEST_F(EmbedderTest, CanRenderGradientWithoutCompositorWithXform) {
   ASSERT_TRUE(ImageMatchesFixture("gradient_xform.png", renderered_scene));
 }
 
+TEST_F(EmbedderTest, ParallelSoftwareRasterizationMatchesSerialRasterization) {
+  auto& context = GetEmbedderContext();
+
+  std::vector<SkBitmap> scenes;
+  for (bool parallel : {false, true}) {
+    EmbedderConfigBuilder builder(context);
+
+    builder.SetDartEntrypoint("render_gradient");
+    builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+    if (parallel) {
+      builder.AddCommandLineArgument(
+          "--enable-parallel-software-rasterization");
+    }
+
+    auto renderered_scene = context.GetNextSceneImage();
+
+    auto engine = builder.LaunchEngine();
+    ASSERT_TRUE(engine.is_valid());
+
+    // Send a window metrics events so frames may be scheduled.
+    FlutterWindowMetricsEvent event = {};
+    event.struct_size = sizeof(event);
+    event.width = 800;
+    event.height = 600;
+    event.pixel_ratio = 1.0;
+    ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+              kSuccess);
+
+    // The presented image refers to the pixels of the engine's backing store,
+    // so copy them while the engine is still running.
+    auto image = renderered_scene.get();
+    ASSERT_TRUE(image);
+    SkBitmap bitmap;
+    ASSERT_TRUE(bitmap.tryAllocPixels(image->imageInfo()));
+    ASSERT_TRUE(image->readPixels(bitmap.pixmap(), 0, 0));
+    scenes.push_back(bitmap);
+  }
+
+  ASSERT_EQ(scenes.size(), 2u);
+  ASSERT_EQ(scenes[0].computeByteSize(), scenes[1].computeByteSize());
+  ASSERT_EQ(::memcmp(scenes[0].getPixels(), scenes[1].getPixels(),
+                     scenes[0].computeByteSize()),
+            0);
+}
+
 TEST_F(EmbedderTest, CanRenderGradientWithCompositor) {
   auto& context = GetEmbedderContext();
 
@@ -3896,6 +3943,73 @@ TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
   ASSERT_EQ(FlutterEngineNotifyLowMemoryWarning(engine.get()), kSuccess);
 }
 
+TEST_F(EmbedderTest, CanGetRasterCacheMetrics) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.GetProjectArgs().raster_cache_max_bytes = 1234;
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterRasterCacheMetrics metrics = {};
+  ASSERT_EQ(FlutterEngineGetRasterCacheMetrics(engine.get(), &metrics),
+            kInvalidArguments);
+
+  metrics.struct_size = sizeof(FlutterRasterCacheMetrics);
+  ASSERT_EQ(FlutterEngineGetRasterCacheMetrics(engine.get(), &metrics),
+            kSuccess);
+  ASSERT_EQ(metrics.max_bytes, 1234u);
+  ASSERT_EQ(metrics.layer_bytes + metrics.picture_bytes, 0u);
+}
+
+TEST_F(EmbedderTest, CanGetFrameLatency) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.GetProjectArgs().frame_latency_mode =
+      kFlutterFrameLatencyModeLowLatency;
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterFrameLatency latency = {};
+  ASSERT_EQ(FlutterEngineGetFrameLatency(engine.get(), &latency),
+            kInvalidArguments);
+
+  latency.struct_size = sizeof(FlutterFrameLatency);
+  ASSERT_EQ(FlutterEngineGetFrameLatency(engine.get(), &latency), kSuccess);
+  ASSERT_EQ(latency.frame_count, 0u);
+  ASSERT_EQ(latency.last_frame_latency_us, 0);
+}
+
+TEST_F(EmbedderTest, CanGetFrameTimingStatistics) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterFrameTimingStatistics statistics = {};
+  ASSERT_EQ(
+      FlutterEngineGetFrameTimingStatistics(engine.get(), &statistics, false),
+      kInvalidArguments);
+
+  statistics.struct_size = sizeof(FlutterFrameTimingStatistics);
+  ASSERT_EQ(
+      FlutterEngineGetFrameTimingStatistics(engine.get(), &statistics, true),
+      kSuccess);
+  ASSERT_LE(statistics.janky_frame_count, statistics.frame_count);
+  ASSERT_LE(statistics.total.p50_us, statistics.total.max_us);
+}
+
 TEST_F(EmbedderTest, CanPostTaskToAllNativeThreads) {
   UniqueEngine engine;
   size_t worker_count = 0;
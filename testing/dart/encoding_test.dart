@@ -58,6 +58,22 @@ void main() {
         final List<int> expected = await readFile('square.png');
         expect(Uint8List.view(data.buffer), expected);
       });
+
+      for (final ImageByteFormat format in <ImageByteFormat>[
+        ImageByteFormat.pngFast,
+        ImageByteFormat.pngUncompressed,
+      ]) {
+        test('$format decodes to the same pixels', () async {
+          final Image image = await Square4x4Image.image;
+          final ByteData data = await image.toByteData(format: format);
+          final Completer<Image> completer = Completer<Image>();
+          decodeImageFromList(
+              data.buffer.asUint8List(), (Image decoded) => completer.complete(decoded));
+          final Image decoded = await completer.future;
+          final ByteData pixels = await decoded.toByteData();
+          expect(Uint8List.view(pixels.buffer), Square4x4Image.bytes);
+        });
+      }
     });
   });
 }
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 // @dart = 2.6
+import 'dart:typed_data';
 import 'dart:ui';
 
 import 'package:test/test.dart';
@@ -70,4 +71,43 @@ void main() {
     expect(metrics.first.baseline, closeTo(11.200042724609375, epsillon));
     expect(metrics.first.lineNumber, 0);
   });
+
+  test('addStyledText lays out like pushing each style', () {
+    final TextStyle small = TextStyle(fontSize: 10.0);
+    final TextStyle large = TextStyle(fontSize: 20.0, fontWeight: FontWeight.bold);
+
+    final ParagraphBuilder styledBuilder = ParagraphBuilder(ParagraphStyle());
+    styledBuilder.addStyledText(
+      Uint16List.fromList('Hello World'.codeUnits),
+      <TextStyle>[small, large],
+      Int32List.fromList(<int>[0, 6, 1, 11]),
+    );
+    final Paragraph styled = styledBuilder.build();
+
+    final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle());
+    builder.pushStyle(small);
+    builder.addText('Hello ');
+    builder.pop();
+    builder.pushStyle(large);
+    builder.addText('World');
+    builder.pop();
+    final Paragraph expected = builder.build();
+
+    styled.layout(const ParagraphConstraints(width: 800.0));
+    expected.layout(const ParagraphConstraints(width: 800.0));
+    expect(styled.height, expected.height);
+    expect(styled.maxIntrinsicWidth, expected.maxIntrinsicWidth);
+  });
+
+  test('addStyledText rejects runs that do not cover the text', () {
+    final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle());
+    expect(
+      () => builder.addStyledText(
+        Uint16List.fromList('Hello'.codeUnits),
+        <TextStyle>[TextStyle(fontSize: 10.0)],
+        Int32List.fromList(<int>[0, 3]),
+      ),
+      throwsArgumentError,
+    );
+  });
 }
@@ -60,4 +60,67 @@ void main() {
       );
     }
   });
+
+  test('lays out a batch of paragraphs like one at a time', () {
+    Paragraph buildParagraph(double fontSize) {
+      final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+        fontFamily: 'Ahem',
+        fontStyle: FontStyle.normal,
+        fontWeight: FontWeight.normal,
+        fontSize: fontSize,
+      ));
+      builder.addText('Test Ahem');
+      return builder.build();
+    }
+
+    final List<Paragraph> paragraphs = <Paragraph>[];
+    final List<ParagraphConstraints> constraints = <ParagraphConstraints>[];
+    for (int index = 0; index < 100; index += 1) {
+      final double fontSize = 10.0 + index % 4 * 10.0;
+      paragraphs.add(buildParagraph(fontSize));
+      // Every other paragraph wraps.
+      constraints.add(ParagraphConstraints(width: fontSize * (index.isEven ? 5.0 : 10.0)));
+    }
+    Paragraph.layoutAll(paragraphs, constraints);
+
+    for (int index = 0; index < paragraphs.length; index += 1) {
+      final Paragraph expected = buildParagraph(10.0 + index % 4 * 10.0);
+      expected.layout(constraints[index]);
+      expect(paragraphs[index].width, closeTo(expected.width, 0.001));
+      expect(paragraphs[index].height, closeTo(expected.height, 0.001));
+      expect(paragraphs[index].longestLine, closeTo(expected.longestLine, 0.001));
+      expect(paragraphs[index].computeLineMetrics().length, expected.computeLineMetrics().length);
+    }
+
+    Paragraph.layoutAll(<Paragraph>[], <ParagraphConstraints>[]);
+  });
+
+  test('lays out repeated paragraphs of a batch with their last constraints', () {
+    Paragraph buildParagraph() {
+      final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+        fontFamily: 'Ahem',
+        fontStyle: FontStyle.normal,
+        fontWeight: FontWeight.normal,
+        fontSize: 20.0,
+      ));
+      builder.addText('Test Ahem');
+      return builder.build();
+    }
+
+    final Paragraph paragraph = buildParagraph();
+    Paragraph.layoutAll(
+      <Paragraph>[paragraph, paragraph, paragraph],
+      const <ParagraphConstraints>[
+        ParagraphConstraints(width: 50.0),
+        ParagraphConstraints(width: 1000.0),
+        ParagraphConstraints(width: 100.0),
+      ],
+    );
+
+    final Paragraph expected = buildParagraph();
+    expected.layout(const ParagraphConstraints(width: 100.0));
+    expect(paragraph.width, 100.0);
+    expect(paragraph.height, closeTo(expected.height, 0.001));
+    expect(paragraph.computeLineMetrics().length, expected.computeLineMetrics().length);
+  });
 }
@@ -76,6 +76,7 @@ void RunDartCodeInIsolate(DartVMRef& vm_ref,
       io_manager,                         // io manager
       {},                                 // unref queue
       {},                                 // image decoder
+      nullptr,                            // concurrent task runner
       "main.dart",                        // advisory uri
       "main",                             // advisory entrypoint
       nullptr,                            // flags
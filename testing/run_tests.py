@@ -161,6 +161,8 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter)
 
+  RunEngineExecutable(build_dir, 'flow_benchmarks', filter)
+
   RunEngineExecutable(build_dir, 'ui_benchmarks', filter)
 
   if IsLinux():
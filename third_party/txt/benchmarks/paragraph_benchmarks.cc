@@ -182,6 +182,131 @@ BENCHMARK_F(ParagraphFixture, ManyStylesLayout)(benchmark::State& state) {
   }
 }
 
+// Lays the paragraph out at alternating widths, as when a window is resized,
+// either from scratch (state.range(0) == 0) or reusing the measurements of the
+// text from the previous layout (state.range(0) == 1).
+BENCHMARK_DEFINE_F(ParagraphFixture, ResizeLayout)(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+  const bool reuse_measurements = state.range(0) == 1;
+  double width = 300;
+  while (state.KeepRunning()) {
+    width = width == 300 ? 250 : 300;
+    if (!reuse_measurements) {
+      paragraph->SetDirty();
+    }
+    paragraph->Layout(width);
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ResizeLayout)->Arg(0)->Arg(1);
+
+// Queries a paragraph of about a megabyte of text near its end, hit testing
+// a coordinate (state.range(0) == 0) or measuring the boxes of a range of
+// text (state.range(0) == 1). Both should take time logarithmic in the
+// length of the paragraph.
+BENCHMARK_DEFINE_F(ParagraphFixture, LongParagraphQueries)
+(benchmark::State& state) {
+  const std::u16string sentence =
+      u"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+      u"eiusmod tempor incididunt ut labore et dolore magna aliqua. ";
+  std::u16string u16_text;
+  while (u16_text.size() * sizeof(char16_t) < (1 << 20)) {
+    u16_text += sentence;
+  }
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+
+  const double height = paragraph->GetHeight();
+  const size_t end = u16_text.size();
+  if (state.range(0) == 0) {
+    while (state.KeepRunning()) {
+      benchmark::DoNotOptimize(
+          paragraph->GetGlyphPositionAtCoordinate(150, height - 5));
+    }
+  } else {
+    while (state.KeepRunning()) {
+      benchmark::DoNotOptimize(paragraph->GetRectsForRange(
+          end - 100, end - 50, txt::Paragraph::RectHeightStyle::kTight,
+          txt::Paragraph::RectWidthStyle::kTight));
+    }
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, LongParagraphQueries)
+    ->Arg(0)
+    ->Arg(1);
+
+// Lays out a paragraph on several threads at once. Each thread has a font
+// collection of its own, as the UI thread of each engine in a process would.
+// The real time per iteration should stay flat as threads are added, unless
+// the layouts contend with each other.
+static void BM_ParagraphLayoutMultiThreaded(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(300);
+  }
+}
+BENCHMARK(BM_ParagraphLayoutMultiThreaded)->ThreadRange(1, 8)->UseRealTime();
+
 BENCHMARK_DEFINE_F(ParagraphFixture, TextBigO)(benchmark::State& state) {
   std::vector<uint16_t> text;
   for (uint16_t i = 0; i < state.range(0); ++i) {
@@ -387,6 +512,37 @@ BENCHMARK_REGISTER_F(ParagraphFixture, MinikinDoLayout)
     ->Range(1 << 7, 1 << 14)
     ->Complexity(benchmark::oN);
 
+// Splits Latin text into runs of the fonts that cover it, with an emoji every
+// state.range(0) characters or none when it is 0.
+BENCHMARK_DEFINE_F(ParagraphFixture, MinikinItemize)(benchmark::State& state) {
+  const std::u16string sentence =
+      u"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+      u"eiusmod tempor incididunt ut labore et dolore magna aliqua. ";
+  std::vector<uint16_t> text;
+  while (text.size() < 16000) {
+    for (char16_t ch : sentence) {
+      text.push_back(ch);
+      if (state.range(0) != 0 && text.size() % state.range(0) == 0) {
+        // U+1F600 GRINNING FACE.
+        text.push_back(0xD83D);
+        text.push_back(0xDE00);
+      }
+    }
+  }
+
+  auto collection = font_collection_->GetMinikinFontCollectionForFamilies(
+      {"Roboto", "Noto Color Emoji"}, "en-US");
+  const minikin::FontStyle style(4, false);
+  std::vector<minikin::FontCollection::Run> runs;
+
+  while (state.KeepRunning()) {
+    runs.clear();
+    collection->itemize(text.data(), text.size(), style, &runs);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size() * sizeof(uint16_t));
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, MinikinItemize)->Arg(0)->Arg(100);
+
 BENCHMARK_DEFINE_F(ParagraphFixture, AddStyleRun)(benchmark::State& state) {
   std::vector<uint16_t> text;
   for (uint16_t i = 0; i < 16000 * 2; ++i) {
@@ -197,4 +197,46 @@ static void BM_ParagraphBuilderLongParagraphConstruct(benchmark::State& state) {
 }
 BENCHMARK(BM_ParagraphBuilderLongParagraphConstruct);
 
+// Builds a paragraph of many short runs that alternate between a few styles,
+// like the lines of a log. Arg 0 pushes, adds and pops each run, Arg 1 adds
+// all of them with AddStyledText.
+static void BM_ParagraphBuilderManyStyledRuns(benchmark::State& state) {
+  const bool styled_text = state.range(0) != 0;
+  const std::u16string line = u"12:00:00.000 I/flutter: Lorem ipsum dolor\n";
+  const size_t run_count = 10000;
+
+  std::vector<txt::TextStyle> styles(4);
+  for (size_t i = 0; i < styles.size(); i++) {
+    styles[i].font_families = std::vector<std::string>(1, "Roboto");
+    styles[i].color = SkColorSetRGB(i * 60, 0, 0);
+  }
+
+  std::u16string text;
+  std::vector<txt::ParagraphBuilder::StyledRange> ranges;
+  for (size_t i = 0; i < run_count; i++) {
+    text += line;
+    ranges.push_back({i % styles.size(), text.size()});
+  }
+
+  txt::ParagraphStyle paragraph_style;
+  auto font_collection = GetTestFontCollection();
+  while (state.KeepRunning()) {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    if (styled_text) {
+      builder.AddStyledText(reinterpret_cast<const uint16_t*>(text.data()),
+                            text.size(), styles, ranges);
+    } else {
+      for (const txt::ParagraphBuilder::StyledRange& range : ranges) {
+        builder.PushStyle(styles[range.style_index]);
+        builder.AddText(line);
+        builder.Pop();
+      }
+    }
+    auto paragraph = builder.Build();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          text.size() * sizeof(char16_t));
+}
+BENCHMARK(BM_ParagraphBuilderManyStyledRuns)->Arg(0)->Arg(1);
+
 }  // namespace txt
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks the layout, painting and hit testing of a corpus of texts in
+// different scripts with each of the paragraph back ends, so that the back
+// ends can be compared on the same workloads.
+//
+// Each benchmark is registered with the index of a corpus text and a back end
+// as its arguments, and labeled with their names. For example, run the
+// Arabic benchmarks only with --benchmark_filter=Corpus.*/1/.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/third_party/txt/tests/txt_test_utils.h"
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+#include "third_party/icu/source/common/unicode/unistr.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColor.h"
+#include "txt/font_collection.h"
+#include "txt/paragraph.h"
+#include "txt/paragraph_builder.h"
+#include "txt/paragraph_style.h"
+#include "txt/text_style.h"
+
+namespace txt {
+
+namespace {
+
+enum class Backend { kTxt, kSkia };
+
+struct CorpusText {
+  const char* name;
+  // UTF-8 text, repeated |repeat| times to form the paragraph.
+  const char* text;
+  int repeat;
+  TextDirection direction;
+  // Whether every word gets a different style than the previous one.
+  bool styled;
+};
+
+// The test fonts cover Latin, Arabic, CJK and emoji. The Hebrew, Devanagari
+// and Thai texts are shaped with the fallback glyphs of the test fonts, but
+// still exercise the bidi, cluster and dictionary based line breaking code.
+const CorpusText kCorpus[] = {
+    {"latin",
+     "The quick brown fox jumps over the lazy dog. Pack my box with five "
+     "dozen liquor jugs. ",
+     4, TextDirection::ltr, false},
+    {"arabic_hebrew_bidi",
+     "من أسر وإعلان الخاصّة وهولندا، عل قائمة الضغوط بالمطالبة تلك 2020. "
+     "שלום עולם, זהו טקסט לבדיקה. Flutter 1.20 ",
+     4, TextDirection::rtl, false},
+    {"devanagari",
+     "हिन्दी भारत की राजभाषा है। "
+     "क्षत्रिय, द्वितीय और श्रृंखला जैसे संयुक्ताक्षर। ",
+     4, TextDirection::ltr, false},
+    {"thai",
+     "ภาษาไทยไม่มีการเว้นวรรคระหว่างคำจึงต้องใช้พจนานุกรมในการตัดคำ"
+     "สวัสดีครับยินดีต้อนรับ ",
+     4, TextDirection::ltr, false},
+    {"cjk",
+     "天地玄黄，宇宙洪荒。日月盈昃，辰宿列张。吾輩は猫である。名前はまだ無い。"
+     "漢字かな交じり文の改行処理。",
+     4, TextDirection::ltr, false},
+    {"emoji_zwj",
+     "Family 👨‍👩‍👧‍👦 and 👩🏽‍💻 with 🏳️‍🌈 flags 🇯🇵🇺🇸 "
+     "👍🏻👍🏼👍🏽👍🏾👍🏿 ❤️ ",
+     8, TextDirection::ltr, false},
+    {"long_paragraph",
+     "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+     "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+     "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+     "commodo consequat. ",
+     100, TextDirection::ltr, false},
+    {"styled_runs",
+     "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+     "tempor incididunt ut labore et dolore magna aliqua. ",
+     10, TextDirection::ltr, true},
+};
+
+constexpr double kLayoutWidth = 300;
+
+const char* GetBackendName(Backend backend) {
+  return backend == Backend::kSkia ? "skia" : "txt";
+}
+
+std::vector<TextStyle> CreateTextStyles() {
+  std::vector<TextStyle> styles(3);
+  for (TextStyle& style : styles) {
+    style.font_families = {"Roboto", "Noto Naskh Arabic", "Noto Sans CJK JP",
+                           "Noto Color Emoji"};
+    style.color = SK_ColorBLACK;
+  }
+  styles[1].color = SK_ColorBLUE;
+  styles[1].font_weight = FontWeight::w700;
+  styles[2].font_size = 20;
+  styles[2].font_style = FontStyle::italic;
+  styles[2].decoration = TextDecoration::kUnderline;
+  return styles;
+}
+
+std::unique_ptr<Paragraph> BuildCorpusParagraph(
+    const CorpusText& corpus,
+    Backend backend,
+    const std::shared_ptr<FontCollection>& font_collection) {
+  const icu::UnicodeString icu_text = icu::UnicodeString::fromUTF8(corpus.text);
+  const std::u16string text(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+
+  ParagraphStyle paragraph_style;
+  paragraph_style.text_direction = corpus.direction;
+
+  std::unique_ptr<ParagraphBuilder> builder;
+#if FLUTTER_ENABLE_SKSHAPER
+  if (backend == Backend::kSkia) {
+    builder = ParagraphBuilder::CreateSkiaBuilder(paragraph_style,
+                                                  font_collection);
+  }
+#endif
+  if (builder == nullptr) {
+    FML_CHECK(backend == Backend::kTxt);
+    builder =
+        ParagraphBuilder::CreateTxtBuilder(paragraph_style, font_collection);
+  }
+
+  const std::vector<TextStyle> styles = CreateTextStyles();
+  if (!corpus.styled) {
+    builder->PushStyle(styles[0]);
+    for (int i = 0; i < corpus.repeat; i++) {
+      builder->AddText(text);
+    }
+    builder->Pop();
+    return builder->Build();
+  }
+
+  size_t style_index = 0;
+  for (int i = 0; i < corpus.repeat; i++) {
+    size_t start = 0;
+    while (start < text.size()) {
+      size_t end = text.find(u' ', start);
+      end = end == std::u16string::npos ? text.size() : end + 1;
+      builder->PushStyle(styles[style_index++ % styles.size()]);
+      builder->AddText(text.substr(start, end - start));
+      builder->Pop();
+      start = end;
+    }
+  }
+  return builder->Build();
+}
+
+void CorpusArguments(benchmark::internal::Benchmark* benchmark) {
+  for (size_t i = 0; i < sizeof(kCorpus) / sizeof(kCorpus[0]); i++) {
+    benchmark->Args({static_cast<int>(i), static_cast<int>(Backend::kTxt)});
+#if FLUTTER_ENABLE_SKSHAPER
+    benchmark->Args({static_cast<int>(i), static_cast<int>(Backend::kSkia)});
+#endif
+  }
+}
+
+}  // namespace
+
+class ParagraphCorpusFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) {
+    font_collection_ = GetTestFontCollection();
+
+    bitmap_ = std::make_unique<SkBitmap>();
+    bitmap_->allocN32Pixels(1000, 1000);
+    canvas_ = std::make_unique<SkCanvas>(*bitmap_);
+    canvas_->clear(SK_ColorWHITE);
+  }
+
+  void TearDown(const benchmark::State& state) { font_collection_.reset(); }
+
+ protected:
+  const CorpusText& GetCorpus(benchmark::State& state) {
+    const CorpusText& corpus = kCorpus[state.range(0)];
+    state.SetLabel(std::string(corpus.name) + "/" +
+                   GetBackendName(GetBackend(state)));
+    return corpus;
+  }
+
+  Backend GetBackend(const benchmark::State& state) {
+    return static_cast<Backend>(state.range(1));
+  }
+
+  std::shared_ptr<FontCollection> font_collection_;
+  std::unique_ptr<SkCanvas> canvas_;
+  std::unique_ptr<SkBitmap> bitmap_;
+};
+
+// Builds and lays out a new paragraph in each iteration, as the framework does
+// when the text changes. Text layout caches stay warm across iterations.
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, CorpusLayout)
+(benchmark::State& state) {
+  const CorpusText& corpus = GetCorpus(state);
+  const Backend backend = GetBackend(state);
+  while (state.KeepRunning()) {
+    std::unique_ptr<Paragraph> paragraph =
+        BuildCorpusParagraph(corpus, backend, font_collection_);
+    paragraph->Layout(kLayoutWidth);
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, CorpusLayout)
+    ->Apply(CorpusArguments);
+
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, CorpusPaint)
+(benchmark::State& state) {
+  const CorpusText& corpus = GetCorpus(state);
+  std::unique_ptr<Paragraph> paragraph =
+      BuildCorpusParagraph(corpus, GetBackend(state), font_collection_);
+  paragraph->Layout(kLayoutWidth);
+  int offset = 0;
+  while (state.KeepRunning()) {
+    paragraph->Paint(canvas_.get(), offset % 700, 10);
+    offset++;
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, CorpusPaint)
+    ->Apply(CorpusArguments);
+
+// Hit tests a grid of points over the paragraph, and queries the boxes of the
+// text between the first and the last hit position of each row of the grid.
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, CorpusHitTest)
+(benchmark::State& state) {
+  const CorpusText& corpus = GetCorpus(state);
+  std::unique_ptr<Paragraph> paragraph =
+      BuildCorpusParagraph(corpus, GetBackend(state), font_collection_);
+  paragraph->Layout(kLayoutWidth);
+  const double height = paragraph->GetHeight();
+  constexpr int kGridSize = 16;
+  while (state.KeepRunning()) {
+    for (int row = 0; row < kGridSize; row++) {
+      size_t row_start = 0;
+      for (int column = 0; column < kGridSize; column++) {
+        const size_t position =
+            paragraph
+                ->GetGlyphPositionAtCoordinate(
+                    kLayoutWidth * column / kGridSize, height * row / kGridSize)
+                .position;
+        if (column == 0) {
+          row_start = position;
+        }
+        if (column == kGridSize - 1) {
+          benchmark::DoNotOptimize(paragraph->GetRectsForRange(
+              std::min(row_start, position), std::max(row_start, position),
+              Paragraph::RectHeightStyle::kMax,
+              Paragraph::RectWidthStyle::kTight));
+        }
+      }
+    }
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, CorpusHitTest)
+    ->Apply(CorpusArguments);
+
+}  // namespace txt
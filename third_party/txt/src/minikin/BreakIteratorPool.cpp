@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <minikin/BreakIteratorPool.h>
+
+namespace minikin {
+
+void BreakIteratorPool::Returner::operator()(
+    icu::BreakIterator* iterator) const {
+  if (mPool != nullptr) {
+    mPool->release(mEntry, iterator);
+  } else {
+    delete iterator;
+  }
+}
+
+BreakIteratorPool& BreakIteratorPool::getInstance() {
+  // Never destroyed, so that iterators may be returned during exit.
+  static BreakIteratorPool* instance = new BreakIteratorPool();
+  return *instance;
+}
+
+BreakIteratorPool::Ptr BreakIteratorPool::acquire(const icu::Locale& locale,
+                                                  Kind kind) {
+  std::string key = locale.getName();
+  key += kind == Kind::kLine ? "#line" : "#word";
+
+  std::scoped_lock lock(mMutex);
+  // Entries are never removed, so the returners may point at them.
+  Entry& entry = mEntries[key];
+  if (!entry.idle.empty()) {
+    icu::BreakIterator* iterator = entry.idle.back().release();
+    entry.idle.pop_back();
+    return Ptr(iterator, Returner(this, &entry));
+  }
+
+  if (!entry.prototype) {
+    UErrorCode status = U_ZERO_ERROR;
+    entry.prototype.reset(
+        kind == Kind::kLine
+            ? icu::BreakIterator::createLineInstance(locale, status)
+            : icu::BreakIterator::createWordInstance(locale, status));
+    if (U_FAILURE(status)) {
+      entry.prototype.reset();
+    }
+    if (!entry.prototype) {
+      return Ptr();
+    }
+  }
+  return Ptr(entry.prototype->clone(), Returner(this, &entry));
+}
+
+size_t BreakIteratorPool::getIdleCount() {
+  std::scoped_lock lock(mMutex);
+  size_t count = 0;
+  for (const auto& entry : mEntries) {
+    count += entry.second.idle.size();
+  }
+  return count;
+}
+
+void BreakIteratorPool::release(Entry* entry, icu::BreakIterator* iterator) {
+  std::unique_ptr<icu::BreakIterator> owned(iterator);
+  std::scoped_lock lock(mMutex);
+  if (entry->idle.size() < kMaxIdlePerKey) {
+    entry->idle.push_back(std::move(owned));
+  }
+}
+
+}  // namespace minikin
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINIKIN_BREAK_ITERATOR_POOL_H
+#define MINIKIN_BREAK_ITERATOR_POOL_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "unicode/brkiter.h"
+#include "unicode/locid.h"
+
+namespace minikin {
+
+// libtxt: A process wide pool of ICU break iterators, keyed by locale and
+// kind. Creating an iterator costs more than breaking a short paragraph into
+// lines, so breakers borrow iterators from the pool and return them when they
+// are done with them instead.
+//
+// The pool may be used from several threads at once. A borrowed iterator is
+// only used by its borrower, which must set its text before using it.
+class BreakIteratorPool {
+ public:
+  enum class Kind { kLine, kWord };
+
+  // The number of idle iterators kept for each locale and kind. Iterators
+  // returned beyond this are deleted.
+  static constexpr size_t kMaxIdlePerKey = 8;
+
+ private:
+  struct Entry;
+
+ public:
+  // Returns the iterator to the pool it was borrowed from.
+  class Returner {
+   public:
+    Returner() = default;
+    Returner(BreakIteratorPool* pool, Entry* entry)
+        : mPool(pool), mEntry(entry) {}
+
+    void operator()(icu::BreakIterator* iterator) const;
+
+   private:
+    BreakIteratorPool* mPool = nullptr;
+    Entry* mEntry = nullptr;
+  };
+
+  using Ptr = std::unique_ptr<icu::BreakIterator, Returner>;
+
+  static BreakIteratorPool& getInstance();
+
+  // Borrows an iterator for |locale|. Returns nullptr if ICU can not create
+  // iterators of this kind for the locale.
+  Ptr acquire(const icu::Locale& locale, Kind kind);
+
+  // The number of idle iterators in the pool.
+  size_t getIdleCount();
+
+ private:
+  struct Entry {
+    // The iterator others of the key are cloned from, which is cheaper than
+    // creating them from the locale.
+    std::unique_ptr<icu::BreakIterator> prototype;
+    std::vector<std::unique_ptr<icu::BreakIterator>> idle;
+  };
+
+  std::mutex mMutex;
+  std::unordered_map<std::string, Entry> mEntries;
+
+  BreakIteratorPool() = default;
+
+  void release(Entry* entry, icu::BreakIterator* iterator);
+
+  // Forbid copying and assignment.
+  BreakIteratorPool(const BreakIteratorPool&) = delete;
+  void operator=(const BreakIteratorPool&) = delete;
+};
+
+}  // namespace minikin
+
+#endif  // MINIKIN_BREAK_ITERATOR_POOL_H
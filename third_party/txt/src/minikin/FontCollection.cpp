@@ -20,6 +20,12 @@
 
 #include <algorithm>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include <log/log.h>
 #include "unicode/unistr.h"
 #include "unicode/unorm2.h"
@@ -43,7 +49,7 @@ static inline T max(T a, T b) {
 const uint32_t EMOJI_STYLE_VS = 0xFE0F;
 const uint32_t TEXT_STYLE_VS = 0xFE0E;
 
-uint32_t FontCollection::sNextId = 0;
+std::atomic<uint32_t> FontCollection::sNextId{0};
 
 // libtxt: return a locale string for a language list ID
 std::string GetFontLocale(uint32_t langListId) {
@@ -66,7 +72,6 @@ FontCollection::FontCollection(
 
 void FontCollection::init(
     const vector<std::shared_ptr<FontFamily>>& typefaces) {
-  std::scoped_lock _l(gMinikinLock);
   mId = sNextId++;
   vector<uint32_t> lastChar;
   size_t nTypefaces = typefaces.size();
@@ -125,6 +130,89 @@ void FontCollection::init(
   // See the comment in Range for more details.
   LOG_ALWAYS_FATAL_IF(mFamilyVec.size() >= 0xFFFF,
                       "Exceeded the maximum indexable cmap coverage.");
+
+  // libtxt: Summarize the coverage of the first family for bulk itemization.
+  // Surrogates and variation selectors need the per character rules.
+  static const uint32_t kExcludedRanges[][2] = {{0xD800, 0xE000},
+                                                {0xFE00, 0xFE10}};
+  const vector<uint32_t> ranges = mFamilies[0]->getCoverage().getRanges();
+  for (size_t i = 0; i < ranges.size(); i += 2) {
+    uint32_t start = ranges[i];
+    const uint32_t end = std::min(ranges[i + 1], 0x10000u);
+    for (const uint32_t* excluded : kExcludedRanges) {
+      if (start >= end || end <= excluded[0] || start >= excluded[1]) {
+        continue;
+      }
+      if (start < excluded[0]) {
+        mFirstFamilyBmpRanges.emplace_back(start, excluded[0]);
+      }
+      start = excluded[1];
+    }
+    if (start < end) {
+      mFirstFamilyBmpRanges.emplace_back(start, end);
+    }
+  }
+}
+
+// libtxt: Returns the number of code units at the start of |units| that are
+// within [first, last]. Compares eight code units at a time where SIMD is
+// available.
+static size_t countCodeUnitsInRange(const uint16_t* units,
+                                    size_t count,
+                                    uint16_t first,
+                                    uint16_t last) {
+  const uint16_t span = last - first;
+  size_t i = 0;
+#if defined(__SSE2__)
+  // SSE2 has no unsigned 16-bit comparison, but a saturating subtraction of
+  // span from (unit - first) is zero exactly when the unit is in the range.
+  const __m128i firstVec = _mm_set1_epi16(static_cast<int16_t>(first));
+  const __m128i spanVec = _mm_set1_epi16(static_cast<int16_t>(span));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(units + i));
+    const __m128i excess =
+        _mm_subs_epu16(_mm_sub_epi16(chunk, firstVec), spanVec);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(excess, zero)) != 0xFFFF) {
+      break;
+    }
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const uint16x8_t firstVec = vdupq_n_u16(first);
+  const uint16x8_t spanVec = vdupq_n_u16(span);
+  for (; i + 8 <= count; i += 8) {
+    const uint16x8_t chunk = vld1q_u16(units + i);
+    const uint16x8_t inRange = vcleq_u16(vsubq_u16(chunk, firstVec), spanVec);
+    if (vminvq_u16(inRange) == 0) {
+      break;
+    }
+  }
+#endif
+  // Finds the end within the chunk that left the range, and handles the tail
+  // and the platforms without SIMD.
+  for (; i < count; i++) {
+    if (static_cast<uint16_t>(units[i] - first) > span) {
+      break;
+    }
+  }
+  return i;
+}
+
+size_t FontCollection::findFirstFamilySpanEnd(const uint16_t* string,
+                                              size_t start,
+                                              size_t string_size) const {
+  const uint32_t ch = string[start];
+  auto range = std::upper_bound(
+      mFirstFamilyBmpRanges.begin(), mFirstFamilyBmpRanges.end(), ch,
+      [](uint32_t value, const std::pair<uint32_t, uint32_t>& range) {
+        return value < range.first;
+      });
+  if (range == mFirstFamilyBmpRanges.begin() || (--range)->second <= ch) {
+    return start;
+  }
+  return start + countCodeUnitsInRange(string + start, string_size - start,
+                                       range->first, range->second - 1);
 }
 
 // Special scores for the font fallback.
@@ -369,20 +457,30 @@ const std::shared_ptr<FontFamily>& FontCollection::findFallbackFont(
     uint32_t langListId) const {
   std::string locale = GetFontLocale(langListId);
 
-  const auto it = mCachedFallbackFamilies.find(locale);
-  if (it != mCachedFallbackFamilies.end()) {
-    for (const auto& fallbackFamily : it->second) {
-      if (calcCoverageScore(ch, vs, fallbackFamily)) {
-        return fallbackFamily;
+  {
+    std::scoped_lock lock(mFallbackMutex);
+    const auto it = mCachedFallbackFamilies.find(locale);
+    if (it != mCachedFallbackFamilies.end()) {
+      for (const auto& fallbackFamily : it->second) {
+        if (calcCoverageScore(ch, vs, fallbackFamily)) {
+          return fallbackFamily;
+        }
       }
     }
   }
 
+  // The provider is called without holding the lock, as it may be slow.
   const std::shared_ptr<FontFamily>& fallback =
       mFallbackFontProvider->matchFallbackFont(ch, GetFontLocale(langListId));
 
   if (fallback) {
-    mCachedFallbackFamilies[locale].push_back(fallback);
+    std::scoped_lock lock(mFallbackMutex);
+    std::deque<std::shared_ptr<FontFamily>>& families =
+        mCachedFallbackFamilies[locale];
+    if (std::find(families.begin(), families.end(), fallback) ==
+        families.end()) {
+      families.push_back(fallback);
+    }
   }
   return fallback;
 }
@@ -428,8 +526,6 @@ bool FontCollection::hasVariationSelector(uint32_t baseCodepoint,
     return false;
   }
 
-  std::scoped_lock _l(gMinikinLock);
-
   // Currently mRanges can not be used here since it isn't aware of the
   // variation sequence.
   for (size_t i = 0; i < mVSFamilyVec.size(); i++) {
@@ -478,6 +574,22 @@ void FontCollection::itemize(const uint16_t* string,
   U16_NEXT(string, readLength, string_size, nextCh);
 
   do {
+    // libtxt: Every character in a span of text that the first family covers
+    // continues a run of the first family. Skip over such spans in bulk. The
+    // last character of the span is left to the loop below, as it may be
+    // followed by a variation selector.
+    if (lastFamily == mFamilies[0].get()) {
+      const size_t spanEnd =
+          findFirstFamilySpanEnd(string, nextUtf16Pos, string_size);
+      if (spanEnd >= nextUtf16Pos + 2) {
+        prevCh = string[spanEnd - 2];
+        nextUtf16Pos = spanEnd - 1;
+        run->end = nextUtf16Pos;
+        readLength = nextUtf16Pos;
+        U16_NEXT(string, readLength, string_size, nextCh);
+      }
+    }
+
     const uint32_t ch = nextCh;
     const size_t utf16Pos = nextUtf16Pos;
     nextUtf16Pos = readLength;
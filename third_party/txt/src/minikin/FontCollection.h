@@ -17,9 +17,13 @@
 #ifndef MINIKIN_FONT_COLLECTION_H
 #define MINIKIN_FONT_COLLECTION_H
 
+#include <atomic>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <minikin/FontFamily.h>
@@ -96,6 +100,12 @@ class FontCollection {
   // Initialize the FontCollection.
   void init(const std::vector<std::shared_ptr<FontFamily>>& typefaces);
 
+  // libtxt: Returns the end of the code units starting at |start| that are
+  // all within one range of mFirstFamilyBmpRanges.
+  size_t findFirstFamilySpanEnd(const uint16_t* string,
+                                size_t start,
+                                size_t string_size) const;
+
   const std::shared_ptr<FontFamily>& getFamilyForChar(uint32_t ch,
                                                       uint32_t vs,
                                                       uint32_t langListId,
@@ -122,7 +132,7 @@ class FontCollection {
                                            const FontFamily& fontFamily);
 
   // static for allocating unique id's
-  static uint32_t sNextId;
+  static std::atomic<uint32_t> sNextId;
 
   // unique id for this font collection (suitable for cache key)
   uint32_t mId;
@@ -143,6 +153,11 @@ class FontCollection {
   std::vector<Range> mRanges;
   std::vector<uint8_t> mFamilyVec;
 
+  // libtxt: The ranges of code points in the BMP that the first family
+  // covers, except for surrogates and variation selectors, sorted by start.
+  // Itemization assigns text in these ranges to the first family in bulk.
+  std::vector<std::pair<uint32_t, uint32_t>> mFirstFamilyBmpRanges;
+
   // This vector has pointers to the font family instances which have cmap 14
   // subtables.
   std::vector<std::shared_ptr<FontFamily>> mVSFamilyVec;
@@ -154,8 +169,11 @@ class FontCollection {
   std::unique_ptr<FallbackFontProvider> mFallbackFontProvider;
 
   // libtxt extension: Fallback fonts discovered after this font collection
-  // was constructed.
-  mutable std::map<std::string, std::vector<std::shared_ptr<FontFamily>>>
+  // was constructed. Layouts on several threads may discover fallback fonts
+  // at once. The families are kept in deques so that references to them stay
+  // valid as more are added.
+  mutable std::mutex mFallbackMutex;
+  mutable std::map<std::string, std::deque<std::shared_ptr<FontFamily>>>
       mCachedFallbackFamilies;
 };
 
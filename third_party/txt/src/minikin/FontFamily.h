@@ -120,7 +120,7 @@ struct Font {
   std::shared_ptr<MinikinFont> typeface;
   FontStyle style;
 
-  std::unordered_set<AxisTag> getSupportedAxesLocked() const;
+  std::unordered_set<AxisTag> getSupportedAxes() const;
 };
 
 struct FontVariation {
@@ -135,6 +135,11 @@ class FontFamily {
   explicit FontFamily(std::vector<Font>&& fonts);
   FontFamily(int variant, std::vector<Font>&& fonts);
   FontFamily(uint32_t langId, int variant, std::vector<Font>&& fonts);
+  // libtxt: Creates a family whose Unicode coverage is already known, for
+  // instance from a cache, instead of parsing the cmap table of its fonts.
+  FontFamily(std::vector<Font>&& fonts,
+             SparseBitSet&& coverage,
+             bool hasVSTable);
 
   // TODO: Good to expose FontUtil.h.
   static bool analyzeStyle(const std::shared_ptr<MinikinFont>& typeface,
@@ -175,6 +180,7 @@ class FontFamily {
 
  private:
   void computeCoverage();
+  void computeSupportedAxes();
 
   uint32_t mLangId;
   int mVariant;
@@ -18,6 +18,8 @@
 
 #include "HbFontCache.h"
 
+#include <mutex>
+
 #include <log/log.h>
 #include <utils/LruCache.h>
 
@@ -40,60 +42,49 @@ class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
     hb_font_destroy(value);
   }
 
-  hb_font_t* get(int32_t fontId) { return mCache.get(fontId); }
+  // Returns a new reference to the cached font, or nullptr.
+  hb_font_t* get(int32_t fontId) {
+    std::scoped_lock lock(mMutex);
+    hb_font_t* font = mCache.get(fontId);
+    return font != nullptr ? hb_font_reference(font) : nullptr;
+  }
 
-  void put(int32_t fontId, hb_font_t* font) { mCache.put(fontId, font); }
+  // Caches |font|, taking ownership of it, unless another thread has cached
+  // a font for |fontId| first. Returns a new reference to the cached font.
+  hb_font_t* put(int32_t fontId, hb_font_t* font) {
+    std::scoped_lock lock(mMutex);
+    hb_font_t* cached = mCache.get(fontId);
+    if (cached != nullptr) {
+      hb_font_destroy(font);
+      return hb_font_reference(cached);
+    }
+    mCache.put(fontId, font);
+    return hb_font_reference(font);
+  }
 
-  void clear() { mCache.clear(); }
+  void clear() {
+    std::scoped_lock lock(mMutex);
+    mCache.clear();
+  }
 
-  void remove(int32_t fontId) { mCache.remove(fontId); }
+  void remove(int32_t fontId) {
+    std::scoped_lock lock(mMutex);
+    mCache.remove(fontId);
+  }
 
  private:
   static const size_t kMaxEntries = 100;
 
+  std::mutex mMutex;
   android::LruCache<int32_t, hb_font_t*> mCache;
 };
 
-HbFontCache* getFontCacheLocked() {
-  assertMinikinLocked();
-  static HbFontCache* cache = nullptr;
-  if (cache == nullptr) {
-    cache = new HbFontCache();
-  }
+HbFontCache* getFontCache() {
+  static HbFontCache* cache = new HbFontCache();
   return cache;
 }
 
-void purgeHbFontCacheLocked() {
-  assertMinikinLocked();
-  getFontCacheLocked()->clear();
-}
-
-void purgeHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
-  const int32_t fontId = minikinFont->GetUniqueId();
-  getFontCacheLocked()->remove(fontId);
-}
-
-// Returns a new reference to a hb_font_t object, caller is
-// responsible for calling hb_font_destroy() on it.
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
-  // TODO: get rid of nullFaceFont
-  static hb_font_t* nullFaceFont = nullptr;
-  if (minikinFont == nullptr) {
-    if (nullFaceFont == nullptr) {
-      nullFaceFont = hb_font_create(nullptr);
-    }
-    return hb_font_reference(nullFaceFont);
-  }
-
-  HbFontCache* fontCache = getFontCacheLocked();
-  const int32_t fontId = minikinFont->GetUniqueId();
-  hb_font_t* font = fontCache->get(fontId);
-  if (font != nullptr) {
-    return hb_font_reference(font);
-  }
-
+static hb_font_t* createHbFont(const MinikinFont* minikinFont) {
   hb_face_t* face = minikinFont->CreateHarfBuzzFace();
 
   hb_font_t* parent_font = hb_font_create(face);
@@ -102,7 +93,7 @@ hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
   unsigned int upem = hb_face_get_upem(face);
   hb_font_set_scale(parent_font, upem, upem);
 
-  font = hb_font_create_sub_font(parent_font);
+  hb_font_t* font = hb_font_create_sub_font(parent_font);
   std::vector<hb_variation_t> variations;
   for (const FontVariation& variation : minikinFont->GetAxes()) {
     variations.push_back({variation.axisTag, variation.value});
@@ -110,8 +101,35 @@ hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
   hb_font_set_variations(font, variations.data(), variations.size());
   hb_font_destroy(parent_font);
   hb_face_destroy(face);
-  fontCache->put(fontId, font);
-  return hb_font_reference(font);
+  hb_font_make_immutable(font);
+  return font;
+}
+
+void purgeHbFontCache() {
+  getFontCache()->clear();
+}
+
+void purgeHbFont(const MinikinFont* minikinFont) {
+  const int32_t fontId = minikinFont->GetUniqueId();
+  getFontCache()->remove(fontId);
+}
+
+hb_font_t* getHbFont(const MinikinFont* minikinFont) {
+  // TODO: get rid of nullFaceFont
+  static hb_font_t* nullFaceFont = hb_font_create(nullptr);
+  if (minikinFont == nullptr) {
+    return hb_font_reference(nullFaceFont);
+  }
+
+  HbFontCache* fontCache = getFontCache();
+  const int32_t fontId = minikinFont->GetUniqueId();
+  hb_font_t* font = fontCache->get(fontId);
+  if (font != nullptr) {
+    return font;
+  }
+  // Create the font without holding the cache's lock. Should another thread
+  // race to create the same font, only one of them is kept.
+  return fontCache->put(fontId, createHbFont(minikinFont));
 }
 
 }  // namespace minikin
@@ -22,9 +22,14 @@ struct hb_font_t;
 namespace minikin {
 class MinikinFont;
 
-void purgeHbFontCacheLocked();
-void purgeHbFontLocked(const MinikinFont* minikinFont);
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont);
+void purgeHbFontCache();
+void purgeHbFont(const MinikinFont* minikinFont);
+
+// Returns a new reference to the hb_font_t for |minikinFont|, which the
+// caller must release with hb_font_destroy(). The font is shared between
+// threads and immutable. To shape text with a size or font functions of its
+// own, a caller should create a sub font of it.
+hb_font_t* getHbFont(const MinikinFont* minikinFont);
 
 }  // namespace minikin
 #endif  // MINIKIN_HBFONT_CACHE_H
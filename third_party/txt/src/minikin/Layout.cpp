@@ -20,9 +20,14 @@
 #include <unicode/ubidi.h>
 #include <unicode/utf16.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <log/log.h>
@@ -108,6 +113,16 @@ class LayoutCacheKey {
                         collection);
   }
 
+  // An estimate of the memory used by this key, once its text is copied, and
+  // by the cached |layout| of its word.
+  size_t getEntryBytes(const Layout& layout) const {
+    return sizeof(LayoutCacheKey) + mNchars * sizeof(uint16_t) +
+           sizeof(Layout) +
+           layout.mGlyphs.capacity() * sizeof(LayoutGlyph) +
+           layout.mAdvances.capacity() * sizeof(float) +
+           layout.mFaces.capacity() * sizeof(FakedFont);
+  }
+
  private:
   const uint16_t* mChars;
   size_t mNchars;
@@ -129,56 +144,169 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// The layout cache is split into shards, each with its own lock, so that
+// threads laying out different words rarely wait on each other. Each shard
+// holds at most its share of the byte budget of the cache.
+class LayoutCache {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
-    mCache.setOnEntryRemovedListener(this);
+  void clear() {
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      shard.cache.clear();
+    }
+  }
+
+  void setMaxBytes(size_t maxBytes) {
+    mMaxBytes = maxBytes;
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      trim(shard);
+    }
   }
 
-  void clear() { mCache.clear(); }
-
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  LayoutCacheStatistics getStatistics() const {
+    LayoutCacheStatistics statistics;
+    statistics.entryCount = mEntryCount;
+    statistics.bytes = mBytes;
+    statistics.maxBytes = mMaxBytes;
+    statistics.hitCount = mHitCount;
+    statistics.missCount = mMissCount;
+    statistics.evictionCount = mEvictionCount;
+    return statistics;
+  }
+
+  // Returns the layout of the word that |key| describes, laying it out on a
+  // miss. The returned layout remains valid after it is evicted.
+  std::shared_ptr<Layout> get(
+      LayoutCacheKey& key,
+      LayoutContext* ctx,
+      const std::shared_ptr<FontCollection>& collection) {
+    Shard& shard = mShards[key.hash() % kShardCount];
+    {
+      std::scoped_lock lock(shard.mutex);
+      const std::shared_ptr<Layout>& cached = shard.cache.get(key);
+      if (cached != nullptr) {
+        mHitCount.fetch_add(1, std::memory_order_relaxed);
+        return cached;
+      }
+    }
+    mMissCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Shape the word without holding the lock of the shard.
+    std::shared_ptr<Layout> layout = std::make_shared<Layout>();
+    key.doLayout(layout.get(), ctx, collection);
+
+    const size_t bytes = key.getEntryBytes(*layout);
+    if (bytes > getShardMaxBytes()) {
+      // Caching a word this large would evict most of the shard.
+      return layout;
     }
+
+    std::scoped_lock lock(shard.mutex);
+    const std::shared_ptr<Layout>& cached = shard.cache.get(key);
+    if (cached != nullptr) {
+      // Another thread laid out the same word meanwhile.
+      return cached;
+    }
+    key.copyText();
+    shard.cache.put(key, layout);
+    shard.bytes += bytes;
+    mBytes += bytes;
+    mEntryCount++;
+    trim(shard);
     return layout;
   }
 
  private:
-  // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
-    key.freeText();
-    delete value;
+  struct Shard
+      : private android::OnEntryRemoved<LayoutCacheKey,
+                                        std::shared_ptr<Layout>> {
+    explicit Shard(LayoutCache* owner)
+        : owner(owner),
+          cache(android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>>::
+                    kUnlimitedCapacity) {
+      cache.setOnEntryRemovedListener(this);
+    }
+
+    // callback for OnEntryRemoved
+    void operator()(LayoutCacheKey& key,
+                    std::shared_ptr<Layout>& value) override {
+      const size_t entryBytes = key.getEntryBytes(*value);
+      bytes -= entryBytes;
+      owner->mBytes -= entryBytes;
+      owner->mEntryCount--;
+      key.freeText();
+    }
+
+    LayoutCache* const owner;
+    std::mutex mutex;
+    android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>> cache;
+    // The bytes used by the entries of this shard. Guarded by |mutex|.
+    size_t bytes = 0;
+  };
+
+  static const size_t kShardCount = 16;
+
+  size_t getShardMaxBytes() const { return mMaxBytes / kShardCount; }
+
+  // Evicts the least recently used entries of |shard| until it fits in its
+  // share of the budget. The caller must hold the lock of the shard.
+  void trim(Shard& shard) {
+    const size_t maxBytes = getShardMaxBytes();
+    while (shard.bytes > maxBytes && shard.cache.removeOldest()) {
+      mEvictionCount.fetch_add(1, std::memory_order_relaxed);
+    }
   }
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+  template <size_t... I>
+  static std::array<Shard, kShardCount> makeShards(
+      LayoutCache* owner,
+      std::index_sequence<I...>) {
+    return {{((void)I, Shard(owner))...}};
+  }
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+  std::atomic<size_t> mMaxBytes = Layout::kDefaultCacheMaxBytes;
+  std::atomic<size_t> mBytes = 0;
+  std::atomic<size_t> mEntryCount = 0;
+  std::atomic<uint64_t> mHitCount = 0;
+  std::atomic<uint64_t> mMissCount = 0;
+  std::atomic<uint64_t> mEvictionCount = 0;
+  std::array<Shard, kShardCount> mShards =
+      makeShards(this, std::make_index_sequence<kShardCount>());
+};
+
+// An RAII wrapper for hb_buffer_t
+class HbBuffer {
+ public:
+  explicit HbBuffer(hb_unicode_funcs_t* unicodeFunctions)
+      : mBuffer(hb_buffer_create()) {
+    hb_buffer_set_unicode_funcs(mBuffer, unicodeFunctions);
+  }
+
+  ~HbBuffer() { hb_buffer_destroy(mBuffer); }
+
+  hb_buffer_t* get() const { return mBuffer; }
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+ private:
+  hb_buffer_t* mBuffer;
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
+    hb_unicode_funcs_make_immutable(unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
+  // Returns the buffer that the calling thread shapes text into.
+  hb_buffer_t* getBuffer() {
+    thread_local HbBuffer buffer(unicodeFunctions);
+    return buffer.get();
+  }
+
   static LayoutEngine& getInstance() {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
@@ -254,34 +382,31 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(funcs, harfbuzzGetGlyphHorizontalOrigin,
+                                        0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +441,11 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // The cached font is shared with other threads, so the paint and the size
+    // of this layout are set on a sub font of its own.
+    hb_font_t* parent = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(parent);
+    hb_font_destroy(parent);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,10 +454,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -588,8 +714,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -612,8 +736,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -720,9 +842,9 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
+    std::shared_ptr<Layout> layoutForWord = cache.get(key, ctx, collection);
     if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
     }
     if (advances) {
       layoutForWord->getAdvances(advances);
@@ -748,7 +870,7 @@ static void addFeatures(const std::string& str,
   const char* end = start + str.size();
 
   while (start < end) {
-    static hb_feature_t feature;
+    hb_feature_t feature;
     const char* p = strchr(start, ',');
     if (!p)
       p = end;
@@ -919,7 +1041,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getInstance().getBuffer();
   std::vector<FontCollection::Run> items;
   collection->itemize(buf + start, count, ctx->style, &items);
 
@@ -1193,10 +1315,17 @@ void Layout::getBounds(MinikinRect* bounds) const {
 }
 
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
+}
+
+void Layout::setCacheMaxBytes(size_t maxBytes) {
+  LayoutEngine::getInstance().layoutCache.setMaxBytes(maxBytes);
+}
+
+LayoutCacheStatistics Layout::getCacheStatistics() {
+  return LayoutEngine::getInstance().layoutCache.getStatistics();
 }
 
 }  // namespace minikin
@@ -19,6 +19,7 @@
 
 #include <hb.h>
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -57,6 +58,19 @@ enum {
   kBidi_Mask = 0x7
 };
 
+// libtxt extension: counters of the cache of laid out words that all layouts
+// share.
+struct LayoutCacheStatistics {
+  // The number of words in the cache and an estimate of the memory they use.
+  size_t entryCount = 0;
+  size_t bytes = 0;
+  size_t maxBytes = 0;
+  // Totals since the process started.
+  uint64_t hitCount = 0;
+  uint64_t missCount = 0;
+  uint64_t evictionCount = 0;
+};
+
 // Lifecycle and threading assumptions for Layout:
 // The object is assumed to be owned by a single thread; multiple threads
 // may not mutate it at the same time.
@@ -117,6 +131,15 @@ class Layout {
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
+  // libtxt extension: the layouts of words are cached until the cache holds
+  // more than this many bytes, after which the least recently used words are
+  // evicted first.
+  static constexpr size_t kDefaultCacheMaxBytes = 4 * 1024 * 1024;
+
+  static void setCacheMaxBytes(size_t maxBytes);
+
+  static LayoutCacheStatistics getCacheStatistics();
+
  private:
   friend class LayoutCacheKey;
 
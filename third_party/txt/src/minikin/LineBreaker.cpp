@@ -122,13 +122,34 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
                                size_t end,
                                bool isRtl) {
   float width = 0.0f;
-
-  float hyphenPenalty = 0.0;
   if (paint != nullptr) {
     width = Layout::measureText(mTextBuf.data(), start, end - start,
                                 mTextBuf.size(), isRtl, style, *paint, typeface,
                                 mCharWidths.data() + start);
+  }
+  addBreakCandidates(paint, typeface, style, start, end, isRtl);
+  return width;
+}
 
+void LineBreaker::addMeasuredStyleRun(
+    MinikinPaint* paint,
+    const std::shared_ptr<FontCollection>& typeface,
+    FontStyle style,
+    size_t start,
+    size_t end,
+    bool isRtl) {
+  addBreakCandidates(paint, typeface, style, start, end, isRtl);
+}
+
+void LineBreaker::addBreakCandidates(
+    MinikinPaint* paint,
+    const std::shared_ptr<FontCollection>& typeface,
+    FontStyle style,
+    size_t start,
+    size_t end,
+    bool isRtl) {
+  float hyphenPenalty = 0.0;
+  if (paint != nullptr) {
     // a heuristic that seems to perform well
     hyphenPenalty =
         0.5 * paint->size * paint->scaleX * mLineWidths.getLineWidth(0);
@@ -222,8 +243,6 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
       current = (size_t)mWordBreaker.next();
     }
   }
-
-  return width;
 }
 
 // add a word break (possibly for a hyphenated fragment), and add desperate
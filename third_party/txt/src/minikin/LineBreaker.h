@@ -145,6 +145,16 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt: Like addStyleRun, but uses the widths already in charWidths() for
+  // [start, end) instead of measuring the text. This lets a paragraph be
+  // broken at another line width without shaping its text again.
+  void addMeasuredStyleRun(MinikinPaint* paint,
+                           const std::shared_ptr<FontCollection>& typeface,
+                           FontStyle style,
+                           size_t start,
+                           size_t end,
+                           bool isRtl);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -206,6 +216,14 @@ class LineBreaker {
 
   float getSpaceWidth() const;
 
+  // Adds the break candidates of a run whose widths are in mCharWidths.
+  void addBreakCandidates(MinikinPaint* paint,
+                          const std::shared_ptr<FontCollection>& typeface,
+                          FontStyle style,
+                          size_t start,
+                          size_t end,
+                          bool isRtl);
+
   void computeBreaksGreedy();
 
   void computeBreaksOptimal(bool isRectangular);
@@ -19,6 +19,8 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include <log/log.h>
 
 #include <minikin/SparseBitSet.h>
@@ -155,4 +157,29 @@ uint32_t SparseBitSet::nextSetBit(uint32_t fromIndex) const {
   return kNotFound;
 }
 
+std::vector<uint32_t> SparseBitSet::getRanges() const {
+  std::vector<uint32_t> ranges;
+  uint32_t start = nextSetBit(0);
+  while (start != kNotFound) {
+    uint32_t end = start + 1;
+    while (end < mMaxVal) {
+      // Skip whole elements of set bits at once.
+      const element* bitmap = &mBitmaps[mIndices[end >> kLogValuesPerPage]];
+      if ((end & kElMask) == 0 &&
+          bitmap[(end & kPageMask) >> kLogBitsPerEl] == kElAllOnes) {
+        end += 1 << kLogBitsPerEl;
+      } else if (get(end)) {
+        end++;
+      } else {
+        break;
+      }
+    }
+    end = std::min(end, mMaxVal);
+    ranges.push_back(start);
+    ranges.push_back(end);
+    start = nextSetBit(end);
+  }
+  return ranges;
+}
+
 }  // namespace minikin
@@ -21,6 +21,7 @@
 #include <sys/types.h>
 
 #include <memory>
+#include <vector>
 
 // ---------------------------------------------------------------------------
 
@@ -65,6 +66,10 @@ class SparseBitSet {
 
   static const uint32_t kNotFound = ~0u;
 
+  // libtxt: Returns the set as ranges, laid out as the constructor takes
+  // them, so that the set can be stored and later recreated.
+  std::vector<uint32_t> getRanges() const;
+
  private:
   void initFromRanges(const uint32_t* ranges, size_t nRanges);
 
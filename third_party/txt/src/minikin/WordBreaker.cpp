@@ -32,15 +32,31 @@ const uint32_t CHAR_SOFT_HYPHEN = 0x00AD;
 const uint32_t CHAR_ZWJ = 0x200D;
 
 void WordBreaker::setLocale(const icu::Locale& locale) {
-  UErrorCode status = U_ZERO_ERROR;
-  mBreakIterator.reset(icu::BreakIterator::createLineInstance(locale, status));
-  // TODO: handle failure status
+  mLocale = locale;
+  mBreakIterator.reset();
   if (mText != nullptr) {
-    mBreakIterator->setText(&mUText, status);
+    acquireIterator();
+    if (mBreakIterator) {
+      UErrorCode status = U_ZERO_ERROR;
+      mBreakIterator->setText(&mUText, status);
+    }
   }
   mIteratorWasReset = true;
 }
 
+void WordBreaker::acquireIterator() {
+  BreakIteratorPool& pool = BreakIteratorPool::getInstance();
+  mBreakIterator = pool.acquire(mLocale, BreakIteratorPool::Kind::kLine);
+  if (!mBreakIterator) {
+    // libtxt: Fall back to the rules of the root locale. If there is no
+    // iterator for those either, the text is not broken at all.
+    ALOGW("Could not create a line break iterator for locale %s",
+          mLocale.getName());
+    mBreakIterator = pool.acquire(icu::Locale::getRoot(),
+                                  BreakIteratorPool::Kind::kLine);
+  }
+}
+
 void WordBreaker::setText(const uint16_t* data, size_t size) {
   mText = data;
   mTextSize = size;
@@ -52,8 +68,13 @@ void WordBreaker::setText(const uint16_t* data, size_t size) {
   UErrorCode status = U_ZERO_ERROR;
   utext_openUChars(&mUText, reinterpret_cast<const UChar*>(data), size,
                    &status);
-  mBreakIterator->setText(&mUText, status);
-  mBreakIterator->first();
+  if (!mBreakIterator) {
+    acquireIterator();
+  }
+  if (mBreakIterator) {
+    mBreakIterator->setText(&mUText, status);
+    mBreakIterator->first();
+  }
 }
 
 ssize_t WordBreaker::current() const {
@@ -114,6 +135,12 @@ static bool isBreakValid(const uint16_t* buf, size_t bufEnd, size_t i) {
 // Customized iteratorNext that takes care of both resets and our modifications
 // to ICU's behavior.
 int32_t WordBreaker::iteratorNext() {
+  if (!mBreakIterator) {
+    // libtxt: Without an iterator, the only break is at the end of the text.
+    mIteratorWasReset = false;
+    return (size_t)mCurrent < mTextSize ? (int32_t)mTextSize
+                                        : icu::BreakIterator::DONE;
+  }
   int32_t result;
   do {
     if (mIteratorWasReset) {
@@ -174,7 +201,7 @@ void WordBreaker::detectEmailOrUrl() {
       }
     }
     if (state == SAW_AT || state == SAW_COLON_SLASH_SLASH) {
-      if (!mBreakIterator->isBoundary(i)) {
+      if (mBreakIterator && !mBreakIterator->isBoundary(i)) {
         // If there are combining marks or such at the end of the URL or the
         // email address, consider them a part of the URL or the email, and skip
         // to the next actual boundary.
@@ -278,6 +305,8 @@ void WordBreaker::finish() {
   mText = nullptr;
   // Note: calling utext_close multiply is safe
   utext_close(&mUText);
+  // libtxt: Return the iterator to the pool for other breakers to use.
+  mBreakIterator.reset();
 }
 
 }  // namespace minikin
@@ -24,7 +24,9 @@
 #define MINIKIN_WORD_BREAKER_H
 
 #include <memory>
+#include "minikin/BreakIteratorPool.h"
 #include "unicode/brkiter.h"
+#include "unicode/locid.h"
 #include "utils/WindowsUtils.h"
 
 namespace minikin {
@@ -59,7 +61,14 @@ class WordBreaker {
   void detectEmailOrUrl();
   ssize_t findNextBreakInEmailOrUrl();
 
-  std::unique_ptr<icu::BreakIterator> mBreakIterator;
+  // libtxt: Borrows an iterator for mLocale from the pool.
+  void acquireIterator();
+
+  icu::Locale mLocale;
+  // libtxt: Borrowed from the pool while there is text, and returned by
+  // finish(). Null if ICU could not create an iterator for the locale or the
+  // root locale.
+  BreakIteratorPool::Ptr mBreakIterator;
   UText mUText = UTEXT_INITIALIZER;
   const uint16_t* mText = nullptr;
   size_t mTextSize;
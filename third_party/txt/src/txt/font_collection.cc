@@ -122,6 +122,12 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
   return order;
 }
 
+void FontCollection::SetFontFallbackCache(
+    std::shared_ptr<FontFallbackCache> cache) {
+  std::scoped_lock lock(mutex_);
+  fallback_cache_ = std::move(cache);
+}
+
 void FontCollection::DisableFontFallback() {
   enable_font_fallback_ = false;
 }
@@ -130,6 +136,8 @@ std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamilies(
     const std::vector<std::string>& font_families,
     const std::string& locale) {
+  std::scoped_lock lock(mutex_);
+
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
   auto cached = font_collections_cache_.find(family_key);
@@ -242,12 +250,35 @@ std::shared_ptr<minikin::FontFamily> FontCollection::CreateMinikinFontFamily(
                            skia_typeface->isItalic()});
   }
 
-  return std::make_shared<minikin::FontFamily>(std::move(minikin_fonts));
+  if (!fallback_cache_) {
+    return std::make_shared<minikin::FontFamily>(std::move(minikin_fonts));
+  }
+
+  // Reuse the coverage of the family computed by an earlier run instead of
+  // parsing the cmap table again.
+  const uint64_t family_id = FontFallbackCache::GetFamilyId(skia_typefaces);
+  minikin::SparseBitSet coverage;
+  bool has_vs_table = false;
+  if (family_id != 0 &&
+      fallback_cache_->GetCoverage(family_id, &coverage, &has_vs_table)) {
+    return std::make_shared<minikin::FontFamily>(
+        std::move(minikin_fonts), std::move(coverage), has_vs_table);
+  }
+
+  auto minikin_family =
+      std::make_shared<minikin::FontFamily>(std::move(minikin_fonts));
+  if (family_id != 0) {
+    fallback_cache_->SetCoverage(family_id, minikin_family->getCoverage(),
+                                 minikin_family->hasVSTable());
+  }
+  return minikin_family;
 }
 
 const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  std::scoped_lock lock(mutex_);
+
   // Check if the ch's matched font has been cached. We cache the results of
   // this method as repeated matchFamilyStyleCharacter calls can become
   // extremely laggy when typing a large number of complex emojis.
@@ -264,6 +295,12 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
 const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  const std::shared_ptr<minikin::FontFamily>& cached =
+      MatchCachedFallbackFont(ch, locale);
+  if (cached) {
+    return cached;
+  }
+
   for (const sk_sp<SkFontMgr>& manager : GetFontManagerOrder()) {
     std::vector<const char*> bcp47;
     if (!locale.empty())
@@ -277,16 +314,52 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     typeface->getFamilyName(&sk_family_name);
     std::string family_name(sk_family_name.c_str());
 
-    if (std::find(fallback_fonts_for_locale_[locale].begin(),
-                  fallback_fonts_for_locale_[locale].end(),
-                  family_name) == fallback_fonts_for_locale_[locale].end())
-      fallback_fonts_for_locale_[locale].push_back(family_name);
+    AddFallbackFontForLocale(locale, family_name);
 
-    return GetFallbackFontFamily(manager, family_name);
+    const std::shared_ptr<minikin::FontFamily>& family =
+        GetFallbackFontFamily(manager, family_name);
+    if (family && fallback_cache_) {
+      fallback_cache_->SetFallbackFamily(ch, locale, family_name);
+    }
+    return family;
   }
   return g_null_family;
 }
 
+const std::shared_ptr<minikin::FontFamily>&
+FontCollection::MatchCachedFallbackFont(uint32_t ch,
+                                        const std::string& locale) {
+  std::string family_name;
+  if (!fallback_cache_ ||
+      !fallback_cache_->GetFallbackFamily(ch, locale, &family_name)) {
+    return g_null_family;
+  }
+
+  // The fonts may have changed since the family was matched, so check that it
+  // still exists and covers ch before trusting it.
+  for (const sk_sp<SkFontMgr>& manager : GetFontManagerOrder()) {
+    const std::shared_ptr<minikin::FontFamily>& family =
+        GetFallbackFontFamily(manager, family_name);
+    if (!family) {
+      continue;
+    }
+    if (!family->getCoverage().get(ch)) {
+      return g_null_family;
+    }
+    AddFallbackFontForLocale(locale, family_name);
+    return family;
+  }
+  return g_null_family;
+}
+
+void FontCollection::AddFallbackFontForLocale(const std::string& locale,
+                                              const std::string& family_name) {
+  std::vector<std::string>& families = fallback_fonts_for_locale_[locale];
+  if (std::find(families.begin(), families.end(), family_name) ==
+      families.end())
+    families.push_back(family_name);
+}
+
 const std::shared_ptr<minikin::FontFamily>&
 FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
                                       const std::string& family_name) {
@@ -312,6 +385,7 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 }
 
 void FontCollection::ClearFontFamilyCache() {
+  std::scoped_lock lock(mutex_);
   font_collections_cache_.clear();
 }
 
@@ -18,6 +18,7 @@
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -28,6 +29,7 @@
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "txt/asset_font_manager.h"
+#include "txt/font_fallback_cache.h"
 #include "txt/text_style.h"
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -67,6 +69,11 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Persists the coverage of the font families this collection creates and
+  // the fallback fonts it matches in |cache|, and consults it before parsing
+  // font tables or querying the font managers.
+  void SetFontFallbackCache(std::shared_ptr<FontFallbackCache> cache);
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -93,6 +100,8 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   sk_sp<SkFontMgr> asset_font_manager_;
   sk_sp<SkFontMgr> dynamic_font_manager_;
   sk_sp<SkFontMgr> test_font_manager_;
+  // Guards the caches below, which paragraphs laid out concurrently share.
+  std::mutex mutex_;
   std::unordered_map<FamilyKey,
                      std::shared_ptr<minikin::FontCollection>,
                      FamilyKey::Hasher>
@@ -106,6 +115,7 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
   bool enable_font_fallback_;
+  std::shared_ptr<FontFallbackCache> fallback_cache_;
 
 #if FLUTTER_ENABLE_SKSHAPER
   // An equivalent font collection usable by the Skia text shaper library.
@@ -118,6 +128,15 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
       uint32_t ch,
       std::string locale);
 
+  // Looks up the family last matched for ch in the fallback cache, if it
+  // still covers ch.
+  const std::shared_ptr<minikin::FontFamily>& MatchCachedFallbackFont(
+      uint32_t ch,
+      const std::string& locale);
+
+  void AddFallbackFontForLocale(const std::string& locale,
+                                const std::string& family_name);
+
   std::vector<sk_sp<SkFontMgr>> GetFontManagerOrder() const;
 
   std::shared_ptr<minikin::FontFamily> FindFontFamilyInManagers(
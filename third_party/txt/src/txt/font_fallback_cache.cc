@@ -0,0 +1,344 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "font_fallback_cache.h"
+
+#include <cstring>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkFontStyle.h"
+#include "third_party/skia/include/core/SkTypes.h"
+
+namespace txt {
+
+namespace {
+
+// The file starts with a FileHeader, followed by the coverage entries and
+// then by the fallback entries. Every part of the file is padded to a
+// multiple of four bytes, so that the ranges of the coverage entries can be
+// read in place from the mapping.
+constexpr uint32_t kMagic = SkSetFourByteTag('t', 'x', 'f', 'b');
+
+// One past the largest code point.
+constexpr uint32_t kMaxCodePointEnd = 0x110000;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t coverage_count;
+  uint32_t fallback_count;
+};
+
+// Followed by range_count pairs of code points.
+struct CoverageHeader {
+  uint64_t family_id;
+  uint32_t has_vs_table;
+  uint32_t range_count;
+};
+
+// Followed by the locale and the family name, each padded.
+struct FallbackHeader {
+  uint32_t code_point;
+  uint32_t locale_size;
+  uint32_t family_name_size;
+};
+
+size_t Padded(size_t size) {
+  return (size + 3) & ~size_t{3};
+}
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  // Returns the next |size| bytes, padded, or nullptr if there are not that
+  // many left.
+  const uint8_t* Skip(size_t size) {
+    if (size > size_ - offset_ || Padded(size) > size_ - offset_) {
+      return nullptr;
+    }
+    const uint8_t* result = data_ + offset_;
+    offset_ += Padded(size);
+    return result;
+  }
+
+  template <typename T>
+  bool Read(T* value) {
+    const uint8_t* bytes = Skip(sizeof(T));
+    if (bytes == nullptr) {
+      return false;
+    }
+    memcpy(value, bytes, sizeof(T));
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  const size_t size_;
+  size_t offset_ = 0;
+};
+
+class Writer {
+ public:
+  template <typename T>
+  void Write(const T& value) {
+    WriteBytes(&value, sizeof(T));
+  }
+
+  void WriteBytes(const void* bytes, size_t size) {
+    const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+    data_.insert(data_.end(), begin, begin + size);
+    data_.resize(Padded(data_.size()));
+  }
+
+  std::vector<uint8_t> TakeData() { return std::move(data_); }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+// Whether |ranges| can be turned into a SparseBitSet, which trusts that they
+// are sorted, disjoint, not empty and within Unicode.
+bool AreValidRanges(const uint32_t* ranges, size_t range_count) {
+  uint32_t previous_end = 0;
+  for (size_t i = 0; i < range_count; i++) {
+    const uint32_t start = ranges[2 * i];
+    const uint32_t end = ranges[2 * i + 1];
+    if (start >= end || start < previous_end || end > kMaxCodePointEnd) {
+      return false;
+    }
+    previous_end = end;
+  }
+  return true;
+}
+
+// 64-bit FNV-1a.
+uint64_t Hash(uint64_t hash, const void* bytes, size_t size) {
+  const uint8_t* data = static_cast<const uint8_t*>(bytes);
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+}  // anonymous namespace
+
+FontFallbackCache::FontFallbackCache(fml::UniqueFD directory, bool read_only)
+    : directory_(std::move(directory)), read_only_(read_only) {
+  if (!directory_.is_valid()) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "FontFallbackCache::Load");
+  mapping_ = fml::FileMapping::CreateReadOnly(directory_, kFileName);
+  if (mapping_ != nullptr && !Load()) {
+    FML_LOG(WARNING) << "Ignoring the invalid font fallback cache.";
+    mapping_.reset();
+  }
+}
+
+FontFallbackCache::~FontFallbackCache() = default;
+
+uint64_t FontFallbackCache::GetFamilyId(
+    const std::vector<sk_sp<SkTypeface>>& typefaces) {
+  // The checksum adjustment in the head table covers the whole font file, so
+  // the head table identifies the font. The style is included as it decides
+  // which font of the family the coverage is computed from.
+  const SkFontTableTag head_tag = SkSetFourByteTag('h', 'e', 'a', 'd');
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const sk_sp<SkTypeface>& typeface : typefaces) {
+    const size_t head_size = typeface->getTableSize(head_tag);
+    if (head_size == 0) {
+      return 0;
+    }
+    std::vector<uint8_t> head(head_size);
+    if (typeface->getTableData(head_tag, 0, head_size, head.data()) !=
+        head_size) {
+      return 0;
+    }
+    hash = Hash(hash, head.data(), head.size());
+    const int style[] = {typeface->fontStyle().weight(),
+                         typeface->fontStyle().width(),
+                         typeface->fontStyle().slant()};
+    hash = Hash(hash, style, sizeof(style));
+  }
+  return typefaces.empty() ? 0 : hash;
+}
+
+bool FontFallbackCache::GetCoverage(uint64_t family_id,
+                                    minikin::SparseBitSet* coverage,
+                                    bool* has_vs_table) {
+  std::scoped_lock lock(mutex_);
+  auto found = coverage_.find(family_id);
+  if (found == coverage_.end()) {
+    return false;
+  }
+  const CoverageEntry& entry = found->second;
+  *coverage = minikin::SparseBitSet(entry.ranges, entry.range_count);
+  *has_vs_table = entry.has_vs_table;
+  return true;
+}
+
+void FontFallbackCache::SetCoverage(uint64_t family_id,
+                                    const minikin::SparseBitSet& coverage,
+                                    bool has_vs_table) {
+  std::vector<uint32_t> ranges = coverage.getRanges();
+  std::scoped_lock lock(mutex_);
+  CoverageEntry& entry = coverage_[family_id];
+  entry.has_vs_table = has_vs_table;
+  entry.owned_ranges = std::move(ranges);
+  entry.ranges = entry.owned_ranges.data();
+  entry.range_count = entry.owned_ranges.size() / 2;
+  dirty_ = true;
+}
+
+bool FontFallbackCache::GetFallbackFamily(uint32_t ch,
+                                          const std::string& locale,
+                                          std::string* family_name) {
+  std::scoped_lock lock(mutex_);
+  auto found = fallback_families_.find(FallbackKey(ch, locale));
+  if (found == fallback_families_.end()) {
+    return false;
+  }
+  *family_name = found->second;
+  return true;
+}
+
+void FontFallbackCache::SetFallbackFamily(uint32_t ch,
+                                          const std::string& locale,
+                                          const std::string& family_name) {
+  std::scoped_lock lock(mutex_);
+  std::string& cached = fallback_families_[FallbackKey(ch, locale)];
+  if (cached != family_name) {
+    cached = family_name;
+    dirty_ = true;
+  }
+}
+
+bool FontFallbackCache::IsDirty() {
+  std::scoped_lock lock(mutex_);
+  return dirty_ && directory_.is_valid() && !read_only_;
+}
+
+bool FontFallbackCache::Save() {
+  TRACE_EVENT0("flutter", "FontFallbackCache::Save");
+  std::vector<uint8_t> data;
+  {
+    std::scoped_lock lock(mutex_);
+    if (!dirty_ || !directory_.is_valid() || read_only_) {
+      return true;
+    }
+    data = Serialize();
+    dirty_ = false;
+  }
+  // The file is replaced rather than written in place, so the current mapping
+  // of the old file stays valid.
+  if (!fml::WriteAtomically(directory_, kFileName,
+                            fml::DataMapping(std::move(data)))) {
+    FML_LOG(ERROR) << "Could not write the font fallback cache.";
+    return false;
+  }
+  return true;
+}
+
+bool FontFallbackCache::Load() {
+  Reader reader(mapping_->GetMapping(), mapping_->GetSize());
+  FileHeader header;
+  if (!reader.Read(&header) || header.magic != kMagic ||
+      header.version != kVersion) {
+    return false;
+  }
+
+  std::unordered_map<uint64_t, CoverageEntry> coverage;
+  for (uint32_t i = 0; i < header.coverage_count; i++) {
+    CoverageHeader coverage_header;
+    if (!reader.Read(&coverage_header)) {
+      return false;
+    }
+    const size_t ranges_size =
+        size_t{coverage_header.range_count} * 2 * sizeof(uint32_t);
+    const uint8_t* ranges = reader.Skip(ranges_size);
+    if (ranges == nullptr || !AreValidRanges(
+                                 reinterpret_cast<const uint32_t*>(ranges),
+                                 coverage_header.range_count)) {
+      return false;
+    }
+    CoverageEntry& entry = coverage[coverage_header.family_id];
+    entry.has_vs_table = coverage_header.has_vs_table != 0;
+    entry.ranges = reinterpret_cast<const uint32_t*>(ranges);
+    entry.range_count = coverage_header.range_count;
+  }
+
+  std::map<FallbackKey, std::string> fallback_families;
+  for (uint32_t i = 0; i < header.fallback_count; i++) {
+    FallbackHeader fallback_header;
+    if (!reader.Read(&fallback_header)) {
+      return false;
+    }
+    const uint8_t* locale = reader.Skip(fallback_header.locale_size);
+    const uint8_t* family_name = reader.Skip(fallback_header.family_name_size);
+    if (locale == nullptr || family_name == nullptr) {
+      return false;
+    }
+    fallback_families[FallbackKey(
+        fallback_header.code_point,
+        std::string(reinterpret_cast<const char*>(locale),
+                    fallback_header.locale_size))] =
+        std::string(reinterpret_cast<const char*>(family_name),
+                    fallback_header.family_name_size);
+  }
+
+  coverage_ = std::move(coverage);
+  fallback_families_ = std::move(fallback_families);
+  return true;
+}
+
+std::vector<uint8_t> FontFallbackCache::Serialize() const {
+  Writer writer;
+  FileHeader header;
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.coverage_count = coverage_.size();
+  header.fallback_count = fallback_families_.size();
+  writer.Write(header);
+
+  for (const auto& coverage : coverage_) {
+    CoverageHeader coverage_header;
+    coverage_header.family_id = coverage.first;
+    coverage_header.has_vs_table = coverage.second.has_vs_table;
+    coverage_header.range_count = coverage.second.range_count;
+    writer.Write(coverage_header);
+    writer.WriteBytes(coverage.second.ranges,
+                      coverage.second.range_count * 2 * sizeof(uint32_t));
+  }
+
+  for (const auto& fallback : fallback_families_) {
+    const std::string& locale = fallback.first.second;
+    const std::string& family_name = fallback.second;
+    FallbackHeader fallback_header;
+    fallback_header.code_point = fallback.first.first;
+    fallback_header.locale_size = locale.size();
+    fallback_header.family_name_size = family_name.size();
+    writer.Write(fallback_header);
+    writer.WriteBytes(locale.data(), locale.size());
+    writer.WriteBytes(family_name.data(), family_name.size());
+  }
+
+  return writer.TakeData();
+}
+
+}  // namespace txt
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIB_TXT_SRC_FONT_FALLBACK_CACHE_H_
+#define LIB_TXT_SRC_FONT_FALLBACK_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "minikin/SparseBitSet.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+
+namespace txt {
+
+// Stores the Unicode coverage of font families and the fallback families
+// matched for code points in a file, so that later runs of the process can
+// skip parsing cmap tables and asking the font managers for fallback fonts.
+//
+// The file is memory mapped when the cache is created. Coverage is read
+// straight out of the mapping. Results added afterwards are kept in memory
+// until the next call to Save, which rewrites the file.
+//
+// A font family is identified by the contents of its fonts, so the coverage
+// stays valid for as long as the fonts do. Fallback results may go stale when
+// the fonts on the system change, so users of the cache must check that a
+// fallback family still covers the code point it was matched for.
+//
+// This class is thread safe.
+class FontFallbackCache {
+ public:
+  // The version of the file format. Files with a different version are
+  // ignored, and replaced on the next save.
+  static constexpr uint32_t kVersion = 1;
+
+  static constexpr char kFileName[] = "font_fallback_cache";
+
+  // Loads the cache from the file in |directory|, if there is a valid one.
+  // Save writes the file to the same directory, unless the cache is
+  // |read_only|, in which case results are only kept in memory.
+  explicit FontFallbackCache(fml::UniqueFD directory, bool read_only = false);
+
+  ~FontFallbackCache();
+
+  // Returns an identifier of the family made of |typefaces|, derived from the
+  // contents of their fonts, or 0 if the family can not be identified.
+  static uint64_t GetFamilyId(const std::vector<sk_sp<SkTypeface>>& typefaces);
+
+  // Looks up the coverage stored for the family with |family_id|.
+  bool GetCoverage(uint64_t family_id,
+                   minikin::SparseBitSet* coverage,
+                   bool* has_vs_table);
+
+  void SetCoverage(uint64_t family_id,
+                   const minikin::SparseBitSet& coverage,
+                   bool has_vs_table);
+
+  // Looks up the name of the family last matched as a fallback for |ch| in
+  // |locale|.
+  bool GetFallbackFamily(uint32_t ch,
+                         const std::string& locale,
+                         std::string* family_name);
+
+  void SetFallbackFamily(uint32_t ch,
+                         const std::string& locale,
+                         const std::string& family_name);
+
+  // Whether results were added since the cache was loaded or last saved, and
+  // need to be saved.
+  bool IsDirty();
+
+  // Writes the cache to its file if it is dirty. Returns false if the file
+  // could not be written.
+  bool Save();
+
+ private:
+  struct CoverageEntry {
+    bool has_vs_table = false;
+    // Points either into the mapped file or to owned_ranges.
+    const uint32_t* ranges = nullptr;
+    size_t range_count = 0;
+    std::vector<uint32_t> owned_ranges;
+  };
+
+  using FallbackKey = std::pair<uint32_t, std::string>;
+
+  const fml::UniqueFD directory_;
+  const bool read_only_;
+  std::mutex mutex_;
+  std::unique_ptr<fml::FileMapping> mapping_;
+  std::unordered_map<uint64_t, CoverageEntry> coverage_;
+  std::map<FallbackKey, std::string> fallback_families_;
+  bool dirty_ = false;
+
+  // Reads the entries of the mapped file. Returns false, having read nothing,
+  // if the file is not a valid cache of the current version, or if any of its
+  // entries is corrupt.
+  bool Load();
+
+  std::vector<uint8_t> Serialize() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FontFallbackCache);
+};
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_FONT_FALLBACK_CACHE_H_
@@ -31,6 +31,19 @@ std::unique_ptr<ParagraphBuilder> ParagraphBuilder::CreateTxtBuilder(
   return std::make_unique<ParagraphBuilderTxt>(style, font_collection);
 }
 
+void ParagraphBuilder::AddStyledText(const uint16_t* text,
+                                     size_t length,
+                                     const std::vector<TextStyle>& styles,
+                                     const std::vector<StyledRange>& ranges) {
+  size_t start = 0;
+  for (const StyledRange& range : ranges) {
+    PushStyle(styles[range.style_index]);
+    AddText(std::u16string(text + start, text + range.end));
+    Pop();
+    start = range.end;
+  }
+}
+
 #if FLUTTER_ENABLE_SKSHAPER
 
 std::unique_ptr<ParagraphBuilder> ParagraphBuilder::CreateSkiaBuilder(
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "font_collection.h"
@@ -31,6 +32,13 @@ namespace txt {
 
 class ParagraphBuilder {
  public:
+  // A run of the text added with AddStyledText. The run ends at the code unit
+  // |end| and starts where the previous run ended.
+  struct StyledRange {
+    size_t style_index;
+    size_t end;
+  };
+
   static std::unique_ptr<ParagraphBuilder> CreateTxtBuilder(
       const ParagraphStyle& style,
       std::shared_ptr<FontCollection> font_collection);
@@ -67,6 +75,17 @@ class ParagraphBuilder {
   // on the style_stack_;
   virtual void AddText(const std::u16string& text) = 0;
 
+  // Adds |length| code units of text, with the runs in |ranges| using the
+  // styles at their index in |styles|. The last range must end at |length|.
+  //
+  // This has the same effect as pushing the style of each range, adding its
+  // text and popping the style again, but avoids copying the text into a
+  // string first. The Txt builder also stores each distinct style only once.
+  virtual void AddStyledText(const uint16_t* text,
+                             size_t length,
+                             const std::vector<TextStyle>& styles,
+                             const std::vector<StyledRange>& ranges);
+
   // Pushes the information requried to leave an open space, where Flutter may
   // draw a custom placeholder into.
   //
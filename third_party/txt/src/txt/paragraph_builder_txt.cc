@@ -60,6 +60,27 @@ void ParagraphBuilderTxt::AddText(const std::u16string& text) {
   text_.insert(text_.end(), text.begin(), text.end());
 }
 
+void ParagraphBuilderTxt::AddStyledText(
+    const uint16_t* text,
+    size_t length,
+    const std::vector<TextStyle>& styles,
+    const std::vector<StyledRange>& ranges) {
+  std::vector<size_t> style_indexes;
+  style_indexes.reserve(styles.size());
+  for (const TextStyle& style : styles) {
+    style_indexes.push_back(runs_.InternStyle(style));
+  }
+
+  const size_t start = text_.size();
+  text_.insert(text_.end(), text, text + length);
+  size_t range_start = start;
+  for (const StyledRange& range : ranges) {
+    runs_.StartRun(style_indexes[range.style_index], range_start);
+    range_start = start + range.end;
+  }
+  runs_.StartRun(PeekStyleIndex(), text_.size());
+}
+
 void ParagraphBuilderTxt::AddPlaceholder(PlaceholderRun& span) {
   obj_replacement_char_indexes_.insert(text_.size());
   runs_.StartRun(PeekStyleIndex(), text_.size());
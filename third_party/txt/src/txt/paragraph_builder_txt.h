@@ -35,6 +35,10 @@ class ParagraphBuilderTxt : public ParagraphBuilder {
   virtual void Pop() override;
   virtual const TextStyle& PeekStyle() override;
   virtual void AddText(const std::u16string& text) override;
+  virtual void AddStyledText(const uint16_t* text,
+                             size_t length,
+                             const std::vector<TextStyle>& styles,
+                             const std::vector<StyledRange>& ranges) override;
   virtual void AddPlaceholder(PlaceholderRun& span) override;
   virtual std::unique_ptr<Paragraph> Build() override;
 
@@ -29,6 +29,7 @@
 #include "flutter/fml/logging.h"
 #include "font_collection.h"
 #include "font_skia.h"
+#include "minikin/BreakIteratorPool.h"
 #include "minikin/FontLanguageListCache.h"
 #include "minikin/GraphemeBreak.h"
 #include "minikin/HbFontCache.h"
@@ -203,8 +204,10 @@ void ParagraphTxt::GlyphPosition::Shift(double delta) {
   x_pos.Shift(delta);
 }
 
-ParagraphTxt::GlyphLine::GlyphLine(std::vector<GlyphPosition>&& p, size_t tcu)
-    : positions(std::move(p)), total_code_units(tcu) {}
+ParagraphTxt::GlyphLine::GlyphLine(std::vector<GlyphPosition>&& p,
+                                   size_t scu,
+                                   size_t tcu)
+    : positions(std::move(p)), start_code_unit(scu), total_code_units(tcu) {}
 
 ParagraphTxt::CodeUnitRun::CodeUnitRun(std::vector<GlyphPosition>&& p,
                                        Range<size_t> cu,
@@ -256,16 +259,23 @@ bool ParagraphTxt::ComputeLineBreaks() {
   line_widths_.clear();
   max_intrinsic_width_ = 0;
 
-  std::vector<size_t> newline_positions;
-  // Discover and add all hard breaks.
-  for (size_t i = 0; i < text_.size(); ++i) {
-    ULineBreak ulb = static_cast<ULineBreak>(
-        u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
-    if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK)
-      newline_positions.push_back(i);
+  // The hard breaks and the widths of the text are reused from the previous
+  // layout if only the width has changed since.
+  if (!text_measured_) {
+    newline_positions_.clear();
+    // Discover and add all hard breaks.
+    for (size_t i = 0; i < text_.size(); ++i) {
+      ULineBreak ulb = static_cast<ULineBreak>(
+          u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
+      if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK)
+        newline_positions_.push_back(i);
+    }
+    // Break at the end of the paragraph.
+    newline_positions_.push_back(text_.size());
+    char_widths_.assign(text_.size(), 0);
+    block_widths_.assign(newline_positions_.size(), 0);
   }
-  // Break at the end of the paragraph.
-  newline_positions.push_back(text_.size());
+  const std::vector<size_t>& newline_positions = newline_positions_;
 
   // Calculate and add any breaks due to a line being too long.
   size_t run_index = 0;
@@ -294,6 +304,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
     memcpy(breaker_.buffer(), text_.data() + block_start,
            block_size * sizeof(text_[0]));
     breaker_.setText();
+    if (text_measured_) {
+      std::copy(char_widths_.begin() + block_start,
+                char_widths_.begin() + block_end, breaker_.charWidths());
+    }
 
     // Add the runs that include this line to the LineBreaker.
     double block_total_width = 0;
@@ -343,6 +357,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
         breaker_.addStyleRun(nullptr, collection, font, run_start, run_end,
                              isRtl);
         inline_placeholder_index++;
+      } else if (text_measured_) {
+        // Is a regular text run that was measured by a previous layout.
+        breaker_.addMeasuredStyleRun(&paint, collection, font, run_start,
+                                     run_end, isRtl);
       } else {
         // Is a regular text run.
         double run_width = breaker_.addStyleRun(&paint, collection, font,
@@ -354,6 +372,13 @@ bool ParagraphTxt::ComputeLineBreaks() {
         break;
       run_index++;
     }
+    if (text_measured_) {
+      block_total_width = block_widths_[newline_index];
+    } else {
+      std::copy(breaker_.charWidths(), breaker_.charWidths() + block_size,
+                char_widths_.begin() + block_start);
+      block_widths_[newline_index] = block_total_width;
+    }
     max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
 
     size_t breaks_count = breaker_.computeBreaks();
@@ -664,6 +689,12 @@ void ParagraphTxt::Layout(double width) {
     return;
   }
 
+  // Anything other than the width may have changed the measurements of the
+  // text.
+  if (needs_layout_) {
+    text_measured_ = false;
+  }
+
   width_ = rounded_width;
 
   needs_layout_ = false;
@@ -679,9 +710,13 @@ void ParagraphTxt::Layout(double width) {
   if (!ComputeLineBreaks())
     return;
 
-  std::vector<BidiRun> bidi_runs;
-  if (!ComputeBidiRuns(&bidi_runs))
-    return;
+  if (!text_measured_) {
+    bidi_runs_.clear();
+    if (!ComputeBidiRuns(&bidi_runs_))
+      return;
+    text_measured_ = true;
+  }
+  const std::vector<BidiRun>& bidi_runs = bidi_runs_;
 
   SkFont font;
   font.setEdging(SkFont::Edging::kAntiAlias);
@@ -1095,7 +1130,12 @@ void ParagraphTxt::Layout(double width) {
     size_t next_line_start = (line_number < line_metrics_.size() - 1)
                                  ? line_metrics_[line_number + 1].start_index
                                  : text_.size();
+    size_t line_start_code_unit =
+        glyph_lines_.empty() ? 0
+                             : glyph_lines_.back().start_code_unit +
+                                   glyph_lines_.back().total_code_units;
     glyph_lines_.emplace_back(std::move(line_glyph_positions),
+                              line_start_code_unit,
                               next_line_start - line_metrics.start_index);
     code_unit_runs_.insert(code_unit_runs_.end(), line_code_unit_runs.begin(),
                            line_code_unit_runs.end());
@@ -1656,8 +1696,22 @@ std::vector<Paragraph::TextBox> ParagraphTxt::GetRectsForRange(
   size_t min_line = INT_MAX;
   size_t glyph_length = 0;
 
+  // Lines and runs are sorted by code unit index. Skip those on the lines
+  // before the range, which contribute no boxes.
+  const size_t first_line = GetFirstLineEndingAfter(start);
+  auto first_run = code_unit_runs_.end();
+  if (first_line < line_metrics_.size()) {
+    const size_t first_line_start = line_metrics_[first_line].start_index;
+    first_run = std::partition_point(
+        code_unit_runs_.begin(), code_unit_runs_.end(),
+        [first_line_start](const CodeUnitRun& run) {
+          return run.code_units.start < first_line_start;
+        });
+  }
+
   // Generate initial boxes and calculate metrics.
-  for (const CodeUnitRun& run : code_unit_runs_) {
+  for (auto run_it = first_run; run_it != code_unit_runs_.end(); ++run_it) {
+    const CodeUnitRun& run = *run_it;
     // Check to see if we are finished.
     if (run.code_units.start >= end)
       break;
@@ -1726,7 +1780,7 @@ std::vector<Paragraph::TextBox> ParagraphTxt::GetRectsForRange(
 
   // Add empty rectangles representing any newline characters within the
   // range.
-  for (size_t line_number = 0; line_number < line_metrics_.size();
+  for (size_t line_number = first_line; line_number < line_metrics_.size();
        ++line_number) {
     LineMetrics& line = line_metrics_[line_number];
     if (line.start_index >= end)
@@ -1849,6 +1903,14 @@ std::vector<Paragraph::TextBox> ParagraphTxt::GetRectsForRange(
   return boxes;
 }
 
+size_t ParagraphTxt::GetFirstLineEndingAfter(size_t offset) const {
+  return std::partition_point(line_metrics_.begin(), line_metrics_.end(),
+                              [offset](const LineMetrics& line) {
+                                return line.end_including_newline <= offset;
+                              }) -
+         line_metrics_.begin();
+}
+
 Paragraph::PositionWithAffinity ParagraphTxt::GetGlyphPositionAtCoordinate(
     double dx,
     double dy) {
@@ -1856,62 +1918,65 @@ Paragraph::PositionWithAffinity ParagraphTxt::GetGlyphPositionAtCoordinate(
   if (final_line_count_ <= 0)
     return PositionWithAffinity(0, DOWNSTREAM);
 
-  size_t y_index;
-  for (y_index = 0; y_index < final_line_count_ - 1; ++y_index) {
-    if (dy < line_metrics_[y_index].height)
-      break;
-  }
+  // The height of each line is the y coordinate of its bottom, so the lines
+  // are sorted by it. The last line also takes all coordinates below it.
+  const size_t y_index =
+      std::partition_point(line_metrics_.begin(),
+                           line_metrics_.begin() + final_line_count_ - 1,
+                           [dy](const LineMetrics& line) {
+                             return dy >= line.height;
+                           }) -
+      line_metrics_.begin();
 
   const std::vector<GlyphPosition>& line_glyph_position =
       glyph_lines_[y_index].positions;
   if (line_glyph_position.empty()) {
-    int line_start_index =
-        std::accumulate(glyph_lines_.begin(), glyph_lines_.begin() + y_index, 0,
-                        [](const int a, const GlyphLine& b) {
-                          return a + static_cast<int>(b.total_code_units);
-                        });
-    return PositionWithAffinity(line_start_index, DOWNSTREAM);
+    return PositionWithAffinity(glyph_lines_[y_index].start_code_unit,
+                                DOWNSTREAM);
   }
 
-  size_t x_index;
-  const GlyphPosition* gp = nullptr;
-  const GlyphPosition* gp_cluster = nullptr;
-  bool is_cluster_corection = false;
-  for (x_index = 0; x_index < line_glyph_position.size(); ++x_index) {
-    double glyph_end = (x_index < line_glyph_position.size() - 1)
-                           ? line_glyph_position[x_index + 1].x_pos.start
-                           : line_glyph_position[x_index].x_pos.end;
-    if (gp_cluster == nullptr ||
-        gp_cluster->cluster != line_glyph_position[x_index].cluster) {
-      gp_cluster = &line_glyph_position[x_index];
-    }
-    if (dx < glyph_end) {
-      // Check if the glyph position is part of a cluster. If it is,
-      // we assign the cluster's root GlyphPosition to represent it.
-      if (gp_cluster->cluster == line_glyph_position[x_index].cluster) {
-        gp = gp_cluster;
-        // Detect if the matching GlyphPosition was non-root for the cluster.
-        if (gp_cluster != &line_glyph_position[x_index]) {
-          is_cluster_corection = true;
-        }
-      } else {
-        gp = &line_glyph_position[x_index];
-      }
-      break;
-    }
-  }
-
-  if (gp == nullptr) {
+  // Find the first glyph that ends after dx. A glyph ends where the next one
+  // starts, and the glyphs are sorted by x coordinate.
+  const GlyphPosition* const line_begin = line_glyph_position.data();
+  const GlyphPosition* const line_end = line_begin + line_glyph_position.size();
+  const GlyphPosition* x_glyph = std::partition_point(
+      line_begin, line_end, [dx, line_end](const GlyphPosition& glyph) {
+        const double glyph_end = (&glyph + 1 < line_end)
+                                     ? (&glyph + 1)->x_pos.start
+                                     : glyph.x_pos.end;
+        return dx >= glyph_end;
+      });
+
+  if (x_glyph == line_end) {
     const GlyphPosition& last_glyph = line_glyph_position.back();
     return PositionWithAffinity(last_glyph.code_units.end, UPSTREAM);
   }
 
-  // Find the direction of the run that contains this glyph.
+  // Check if the glyph position is part of a cluster. If it is, we assign the
+  // cluster's root GlyphPosition to represent it.
+  const GlyphPosition* gp = x_glyph;
+  while (gp > line_begin && (gp - 1)->cluster == x_glyph->cluster) {
+    --gp;
+  }
+  // Detect if the matching GlyphPosition was non-root for the cluster.
+  const bool is_cluster_corection = gp != x_glyph;
+
+  // Find the direction of the run that contains this glyph. The runs are
+  // sorted by code unit index and do not overlap, so only the runs starting at
+  // or before the glyph can contain it.
   TextDirection direction = TextDirection::ltr;
-  for (const CodeUnitRun& run : code_unit_runs_) {
-    if (gp->code_units.start >= run.code_units.start &&
-        gp->code_units.end <= run.code_units.end) {
-      direction = run.direction;
+  auto run_it = std::partition_point(
+      code_unit_runs_.begin(), code_unit_runs_.end(),
+      [gp](const CodeUnitRun& run) {
+        return run.code_units.start <= gp->code_units.start;
+      });
+  while (run_it != code_unit_runs_.begin()) {
+    --run_it;
+    if (gp->code_units.end <= run_it->code_units.end) {
+      direction = run_it->direction;
+      break;
+    }
+    if (run_it->code_units.end < gp->code_units.start) {
       break;
     }
   }
@@ -1976,18 +2041,18 @@ Paragraph::Range<size_t> ParagraphTxt::GetWordBoundary(size_t offset) {
   if (text_.size() == 0)
     return Range<size_t>(0, 0);
 
-  if (!word_breaker_) {
-    UErrorCode status = U_ZERO_ERROR;
-    word_breaker_.reset(
-        icu::BreakIterator::createWordInstance(icu::Locale(), status));
-    if (!U_SUCCESS(status))
-      return Range<size_t>(0, 0);
-  }
+  minikin::BreakIteratorPool::Ptr word_breaker =
+      minikin::BreakIteratorPool::getInstance().acquire(
+          icu::Locale(), minikin::BreakIteratorPool::Kind::kWord);
+  if (!word_breaker)
+    return Range<size_t>(0, 0);
 
-  word_breaker_->setText(icu::UnicodeString(false, text_.data(), text_.size()));
+  // The iterator refers to the string, so it must outlive the queries.
+  const icu::UnicodeString text(false, text_.data(), text_.size());
+  word_breaker->setText(text);
 
-  int32_t prev_boundary = word_breaker_->preceding(offset + 1);
-  int32_t next_boundary = word_breaker_->next();
+  int32_t prev_boundary = word_breaker->preceding(offset + 1);
+  int32_t next_boundary = word_breaker->next();
   if (prev_boundary == icu::BreakIterator::DONE)
     prev_boundary = offset;
   if (next_boundary == icu::BreakIterator::DONE)
@@ -161,6 +161,8 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST(ParagraphTest, InlinePlaceholder0xFFFCParagraph);
   FRIEND_TEST(ParagraphTest, FontFeaturesParagraph);
   FRIEND_TEST(ParagraphTest, GetGlyphPositionAtCoordinateSegfault);
+  FRIEND_TEST(ParagraphTest, HitTestManyLines);
+  FRIEND_TEST(ParagraphTest, AddStyledText);
   FRIEND_TEST(ParagraphTest, KhmerLineBreaker);
   FRIEND_TEST(ParagraphTest, TextHeightBehaviorRectsParagraph);
 
@@ -183,7 +185,6 @@ class ParagraphTxt : public Paragraph {
   std::shared_ptr<FontCollection> font_collection_;
 
   minikin::LineBreaker breaker_;
-  mutable std::unique_ptr<icu::BreakIterator> word_breaker_;
 
   std::vector<LineMetrics> line_metrics_;
   size_t final_line_count_;
@@ -276,9 +277,11 @@ class ParagraphTxt : public Paragraph {
   struct GlyphLine {
     // Glyph positions sorted by x coordinate.
     const std::vector<GlyphPosition> positions;
+    // The number of code units in the lines before this one.
+    const size_t start_code_unit;
     const size_t total_code_units;
 
-    GlyphLine(std::vector<GlyphPosition>&& p, size_t tcu);
+    GlyphLine(std::vector<GlyphPosition>&& p, size_t scu, size_t tcu);
   };
 
   struct CodeUnitRun {
@@ -307,12 +310,30 @@ class ParagraphTxt : public Paragraph {
   // Holds the laid out x positions of each glyph.
   std::vector<GlyphLine> glyph_lines_;
 
+  // Returns the index of the first line in line_metrics_ that ends, including
+  // its newline, after the code unit at |offset|. Lines are sorted by code
+  // unit index, so this is a binary search.
+  size_t GetFirstLineEndingAfter(size_t offset) const;
+
   // Holds the positions of each range of code units in the text.
   // Sorted in code unit index order.
   std::vector<CodeUnitRun> code_unit_runs_;
   // Holds the positions of the inline placeholders.
   std::vector<CodeUnitRun> inline_placeholder_code_unit_runs_;
 
+  // Measurements of the text that do not depend on the width it is laid out
+  // at. They are kept across calls to Layout() so that laying the paragraph
+  // out again at another width only breaks and positions its lines, without
+  // shaping the text or resolving its bidi runs again.
+  bool text_measured_ = false;
+  // The positions of the hard breaks, followed by the end of the text.
+  std::vector<size_t> newline_positions_;
+  // The advance of each code unit as measured for line breaking.
+  std::vector<float> char_widths_;
+  // The width of each block of text between hard breaks.
+  std::vector<double> block_widths_;
+  std::vector<BidiRun> bidi_runs_;
+
   // The max width of the paragraph as provided in the most recent Layout()
   // call.
   double width_ = -1.0f;
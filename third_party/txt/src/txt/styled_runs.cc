@@ -16,10 +16,28 @@
 
 #include "styled_runs.h"
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/logging.h"
 #include "utils/WindowsUtils.h"
 
 namespace txt {
+namespace {
+
+// Hashes the attributes of |style| that usually tell styles apart. Styles
+// that are equal have the same hash.
+size_t HashStyle(const TextStyle& style) {
+  size_t hash = fml::HashCombine(
+      style.color, style.decoration, style.font_weight, style.font_style,
+      style.font_size, style.letter_spacing, style.word_spacing, style.height,
+      style.locale, style.has_foreground, style.foreground.getColor(),
+      style.has_background, style.background.getColor());
+  for (const std::string& font_family : style.font_families) {
+    fml::HashCombineSeed(hash, font_family);
+  }
+  return hash;
+}
+
+}  // namespace
 
 StyledRuns::StyledRuns() = default;
 
@@ -28,17 +46,20 @@ StyledRuns::~StyledRuns() = default;
 StyledRuns::StyledRuns(StyledRuns&& other) {
   styles_.swap(other.styles_);
   runs_.swap(other.runs_);
+  interned_styles_.swap(other.interned_styles_);
 }
 
 const StyledRuns& StyledRuns::operator=(StyledRuns&& other) {
   styles_.swap(other.styles_);
   runs_.swap(other.runs_);
+  interned_styles_.swap(other.interned_styles_);
   return *this;
 }
 
 void StyledRuns::swap(StyledRuns& other) {
   styles_.swap(other.styles_);
   runs_.swap(other.runs_);
+  interned_styles_.swap(other.interned_styles_);
 }
 
 size_t StyledRuns::AddStyle(const TextStyle& style) {
@@ -47,6 +68,19 @@ size_t StyledRuns::AddStyle(const TextStyle& style) {
   return style_index;
 }
 
+size_t StyledRuns::InternStyle(const TextStyle& style) {
+  const size_t hash = HashStyle(style);
+  auto candidates = interned_styles_.equal_range(hash);
+  for (auto it = candidates.first; it != candidates.second; ++it) {
+    if (styles_[it->second].equals(style)) {
+      return it->second;
+    }
+  }
+  const size_t style_index = AddStyle(style);
+  interned_styles_.emplace(hash, style_index);
+  return style_index;
+}
+
 const TextStyle& StyledRuns::GetStyle(size_t style_index) const {
   return styles_[style_index];
 }
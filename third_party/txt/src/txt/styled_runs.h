@@ -18,6 +18,7 @@
 #define LIB_TXT_SRC_STYLED_RUNS_H_
 
 #include <list>
+#include <unordered_map>
 #include <vector>
 
 #include "text_style.h"
@@ -50,6 +51,11 @@ class StyledRuns {
 
   size_t AddStyle(const TextStyle& style);
 
+  // Like AddStyle, but returns the index of an equal style that was
+  // previously interned instead of storing the style again. Styles are looked
+  // up by hash, so interning n styles takes O(n) comparisons.
+  size_t InternStyle(const TextStyle& style);
+
   const TextStyle& GetStyle(size_t style_index) const;
 
   void StartRun(size_t style_index, size_t start);
@@ -83,6 +89,7 @@ class StyledRuns {
   FRIEND_TEST(ParagraphTest, SimpleShadow);
   FRIEND_TEST(ParagraphTest, ComplexShadow);
   FRIEND_TEST(ParagraphTest, FontFallbackParagraph);
+  FRIEND_TEST(ParagraphTest, AddStyledText);
 
   struct IndexedRun {
     size_t style_index = 0;
@@ -95,6 +102,8 @@ class StyledRuns {
 
   std::vector<TextStyle> styles_;
   std::vector<IndexedRun> runs_;
+  // The indexes of the styles added by InternStyle, by the hash of the style.
+  std::unordered_multimap<size_t, size_t> interned_styles_;
 };
 
 }  // namespace txt
@@ -40,6 +40,12 @@ bool TextStyle::equals(const TextStyle& other) const {
     return false;
   if (font_style != other.font_style)
     return false;
+  if (text_baseline != other.text_baseline)
+    return false;
+  if (font_families != other.font_families)
+    return false;
+  if (font_size != other.font_size)
+    return false;
   if (letter_spacing != other.letter_spacing)
     return false;
   if (word_spacing != other.word_spacing)
@@ -50,19 +56,18 @@ bool TextStyle::equals(const TextStyle& other) const {
     return false;
   if (locale != other.locale)
     return false;
+  if (has_background != other.has_background)
+    return false;
+  if (background != other.background)
+    return false;
+  if (has_foreground != other.has_foreground)
+    return false;
   if (foreground != other.foreground)
     return false;
-  if (text_shadows.size() != other.text_shadows.size())
-    return false;
-  for (size_t font_index = 0; font_index < font_families.size(); ++font_index) {
-    if (font_families[font_index] != other.font_families[font_index])
-      return false;
-  }
-  for (size_t shadow_index = 0; shadow_index < text_shadows.size();
-       ++shadow_index) {
-    if (text_shadows[shadow_index] != other.text_shadows[shadow_index])
-      return false;
-  }
+  if (text_shadows != other.text_shadows)
+    return false;
+  if (font_features.GetFontFeatures() != other.font_features.GetFontFeatures())
+    return false;
 
   return true;
 }
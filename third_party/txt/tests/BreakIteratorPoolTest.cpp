@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <minikin/BreakIteratorPool.h>
+#include <minikin/WordBreaker.h>
+
+namespace minikin {
+
+TEST(BreakIteratorPoolTest, reusesReturnedIterators) {
+  BreakIteratorPool& pool = BreakIteratorPool::getInstance();
+  const icu::Locale locale("fr", "CA");
+
+  icu::BreakIterator* first = nullptr;
+  {
+    BreakIteratorPool::Ptr iterator =
+        pool.acquire(locale, BreakIteratorPool::Kind::kLine);
+    ASSERT_NE(iterator, nullptr);
+    first = iterator.get();
+  }
+  BreakIteratorPool::Ptr line =
+      pool.acquire(locale, BreakIteratorPool::Kind::kLine);
+  EXPECT_EQ(line.get(), first);
+
+  // Iterators of another kind or locale are not shared.
+  BreakIteratorPool::Ptr word =
+      pool.acquire(locale, BreakIteratorPool::Kind::kWord);
+  ASSERT_NE(word, nullptr);
+  EXPECT_NE(word.get(), first);
+  BreakIteratorPool::Ptr other =
+      pool.acquire(icu::Locale("de"), BreakIteratorPool::Kind::kLine);
+  ASSERT_NE(other, nullptr);
+  EXPECT_NE(other.get(), first);
+}
+
+TEST(BreakIteratorPoolTest, keepsBoundedIdleIterators) {
+  BreakIteratorPool& pool = BreakIteratorPool::getInstance();
+  const icu::Locale locale("nl");
+
+  const size_t idle = pool.getIdleCount();
+  {
+    std::vector<BreakIteratorPool::Ptr> iterators;
+    for (size_t i = 0; i < BreakIteratorPool::kMaxIdlePerKey * 2; i++) {
+      iterators.push_back(pool.acquire(locale, BreakIteratorPool::Kind::kWord));
+      ASSERT_NE(iterators.back(), nullptr);
+    }
+  }
+  EXPECT_EQ(pool.getIdleCount(), idle + BreakIteratorPool::kMaxIdlePerKey);
+}
+
+TEST(BreakIteratorPoolTest, breakersOnSeveralThreads) {
+  const std::u16string text = u"The quick brown fox jumps over the lazy dog.";
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&text]() {
+      for (int j = 0; j < 100; j++) {
+        WordBreaker breaker;
+        breaker.setLocale(icu::Locale::getEnglish());
+        breaker.setText(reinterpret_cast<const uint16_t*>(text.data()),
+                        text.size());
+        int breaks = 0;
+        while (breaker.next() != -1) {
+          breaks++;
+        }
+        breaker.finish();
+        // One break after each of the nine words.
+        EXPECT_EQ(breaks, 9);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace minikin
@@ -51,4 +51,20 @@ TEST(SparseBitSetTest, randomTest) {
   }
 }
 
+TEST(SparseBitSetTest, getRanges) {
+  const uint32_t ranges[] = {0x20, 0x7F, 0xA0, 0x100, 0x4E00, 0x9FFF,
+                             0x1F600, 0x1F650};
+  SparseBitSet bitset(ranges, 4);
+
+  std::vector<uint32_t> result = bitset.getRanges();
+  ASSERT_EQ(std::vector<uint32_t>(ranges, ranges + 8), result);
+
+  SparseBitSet copy(result.data(), result.size() / 2);
+  for (uint32_t ch = 0; ch < 0x20000; ++ch) {
+    ASSERT_EQ(bitset.get(ch), copy.get(ch)) << std::hex << ch;
+  }
+
+  EXPECT_TRUE(SparseBitSet().getRanges().empty());
+}
+
 }  // namespace minikin
@@ -22,6 +22,35 @@
 
 namespace txt {
 
+TEST(FontCollection, ItemizeLongLatinText) {
+  std::u16string text;
+  for (int i = 0; i < 100; i++) {
+    text += u"Lorem ipsum, ";
+  }
+  const size_t latin_length = text.size();
+  // U+1F600 GRINNING FACE.
+  text += u"\U0001F600 dolor";
+
+  std::shared_ptr<FontCollection> font_collection = GetTestFontCollection();
+  auto collection = font_collection->GetMinikinFontCollectionForFamilies(
+      {"Roboto", "Noto Color Emoji"}, "en-US");
+  ASSERT_NE(collection, nullptr);
+
+  std::vector<minikin::FontCollection::Run> runs;
+  collection->itemize(reinterpret_cast<const uint16_t*>(text.data()),
+                      text.size(), minikin::FontStyle(4, false), &runs);
+
+  ASSERT_EQ(runs.size(), 3u);
+  EXPECT_EQ(runs[0].start, 0);
+  EXPECT_EQ(runs[0].end, static_cast<int>(latin_length));
+  EXPECT_EQ(runs[1].start, static_cast<int>(latin_length));
+  EXPECT_EQ(runs[1].end, static_cast<int>(latin_length + 2));
+  EXPECT_EQ(runs[2].start, static_cast<int>(latin_length + 2));
+  EXPECT_EQ(runs[2].end, static_cast<int>(text.size()));
+  EXPECT_EQ(runs[0].fakedFont.font, runs[2].fakedFont.font);
+  EXPECT_NE(runs[0].fakedFont.font, runs[1].fakedFont.font);
+}
+
 #if 0
 
 TEST(FontCollection, HasDefaultRegistrations) {
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+#include "txt/font_fallback_cache.h"
+#include "txt_test_utils.h"
+
+namespace txt {
+
+namespace {
+
+fml::UniqueFD OpenDirectory(const fml::ScopedTemporaryDirectory& directory) {
+  return fml::OpenDirectory(directory.path().c_str(), false,
+                            fml::FilePermission::kReadWrite);
+}
+
+sk_sp<SkTypeface> LoadTestTypeface(const std::string& file_name) {
+  return SkTypeface::MakeFromFile((GetFontDir() + "/" + file_name).c_str());
+}
+
+// Makes a cache file with a coverage entry of |ranges| for family 42, and a
+// valid fallback entry.
+std::string MakeCacheFile(const std::vector<uint32_t>& ranges) {
+  std::string data;
+  auto append = [&data](const auto& value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  append(SkSetFourByteTag('t', 'x', 'f', 'b'));
+  append(FontFallbackCache::kVersion);
+  append(uint32_t{1});  // Coverage count.
+  append(uint32_t{1});  // Fallback count.
+  append(uint64_t{42});
+  append(uint32_t{0});  // Has no variation selector table.
+  append(static_cast<uint32_t>(ranges.size() / 2));
+  for (uint32_t value : ranges) {
+    append(value);
+  }
+  append(uint32_t{0x4E00});
+  append(uint32_t{0});  // Locale size.
+  append(uint32_t{4});  // Family name size.
+  data.append("Noto");
+  return data;
+}
+
+}  // namespace
+
+TEST(FontFallbackCache, SavesAndLoads) {
+  fml::ScopedTemporaryDirectory directory;
+  const uint32_t ranges[] = {0x20, 0x7F, 0x4E00, 0x9FFF};
+
+  {
+    FontFallbackCache cache(OpenDirectory(directory));
+    EXPECT_FALSE(cache.IsDirty());
+    cache.SetCoverage(42, minikin::SparseBitSet(ranges, 2), true);
+    cache.SetFallbackFamily(0x4E00, "ja", "Noto Sans CJK JP");
+    EXPECT_TRUE(cache.IsDirty());
+    ASSERT_TRUE(cache.Save());
+    EXPECT_FALSE(cache.IsDirty());
+  }
+
+  FontFallbackCache cache(OpenDirectory(directory));
+  EXPECT_FALSE(cache.IsDirty());
+
+  minikin::SparseBitSet coverage;
+  bool has_vs_table = false;
+  ASSERT_TRUE(cache.GetCoverage(42, &coverage, &has_vs_table));
+  EXPECT_TRUE(has_vs_table);
+  EXPECT_EQ(coverage.getRanges(), std::vector<uint32_t>(ranges, ranges + 4));
+  EXPECT_FALSE(cache.GetCoverage(43, &coverage, &has_vs_table));
+
+  std::string family_name;
+  ASSERT_TRUE(cache.GetFallbackFamily(0x4E00, "ja", &family_name));
+  EXPECT_EQ(family_name, "Noto Sans CJK JP");
+  EXPECT_FALSE(cache.GetFallbackFamily(0x4E00, "zh", &family_name));
+  EXPECT_FALSE(cache.GetFallbackFamily(0x4E01, "ja", &family_name));
+}
+
+TEST(FontFallbackCache, IgnoresInvalidFiles) {
+  fml::ScopedTemporaryDirectory directory;
+  fml::UniqueFD fd = OpenDirectory(directory);
+  ASSERT_TRUE(fml::WriteAtomically(
+      fd, FontFallbackCache::kFileName,
+      fml::DataMapping(std::string("not a font fallback cache"))));
+
+  FontFallbackCache cache(std::move(fd));
+  minikin::SparseBitSet coverage;
+  bool has_vs_table = false;
+  EXPECT_FALSE(cache.GetCoverage(42, &coverage, &has_vs_table));
+
+  // The invalid file is replaced on the next save.
+  cache.SetFallbackFamily(0x1F600, "", "Noto Color Emoji");
+  ASSERT_TRUE(cache.Save());
+  FontFallbackCache reloaded(OpenDirectory(directory));
+  std::string family_name;
+  ASSERT_TRUE(reloaded.GetFallbackFamily(0x1F600, "", &family_name));
+  EXPECT_EQ(family_name, "Noto Color Emoji");
+}
+
+TEST(FontFallbackCache, LoadsHandWrittenFile) {
+  fml::ScopedTemporaryDirectory directory;
+  fml::UniqueFD fd = OpenDirectory(directory);
+  ASSERT_TRUE(fml::WriteAtomically(
+      fd, FontFallbackCache::kFileName,
+      fml::DataMapping(MakeCacheFile({0x20, 0x7F, 0x7F, 0x80, 0x10FFFF,
+                                      0x110000}))));
+
+  FontFallbackCache cache(std::move(fd));
+  minikin::SparseBitSet coverage;
+  bool has_vs_table = false;
+  ASSERT_TRUE(cache.GetCoverage(42, &coverage, &has_vs_table));
+  EXPECT_TRUE(coverage.get(0x7F));
+  EXPECT_TRUE(coverage.get(0x10FFFF));
+  std::string family_name;
+  EXPECT_TRUE(cache.GetFallbackFamily(0x4E00, "", &family_name));
+}
+
+TEST(FontFallbackCache, IgnoresFilesWithCorruptRanges) {
+  const std::vector<std::vector<uint32_t>> corrupt_ranges = {
+      // Unsorted.
+      {0x4E00, 0x9FFF, 0x20, 0x7F},
+      // Overlapping.
+      {0x20, 0x7F, 0x40, 0x100},
+      // Empty.
+      {0x20, 0x20},
+      // Reversed.
+      {0x7F, 0x20},
+      // Beyond Unicode.
+      {0x20, 0x110001},
+  };
+  for (const std::vector<uint32_t>& ranges : corrupt_ranges) {
+    fml::ScopedTemporaryDirectory directory;
+    fml::UniqueFD fd = OpenDirectory(directory);
+    ASSERT_TRUE(fml::WriteAtomically(
+        fd, FontFallbackCache::kFileName,
+        fml::DataMapping(MakeCacheFile(ranges))));
+
+    // Nothing of the file is used, not even its valid entries.
+    FontFallbackCache cache(std::move(fd));
+    minikin::SparseBitSet coverage;
+    bool has_vs_table = false;
+    EXPECT_FALSE(cache.GetCoverage(42, &coverage, &has_vs_table));
+    std::string family_name;
+    EXPECT_FALSE(cache.GetFallbackFamily(0x4E00, "", &family_name));
+  }
+}
+
+TEST(FontFallbackCache, DoesNotSaveWhenReadOnly) {
+  fml::ScopedTemporaryDirectory directory;
+  {
+    FontFallbackCache cache(OpenDirectory(directory), true);
+    cache.SetFallbackFamily(0x1F600, "", "Noto Color Emoji");
+    EXPECT_FALSE(cache.IsDirty());
+    ASSERT_TRUE(cache.Save());
+
+    // Results are still kept in memory.
+    std::string family_name;
+    EXPECT_TRUE(cache.GetFallbackFamily(0x1F600, "", &family_name));
+  }
+
+  FontFallbackCache reloaded(OpenDirectory(directory));
+  std::string family_name;
+  EXPECT_FALSE(reloaded.GetFallbackFamily(0x1F600, "", &family_name));
+}
+
+TEST(FontFallbackCache, FamilyIdDependsOnFonts) {
+  std::vector<sk_sp<SkTypeface>> roboto = {
+      LoadTestTypeface("Roboto-Regular.ttf")};
+  std::vector<sk_sp<SkTypeface>> roboto_again = {
+      LoadTestTypeface("Roboto-Regular.ttf")};
+  std::vector<sk_sp<SkTypeface>> roboto_bold = {
+      LoadTestTypeface("Roboto-Regular.ttf"),
+      LoadTestTypeface("Roboto-Bold.ttf")};
+  ASSERT_TRUE(roboto[0] && roboto_bold[1]);
+
+  const uint64_t id = FontFallbackCache::GetFamilyId(roboto);
+  EXPECT_NE(id, 0u);
+  EXPECT_EQ(id, FontFallbackCache::GetFamilyId(roboto_again));
+  EXPECT_NE(id, FontFallbackCache::GetFamilyId(roboto_bold));
+  EXPECT_EQ(FontFallbackCache::GetFamilyId({}), 0u);
+}
+
+}  // namespace txt
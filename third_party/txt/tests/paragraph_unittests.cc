@@ -17,6 +17,7 @@
 #include <iostream>
 
 #include "flutter/fml/logging.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
@@ -177,6 +178,115 @@ TEST_F(ParagraphTest, GetGlyphPositionAtCoordinateSegfault) {
 
 // Check that GetGlyphPositionAtCoordinate computes correct text positions for
 // a paragraph containing multiple styled runs.
+TEST_F(ParagraphTest, HitTestManyLines) {
+  std::u16string text;
+  for (int i = 0; i < 200; i++) {
+    text += u"Line of text ";
+    text += std::u16string(i % 3 + 1, u'x');
+    text += u"\n";
+  }
+
+  txt::ParagraphStyle paragraph_style;
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  builder.PushStyle(text_style);
+  builder.AddText(text);
+  builder.Pop();
+
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(GetTestCanvasWidth());
+
+  ASSERT_GE(paragraph->final_line_count_, 200ull);
+  for (size_t i = 0; i < paragraph->final_line_count_; i++) {
+    const LineMetrics& line = paragraph->line_metrics_[i];
+    const double line_top =
+        i == 0 ? 0 : paragraph->line_metrics_[i - 1].height;
+    const double line_middle = (line_top + line.height) / 2;
+
+    // The start and the end of each line.
+    EXPECT_EQ(paragraph->GetGlyphPositionAtCoordinate(-10, line_middle)
+                  .position,
+              line.start_index);
+    if (line.end_index > line.start_index) {
+      const size_t end_position =
+          paragraph
+              ->GetGlyphPositionAtCoordinate(GetTestCanvasWidth(), line_middle)
+              .position;
+      EXPECT_GE(end_position, line.end_excluding_whitespace);
+      EXPECT_LE(end_position, line.end_including_newline);
+
+      // The boxes of the text of the line lie within the line.
+      std::vector<txt::Paragraph::TextBox> boxes =
+          paragraph->GetRectsForRange(line.start_index, line.end_index,
+                                      Paragraph::RectHeightStyle::kMax,
+                                      Paragraph::RectWidthStyle::kTight);
+      ASSERT_FALSE(boxes.empty());
+      for (const txt::Paragraph::TextBox& box : boxes) {
+        EXPECT_NEAR(box.rect.top(), line_top, 1);
+        EXPECT_NEAR(box.rect.bottom(), line.height, 1);
+      }
+    }
+  }
+
+  // Coordinates below the last line hit the last line.
+  EXPECT_EQ(paragraph->GetGlyphPositionAtCoordinate(-10, 1e9).position,
+            paragraph->line_metrics_[paragraph->final_line_count_ - 1]
+                .start_index);
+}
+
+TEST_F(ParagraphTest, AddStyledText) {
+  const std::u16string text = u"aaabbbccc";
+  const std::u16string more_text = u"dd";
+
+  txt::ParagraphStyle paragraph_style;
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+
+  std::vector<txt::TextStyle> styles(2);
+  styles[0].font_families = std::vector<std::string>(1, "Roboto");
+  styles[0].color = SK_ColorBLACK;
+  styles[1].font_families = std::vector<std::string>(1, "Roboto");
+  styles[1].color = SK_ColorRED;
+  builder.AddStyledText(reinterpret_cast<const uint16_t*>(text.data()),
+                        text.size(), styles, {{0, 3}, {1, 6}, {0, 9}});
+  // Equal styles added later are not stored again.
+  builder.AddStyledText(reinterpret_cast<const uint16_t*>(more_text.data()),
+                        more_text.size(), {styles[1]}, {{0, 2}});
+
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(GetTestCanvasWidth());
+
+  ASSERT_EQ(paragraph->text_.size(), text.size() + more_text.size());
+  ASSERT_EQ(paragraph->runs_.styles_.size(), 3ull);
+  ASSERT_EQ(paragraph->runs_.size(), 4ull);
+  const SkColor colors[] = {SK_ColorBLACK, SK_ColorRED, SK_ColorBLACK,
+                            SK_ColorRED};
+  const size_t ends[] = {3, 6, 9, 11};
+  for (size_t i = 0; i < paragraph->runs_.size(); i++) {
+    EXPECT_EQ(paragraph->runs_.GetRun(i).style.color, colors[i]);
+    EXPECT_EQ(paragraph->runs_.GetRun(i).end, ends[i]);
+  }
+}
+
+TEST_F(ParagraphTest, InternStyleComparesStylesWithEqualHashes) {
+  txt::StyledRuns runs;
+  txt::TextStyle style;
+  style.font_families = std::vector<std::string>(1, "Roboto");
+  // Differs only in an attribute that the hash of a style leaves out.
+  txt::TextStyle dotted_style = style;
+  dotted_style.decoration_style = txt::TextDecorationStyle::kDotted;
+
+  const size_t style_index = runs.InternStyle(style);
+  const size_t dotted_style_index = runs.InternStyle(dotted_style);
+  EXPECT_NE(style_index, dotted_style_index);
+  EXPECT_EQ(runs.InternStyle(style), style_index);
+  EXPECT_EQ(runs.InternStyle(dotted_style), dotted_style_index);
+  EXPECT_EQ(runs.GetStyle(dotted_style_index).decoration_style,
+            txt::TextDecorationStyle::kDotted);
+}
+
 TEST_F(ParagraphTest, GetGlyphPositionAtCoordinateMultiRun) {
   txt::ParagraphStyle paragraph_style;
   txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
@@ -206,6 +316,112 @@ TEST_F(ParagraphTest, GetGlyphPositionAtCoordinateMultiRun) {
   ASSERT_TRUE(Snapshot());
 }
 
+// Check that laying a paragraph out again at another width, which reuses the
+// measurements of its text, gives the same result as laying it out from
+// scratch at that width.
+TEST_F(ParagraphTest, RelayoutAtNewWidth) {
+  const std::u16string text[] = {
+      u"This is a long sentence to test how the text wraps. ",
+      u"Larger words\nafter a hard break, ",
+      u"and some more words at the end of the paragraph.",
+  };
+  const size_t text_length =
+      text[0].length() + text[1].length() + text[2].length();
+  auto build_paragraph = [&text]() {
+    txt::ParagraphStyle paragraph_style;
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+
+    txt::TextStyle text_style;
+    text_style.font_families = std::vector<std::string>(1, "Roboto");
+    text_style.color = SK_ColorBLACK;
+    builder.PushStyle(text_style);
+    builder.AddText(text[0]);
+    text_style.font_size = 30;
+    builder.PushStyle(text_style);
+    builder.AddText(text[1]);
+    builder.Pop();
+    builder.AddText(text[2]);
+    return BuildParagraph(builder);
+  };
+
+  auto relaid_out = build_paragraph();
+  relaid_out->Layout(GetTestCanvasWidth());
+  const double max_intrinsic_width = relaid_out->GetMaxIntrinsicWidth();
+  relaid_out->Layout(150);
+
+  auto laid_out = build_paragraph();
+  laid_out->Layout(150);
+
+  EXPECT_GT(relaid_out->GetLineCount(), 3ull);
+  EXPECT_EQ(relaid_out->GetLineCount(), laid_out->GetLineCount());
+  EXPECT_EQ(relaid_out->GetHeight(), laid_out->GetHeight());
+  EXPECT_EQ(relaid_out->GetLongestLine(), laid_out->GetLongestLine());
+  EXPECT_EQ(relaid_out->GetMaxIntrinsicWidth(), max_intrinsic_width);
+  EXPECT_EQ(relaid_out->GetMaxIntrinsicWidth(),
+            laid_out->GetMaxIntrinsicWidth());
+  EXPECT_EQ(relaid_out->GetMinIntrinsicWidth(),
+            laid_out->GetMinIntrinsicWidth());
+
+  std::vector<txt::Paragraph::TextBox> relaid_out_boxes =
+      relaid_out->GetRectsForRange(0, text_length,
+                                   Paragraph::RectHeightStyle::kTight,
+                                   Paragraph::RectWidthStyle::kTight);
+  std::vector<txt::Paragraph::TextBox> laid_out_boxes =
+      laid_out->GetRectsForRange(0, text_length,
+                                 Paragraph::RectHeightStyle::kTight,
+                                 Paragraph::RectWidthStyle::kTight);
+  ASSERT_EQ(relaid_out_boxes.size(), laid_out_boxes.size());
+  for (size_t i = 0; i < laid_out_boxes.size(); ++i) {
+    EXPECT_EQ(relaid_out_boxes[i].rect, laid_out_boxes[i].rect);
+  }
+}
+
+TEST_F(ParagraphTest, LayoutCacheReusesWords) {
+  auto build_paragraph = [](const std::u16string& text) {
+    txt::ParagraphStyle paragraph_style;
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+
+    txt::TextStyle text_style;
+    text_style.font_families = std::vector<std::string>(1, "Roboto");
+    text_style.color = SK_ColorBLACK;
+    builder.PushStyle(text_style);
+    builder.AddText(text);
+    return BuildParagraph(builder);
+  };
+
+  minikin::Layout::purgeCaches();
+  const minikin::LayoutCacheStatistics empty =
+      minikin::Layout::getCacheStatistics();
+  EXPECT_EQ(empty.entryCount, 0u);
+  EXPECT_EQ(empty.bytes, 0u);
+  EXPECT_EQ(empty.maxBytes, minikin::Layout::kDefaultCacheMaxBytes);
+
+  build_paragraph(u"reused words")->Layout(GetTestCanvasWidth());
+  const minikin::LayoutCacheStatistics first =
+      minikin::Layout::getCacheStatistics();
+  EXPECT_GT(first.entryCount, 0u);
+  EXPECT_GT(first.bytes, 0u);
+  EXPECT_LE(first.bytes, first.maxBytes);
+  EXPECT_GT(first.missCount, empty.missCount);
+
+  // The same words in another paragraph are served from the cache.
+  build_paragraph(u"reused words")->Layout(GetTestCanvasWidth());
+  const minikin::LayoutCacheStatistics second =
+      minikin::Layout::getCacheStatistics();
+  EXPECT_GT(second.hitCount, first.hitCount);
+
+  // A budget too small for any word keeps the cache empty.
+  minikin::Layout::setCacheMaxBytes(1);
+  EXPECT_EQ(minikin::Layout::getCacheStatistics().entryCount, 0u);
+  EXPECT_EQ(minikin::Layout::getCacheStatistics().bytes, 0u);
+  EXPECT_GE(minikin::Layout::getCacheStatistics().evictionCount,
+            second.entryCount);
+  build_paragraph(u"uncached words")->Layout(GetTestCanvasWidth());
+  EXPECT_EQ(minikin::Layout::getCacheStatistics().entryCount, 0u);
+
+  minikin::Layout::setCacheMaxBytes(minikin::Layout::kDefaultCacheMaxBytes);
+}
+
 TEST_F(ParagraphTest, LineMetricsParagraph1) {
   const char* text = "Hello! What is going on?\nSecond line \nthirdline";
   auto icu_text = icu::UnicodeString::fromUTF8(text);